@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Convert CBOR batch messages of the asset tracker to the JSON batch format.
+
+The keys must be kept in sync with src/cloud/cloud_codec/cbor_protocol_keys.h.
+"""
+import argparse
+import json
+import struct
+import sys
+
+FORMAT_VERSION = 1
+
+KEY_VERSION = 0
+KEY_TIMESTAMP = 0
+
+# Batch message key: (JSON label, entry value keys). An entry value key of None means
+# that the entry holds a single value.
+ARRAYS = {
+    1: ('roam', {1: 'rsrp', 2: 'area', 3: 'mccmnc', 4: 'cell', 5: 'ip'}),
+    2: ('gps', {1: 'lng', 2: 'lat', 3: 'acc', 4: 'alt', 5: 'spd', 6: 'hdg', 7: None}),
+    3: ('env', {1: 'temp', 2: 'hum'}),
+    4: ('btn', {1: None}),
+    5: ('bat', {1: None}),
+    6: ('acc', {1: 'x', 2: 'y', 3: 'z'}),
+}
+
+BREAK = object()
+
+
+class Decoder:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, length):
+        if self.pos + length > len(self.data):
+            raise ValueError('Truncated message')
+        chunk = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return chunk
+
+    def argument(self, info):
+        if info < 24:
+            return info
+        if info == 24:
+            return self.read(1)[0]
+        if info == 25:
+            return struct.unpack('>H', self.read(2))[0]
+        if info == 26:
+            return struct.unpack('>I', self.read(4))[0]
+        if info == 27:
+            return struct.unpack('>Q', self.read(8))[0]
+        if info == 31:
+            return None
+        raise ValueError(f'Invalid additional information {info}')
+
+    def item(self):
+        initial = self.read(1)[0]
+        major = initial >> 5
+        info = initial & 0x1f
+
+        if major == 7:
+            if info == 25:
+                return struct.unpack('>e', self.read(2))[0]
+            if info == 26:
+                return struct.unpack('>f', self.read(4))[0]
+            if info == 27:
+                return struct.unpack('>d', self.read(8))[0]
+            if info == 31:
+                return BREAK
+            return {20: False, 21: True, 22: None}[info]
+
+        arg = self.argument(info)
+
+        if major == 0:
+            return arg
+        if major == 1:
+            return -1 - arg
+        if major in (2, 3):
+            raw = self.read(arg)
+            return raw.decode('utf-8') if major == 3 else raw
+        if major == 4:
+            return self.items(arg)
+        if major == 5:
+            values = self.items(None if arg is None else 2 * arg)
+            return dict(zip(values[0::2], values[1::2]))
+        raise ValueError(f'Unsupported major type {major}')
+
+    def items(self, count):
+        values = []
+        while count is None or len(values) < count:
+            value = self.item()
+            if value is BREAK:
+                if count is not None:
+                    raise ValueError('Unexpected break')
+                break
+            values.append(value)
+        return values
+
+
+def convert(message):
+    decoder = Decoder(message)
+    root = decoder.item()
+
+    if decoder.pos != len(message):
+        raise ValueError('Trailing data after message')
+    if root.get(KEY_VERSION) != FORMAT_VERSION:
+        raise ValueError(f'Unsupported format version {root.get(KEY_VERSION)}')
+
+    batch = {}
+
+    for key, entries in root.items():
+        if key == KEY_VERSION:
+            continue
+
+        label, value_keys = ARRAYS[key]
+        converted = []
+        ts = 0
+
+        for entry in entries:
+            # Timestamps after the first are relative to the previous entry.
+            ts += entry.pop(KEY_TIMESTAMP)
+
+            if len(entry) == 1 and value_keys.get(next(iter(entry))) is None:
+                value = next(iter(entry.values()))
+            else:
+                value = {value_keys[k]: v for k, v in entry.items()}
+
+            converted.append({'v': value, 'ts': ts})
+
+        batch[label] = converted
+
+    return batch
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert a CBOR batch message to the JSON batch format.')
+    parser.add_argument('input', nargs='?', type=argparse.FileType('rb'),
+                        default=sys.stdin.buffer,
+                        help='File holding the binary message, stdin if omitted.')
+    parser.add_argument('--hex', action='store_true',
+                        help='The input is a hexadecimal string.')
+    args = parser.parse_args()
+
+    message = args.input.read()
+    if args.hex:
+        message = bytes.fromhex(message.decode('ascii'))
+
+    print(json.dumps(convert(message), indent=4))
+
+
+if __name__ == '__main__':
+    main()
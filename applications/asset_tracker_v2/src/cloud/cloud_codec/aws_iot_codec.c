@@ -16,6 +16,7 @@
 #include "json_helpers.h"
 #include "json_common.h"
 #include "json_protocol_names.h"
+#include "cbor_codec.h"
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(cloud_codec, CONFIG_CLOUD_CODEC_LOG_LEVEL);
@@ -349,6 +350,29 @@ int cloud_codec_encode_batch_data(
 	char *buffer;
 	bool object_added = false;
 
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_BATCH_FORMAT_CBOR)) {
+		return cbor_codec_encode_batch_data(output,
+						    gps_buf, sensor_buf, modem_dyn_buf,
+						    ui_buf, accel_buf, bat_buf,
+						    gps_buf_count, sensor_buf_count,
+						    modem_dyn_buf_count, ui_buf_count,
+						    accel_buf_count, bat_buf_count);
+	}
+
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_JSON_STREAMING)) {
+		const struct json_common_batch_section sections[] = {
+			{ JSON_COMMON_MODEM_DYNAMIC, modem_dyn_buf, modem_dyn_buf_count,
+			  DATA_MODEM_DYNAMIC },
+			{ JSON_COMMON_GPS, gps_buf, gps_buf_count, DATA_GPS },
+			{ JSON_COMMON_SENSOR, sensor_buf, sensor_buf_count, DATA_ENVIRONMENTALS },
+			{ JSON_COMMON_UI, ui_buf, ui_buf_count, DATA_BUTTON },
+			{ JSON_COMMON_BATTERY, bat_buf, bat_buf_count, DATA_BATTERY },
+			{ JSON_COMMON_ACCELEROMETER, accel_buf, accel_buf_count, DATA_MOVEMENT },
+		};
+
+		return json_common_batch_data_encode(output, sections, ARRAY_SIZE(sections));
+	}
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
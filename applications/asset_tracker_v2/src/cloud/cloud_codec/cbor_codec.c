@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+
+#include "cloud_codec.h"
+#include "cloud_codec_batch.h"
+#include "cbor_codec.h"
+#include "cbor_protocol_keys.h"
+#include "cbor_writer.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(cbor_codec, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* State of an array of entries in the batch message. */
+struct batch_array {
+	/* Key of the array in the batch message. */
+	int key;
+	/* Set once the array has been opened. */
+	bool open;
+	/* Timestamp of the previous entry, which the next timestamp is relative to. */
+	int64_t prev_ts;
+};
+
+/* Buffer encoded as an array in the batch message. */
+struct batch_section {
+	struct batch_array array;
+	void *buf;
+	size_t buf_count;
+	size_t entry_size;
+	cloud_codec_batch_entry_write_t entry_write;
+};
+
+/* Open the array before its first entry, and write the map header and the timestamp of the
+ * entry, followed by the given number of values.
+ */
+static void entry_start(struct cbor_writer *writer, struct batch_array *array, int64_t ts,
+			size_t values)
+{
+	if (!array->open) {
+		cbor_writer_int(writer, array->key);
+		cbor_writer_array_start_indefinite(writer);
+		array->open = true;
+		array->prev_ts = 0;
+	}
+
+	cbor_writer_map_start(writer, values + 1);
+	cbor_writer_int(writer, CBOR_KEY_TIMESTAMP);
+	cbor_writer_int(writer, ts - array->prev_ts);
+
+	array->prev_ts = ts;
+}
+
+static int modem_dynamic_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_modem_dynamic *data = entry;
+	size_t values = 0;
+	uint32_t mccmnc = 0;
+	char *end_ptr;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	values = data->rsrp_fresh + data->area_code_fresh + data->mccmnc_fresh +
+		 data->cell_id_fresh + data->ip_address_fresh;
+	if (values == 0) {
+		data->queued = false;
+		LOG_WRN("No valid dynamic modem data values present, entry unqueued");
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	if (data->mccmnc_fresh) {
+		/* Convert mccmnc to unsigned long integer. */
+		errno = 0;
+		mccmnc = strtoul(data->mccmnc, &end_ptr, 10);
+
+		if ((errno == ERANGE) || (*end_ptr != '\0')) {
+			LOG_ERR("MCCMNC string could not be converted.");
+			return -ENOTEMPTY;
+		}
+	}
+
+	entry_start(writer, array, ts, values);
+
+	if (data->rsrp_fresh) {
+		cbor_writer_int(writer, CBOR_KEY_MODEM_RSRP);
+		cbor_writer_int(writer, data->rsrp);
+	}
+
+	if (data->area_code_fresh) {
+		cbor_writer_int(writer, CBOR_KEY_MODEM_AREA_CODE);
+		cbor_writer_int(writer, data->area);
+	}
+
+	if (data->mccmnc_fresh) {
+		cbor_writer_int(writer, CBOR_KEY_MODEM_MCCMNC);
+		cbor_writer_int(writer, mccmnc);
+	}
+
+	if (data->cell_id_fresh) {
+		cbor_writer_int(writer, CBOR_KEY_MODEM_CELL_ID);
+		cbor_writer_int(writer, data->cell);
+	}
+
+	if (data->ip_address_fresh) {
+		cbor_writer_int(writer, CBOR_KEY_MODEM_IP_ADDRESS);
+		cbor_writer_str(writer, data->ip);
+	}
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int gps_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_gps *data = entry;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->gps_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	switch (data->format) {
+	case CLOUD_CODEC_GPS_FORMAT_PVT:
+		entry_start(writer, array, ts, 6);
+		cbor_writer_int(writer, CBOR_KEY_GPS_LONGITUDE);
+		cbor_writer_number(writer, data->pvt.longi);
+		cbor_writer_int(writer, CBOR_KEY_GPS_LATITUDE);
+		cbor_writer_number(writer, data->pvt.lat);
+		cbor_writer_int(writer, CBOR_KEY_GPS_ACCURACY);
+		cbor_writer_number(writer, data->pvt.acc);
+		cbor_writer_int(writer, CBOR_KEY_GPS_ALTITUDE);
+		cbor_writer_number(writer, data->pvt.alt);
+		cbor_writer_int(writer, CBOR_KEY_GPS_SPEED);
+		cbor_writer_number(writer, data->pvt.spd);
+		cbor_writer_int(writer, CBOR_KEY_GPS_HEADING);
+		cbor_writer_number(writer, data->pvt.hdg);
+		break;
+	case CLOUD_CODEC_GPS_FORMAT_NMEA:
+		entry_start(writer, array, ts, 1);
+		cbor_writer_int(writer, CBOR_KEY_GPS_NMEA);
+		cbor_writer_str(writer, data->nmea);
+		break;
+	case CLOUD_CODEC_GPS_FORMAT_INVALID:
+		/* Fall through */
+	default:
+		LOG_WRN("GPS data format not set");
+		return -EINVAL;
+	}
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->gps_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int sensor_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_sensors *data = entry;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->env_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array, ts, 2);
+	cbor_writer_int(writer, CBOR_KEY_TEMPERATURE);
+	cbor_writer_number(writer, data->temp);
+	cbor_writer_int(writer, CBOR_KEY_HUMIDITY);
+	cbor_writer_number(writer, data->hum);
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->env_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int ui_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_ui *data = entry;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->btn_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array, ts, 1);
+	cbor_writer_int(writer, CBOR_KEY_VALUE);
+	cbor_writer_int(writer, data->btn);
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->btn_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int battery_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_battery *data = entry;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->bat_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array, ts, 1);
+	cbor_writer_int(writer, CBOR_KEY_VALUE);
+	cbor_writer_int(writer, data->bat);
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->bat_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int accel_entry_write(void *w, void *entry, void *arr)
+{
+	struct cbor_writer *writer = w;
+	struct batch_array *array = arr;
+	struct cloud_data_accelerometer *data = entry;
+	int64_t ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array, ts, 3);
+	cbor_writer_int(writer, CBOR_KEY_MOVEMENT_X);
+	cbor_writer_number(writer, data->values[0]);
+	cbor_writer_int(writer, CBOR_KEY_MOVEMENT_Y);
+	cbor_writer_number(writer, data->values[1]);
+	cbor_writer_int(writer, CBOR_KEY_MOVEMENT_Z);
+	cbor_writer_number(writer, data->values[2]);
+
+	if (!cbor_writer_is_measuring(writer)) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int batch_write(struct cbor_writer *writer, struct batch_section *sections,
+		       size_t section_count)
+{
+	int err;
+	bool object_added = false;
+
+	cbor_writer_map_start_indefinite(writer);
+	cbor_writer_int(writer, CBOR_KEY_VERSION);
+	cbor_writer_int(writer, CBOR_BATCH_FORMAT_VERSION);
+
+	for (size_t i = 0; i < section_count; i++) {
+		struct batch_section *section = &sections[i];
+
+		section->array.open = false;
+
+		err = cloud_codec_batch_entries_write(writer, &section->array, section->buf,
+						      section->buf_count, section->entry_size,
+						      section->entry_write);
+		if (err) {
+			return err;
+		}
+
+		if (section->array.open) {
+			cbor_writer_end(writer);
+			object_added = true;
+		}
+	}
+
+	if (!object_added) {
+		LOG_DBG("No data to encode, CBOR message empty...");
+		return -ENODATA;
+	}
+
+	cbor_writer_end(writer);
+
+	return cbor_writer_finish(writer);
+}
+
+int cbor_codec_encode_batch_data(struct cloud_codec_data *output,
+				 struct cloud_data_gps *gps_buf,
+				 struct cloud_data_sensors *sensor_buf,
+				 struct cloud_data_modem_dynamic *modem_dyn_buf,
+				 struct cloud_data_ui *ui_buf,
+				 struct cloud_data_accelerometer *accel_buf,
+				 struct cloud_data_battery *bat_buf,
+				 size_t gps_buf_count,
+				 size_t sensor_buf_count,
+				 size_t modem_dyn_buf_count,
+				 size_t ui_buf_count,
+				 size_t accel_buf_count,
+				 size_t bat_buf_count)
+{
+	int len;
+	uint8_t *buffer;
+	struct cbor_writer writer;
+	struct batch_section sections[] = {
+		{ { CBOR_KEY_MODEM_DYNAMIC }, modem_dyn_buf, modem_dyn_buf_count,
+		  sizeof(*modem_dyn_buf), modem_dynamic_entry_write },
+		{ { CBOR_KEY_GPS }, gps_buf, gps_buf_count,
+		  sizeof(*gps_buf), gps_entry_write },
+		{ { CBOR_KEY_ENVIRONMENTALS }, sensor_buf, sensor_buf_count,
+		  sizeof(*sensor_buf), sensor_entry_write },
+		{ { CBOR_KEY_BUTTON }, ui_buf, ui_buf_count,
+		  sizeof(*ui_buf), ui_entry_write },
+		{ { CBOR_KEY_BATTERY }, bat_buf, bat_buf_count,
+		  sizeof(*bat_buf), battery_entry_write },
+		{ { CBOR_KEY_MOVEMENT }, accel_buf, accel_buf_count,
+		  sizeof(*accel_buf), accel_entry_write },
+	};
+
+	/* The measuring pass leaves the entries queued, so that the second pass encodes the
+	 * same entries.
+	 */
+	cbor_writer_init(&writer, NULL, 0);
+
+	len = batch_write(&writer, sections, ARRAY_SIZE(sections));
+	if (len < 0) {
+		return len;
+	}
+
+	buffer = k_malloc(len);
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for CBOR message");
+		return -ENOMEM;
+	}
+
+	cbor_writer_init(&writer, buffer, len);
+
+	len = batch_write(&writer, sections, ARRAY_SIZE(sections));
+	if (len < 0) {
+		LOG_ERR("Failed to encode batch message, error: %d", len);
+		k_free(buffer);
+		return len;
+	}
+
+	LOG_HEXDUMP_DBG(buffer, len, "Encoded batch message:");
+
+	output->buf = (char *)buffer;
+	output->len = len;
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief CBOR codec header.
+ */
+
+#ifndef CBOR_CODEC_H__
+#define CBOR_CODEC_H__
+
+/**@file
+ *
+ * @defgroup CBOR codec cbor_codec
+ * @brief    Module encoding batch messages in a compact CBOR format with integer keys and
+ *           delta-encoded timestamps. See cbor_protocol_keys.h for the format.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+#include "cloud_codec.h"
+
+/**
+ * @brief Encode all queued entries of the passed in buffers as a CBOR batch message.
+ *
+ * @details The parameters are the same as for cloud_codec_encode_batch_data(). The encoded
+ *          entries are unqueued. The output is allocated once with the exact size and must be
+ *          released with cloud_codec_release_data().
+ *
+ * @return 0 on success. -ENODATA if none of the buffers has queued entries. Otherwise a
+ *         negative error code is returned.
+ */
+int cbor_codec_encode_batch_data(struct cloud_codec_data *output,
+				 struct cloud_data_gps *gps_buf,
+				 struct cloud_data_sensors *sensor_buf,
+				 struct cloud_data_modem_dynamic *modem_dyn_buf,
+				 struct cloud_data_ui *ui_buf,
+				 struct cloud_data_accelerometer *accel_buf,
+				 struct cloud_data_battery *bat_buf,
+				 size_t gps_buf_count,
+				 size_t sensor_buf_count,
+				 size_t modem_dyn_buf_count,
+				 size_t ui_buf_count,
+				 size_t accel_buf_count,
+				 size_t bat_buf_count);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* CBOR_CODEC_H__ */
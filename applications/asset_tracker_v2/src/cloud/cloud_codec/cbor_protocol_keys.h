@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief Integer keys of the CBOR batch message format.
+ *
+ * The batch message is a map from the keys below to arrays of entries. Each entry is a map
+ * from the entry keys to the values. The timestamp of the first entry of an array is the
+ * UNIX time in milliseconds, the timestamp of each following entry is the difference to
+ * the timestamp of the previous entry of the same array.
+ *
+ * The keys must be kept in sync with scripts/cbor_batch_decode.py.
+ */
+
+#ifndef CBOR_PROTOCOL_KEYS_H__
+#define CBOR_PROTOCOL_KEYS_H__
+
+/** Version of the format, incremented on incompatible changes. */
+#define CBOR_BATCH_FORMAT_VERSION	1
+
+/* Batch message keys */
+#define CBOR_KEY_VERSION		0
+#define CBOR_KEY_MODEM_DYNAMIC		1
+#define CBOR_KEY_GPS			2
+#define CBOR_KEY_ENVIRONMENTALS		3
+#define CBOR_KEY_BUTTON			4
+#define CBOR_KEY_BATTERY		5
+#define CBOR_KEY_MOVEMENT		6
+
+/* Entry keys common to all entries */
+#define CBOR_KEY_TIMESTAMP		0
+
+/* Dynamic modem data entry keys */
+#define CBOR_KEY_MODEM_RSRP		1
+#define CBOR_KEY_MODEM_AREA_CODE	2
+#define CBOR_KEY_MODEM_MCCMNC		3
+#define CBOR_KEY_MODEM_CELL_ID		4
+#define CBOR_KEY_MODEM_IP_ADDRESS	5
+
+/* GPS data entry keys */
+#define CBOR_KEY_GPS_LONGITUDE		1
+#define CBOR_KEY_GPS_LATITUDE		2
+#define CBOR_KEY_GPS_ACCURACY		3
+#define CBOR_KEY_GPS_ALTITUDE		4
+#define CBOR_KEY_GPS_SPEED		5
+#define CBOR_KEY_GPS_HEADING		6
+#define CBOR_KEY_GPS_NMEA		7
+
+/* Environmental sensor data entry keys */
+#define CBOR_KEY_TEMPERATURE		1
+#define CBOR_KEY_HUMIDITY		2
+
+/* Button, battery and accelerometer data entry keys */
+#define CBOR_KEY_VALUE			1
+#define CBOR_KEY_MOVEMENT_X		1
+#define CBOR_KEY_MOVEMENT_Y		2
+#define CBOR_KEY_MOVEMENT_Z		3
+
+#endif /* CBOR_PROTOCOL_KEYS_H__ */
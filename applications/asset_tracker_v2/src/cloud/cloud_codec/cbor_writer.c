@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <sys/byteorder.h>
+
+#include "cbor_writer.h"
+
+/* Major types, in the upper three bits of the initial byte. */
+#define CBOR_MAJOR_UINT		0x00
+#define CBOR_MAJOR_NINT		0x20
+#define CBOR_MAJOR_TEXT		0x60
+#define CBOR_MAJOR_ARRAY	0x80
+#define CBOR_MAJOR_MAP		0xa0
+#define CBOR_MAJOR_SIMPLE	0xe0
+
+/* Additional information, in the lower five bits of the initial byte. */
+#define CBOR_INFO_UINT8		24
+#define CBOR_INFO_UINT16	25
+#define CBOR_INFO_UINT32	26
+#define CBOR_INFO_UINT64	27
+#define CBOR_INFO_INDEFINITE	31
+
+#define CBOR_FLOAT32		(CBOR_MAJOR_SIMPLE | 26)
+#define CBOR_FLOAT64		(CBOR_MAJOR_SIMPLE | 27)
+#define CBOR_BREAK		(CBOR_MAJOR_SIMPLE | 31)
+
+static void write_raw(struct cbor_writer *writer, const void *data, size_t len)
+{
+	if (writer->err) {
+		return;
+	}
+
+	if (!cbor_writer_is_measuring(writer)) {
+		if (len > writer->size - writer->len) {
+			writer->err = -ENOMEM;
+			return;
+		}
+
+		memcpy(&writer->buf[writer->len], data, len);
+	}
+
+	writer->len += len;
+}
+
+/* Write the initial byte of a data item and its argument in the shortest form. */
+static void write_head(struct cbor_writer *writer, uint8_t major, uint64_t arg)
+{
+	uint8_t head[9];
+	size_t len;
+
+	if (arg < CBOR_INFO_UINT8) {
+		head[0] = major | arg;
+		len = 1;
+	} else if (arg <= UINT8_MAX) {
+		head[0] = major | CBOR_INFO_UINT8;
+		head[1] = arg;
+		len = 2;
+	} else if (arg <= UINT16_MAX) {
+		head[0] = major | CBOR_INFO_UINT16;
+		sys_put_be16(arg, &head[1]);
+		len = 3;
+	} else if (arg <= UINT32_MAX) {
+		head[0] = major | CBOR_INFO_UINT32;
+		sys_put_be32(arg, &head[1]);
+		len = 5;
+	} else {
+		head[0] = major | CBOR_INFO_UINT64;
+		sys_put_be64(arg, &head[1]);
+		len = 9;
+	}
+
+	write_raw(writer, head, len);
+}
+
+void cbor_writer_init(struct cbor_writer *writer, uint8_t *buf, size_t size)
+{
+	memset(writer, 0, sizeof(*writer));
+
+	writer->buf = buf;
+	writer->size = size;
+}
+
+void cbor_writer_map_start(struct cbor_writer *writer, size_t pairs)
+{
+	write_head(writer, CBOR_MAJOR_MAP, pairs);
+}
+
+void cbor_writer_map_start_indefinite(struct cbor_writer *writer)
+{
+	uint8_t head = CBOR_MAJOR_MAP | CBOR_INFO_INDEFINITE;
+
+	write_raw(writer, &head, 1);
+}
+
+void cbor_writer_array_start_indefinite(struct cbor_writer *writer)
+{
+	uint8_t head = CBOR_MAJOR_ARRAY | CBOR_INFO_INDEFINITE;
+
+	write_raw(writer, &head, 1);
+}
+
+void cbor_writer_end(struct cbor_writer *writer)
+{
+	uint8_t head = CBOR_BREAK;
+
+	write_raw(writer, &head, 1);
+}
+
+void cbor_writer_int(struct cbor_writer *writer, int64_t value)
+{
+	if (value < 0) {
+		/* Negative integers are encoded as -1 - n. */
+		write_head(writer, CBOR_MAJOR_NINT, -(value + 1));
+	} else {
+		write_head(writer, CBOR_MAJOR_UINT, value);
+	}
+}
+
+void cbor_writer_number(struct cbor_writer *writer, double value)
+{
+	uint8_t item[9];
+	uint32_t single_bits;
+	uint64_t double_bits;
+	float single;
+
+	if (fabs(value) < 9.2e18 && value == (double)(int64_t)value &&
+	    !(value == 0 && signbit(value))) {
+		cbor_writer_int(writer, (int64_t)value);
+		return;
+	}
+
+	/* Infinities, NaN and values exactly representable in single precision. */
+	if (isinf(value) || isnan(value) ||
+	    (fabs(value) <= FLT_MAX && (double)(float)value == value)) {
+		single = (float)value;
+		memcpy(&single_bits, &single, sizeof(single_bits));
+		item[0] = CBOR_FLOAT32;
+		sys_put_be32(single_bits, &item[1]);
+		write_raw(writer, item, 5);
+		return;
+	}
+
+	memcpy(&double_bits, &value, sizeof(double_bits));
+	item[0] = CBOR_FLOAT64;
+	sys_put_be64(double_bits, &item[1]);
+	write_raw(writer, item, 9);
+}
+
+void cbor_writer_str(struct cbor_writer *writer, const char *value)
+{
+	size_t len = strlen(value);
+
+	write_head(writer, CBOR_MAJOR_TEXT, len);
+	write_raw(writer, value, len);
+}
+
+int cbor_writer_finish(struct cbor_writer *writer)
+{
+	return writer->err ? writer->err : writer->len;
+}
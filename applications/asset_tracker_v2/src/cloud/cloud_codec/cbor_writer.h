@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief CBOR writer header.
+ */
+
+#ifndef CBOR_WRITER_H__
+#define CBOR_WRITER_H__
+
+/**@file
+ *
+ * @defgroup CBOR writer cbor_writer
+ * @brief    Module writing CBOR (RFC 8949) data items directly to a buffer.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <stdbool.h>
+
+/** @brief CBOR writer. */
+struct cbor_writer {
+	/** Output buffer. NULL if the writer only measures the output length. */
+	uint8_t *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Number of bytes written. */
+	size_t len;
+	/** First error encountered, 0 if none. */
+	int err;
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param[out] writer Pointer to the writer.
+ * @param[in] buf Output buffer. If NULL, nothing is written and only the output length
+ *		  is counted.
+ * @param[in] size Size of the output buffer.
+ */
+void cbor_writer_init(struct cbor_writer *writer, uint8_t *buf, size_t size);
+
+/**
+ * @brief Check whether the writer only counts the output length.
+ *
+ * @param[in] writer Pointer to the writer.
+ *
+ * @return true if nothing is written, false otherwise.
+ */
+static inline bool cbor_writer_is_measuring(const struct cbor_writer *writer)
+{
+	return writer->buf == NULL;
+}
+
+/**
+ * @brief Open a map with a known number of key-value pairs.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] pairs Number of key-value pairs that follow.
+ */
+void cbor_writer_map_start(struct cbor_writer *writer, size_t pairs);
+
+/**
+ * @brief Open a map whose end is marked by cbor_writer_end().
+ *
+ * @param[in] writer Pointer to the writer.
+ */
+void cbor_writer_map_start_indefinite(struct cbor_writer *writer);
+
+/**
+ * @brief Open an array whose end is marked by cbor_writer_end().
+ *
+ * @param[in] writer Pointer to the writer.
+ */
+void cbor_writer_array_start_indefinite(struct cbor_writer *writer);
+
+/**
+ * @brief Close the innermost map or array of indefinite length.
+ *
+ * @param[in] writer Pointer to the writer.
+ */
+void cbor_writer_end(struct cbor_writer *writer);
+
+/**
+ * @brief Write an integer.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] value Value to be written.
+ */
+void cbor_writer_int(struct cbor_writer *writer, int64_t value);
+
+/**
+ * @brief Write a number in the shortest form that represents it exactly.
+ *
+ * @details Integral values are written as integers, values that are exactly representable
+ *          in single precision as single precision floats, and other values as double
+ *          precision floats.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] value Value to be written.
+ */
+void cbor_writer_number(struct cbor_writer *writer, double value);
+
+/**
+ * @brief Write a text string.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] value Null-terminated UTF-8 string to be written.
+ */
+void cbor_writer_str(struct cbor_writer *writer, const char *value);
+
+/**
+ * @brief Finish writing.
+ *
+ * @param[in] writer Pointer to the writer.
+ *
+ * @return Length of the output on success. -ENOMEM if the output did not fit the buffer.
+ */
+int cbor_writer_finish(struct cbor_writer *writer);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* CBOR_WRITER_H__ */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <date_time.h>
+
+#include "cloud_codec_batch.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(cloud_codec_batch, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+int cloud_codec_batch_entries_write(void *writer, void *array, void *buf, size_t buf_count,
+				    size_t entry_size, cloud_codec_batch_entry_write_t entry_write)
+{
+	int err;
+
+	for (size_t i = 0; i < buf_count; i++) {
+		err = entry_write(writer, (uint8_t *)buf + i * entry_size, array);
+		if ((err != 0) && (err != -ENODATA)) {
+			LOG_ERR("Failed writing data to array");
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+int cloud_codec_batch_entry_ts_get(int64_t uptime, int64_t *ts)
+{
+	int err;
+
+	*ts = uptime;
+
+	err = date_time_uptime_to_unix_time_ms(ts);
+	if (err) {
+		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+	}
+
+	return err;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief Batch encoding helpers shared by the streaming codecs.
+ */
+
+#ifndef CLOUD_CODEC_BATCH_H__
+#define CLOUD_CODEC_BATCH_H__
+
+/**@file
+ *
+ * @defgroup Cloud codec batch cloud_codec_batch
+ * @brief    Helpers iterating over the entries of a data buffer encoded as an array in a batch
+ *           message. The writer and the array state are specific to the codec.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+/**
+ * @brief Write a single buffer entry.
+ *
+ * @param[in] writer Pointer to the writer of the codec.
+ * @param[in] entry Pointer to the entry.
+ * @param[in] array Pointer to the state of the array the entry is written to.
+ *
+ * @return 0 if the entry was written. -ENODATA if the entry is not queued or has no data to
+ *         encode. Otherwise a negative error code is returned.
+ */
+typedef int (*cloud_codec_batch_entry_write_t)(void *writer, void *entry, void *array);
+
+/**
+ * @brief Write all entries of a data buffer.
+ *
+ * @details Entries that are skipped by the write function with -ENODATA are ignored.
+ *
+ * @param[in] writer Pointer to the writer of the codec.
+ * @param[in] array Pointer to the state of the array the entries are written to.
+ * @param[in] buf Pointer to the data buffer.
+ * @param[in] buf_count Number of entries in the data buffer.
+ * @param[in] entry_size Size of a single entry.
+ * @param[in] entry_write Function writing a single entry.
+ *
+ * @return 0 on success. Otherwise the negative error code of the failed entry is returned.
+ */
+int cloud_codec_batch_entries_write(void *writer, void *array, void *buf, size_t buf_count,
+				    size_t entry_size, cloud_codec_batch_entry_write_t entry_write);
+
+/**
+ * @brief Convert the uptime of an entry to UNIX time.
+ *
+ * @param[in] uptime Uptime of the entry, in milliseconds.
+ * @param[out] ts Pointer to the UNIX time, in milliseconds.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int cloud_codec_batch_entry_ts_get(int64_t uptime, int64_t *ts);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* CLOUD_CODEC_BATCH_H__ */
@@ -9,6 +9,7 @@
 #include <date_time.h>
 
 #include "cloud_codec.h"
+#include "cloud_codec_batch.h"
 #include "json_common.h"
 #include "json_helpers.h"
 #include "json_protocol_names.h"
@@ -850,3 +851,447 @@ int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type,
 	json_add_obj(parent, object_label, array_obj);
 	return 0;
 }
+
+/* Streaming encoding. The entries are validated before anything is written, so that an entry
+ * that is skipped leaves no partial output behind.
+ */
+
+/* Open the array of the batch before its first entry, and the object of the entry. */
+static void entry_start(struct json_writer *writer, const char **array_label)
+{
+	if (*array_label != NULL) {
+		json_writer_array_start(writer, *array_label);
+		*array_label = NULL;
+	}
+
+	json_writer_object_start(writer, NULL);
+}
+
+static int modem_static_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_modem_static *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+	char nw_mode[50] = {0};
+
+	static const char lte_string[] = "LTE-M";
+	static const char nbiot_string[] = "NB-IoT";
+	static const char gps_string[] = " GPS";
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	if (data->nw_lte_m) {
+		strcpy(nw_mode, lte_string);
+	} else if (data->nw_nb_iot) {
+		strcpy(nw_mode, nbiot_string);
+	}
+
+	if (data->nw_gps) {
+		strcat(nw_mode, gps_string);
+	}
+
+	entry_start(writer, array_label);
+	json_writer_object_start(writer, DATA_VALUE);
+	json_writer_number(writer, MODEM_CURRENT_BAND, data->bnd);
+	json_writer_str(writer, MODEM_NETWORK_MODE, nw_mode);
+	json_writer_str(writer, MODEM_ICCID, data->iccid);
+	json_writer_str(writer, MODEM_FIRMWARE_VERSION, data->fw);
+	json_writer_str(writer, MODEM_BOARD, data->brdv);
+	json_writer_str(writer, MODEM_APP_VERSION, data->appv);
+	json_writer_object_end(writer);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int modem_dynamic_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_modem_dynamic *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+	uint32_t mccmnc = 0;
+	char *end_ptr;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	if (!data->rsrp_fresh && !data->area_code_fresh && !data->mccmnc_fresh &&
+	    !data->cell_id_fresh && !data->ip_address_fresh) {
+		data->queued = false;
+		LOG_WRN("No valid dynamic modem data values present, entry unqueued");
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	if (data->mccmnc_fresh) {
+		/* Convert mccmnc to unsigned long integer. */
+		errno = 0;
+		mccmnc = strtoul(data->mccmnc, &end_ptr, 10);
+
+		if ((errno == ERANGE) || (*end_ptr != '\0')) {
+			LOG_ERR("MCCMNC string could not be converted.");
+			return -ENOTEMPTY;
+		}
+	}
+
+	entry_start(writer, array_label);
+	json_writer_object_start(writer, DATA_VALUE);
+
+	if (data->rsrp_fresh) {
+		json_writer_number(writer, MODEM_RSRP, data->rsrp);
+	}
+
+	if (data->area_code_fresh) {
+		json_writer_number(writer, MODEM_AREA_CODE, data->area);
+	}
+
+	if (data->mccmnc_fresh) {
+		json_writer_number(writer, MODEM_MCCMNC, mccmnc);
+	}
+
+	if (data->cell_id_fresh) {
+		json_writer_number(writer, MODEM_CELL_ID, data->cell);
+	}
+
+	if (data->ip_address_fresh) {
+		json_writer_str(writer, MODEM_IP_ADDRESS, data->ip);
+	}
+
+	json_writer_object_end(writer);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int sensor_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_sensors *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->env_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array_label);
+	json_writer_object_start(writer, DATA_VALUE);
+	json_writer_number(writer, DATA_TEMPERATURE, data->temp);
+	json_writer_number(writer, DATA_HUMID, data->hum);
+	json_writer_object_end(writer);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->env_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int gps_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_gps *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	if (data->format != CLOUD_CODEC_GPS_FORMAT_PVT &&
+	    data->format != CLOUD_CODEC_GPS_FORMAT_NMEA) {
+		LOG_WRN("GPS data format not set");
+		return -EINVAL;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->gps_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array_label);
+
+	if (data->format == CLOUD_CODEC_GPS_FORMAT_PVT) {
+		json_writer_object_start(writer, DATA_VALUE);
+		json_writer_number(writer, DATA_GPS_LONGITUDE, data->pvt.longi);
+		json_writer_number(writer, DATA_GPS_LATITUDE, data->pvt.lat);
+		json_writer_number(writer, DATA_MOVEMENT, data->pvt.acc);
+		json_writer_number(writer, DATA_GPS_ALTITUDE, data->pvt.alt);
+		json_writer_number(writer, DATA_GPS_SPEED, data->pvt.spd);
+		json_writer_number(writer, DATA_GPS_HEADING, data->pvt.hdg);
+		json_writer_object_end(writer);
+	} else {
+		json_writer_str(writer, DATA_VALUE, data->nmea);
+	}
+
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->gps_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int accel_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_accelerometer *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array_label);
+	json_writer_object_start(writer, DATA_VALUE);
+	json_writer_number(writer, DATA_MOVEMENT_X, data->values[0]);
+	json_writer_number(writer, DATA_MOVEMENT_Y, data->values[1]);
+	json_writer_number(writer, DATA_MOVEMENT_Z, data->values[2]);
+	json_writer_object_end(writer);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int ui_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_ui *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->btn_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array_label);
+	json_writer_number(writer, DATA_VALUE, data->btn);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->btn_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+static int battery_data_write(void *w, void *entry, void *array)
+{
+	struct json_writer *writer = w;
+	struct cloud_data_battery *data = entry;
+	const char **array_label = array;
+	int err;
+	int64_t ts;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = cloud_codec_batch_entry_ts_get(data->bat_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(writer, array_label);
+	json_writer_number(writer, DATA_VALUE, data->bat);
+	json_writer_number(writer, DATA_TIMESTAMP, ts);
+	json_writer_object_end(writer);
+
+	if (!json_writer_is_measuring(writer)) {
+		data->bat_ts = ts;
+		data->queued = false;
+	}
+
+	return 0;
+}
+
+/* Size and write function of the entries of every buffer type. */
+static const struct {
+	size_t entry_size;
+	cloud_codec_batch_entry_write_t entry_write;
+} batch_entry_types[] = {
+	[JSON_COMMON_UI] = { sizeof(struct cloud_data_ui), ui_data_write },
+	[JSON_COMMON_MODEM_STATIC] = { sizeof(struct cloud_data_modem_static),
+				       modem_static_data_write },
+	[JSON_COMMON_MODEM_DYNAMIC] = { sizeof(struct cloud_data_modem_dynamic),
+					modem_dynamic_data_write },
+	[JSON_COMMON_GPS] = { sizeof(struct cloud_data_gps), gps_data_write },
+	[JSON_COMMON_SENSOR] = { sizeof(struct cloud_data_sensors), sensor_data_write },
+	[JSON_COMMON_ACCELEROMETER] = { sizeof(struct cloud_data_accelerometer),
+					accel_data_write },
+	[JSON_COMMON_BATTERY] = { sizeof(struct cloud_data_battery), battery_data_write },
+};
+
+BUILD_ASSERT(ARRAY_SIZE(batch_entry_types) == JSON_COMMON_COUNT);
+
+int json_common_batch_data_write(struct json_writer *writer, enum json_common_buffer_type type,
+				 void *buf, size_t buf_count, const char *object_label)
+{
+	int err;
+	/* Set to NULL once the array has been opened. */
+	const char *array_label = object_label;
+
+	if (writer == NULL) {
+		return -ENOMEM;
+	}
+
+	if (object_label == NULL) {
+		LOG_WRN("Missing object label");
+		return -EINVAL;
+	}
+
+	if ((unsigned int)type >= ARRAY_SIZE(batch_entry_types)) {
+		LOG_WRN("Unknown buffer type: %d", type);
+		return -EINVAL;
+	}
+
+	err = cloud_codec_batch_entries_write(writer, &array_label, buf, buf_count,
+					      batch_entry_types[type].entry_size,
+					      batch_entry_types[type].entry_write);
+	if (err) {
+		return err;
+	}
+
+	if (array_label != NULL) {
+		return -ENODATA;
+	}
+
+	json_writer_array_end(writer);
+
+	return writer->err;
+}
+
+static int batch_data_write(struct json_writer *writer,
+			    const struct json_common_batch_section *sections,
+			    size_t section_count)
+{
+	int err;
+	bool object_added = false;
+
+	json_writer_object_start(writer, NULL);
+
+	for (size_t i = 0; i < section_count; i++) {
+		err = json_common_batch_data_write(writer, sections[i].type, sections[i].buf,
+						   sections[i].buf_count,
+						   sections[i].object_label);
+		if (err == 0) {
+			object_added = true;
+		} else if (err != -ENODATA) {
+			return err;
+		}
+	}
+
+	if (!object_added) {
+		LOG_DBG("No data to encode, JSON string empty...");
+		return -ENODATA;
+	}
+
+	json_writer_object_end(writer);
+
+	return json_writer_finish(writer);
+}
+
+int json_common_batch_data_encode(struct cloud_codec_data *output,
+				  const struct json_common_batch_section *sections,
+				  size_t section_count)
+{
+	int len;
+	char *buffer;
+	struct json_writer writer;
+
+	/* The measuring pass leaves the entries queued, so that the second pass encodes the
+	 * same entries.
+	 */
+	json_writer_init(&writer, NULL, 0, NULL, NULL);
+
+	len = batch_data_write(&writer, sections, section_count);
+	if (len < 0) {
+		return len;
+	}
+
+	buffer = cJSON_malloc(len + 1);
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for JSON string");
+		return -ENOMEM;
+	}
+
+	json_writer_init(&writer, buffer, len + 1, NULL, NULL);
+
+	len = batch_data_write(&writer, sections, section_count);
+	if (len < 0) {
+		LOG_ERR("Failed to encode batch message, error: %d", len);
+		cJSON_free(buffer);
+		return len;
+	}
+
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_LOG_LEVEL_DBG)) {
+		printk("Encoded batch message:\n%s\n", buffer);
+	}
+
+	output->buf = buffer;
+	output->len = len;
+
+	return 0;
+}
@@ -27,6 +27,7 @@ extern "C" {
 
 #include "cloud_codec.h"
 #include "json_protocol_names.h"
+#include "json_writer.h"
 
 /** @brief Type of data to be handled by the respective API. Used to signify what data structure
  *         that is passed in to the function.
@@ -56,6 +57,18 @@ enum json_common_op_code {
 	JSON_COMMON_GET_POINTER_TO_OBJECT
 };
 
+/** @brief Buffer encoded as a labeled array in a batch message. */
+struct json_common_batch_section {
+	/** Type of data in the buffer. */
+	enum json_common_buffer_type type;
+	/** Pointer to the data buffer. */
+	void *buf;
+	/** Number of entries in the data buffer. */
+	size_t buf_count;
+	/** Name of the array holding the encoded entries. */
+	const char *object_label;
+};
+
 /**
  * @brief Encode and add static modem data to the parent object.
  *
@@ -239,6 +252,45 @@ void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data);
 int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
 			       size_t buf_count, const char *object_label);
 
+/**
+ * @brief Write all queued entries in the passed in buffer to a streaming JSON writer as an
+ *        array, without building cJSON objects.
+ *
+ * @details The output is identical to the output of json_common_batch_data_add(). The array
+ *          is only written if the buffer has queued entries. If the writer only measures the
+ *          output length, the encoded entries are left queued. Otherwise, their timestamps are
+ *          converted to UNIX time and they are unqueued, as by json_common_batch_data_add().
+ *
+ * @param[in] writer Pointer to the writer, positioned inside an object.
+ * @param[in] type Type of data passed in to the function.
+ * @param[in] buf Pointer to data buffer that is to be encoded.
+ * @param[in] buf_count Number of entries in passed in data buffer.
+ * @param[in] object_label Name of the array.
+ *
+ * @return 0 on success. -ENODATA if the passed in buffer has no queued entries. Otherwise a
+ *         negative error code is returned.
+ */
+int json_common_batch_data_write(struct json_writer *writer, enum json_common_buffer_type type,
+				 void *buf, size_t buf_count, const char *object_label);
+
+/**
+ * @brief Encode a batch message with one array per buffer, without building cJSON objects.
+ *
+ * @details The message length is measured first, so that the output is allocated once with
+ *          the exact size, using the cJSON allocator. The output must be released with
+ *          cloud_codec_release_data().
+ *
+ * @param[out] output Pointer to the encoded message.
+ * @param[in] sections Buffers to be encoded, in the order of the arrays in the message.
+ * @param[in] section_count Number of buffers.
+ *
+ * @return 0 on success. -ENODATA if none of the buffers has queued entries. Otherwise a
+ *         negative error code is returned.
+ */
+int json_common_batch_data_encode(struct cloud_codec_data *output,
+				  const struct json_common_batch_section *sections,
+				  size_t section_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "json_writer.h"
+
+BUILD_ASSERT(JSON_WRITER_MAX_DEPTH <= 32, "Nesting depth does not fit the member bitmask");
+
+static void write_flush(struct json_writer *writer)
+{
+	int err;
+
+	if (writer->len == 0) {
+		return;
+	}
+
+	err = writer->flush(writer->buf, writer->len, writer->user_data);
+	if (err) {
+		writer->err = err;
+	}
+
+	writer->len = 0;
+}
+
+static void write_raw(struct json_writer *writer, const char *data, size_t len)
+{
+	size_t chunk;
+
+	if (writer->err) {
+		return;
+	}
+
+	writer->total += len;
+
+	if (json_writer_is_measuring(writer)) {
+		return;
+	}
+
+	if (writer->flush == NULL) {
+		/* Keep room for the null terminator. */
+		if (len >= writer->size - writer->len) {
+			writer->err = -ENOMEM;
+			return;
+		}
+
+		memcpy(&writer->buf[writer->len], data, len);
+		writer->len += len;
+		return;
+	}
+
+	while (len > 0 && !writer->err) {
+		chunk = MIN(len, writer->size - writer->len);
+
+		memcpy(&writer->buf[writer->len], data, chunk);
+		writer->len += chunk;
+		data += chunk;
+		len -= chunk;
+
+		if (writer->len == writer->size) {
+			write_flush(writer);
+		}
+	}
+}
+
+static void write_char(struct json_writer *writer, char c)
+{
+	write_raw(writer, &c, 1);
+}
+
+static void write_escaped(struct json_writer *writer, const char *str)
+{
+	const char *start = str;
+	char escape[7];
+
+	write_char(writer, '"');
+
+	for (; *str != '\0'; str++) {
+		unsigned char c = *str;
+
+		if (c >= ' ' && c != '"' && c != '\\') {
+			continue;
+		}
+
+		/* Write the run of characters that need no escaping. */
+		write_raw(writer, start, str - start);
+		start = str + 1;
+
+		switch (c) {
+		case '"':
+			write_raw(writer, "\\\"", 2);
+			break;
+		case '\\':
+			write_raw(writer, "\\\\", 2);
+			break;
+		case '\b':
+			write_raw(writer, "\\b", 2);
+			break;
+		case '\f':
+			write_raw(writer, "\\f", 2);
+			break;
+		case '\n':
+			write_raw(writer, "\\n", 2);
+			break;
+		case '\r':
+			write_raw(writer, "\\r", 2);
+			break;
+		case '\t':
+			write_raw(writer, "\\t", 2);
+			break;
+		default:
+			snprintf(escape, sizeof(escape), "\\u%04x", c);
+			write_raw(writer, escape, 6);
+			break;
+		}
+	}
+
+	write_raw(writer, start, str - start);
+	write_char(writer, '"');
+}
+
+static void write_integer(struct json_writer *writer, int64_t value)
+{
+	char digits[20];
+	size_t pos = sizeof(digits);
+	uint64_t magnitude = value < 0 ? -(uint64_t)value : value;
+
+	do {
+		digits[--pos] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude > 0);
+
+	if (value < 0) {
+		digits[--pos] = '-';
+	}
+
+	write_raw(writer, &digits[pos], sizeof(digits) - pos);
+}
+
+/* Write the separator and the key preceding a value. */
+static void write_key(struct json_writer *writer, const char *key)
+{
+	uint32_t level = BIT(writer->depth);
+
+	if (writer->members & level) {
+		write_char(writer, ',');
+	}
+
+	writer->members |= level;
+
+	if (key != NULL) {
+		write_escaped(writer, key);
+		write_char(writer, ':');
+	}
+}
+
+static void container_start(struct json_writer *writer, const char *key, char c)
+{
+	write_key(writer, key);
+	write_char(writer, c);
+
+	if (writer->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+		writer->err = -EINVAL;
+		return;
+	}
+
+	writer->depth++;
+	writer->members &= ~BIT(writer->depth);
+}
+
+static void container_end(struct json_writer *writer, char c)
+{
+	if (writer->depth == 0) {
+		writer->err = -EINVAL;
+		return;
+	}
+
+	writer->depth--;
+	write_char(writer, c);
+}
+
+void json_writer_init(struct json_writer *writer, char *buf, size_t size,
+		      json_writer_flush_t flush, void *user_data)
+{
+	memset(writer, 0, sizeof(*writer));
+
+	writer->buf = buf;
+	writer->size = size;
+	writer->flush = flush;
+	writer->user_data = user_data;
+
+	if (buf != NULL && size == 0) {
+		writer->err = -ENOMEM;
+	}
+}
+
+void json_writer_object_start(struct json_writer *writer, const char *key)
+{
+	container_start(writer, key, '{');
+}
+
+void json_writer_object_end(struct json_writer *writer)
+{
+	container_end(writer, '}');
+}
+
+void json_writer_array_start(struct json_writer *writer, const char *key)
+{
+	container_start(writer, key, '[');
+}
+
+void json_writer_array_end(struct json_writer *writer)
+{
+	container_end(writer, ']');
+}
+
+void json_writer_number(struct json_writer *writer, const char *key, double value)
+{
+	char number[26];
+	double test;
+	int len;
+
+	write_key(writer, key);
+
+	if (isnan(value) || isinf(value)) {
+		write_raw(writer, "null", 4);
+		return;
+	}
+
+	/* Integers with up to 15 digits, like timestamps, are printed as such by cJSON. Format
+	 * them without the floating point conversion and the round trip check. Negative zero
+	 * compares equal to zero and is printed as "0", like cJSON does.
+	 */
+	if (fabs(value) < 1e15 && value == (double)(int64_t)value) {
+		write_integer(writer, (int64_t)value);
+		return;
+	}
+
+	/* Same formatting as cJSON: 15 significant digits, unless the value cannot be
+	 * recovered from them.
+	 */
+	len = snprintf(number, sizeof(number), "%1.15g", value);
+	test = strtod(number, NULL);
+
+	if (fabs(test - value) > MAX(fabs(test), fabs(value)) * DBL_EPSILON) {
+		len = snprintf(number, sizeof(number), "%1.17g", value);
+	}
+
+	if (len < 0 || len >= sizeof(number)) {
+		writer->err = -EINVAL;
+		return;
+	}
+
+	write_raw(writer, number, len);
+}
+
+void json_writer_str(struct json_writer *writer, const char *key, const char *value)
+{
+	write_key(writer, key);
+	write_escaped(writer, value);
+}
+
+void json_writer_bool(struct json_writer *writer, const char *key, bool value)
+{
+	write_key(writer, key);
+
+	if (value) {
+		write_raw(writer, "true", 4);
+	} else {
+		write_raw(writer, "false", 5);
+	}
+}
+
+int json_writer_finish(struct json_writer *writer)
+{
+	if (!writer->err && writer->depth != 0) {
+		writer->err = -EINVAL;
+	}
+
+	if (!writer->err && !json_writer_is_measuring(writer)) {
+		if (writer->flush != NULL) {
+			write_flush(writer);
+		} else {
+			writer->buf[writer->len] = '\0';
+		}
+	}
+
+	return writer->err ? writer->err : writer->total;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief Streaming JSON writer header.
+ */
+
+#ifndef JSON_WRITER_H__
+#define JSON_WRITER_H__
+
+/**@file
+ *
+ * @defgroup JSON writer json_writer
+ * @brief    Module writing unformatted JSON directly to a buffer, without building cJSON
+ *           objects. The output is identical to the output of cJSON_PrintUnformatted() for
+ *           the same sequence of values.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <stdbool.h>
+
+/** @brief Maximum nesting depth of objects and arrays. */
+#define JSON_WRITER_MAX_DEPTH 8
+
+/**
+ * @brief Function called when the writer buffer is full and when the writer is finished.
+ *
+ * @param[in] buf Pointer to the written data.
+ * @param[in] len Length of the written data.
+ * @param[in] user_data User data passed to json_writer_init().
+ *
+ * @return 0 on success. Otherwise a negative error code, which aborts the writer.
+ */
+typedef int (*json_writer_flush_t)(const char *buf, size_t len, void *user_data);
+
+/** @brief Streaming JSON writer. */
+struct json_writer {
+	/** Output buffer. NULL if the writer only measures the output length. */
+	char *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Number of bytes in the output buffer. */
+	size_t len;
+	/** Total number of bytes written, including flushed bytes. */
+	size_t total;
+	/** Function flushing the output buffer, NULL if the output is not flushed. */
+	json_writer_flush_t flush;
+	/** User data passed to the flush function. */
+	void *user_data;
+	/** Bitmask of the open objects and arrays that have members, one bit per level. */
+	uint32_t members;
+	/** Current nesting depth. */
+	uint8_t depth;
+	/** First error encountered, 0 if none. */
+	int err;
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @details The writer operates in one of three modes:
+ *          - If @p flush is NULL, the output is written to @p buf and null-terminated.
+ *            Writing fails with -ENOMEM if the output does not fit.
+ *          - If @p flush is set, @p flush is called each time @p buf is full, and with the
+ *            remaining data when the writer is finished. The output is not null-terminated.
+ *          - If @p buf is NULL, nothing is written and only the output length is counted.
+ *
+ * @param[out] writer Pointer to the writer.
+ * @param[in] buf Output buffer, or NULL.
+ * @param[in] size Size of the output buffer.
+ * @param[in] flush Function flushing the output buffer, or NULL.
+ * @param[in] user_data User data passed to @p flush.
+ */
+void json_writer_init(struct json_writer *writer, char *buf, size_t size,
+		      json_writer_flush_t flush, void *user_data);
+
+/**
+ * @brief Check whether the writer only counts the output length.
+ *
+ * @param[in] writer Pointer to the writer.
+ *
+ * @return true if nothing is written, false otherwise.
+ */
+static inline bool json_writer_is_measuring(const struct json_writer *writer)
+{
+	return writer->buf == NULL;
+}
+
+/**
+ * @brief Open an object.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] key Name of the object in the enclosing object. NULL at the top level and
+ *		  inside arrays.
+ */
+void json_writer_object_start(struct json_writer *writer, const char *key);
+
+/** @brief Close the innermost object. */
+void json_writer_object_end(struct json_writer *writer);
+
+/**
+ * @brief Open an array.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] key Name of the array in the enclosing object. NULL at the top level and
+ *		  inside arrays.
+ */
+void json_writer_array_start(struct json_writer *writer, const char *key);
+
+/** @brief Close the innermost array. */
+void json_writer_array_end(struct json_writer *writer);
+
+/**
+ * @brief Write a number, formatted in the same way as by cJSON.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] key Name of the value, or NULL inside arrays.
+ * @param[in] value Value to be written.
+ */
+void json_writer_number(struct json_writer *writer, const char *key, double value);
+
+/**
+ * @brief Write a string, escaped in the same way as by cJSON.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] key Name of the value, or NULL inside arrays.
+ * @param[in] value Null-terminated string to be written.
+ */
+void json_writer_str(struct json_writer *writer, const char *key, const char *value);
+
+/**
+ * @brief Write a boolean.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] key Name of the value, or NULL inside arrays.
+ * @param[in] value Value to be written.
+ */
+void json_writer_bool(struct json_writer *writer, const char *key, bool value);
+
+/**
+ * @brief Finish writing and flush the remaining output.
+ *
+ * @param[in] writer Pointer to the writer.
+ *
+ * @return Total length of the output on success. -ENOMEM if the output did not fit the
+ *	   buffer, -EINVAL if objects or arrays were not closed or nested too deep. Otherwise
+ *	   the error returned by the flush function.
+ */
+int json_writer_finish(struct json_writer *writer);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* JSON_WRITER_H__ */
@@ -514,6 +514,20 @@ int cloud_codec_encode_batch_data(
 	char *buffer;
 	bool object_added = false;
 
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_JSON_STREAMING)) {
+		const struct json_common_batch_section sections[] = {
+			{ JSON_COMMON_MODEM_DYNAMIC, modem_dyn_buf, modem_dyn_buf_count,
+			  DATA_MODEM_DYNAMIC },
+			{ JSON_COMMON_GPS, gps_buf, gps_buf_count, DATA_GPS },
+			{ JSON_COMMON_SENSOR, sensor_buf, sensor_buf_count, DATA_ENVIRONMENTALS },
+			{ JSON_COMMON_UI, ui_buf, ui_buf_count, DATA_BUTTON },
+			{ JSON_COMMON_BATTERY, bat_buf, bat_buf_count, DATA_BATTERY },
+			{ JSON_COMMON_ACCELEROMETER, accel_buf, accel_buf_count, DATA_MOVEMENT },
+		};
+
+		return json_common_batch_data_encode(output, sections, ARRAY_SIZE(sections));
+	}
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
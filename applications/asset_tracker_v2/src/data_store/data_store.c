@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <fs/fcb.h>
+#include <storage/flash_map.h>
+#include <date_time.h>
+
+#include "data_store.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(data_store, CONFIG_DATA_MODULE_LOG_LEVEL);
+
+#define DATA_STORE_FLASH_AREA_ID	FLASH_AREA_ID(data_storage)
+#define DATA_STORE_MAGIC		0x44415441
+/* Incremented when the layout of the stored structures changes. */
+#define DATA_STORE_VERSION		1
+#define DATA_STORE_SECTORS_MAX		32
+
+/* Type of the records holding the position of the last sent entry. */
+#define RECORD_TAIL			0x80
+
+struct record_tail {
+	/* Offset of the sector holding the last sent entry. */
+	uint32_t sector_off;
+	/* Offset of the last sent entry in the sector, 0 if no entry has been sent. */
+	uint32_t elem_off;
+};
+
+struct record {
+	uint8_t type;
+	union {
+		struct cloud_data_gps gps;
+		struct cloud_data_sensors sensors;
+		struct cloud_data_modem_dynamic modem_dynamic;
+		struct cloud_data_ui ui;
+		struct cloud_data_accelerometer accelerometer;
+		struct cloud_data_battery battery;
+		struct record_tail tail;
+	} data;
+};
+
+static struct flash_sector sectors[DATA_STORE_SECTORS_MAX];
+static struct fcb fcb;
+static bool initialized;
+
+/* Last sent entry. The sector is NULL if the oldest entry has not been sent. */
+static struct fcb_entry tail;
+
+/* Last entry returned by data_store_read(), and whether it is still stored. */
+static struct fcb_entry read_end;
+static bool read_end_valid;
+
+/* Record being written or read. Padded to the write block size of the flash. */
+static union {
+	struct record record;
+	uint8_t bytes[ROUND_UP(sizeof(struct record), 8)];
+} record_buf;
+
+static size_t record_len(uint8_t type)
+{
+	size_t len;
+
+	switch (type) {
+	case DATA_STORE_GPS:
+		len = sizeof(record_buf.record.data.gps);
+		break;
+	case DATA_STORE_SENSOR:
+		len = sizeof(record_buf.record.data.sensors);
+		break;
+	case DATA_STORE_MODEM_DYNAMIC:
+		len = sizeof(record_buf.record.data.modem_dynamic);
+		break;
+	case DATA_STORE_UI:
+		len = sizeof(record_buf.record.data.ui);
+		break;
+	case DATA_STORE_ACCELEROMETER:
+		len = sizeof(record_buf.record.data.accelerometer);
+		break;
+	case DATA_STORE_BATTERY:
+		len = sizeof(record_buf.record.data.battery);
+		break;
+	case RECORD_TAIL:
+		len = sizeof(record_buf.record.data.tail);
+		break;
+	default:
+		return 0;
+	}
+
+	return offsetof(struct record, data) + len;
+}
+
+static int64_t *record_ts_get(struct record *record)
+{
+	switch (record->type) {
+	case DATA_STORE_GPS:
+		return &record->data.gps.gps_ts;
+	case DATA_STORE_SENSOR:
+		return &record->data.sensors.env_ts;
+	case DATA_STORE_MODEM_DYNAMIC:
+		return &record->data.modem_dynamic.ts;
+	case DATA_STORE_UI:
+		return &record->data.ui.btn_ts;
+	case DATA_STORE_ACCELEROMETER:
+		return &record->data.accelerometer.ts;
+	case DATA_STORE_BATTERY:
+		return &record->data.battery.bat_ts;
+	default:
+		return NULL;
+	}
+}
+
+/* Position of an entry in the order of the buffer, from the oldest sector to the active. */
+static uint64_t entry_order(const struct fcb_entry *entry)
+{
+	uint64_t index = (entry->fe_sector - fcb.f_oldest + fcb.f_sector_cnt) %
+			 fcb.f_sector_cnt;
+
+	return (index << 32) | entry->fe_elem_off;
+}
+
+/* Read the record at the given location. Returns the type of the record, or a negative
+ * error code if the record cannot be used.
+ */
+static int record_read(const struct fcb_entry *loc)
+{
+	int err;
+
+	if (loc->fe_data_len > sizeof(record_buf.record)) {
+		return -EMSGSIZE;
+	}
+
+	err = flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(*loc), &record_buf.record,
+			      loc->fe_data_len);
+	if (err) {
+		LOG_ERR("flash_area_read, error: %d", err);
+		return err;
+	}
+
+	/* Entries stored by firmware with another layout of the structures have another
+	 * length and are skipped.
+	 */
+	if (loc->fe_data_len != record_len(record_buf.record.type)) {
+		return -EBADMSG;
+	}
+
+	return record_buf.record.type;
+}
+
+static int oldest_sector_drop(void)
+{
+	int err;
+
+	LOG_WRN("Data store full, erasing the oldest sector");
+
+	if (tail.fe_sector == fcb.f_oldest) {
+		tail.fe_sector = NULL;
+	}
+
+	if (read_end.fe_sector == fcb.f_oldest) {
+		read_end_valid = false;
+	}
+
+	err = fcb_rotate(&fcb);
+	if (err) {
+		LOG_ERR("fcb_rotate, error: %d", err);
+	}
+
+	return err;
+}
+
+/* Append the record in the record buffer. */
+static int record_append(void)
+{
+	int err;
+	struct fcb_entry loc;
+	size_t len = record_len(record_buf.record.type);
+
+	while (true) {
+		err = fcb_append(&fcb, len, &loc);
+		if (err != -ENOSPC) {
+			break;
+		}
+
+		err = oldest_sector_drop();
+		if (err) {
+			return err;
+		}
+	}
+
+	if (err) {
+		LOG_ERR("fcb_append, error: %d", err);
+		return err;
+	}
+
+	err = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), &record_buf,
+			       ROUND_UP(len, fcb.f_align));
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	/* The entry is only valid after its CRC has been written. */
+	err = fcb_append_finish(&fcb, &loc);
+	if (err) {
+		LOG_ERR("fcb_append_finish, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Apply a tail record that is located at the given location. */
+static void tail_record_apply(const struct record_tail *record, const struct fcb_entry *loc)
+{
+	struct fcb_entry entry = {
+		.fe_elem_off = record->elem_off,
+	};
+
+	tail.fe_sector = NULL;
+
+	if (record->elem_off == 0) {
+		return;
+	}
+
+	for (size_t i = 0; i < fcb.f_sector_cnt; i++) {
+		if (sectors[i].fs_off == record->sector_off) {
+			entry.fe_sector = &sectors[i];
+			break;
+		}
+	}
+
+	/* The last sent entry precedes the record. If it does not, its sector has been
+	 * erased after the record was written, and all entries are unsent.
+	 */
+	if ((entry.fe_sector != NULL) && (entry_order(&entry) < entry_order(loc))) {
+		tail = entry;
+	}
+}
+
+static int partition_erase(void)
+{
+	int err;
+	const struct flash_area *fap;
+
+	err = flash_area_open(DATA_STORE_FLASH_AREA_ID, &fap);
+	if (err) {
+		LOG_ERR("flash_area_open, error: %d", err);
+		return err;
+	}
+
+	err = flash_area_erase(fap, 0, fap->fa_size);
+	if (err) {
+		LOG_ERR("flash_area_erase, error: %d", err);
+	}
+
+	flash_area_close(fap);
+
+	return err;
+}
+
+static int fcb_setup(void)
+{
+	int err;
+	uint32_t sector_count = ARRAY_SIZE(sectors);
+
+	err = flash_area_get_sectors(DATA_STORE_FLASH_AREA_ID, &sector_count, sectors);
+	if (err) {
+		LOG_ERR("flash_area_get_sectors, error: %d", err);
+		return err;
+	}
+
+	memset(&fcb, 0, sizeof(fcb));
+
+	fcb.f_magic = DATA_STORE_MAGIC;
+	fcb.f_version = DATA_STORE_VERSION;
+	fcb.f_sector_cnt = sector_count;
+	fcb.f_sectors = sectors;
+
+	return fcb_init(DATA_STORE_FLASH_AREA_ID, &fcb);
+}
+
+int data_store_init(void)
+{
+	int err;
+	size_t pending = 0;
+	struct fcb_entry loc = {0};
+
+	initialized = false;
+
+	err = fcb_setup();
+	if (err) {
+		/* The partition holds data of another format version, or is corrupted. */
+		LOG_WRN("fcb_init, error: %d, erasing the data store", err);
+
+		err = partition_erase();
+		if (err) {
+			return err;
+		}
+
+		err = fcb_setup();
+		if (err) {
+			LOG_ERR("fcb_init, error: %d", err);
+			return err;
+		}
+	}
+
+	tail.fe_sector = NULL;
+
+	while (fcb_getnext(&fcb, &loc) == 0) {
+		int type = record_read(&loc);
+
+		if (type == RECORD_TAIL) {
+			tail_record_apply(&record_buf.record.data.tail, &loc);
+			pending = 0;
+		} else if (type > 0) {
+			pending++;
+		}
+	}
+
+	read_end = tail;
+	read_end_valid = true;
+	initialized = true;
+
+	LOG_DBG("Data store initialized, %d entries stored since the last sent entry",
+		pending);
+
+	return 0;
+}
+
+int data_store_write(enum data_store_type type, const void *entry)
+{
+	int err;
+	size_t len = record_len(type);
+	int64_t *ts;
+
+	if (!initialized) {
+		return -EACCES;
+	}
+
+	if ((len == 0) || (type == RECORD_TAIL)) {
+		return -EINVAL;
+	}
+
+	memset(&record_buf, 0, sizeof(record_buf));
+	record_buf.record.type = type;
+	memcpy(&record_buf.record.data, entry, len - offsetof(struct record, data));
+
+	/* Uptime is reset by a reboot, store the UNIX time. */
+	ts = record_ts_get(&record_buf.record);
+
+	err = date_time_uptime_to_unix_time_ms(ts);
+	if (err) {
+		return -ENODATA;
+	}
+
+	return record_append();
+}
+
+/* Add the entry in the record buffer to the chunk. Returns false if the buffer of the
+ * entry's type is full.
+ */
+static bool chunk_add(struct data_store_chunk *chunk, int64_t uptime_offset)
+{
+	struct record *record = &record_buf.record;
+
+	/* Convert the timestamp back to uptime, which the codec expects. Entries stored
+	 * before the last reboot get a negative uptime.
+	 */
+	*record_ts_get(record) -= uptime_offset;
+
+	switch (record->type) {
+	case DATA_STORE_GPS:
+		if (chunk->gps_count == chunk->gps_size) {
+			return false;
+		}
+
+		chunk->gps[chunk->gps_count] = record->data.gps;
+		chunk->gps[chunk->gps_count++].queued = true;
+		break;
+	case DATA_STORE_SENSOR:
+		if (chunk->sensors_count == chunk->sensors_size) {
+			return false;
+		}
+
+		chunk->sensors[chunk->sensors_count] = record->data.sensors;
+		chunk->sensors[chunk->sensors_count++].queued = true;
+		break;
+	case DATA_STORE_MODEM_DYNAMIC:
+		if (chunk->modem_dynamic_count == chunk->modem_dynamic_size) {
+			return false;
+		}
+
+		chunk->modem_dynamic[chunk->modem_dynamic_count] = record->data.modem_dynamic;
+		chunk->modem_dynamic[chunk->modem_dynamic_count++].queued = true;
+		break;
+	case DATA_STORE_UI:
+		if (chunk->ui_count == chunk->ui_size) {
+			return false;
+		}
+
+		chunk->ui[chunk->ui_count] = record->data.ui;
+		chunk->ui[chunk->ui_count++].queued = true;
+		break;
+	case DATA_STORE_ACCELEROMETER:
+		if (chunk->accelerometer_count == chunk->accelerometer_size) {
+			return false;
+		}
+
+		chunk->accelerometer[chunk->accelerometer_count] = record->data.accelerometer;
+		chunk->accelerometer[chunk->accelerometer_count++].queued = true;
+		break;
+	case DATA_STORE_BATTERY:
+		if (chunk->battery_count == chunk->battery_size) {
+			return false;
+		}
+
+		chunk->battery[chunk->battery_count] = record->data.battery;
+		chunk->battery[chunk->battery_count++].queued = true;
+		break;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+int data_store_read(struct data_store_chunk *chunk)
+{
+	int err;
+	size_t count = 0;
+	int64_t uptime_offset = 0;
+	struct fcb_entry loc = tail;
+
+	if (!initialized) {
+		return -EACCES;
+	}
+
+	/* UNIX time at uptime 0. */
+	err = date_time_uptime_to_unix_time_ms(&uptime_offset);
+	if (err) {
+		return -ENODATA;
+	}
+
+	chunk->gps_count = 0;
+	chunk->sensors_count = 0;
+	chunk->modem_dynamic_count = 0;
+	chunk->ui_count = 0;
+	chunk->accelerometer_count = 0;
+	chunk->battery_count = 0;
+
+	read_end = tail;
+	read_end_valid = true;
+
+	while (fcb_getnext(&fcb, &loc) == 0) {
+		int type = record_read(&loc);
+
+		if ((type > 0) && (type != RECORD_TAIL)) {
+			if (!chunk_add(chunk, uptime_offset)) {
+				break;
+			}
+
+			count++;
+		}
+
+		read_end = loc;
+	}
+
+	LOG_DBG("%d entries read", count);
+
+	return (count > 0) ? 0 : -ENODATA;
+}
+
+int data_store_commit(void)
+{
+	int err;
+
+	if (!initialized) {
+		return -EACCES;
+	}
+
+	if (!read_end_valid) {
+		/* The entries have been erased since they were read. */
+		return 0;
+	}
+
+	if ((read_end.fe_sector == tail.fe_sector) &&
+	    (read_end.fe_elem_off == tail.fe_elem_off)) {
+		return 0;
+	}
+
+	memset(&record_buf, 0, sizeof(record_buf));
+	record_buf.record.type = RECORD_TAIL;
+	record_buf.record.data.tail.sector_off = read_end.fe_sector->fs_off;
+	record_buf.record.data.tail.elem_off = read_end.fe_elem_off;
+
+	err = record_append();
+	if (err) {
+		return err;
+	}
+
+	if (!read_end_valid) {
+		return 0;
+	}
+
+	tail = read_end;
+
+	/* Erase the sectors that only hold sent entries. */
+	while (fcb.f_oldest != tail.fe_sector) {
+		err = fcb_rotate(&fcb);
+		if (err) {
+			LOG_ERR("fcb_rotate, error: %d", err);
+			return err;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef DATA_STORE_H__
+#define DATA_STORE_H__
+
+/**@file
+ *
+ * @defgroup data_store Data store
+ * @brief    Persistent store for data that has not been sent to cloud.
+ *
+ * @details The entries are appended to a flash circular buffer (FCB) in the data_storage
+ *          flash partition. Each entry is protected by a CRC, and entries that fail the
+ *          check are skipped. The sectors of the partition are erased in turn, which
+ *          levels the wear. The position of the last entry that has been sent is
+ *          appended to the same buffer, so that the store resumes where it left off
+ *          after a reboot. If the partition is full, the oldest sector is erased and the
+ *          entries that it holds are lost.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+
+/** @brief Types of data held by the store. */
+enum data_store_type {
+	DATA_STORE_GPS = 1,
+	DATA_STORE_SENSOR,
+	DATA_STORE_MODEM_DYNAMIC,
+	DATA_STORE_UI,
+	DATA_STORE_ACCELEROMETER,
+	DATA_STORE_BATTERY,
+};
+
+/** @brief Buffers that entries are read into.
+ *
+ *  @details Each buffer is described by a pointer, its size in number of entries and the
+ *           number of entries that have been read into it.
+ */
+struct data_store_chunk {
+	struct cloud_data_gps *gps;
+	size_t gps_size;
+	size_t gps_count;
+
+	struct cloud_data_sensors *sensors;
+	size_t sensors_size;
+	size_t sensors_count;
+
+	struct cloud_data_modem_dynamic *modem_dynamic;
+	size_t modem_dynamic_size;
+	size_t modem_dynamic_count;
+
+	struct cloud_data_ui *ui;
+	size_t ui_size;
+	size_t ui_count;
+
+	struct cloud_data_accelerometer *accelerometer;
+	size_t accelerometer_size;
+	size_t accelerometer_count;
+
+	struct cloud_data_battery *battery;
+	size_t battery_size;
+	size_t battery_count;
+};
+
+/**
+ * @brief Initialize the store and find the entries that have not been sent.
+ *
+ * @details Can be called again to reload the store from flash.
+ *
+ * @return 0 on success, otherwise a negative error code.
+ */
+int data_store_init(void);
+
+/**
+ * @brief Append an entry to the store.
+ *
+ * @details The timestamp of the entry is converted to UNIX time before it is stored, and
+ *          valid date time is therefore required.
+ *
+ * @param[in] type Type of the entry.
+ * @param[in] entry Pointer to the entry, a cloud_data structure matching the type.
+ *
+ * @return 0 on success. -ENODATA if valid date time is not available. Otherwise a negative
+ *         error code is returned.
+ */
+int data_store_write(enum data_store_type type, const void *entry);
+
+/**
+ * @brief Read the oldest entries that have not been sent.
+ *
+ * @details Entries are read in the order they were stored until the buffer of the next
+ *          entry's type is full. The timestamps of the entries are converted back to uptime,
+ *          as expected by the cloud codec, and the entries are queued. The entries are read
+ *          again by the next call, unless data_store_commit() is called in between.
+ *
+ * @param[in,out] chunk Pointer to the buffers that the entries are read into.
+ *
+ * @return 0 on success. -ENODATA if there are no entries or valid date time is not
+ *         available. Otherwise a negative error code is returned.
+ */
+int data_store_read(struct data_store_chunk *chunk);
+
+/**
+ * @brief Mark the entries returned by the last call to data_store_read() as sent.
+ *
+ * @details Sectors that only hold sent entries are erased.
+ *
+ * @return 0 on success, otherwise a negative error code.
+ */
+int data_store_commit(void);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* DATA_STORE_H__ */
@@ -10,6 +10,7 @@
 #include <date_time.h>
 
 #include "cloud/cloud_codec/cloud_codec.h"
+#include "data_store/data_store.h"
 
 #define MODULE data_module
 
@@ -65,6 +66,35 @@ static struct cloud_data_accelerometer accel_buf[CONFIG_DATA_ACCELEROMETER_BUFFE
 static struct cloud_data_battery bat_buf[CONFIG_DATA_BATTERY_BUFFER_COUNT];
 static struct cloud_data_modem_dynamic modem_dyn_buf[CONFIG_DATA_MODEM_DYNAMIC_BUFFER_COUNT];
 
+#if defined(CONFIG_DATA_STORE)
+/* Buffers that entries stored in flash are read into. */
+static struct cloud_data_gps stored_gps_buf[CONFIG_DATA_GPS_BUFFER_COUNT];
+static struct cloud_data_sensors stored_sensors_buf[CONFIG_DATA_SENSOR_BUFFER_COUNT];
+static struct cloud_data_ui stored_ui_buf[CONFIG_DATA_UI_BUFFER_COUNT];
+static struct cloud_data_accelerometer stored_accel_buf[CONFIG_DATA_ACCELEROMETER_BUFFER_COUNT];
+static struct cloud_data_battery stored_bat_buf[CONFIG_DATA_BATTERY_BUFFER_COUNT];
+static struct cloud_data_modem_dynamic
+	stored_modem_dyn_buf[CONFIG_DATA_MODEM_DYNAMIC_BUFFER_COUNT];
+
+static struct data_store_chunk stored_chunk = {
+	.gps = stored_gps_buf,
+	.gps_size = ARRAY_SIZE(stored_gps_buf),
+	.sensors = stored_sensors_buf,
+	.sensors_size = ARRAY_SIZE(stored_sensors_buf),
+	.modem_dynamic = stored_modem_dyn_buf,
+	.modem_dynamic_size = ARRAY_SIZE(stored_modem_dyn_buf),
+	.ui = stored_ui_buf,
+	.ui_size = ARRAY_SIZE(stored_ui_buf),
+	.accelerometer = stored_accel_buf,
+	.accelerometer_size = ARRAY_SIZE(stored_accel_buf),
+	.battery = stored_bat_buf,
+	.battery_size = ARRAY_SIZE(stored_bat_buf),
+};
+#endif /* defined(CONFIG_DATA_STORE) */
+
+/* Batch message holding entries stored in flash while it is being sent. */
+static void *stored_batch;
+
 /* Static modem data does not change between firmware versions and does not
  * have to be buffered.
  */
@@ -306,6 +336,11 @@ static void data_list_clear_and_free(struct ack_data *list, size_t list_count)
 {
 	for (size_t i = 0; i < list_count; i++) {
 		if (list[i].ptr != NULL) {
+			if (list[i].ptr == stored_batch) {
+				/* The entries are read from flash again. */
+				stored_batch = NULL;
+			}
+
 			k_free(list[i].ptr);
 			data_list_clear_entry(&list[i]);
 		}
@@ -402,6 +437,8 @@ static void data_resend(void)
 	}
 }
 
+static void data_store_send(void);
+
 static void data_ack(void *ptr, bool sent)
 {
 	/* Move data from pending to failed data list if incoming data is
@@ -411,10 +448,18 @@ static void data_ack(void *ptr, bool sent)
 
 	for (size_t i = 0; i < ARRAY_SIZE(pending_data); i++) {
 		if (pending_data[i].ptr == ptr) {
+			bool stored_batch_sent = false;
+
 			if (sent) {
-				k_free(ptr);
+				/* Release the batch read from flash before the buffer is freed. */
+				if (IS_ENABLED(CONFIG_DATA_STORE) && (ptr == stored_batch)) {
+					stored_batch = NULL;
+					stored_batch_sent = true;
+				}
+
 				LOG_DBG("Pending data ACKed: %p",
 					pending_data[i].ptr);
+				k_free(ptr);
 			} else {
 				LOG_DBG("Moving %p data from pending to failed",
 					pending_data[i].ptr);
@@ -425,6 +470,13 @@ static void data_ack(void *ptr, bool sent)
 						     pending_data[i].type);
 			}
 			data_list_clear_entry(&pending_data[i]);
+
+			if (stored_batch_sent) {
+				(void)data_store_commit();
+
+				/* Continue with the next entries in flash. */
+				data_store_send();
+			}
 			return;
 		}
 	}
@@ -468,6 +520,14 @@ static int setup(void)
 		return err;
 	}
 
+	if (IS_ENABLED(CONFIG_DATA_STORE)) {
+		err = data_store_init();
+		if (err) {
+			/* Data is kept in the ringbuffers only. */
+			LOG_ERR("data_store_init, error: %d", err);
+		}
+	}
+
 	return 0;
 }
 
@@ -574,6 +634,83 @@ static void data_send(void)
 	EVENT_SUBMIT(data_module_event_batch);
 }
 
+/* Send the oldest entries stored in flash. The next entries are sent when the batch has
+ * been acknowledged.
+ */
+static void data_store_send(void)
+{
+#if defined(CONFIG_DATA_STORE)
+	int err;
+	struct data_module_event *evt;
+	struct cloud_codec_data codec;
+
+	if ((stored_batch != NULL) || !date_time_is_valid()) {
+		return;
+	}
+
+	err = data_store_read(&stored_chunk);
+	if (err == -ENODATA) {
+		return;
+	} else if (err) {
+		LOG_ERR("data_store_read, error: %d", err);
+		return;
+	}
+
+	err = cloud_codec_encode_batch_data(&codec,
+					stored_chunk.gps,
+					stored_chunk.sensors,
+					stored_chunk.modem_dynamic,
+					stored_chunk.ui,
+					stored_chunk.accelerometer,
+					stored_chunk.battery,
+					stored_chunk.gps_count,
+					stored_chunk.sensors_count,
+					stored_chunk.modem_dynamic_count,
+					stored_chunk.ui_count,
+					stored_chunk.accelerometer_count,
+					stored_chunk.battery_count);
+	if (err == -ENODATA) {
+		/* None of the entries hold data that can be sent. */
+		(void)data_store_commit();
+		return;
+	} else if (err) {
+		LOG_ERR("Error batch-enconding stored data: %d", err);
+		SEND_ERROR(data, DATA_EVT_ERROR, err);
+		return;
+	}
+
+	stored_batch = codec.buf;
+
+	evt = new_data_module_event();
+	evt->type = DATA_EVT_DATA_SEND_BATCH;
+	evt->data.buffer.buf = codec.buf;
+	evt->data.buffer.len = codec.len;
+
+	data_list_add_pending(codec.buf, codec.len, BATCH);
+	EVENT_SUBMIT(evt);
+#endif /* defined(CONFIG_DATA_STORE) */
+}
+
+/* Move the newest entry of a ringbuffer to flash while the cloud is disconnected.
+ * Returns true if the entry was stored and must no longer be queued for sending.
+ */
+static bool buffer_entry_store(enum data_store_type type, const void *entry, bool queued)
+{
+	if (!IS_ENABLED(CONFIG_DATA_STORE) || (state == STATE_CLOUD_CONNECTED) || !queued) {
+		return false;
+	}
+
+	return data_store_write(type, entry) == 0;
+}
+
+/* The queued flag is a bitfield, so it is cleared by the caller for all entry types. */
+#define BUFFER_ENTRY_STORE(_type, _entry)					\
+	do {									\
+		if (buffer_entry_store(_type, &(_entry), (_entry).queued)) {	\
+			(_entry).queued = false;				\
+		}								\
+	} while (0)
+
 static void config_get(void)
 {
 	SEND_EVENT(data, DATA_EVT_CONFIG_GET);
@@ -810,6 +947,7 @@ static void on_cloud_state_connected(struct data_msg_data *msg)
 		/* Resend data previously failed to be sent. */
 		data_resend();
 		data_send();
+		data_store_send();
 		return;
 	}
 
@@ -896,6 +1034,7 @@ static void on_all_states(struct data_msg_data *msg)
 		cloud_codec_populate_ui_buffer(ui_buf, &new_ui_data,
 					       &head_ui_buf,
 					       ARRAY_SIZE(ui_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_UI, ui_buf[head_ui_buf]);
 
 		SEND_EVENT(data, DATA_EVT_UI_DATA_READY);
 		return;
@@ -966,6 +1105,7 @@ static void on_all_states(struct data_msg_data *msg)
 						&new_modem_data,
 						&head_modem_dyn_buf,
 						ARRAY_SIZE(modem_dyn_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_MODEM_DYNAMIC, modem_dyn_buf[head_modem_dyn_buf]);
 
 		requested_data_status_set(APP_DATA_MODEM_DYNAMIC);
 	}
@@ -984,6 +1124,7 @@ static void on_all_states(struct data_msg_data *msg)
 		cloud_codec_populate_bat_buffer(bat_buf, &new_battery_data,
 						&head_bat_buf,
 						ARRAY_SIZE(bat_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_BATTERY, bat_buf[head_bat_buf]);
 
 		requested_data_status_set(APP_DATA_BATTERY);
 	}
@@ -1000,6 +1141,7 @@ static void on_all_states(struct data_msg_data *msg)
 						   &new_sensor_data,
 						   &head_sensor_buf,
 						   ARRAY_SIZE(sensors_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_SENSOR, sensors_buf[head_sensor_buf]);
 
 		requested_data_status_set(APP_DATA_ENVIRONMENTAL);
 	}
@@ -1020,6 +1162,7 @@ static void on_all_states(struct data_msg_data *msg)
 		cloud_codec_populate_accel_buffer(accel_buf, &new_movement_data,
 						  &head_accel_buf,
 						  ARRAY_SIZE(accel_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_ACCELEROMETER, accel_buf[head_accel_buf]);
 	}
 
 	if (IS_EVENT(msg, gps, GPS_EVT_DATA_READY)) {
@@ -1060,6 +1203,7 @@ static void on_all_states(struct data_msg_data *msg)
 		cloud_codec_populate_gps_buffer(gps_buf, &new_gps_data,
 						&head_gps_buf,
 						ARRAY_SIZE(gps_buf));
+		BUFFER_ENTRY_STORE(DATA_STORE_GPS, gps_buf[head_gps_buf]);
 
 		requested_data_status_set(APP_DATA_GNSS);
 	}
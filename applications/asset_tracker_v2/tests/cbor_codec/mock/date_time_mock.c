@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+
+#include "date_time.h"
+
+/* Mocking function that converts the input uptime to a timestamp at a known offset, so that
+ * entries keep their relative timestamps.
+ */
+int date_time_uptime_to_unix_time_ms(int64_t *uptime)
+{
+	*uptime += 1563968747000;
+
+	return 0;
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <cJSON.h>
+#include <cJSON_os.h>
+
+#include "cloud_codec.h"
+#include "cbor_codec.h"
+#include "cbor_writer.h"
+#include "json_common.h"
+#include "json_protocol_names.h"
+
+/* Default number of entries buffered in the data module. */
+#define FULL_GPS_COUNT			10
+#define FULL_SENSOR_COUNT		10
+#define FULL_MODEM_DYNAMIC_COUNT	3
+#define FULL_UI_COUNT			3
+#define FULL_ACCELEROMETER_COUNT	3
+#define FULL_BATTERY_COUNT		3
+
+static struct {
+	struct cloud_data_gps gps[FULL_GPS_COUNT];
+	struct cloud_data_sensors sensors[FULL_SENSOR_COUNT];
+	struct cloud_data_modem_dynamic modem_dynamic[FULL_MODEM_DYNAMIC_COUNT];
+	struct cloud_data_ui ui[FULL_UI_COUNT];
+	struct cloud_data_accelerometer accelerometer[FULL_ACCELEROMETER_COUNT];
+	struct cloud_data_battery battery[FULL_BATTERY_COUNT];
+} full;
+
+static int encode(struct cloud_codec_data *output)
+{
+	return cbor_codec_encode_batch_data(output,
+					    full.gps, full.sensors, full.modem_dynamic,
+					    full.ui, full.accelerometer, full.battery,
+					    FULL_GPS_COUNT, FULL_SENSOR_COUNT,
+					    FULL_MODEM_DYNAMIC_COUNT, FULL_UI_COUNT,
+					    FULL_ACCELEROMETER_COUNT, FULL_BATTERY_COUNT);
+}
+
+static void full_fill(void)
+{
+	memset(&full, 0, sizeof(full));
+
+	for (size_t i = 0; i < FULL_GPS_COUNT; i++) {
+		full.gps[i].pvt.longi = 10.4273551 + i * 0.0001;
+		full.gps[i].pvt.lat = 63.4214783 - i * 0.0001;
+		full.gps[i].pvt.acc = 12.7;
+		full.gps[i].pvt.alt = 171.4 + i;
+		full.gps[i].pvt.spd = 0.31;
+		full.gps[i].pvt.hdg = 176.2;
+		full.gps[i].gps_ts = 1000 + i * 60000;
+		full.gps[i].format = CLOUD_CODEC_GPS_FORMAT_PVT;
+		full.gps[i].queued = true;
+	}
+
+	for (size_t i = 0; i < FULL_SENSOR_COUNT; i++) {
+		full.sensors[i].temp = 22.8 + i * 0.1;
+		full.sensors[i].hum = 47.3;
+		full.sensors[i].env_ts = 1000 + i * 60000;
+		full.sensors[i].queued = true;
+	}
+
+	for (size_t i = 0; i < FULL_MODEM_DYNAMIC_COUNT; i++) {
+		full.modem_dynamic[i].rsrp = -80 - i;
+		full.modem_dynamic[i].area = 2305;
+		strcpy(full.modem_dynamic[i].mccmnc, "24202");
+		full.modem_dynamic[i].cell = 33703719;
+		strcpy(full.modem_dynamic[i].ip, "10.81.183.99");
+		full.modem_dynamic[i].rsrp_fresh = true;
+		full.modem_dynamic[i].area_code_fresh = true;
+		full.modem_dynamic[i].mccmnc_fresh = true;
+		full.modem_dynamic[i].cell_id_fresh = true;
+		full.modem_dynamic[i].ip_address_fresh = true;
+		full.modem_dynamic[i].ts = 1000 + i * 60000;
+		full.modem_dynamic[i].queued = true;
+	}
+
+	for (size_t i = 0; i < FULL_UI_COUNT; i++) {
+		full.ui[i].btn = 1;
+		full.ui[i].btn_ts = 1000 + i * 60000;
+		full.ui[i].queued = true;
+	}
+
+	for (size_t i = 0; i < FULL_ACCELEROMETER_COUNT; i++) {
+		full.accelerometer[i].values[0] = 0.12 * i;
+		full.accelerometer[i].values[1] = -9.81;
+		full.accelerometer[i].values[2] = 0.4;
+		full.accelerometer[i].ts = 1000 + i * 60000;
+		full.accelerometer[i].queued = true;
+	}
+
+	for (size_t i = 0; i < FULL_BATTERY_COUNT; i++) {
+		full.battery[i].bat = 3650 - i;
+		full.battery[i].bat_ts = 1000 + i * 60000;
+		full.battery[i].queued = true;
+	}
+}
+
+static void test_cbor_writer(void)
+{
+	int ret;
+	uint8_t buf[64];
+	struct cbor_writer writer;
+	const uint8_t expected[] = {
+		/* Integers in all argument sizes. */
+		0x00, 0x17, 0x18, 0x18, 0x19, 0x01, 0x00, 0x1a, 0x00, 0x01, 0x00, 0x00,
+		0x1b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x20, 0x38, 0x63,
+		/* 1.0 as integer, 0.5 in single precision, 0.1 in double precision. */
+		0x01, 0xfa, 0x3f, 0x00, 0x00, 0x00,
+		0xfb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a,
+		/* Text string, map and indefinite array. */
+		0x62, 'i', 'p', 0xa1, 0x9f, 0xff,
+	};
+
+	cbor_writer_init(&writer, buf, sizeof(buf));
+
+	cbor_writer_int(&writer, 0);
+	cbor_writer_int(&writer, 23);
+	cbor_writer_int(&writer, 24);
+	cbor_writer_int(&writer, 256);
+	cbor_writer_int(&writer, 65536);
+	cbor_writer_int(&writer, 4294967296);
+	cbor_writer_int(&writer, -1);
+	cbor_writer_int(&writer, -100);
+	cbor_writer_number(&writer, 1.0);
+	cbor_writer_number(&writer, 0.5);
+	cbor_writer_number(&writer, 0.1);
+	cbor_writer_str(&writer, "ip");
+	cbor_writer_map_start(&writer, 1);
+	cbor_writer_array_start_indefinite(&writer);
+	cbor_writer_end(&writer);
+
+	ret = cbor_writer_finish(&writer);
+	zassert_equal(sizeof(expected), ret, "Length %d is wrong", ret);
+	zassert_mem_equal(expected, buf, sizeof(expected), "Output is wrong");
+
+	/* The measuring writer counts the same length. */
+	cbor_writer_init(&writer, NULL, 0);
+	cbor_writer_int(&writer, 4294967296);
+	cbor_writer_number(&writer, 0.1);
+
+	ret = cbor_writer_finish(&writer);
+	zassert_equal(18, ret, "Length %d is wrong", ret);
+
+	/* Output that does not fit the buffer. */
+	cbor_writer_init(&writer, buf, 4);
+	cbor_writer_int(&writer, 65536);
+
+	ret = cbor_writer_finish(&writer);
+	zassert_equal(-ENOMEM, ret, "Return value %d is wrong", ret);
+}
+
+static void test_encode_batch_data(void)
+{
+	int ret;
+	struct cloud_codec_data output = {0};
+	struct cloud_data_ui ui = {
+		.btn = 1,
+		.btn_ts = 1500,
+		.queued = true
+	};
+	struct cloud_data_battery bat[] = {
+		{ .bat = 3600, .bat_ts = 1000, .queued = true },
+		{ .bat = 3599, .bat_ts = 2000, .queued = true },
+	};
+	const uint8_t expected[] = {
+		/* Format version. */
+		0xbf, 0x00, 0x01,
+		/* Button array with an absolute timestamp. */
+		0x04, 0x9f, 0xa2, 0x00, 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x3b, 0xd4,
+		0x01, 0x01, 0xff,
+		/* Battery array, the second timestamp is 1000 ms after the first. */
+		0x05, 0x9f, 0xa2, 0x00, 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x39, 0xe0,
+		0x01, 0x19, 0x0e, 0x10, 0xa2, 0x00, 0x19, 0x03, 0xe8, 0x01, 0x19, 0x0e, 0x0f, 0xff,
+		0xff,
+	};
+
+	ret = cbor_codec_encode_batch_data(&output, NULL, NULL, NULL, &ui, NULL, bat,
+					   0, 0, 0, 1, 0, ARRAY_SIZE(bat));
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(sizeof(expected), output.len, "Length %d is wrong", (int)output.len);
+	zassert_mem_equal(expected, output.buf, sizeof(expected), "Output is wrong");
+
+	zassert_false(ui.queued, "Entry is still queued");
+	zassert_false(bat[0].queued, "Entry is still queued");
+	zassert_false(bat[1].queued, "Entry is still queued");
+
+	k_free(output.buf);
+
+	/* All entries have been encoded. */
+	ret = cbor_codec_encode_batch_data(&output, NULL, NULL, NULL, &ui, NULL, bat,
+					   0, 0, 0, 1, 0, ARRAY_SIZE(bat));
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+}
+
+/* Timestamps that decrease are encoded as negative integers, and each difference uses the
+ * shortest integer encoding.
+ */
+static void test_encode_batch_data_ts_delta(void)
+{
+	int ret;
+	struct cloud_codec_data output = {0};
+	struct cloud_data_battery bat[] = {
+		{ .bat = 3600, .bat_ts = 2000, .queued = true },
+		{ .bat = 3600, .bat_ts = 1000, .queued = true },
+		{ .bat = 3600, .bat_ts = 1010, .queued = true },
+		{ .bat = 3600, .bat_ts = 910, .queued = true },
+	};
+	const uint8_t expected[] = {
+		0xbf, 0x00, 0x01,
+		0x05, 0x9f, 0xa2, 0x00, 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x3d, 0xc8,
+		0x01, 0x19, 0x0e, 0x10,
+		/* -1000 */
+		0xa2, 0x00, 0x39, 0x03, 0xe7, 0x01, 0x19, 0x0e, 0x10,
+		/* 10 */
+		0xa2, 0x00, 0x0a, 0x01, 0x19, 0x0e, 0x10,
+		/* -100 */
+		0xa2, 0x00, 0x38, 0x63, 0x01, 0x19, 0x0e, 0x10, 0xff,
+		0xff,
+	};
+
+	ret = cbor_codec_encode_batch_data(&output, NULL, NULL, NULL, NULL, NULL, bat,
+					   0, 0, 0, 0, 0, ARRAY_SIZE(bat));
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(sizeof(expected), output.len, "Length %d is wrong", (int)output.len);
+	zassert_mem_equal(expected, output.buf, sizeof(expected), "Output is wrong");
+
+	k_free(output.buf);
+}
+
+static void test_encode_batch_data_modem_dynamic(void)
+{
+	int ret;
+	struct cloud_codec_data output = {0};
+	struct cloud_data_modem_dynamic modem[] = {
+		/* No fresh values, the entry is unqueued without being encoded. */
+		{ .ts = 1000, .queued = true },
+		{ .rsrp = -80, .rsrp_fresh = true, .ts = 1000, .queued = true },
+	};
+	const uint8_t expected[] = {
+		0xbf, 0x00, 0x01,
+		0x01, 0x9f, 0xa2, 0x00, 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x39, 0xe0,
+		0x01, 0x38, 0x4f, 0xff,
+		0xff,
+	};
+
+	ret = cbor_codec_encode_batch_data(&output, NULL, NULL, modem, NULL, NULL, NULL,
+					   0, 0, ARRAY_SIZE(modem), 0, 0, 0);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(sizeof(expected), output.len, "Length %d is wrong", (int)output.len);
+	zassert_mem_equal(expected, output.buf, sizeof(expected), "Output is wrong");
+
+	zassert_false(modem[0].queued, "Entry is still queued");
+	zassert_false(modem[1].queued, "Entry is still queued");
+
+	k_free(output.buf);
+
+	/* Invalid MCCMNC. */
+	modem[1].queued = true;
+	modem[1].mccmnc_fresh = true;
+	strcpy(modem[1].mccmnc, "242O2");
+
+	ret = cbor_codec_encode_batch_data(&output, NULL, NULL, modem, NULL, NULL, NULL,
+					   0, 0, ARRAY_SIZE(modem), 0, 0, 0);
+	zassert_equal(-ENOTEMPTY, ret, "Return value %d is wrong", ret);
+	zassert_true(modem[1].queued, "Entry is not queued");
+}
+
+/* Encode a full batch message in CBOR and JSON, and compare the sizes and encoding times.
+ * The cycle counts are only meaningful on hardware.
+ */
+static void test_batch_size_comparison(void)
+{
+	int ret;
+	uint32_t cycles;
+	uint32_t json_cycles;
+	struct cloud_codec_data json_output = {0};
+	struct cloud_codec_data output = {0};
+	const struct json_common_batch_section sections[] = {
+		{ JSON_COMMON_MODEM_DYNAMIC, full.modem_dynamic, FULL_MODEM_DYNAMIC_COUNT,
+		  DATA_MODEM_DYNAMIC },
+		{ JSON_COMMON_GPS, full.gps, FULL_GPS_COUNT, DATA_GPS },
+		{ JSON_COMMON_SENSOR, full.sensors, FULL_SENSOR_COUNT, DATA_ENVIRONMENTALS },
+		{ JSON_COMMON_UI, full.ui, FULL_UI_COUNT, DATA_BUTTON },
+		{ JSON_COMMON_BATTERY, full.battery, FULL_BATTERY_COUNT, DATA_BATTERY },
+		{ JSON_COMMON_ACCELEROMETER, full.accelerometer, FULL_ACCELEROMETER_COUNT,
+		  DATA_MOVEMENT },
+	};
+
+	full_fill();
+
+	cycles = k_cycle_get_32();
+	ret = json_common_batch_data_encode(&json_output, sections, ARRAY_SIZE(sections));
+	json_cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	full_fill();
+
+	cycles = k_cycle_get_32();
+	ret = encode(&output);
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	TC_PRINT("Encoding a full batch message:\n");
+	TC_PRINT("JSON: %d bytes, %u cycles\n", (int)json_output.len, json_cycles);
+	TC_PRINT("CBOR: %d bytes, %u cycles\n", (int)output.len, cycles);
+
+	zassert_true(output.len * 2 < json_output.len, "CBOR message is not less than half");
+
+	for (size_t i = 0; i < FULL_GPS_COUNT; i++) {
+		zassert_false(full.gps[i].queued, "Entry is still queued");
+	}
+
+	cJSON_FreeString(json_output.buf);
+	k_free(output.buf);
+}
+
+void test_main(void)
+{
+	cJSON_Init();
+
+	ztest_test_suite(cbor_codec,
+		ztest_unit_test(test_cbor_writer),
+		ztest_unit_test(test_encode_batch_data),
+		ztest_unit_test(test_encode_batch_data_ts_delta),
+		ztest_unit_test(test_encode_batch_data_modem_dynamic),
+		ztest_unit_test(test_batch_size_comparison)
+	);
+
+	ztest_run_test_suite(cbor_codec);
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+
+#include "date_time.h"
+#include "date_time_mock.h"
+
+int64_t date_time_mock_offset = 1563968747000;
+bool date_time_mock_valid = true;
+
+/* Mocking function that converts the input uptime with a configurable offset. */
+int date_time_uptime_to_unix_time_ms(int64_t *uptime)
+{
+	if (!date_time_mock_valid) {
+		return -ENODATA;
+	}
+
+	*uptime += date_time_mock_offset;
+
+	return 0;
+}
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef DATE_TIME_MOCK_H__
+#define DATE_TIME_MOCK_H__
+
+#include <zephyr.h>
+
+/* UNIX time in milliseconds at uptime 0. */
+extern int64_t date_time_mock_offset;
+
+/* Whether date time is valid. */
+extern bool date_time_mock_valid;
+
+#endif /* DATE_TIME_MOCK_H__ */
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <storage/flash_map.h>
+
+#include "data_store/data_store.h"
+#include "mock/date_time_mock.h"
+
+#define TEST_OFFSET		1563968747000
+#define TEST_BUFFER_COUNT	10
+/* More battery entries than the partition holds. */
+#define TEST_OVERFLOW_COUNT	1000
+
+static struct cloud_data_gps gps_buf[TEST_BUFFER_COUNT];
+static struct cloud_data_sensors sensors_buf[TEST_BUFFER_COUNT];
+static struct cloud_data_modem_dynamic modem_dyn_buf[TEST_BUFFER_COUNT];
+static struct cloud_data_ui ui_buf[TEST_BUFFER_COUNT];
+static struct cloud_data_accelerometer accel_buf[TEST_BUFFER_COUNT];
+static struct cloud_data_battery bat_buf[TEST_OVERFLOW_COUNT];
+
+static struct data_store_chunk chunk = {
+	.gps = gps_buf,
+	.sensors = sensors_buf,
+	.modem_dynamic = modem_dyn_buf,
+	.ui = ui_buf,
+	.accelerometer = accel_buf,
+	.battery = bat_buf,
+};
+
+static void chunk_sizes_set(size_t size)
+{
+	chunk.gps_size = size;
+	chunk.sensors_size = size;
+	chunk.modem_dynamic_size = size;
+	chunk.ui_size = size;
+	chunk.accelerometer_size = size;
+	chunk.battery_size = size;
+}
+
+static int battery_write(uint16_t bat, int64_t ts)
+{
+	struct cloud_data_battery data = {
+		.bat = bat,
+		.bat_ts = ts,
+		.queued = true
+	};
+
+	return data_store_write(DATA_STORE_BATTERY, &data);
+}
+
+static void test_setup(void)
+{
+	int err;
+	const struct flash_area *fap;
+
+	err = flash_area_open(FLASH_AREA_ID(data_storage), &fap);
+	zassert_equal(0, err, "flash_area_open, error: %d", err);
+
+	err = flash_area_erase(fap, 0, fap->fa_size);
+	zassert_equal(0, err, "flash_area_erase, error: %d", err);
+
+	flash_area_close(fap);
+
+	date_time_mock_offset = TEST_OFFSET;
+	date_time_mock_valid = true;
+	chunk_sizes_set(TEST_BUFFER_COUNT);
+
+	err = data_store_init();
+	zassert_equal(0, err, "data_store_init, error: %d", err);
+}
+
+static void test_write_read(void)
+{
+	int ret;
+	struct cloud_data_gps gps = {
+		.pvt.longi = 10.4273551,
+		.pvt.lat = 63.4214783,
+		.pvt.alt = 171.4,
+		.gps_ts = 1000,
+		.format = CLOUD_CODEC_GPS_FORMAT_PVT,
+		.queued = true
+	};
+	struct cloud_data_modem_dynamic modem = {
+		.rsrp = -80,
+		.mccmnc = "24202",
+		.rsrp_fresh = true,
+		.mccmnc_fresh = true,
+		.ts = 2000,
+		.queued = true
+	};
+	struct cloud_data_ui ui = {
+		.btn = 2,
+		.btn_ts = 3000,
+		.queued = true
+	};
+
+	ret = data_store_write(DATA_STORE_GPS, &gps);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_write(DATA_STORE_MODEM_DYNAMIC, &modem);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_write(DATA_STORE_UI, &ui);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	zassert_equal(1, chunk.gps_count, "Wrong number of GPS entries");
+	zassert_equal(1, chunk.modem_dynamic_count, "Wrong number of modem entries");
+	zassert_equal(1, chunk.ui_count, "Wrong number of UI entries");
+	zassert_equal(0, chunk.sensors_count, "Wrong number of sensor entries");
+	zassert_equal(0, chunk.accelerometer_count, "Wrong number of movement entries");
+	zassert_equal(0, chunk.battery_count, "Wrong number of battery entries");
+
+	/* Timestamps are converted back to uptime. */
+	zassert_equal(gps.pvt.longi, gps_buf[0].pvt.longi, "Longitude is wrong");
+	zassert_equal(gps.pvt.lat, gps_buf[0].pvt.lat, "Latitude is wrong");
+	zassert_equal(gps.pvt.alt, gps_buf[0].pvt.alt, "Altitude is wrong");
+	zassert_equal(CLOUD_CODEC_GPS_FORMAT_PVT, gps_buf[0].format, "Format is wrong");
+	zassert_equal(1000, gps_buf[0].gps_ts, "Timestamp is wrong");
+	zassert_true(gps_buf[0].queued, "Entry is not queued");
+	zassert_equal(0, strcmp("24202", modem_dyn_buf[0].mccmnc), "MCCMNC is wrong");
+	zassert_equal(-80, modem_dyn_buf[0].rsrp, "RSRP is wrong");
+	zassert_equal(2000, modem_dyn_buf[0].ts, "Timestamp is wrong");
+	zassert_true(modem_dyn_buf[0].queued, "Entry is not queued");
+	zassert_equal(2, ui_buf[0].btn, "Button is wrong");
+	zassert_equal(3000, ui_buf[0].btn_ts, "Timestamp is wrong");
+
+	/* Entries are read again until they are committed. */
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(1, chunk.gps_count, "Wrong number of GPS entries");
+
+	ret = data_store_commit();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_read(&chunk);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	/* Valid date time is required. */
+	date_time_mock_valid = false;
+
+	ret = data_store_write(DATA_STORE_UI, &ui);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_read(&chunk);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+}
+
+static void test_read_chunks(void)
+{
+	int ret;
+
+	chunk_sizes_set(2);
+
+	for (int i = 0; i < 5; i++) {
+		ret = battery_write(3600 + i, 1000 * i);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+
+	for (int i = 0; i < 5; i += 2) {
+		ret = data_store_read(&chunk);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+		zassert_equal(MIN(2, 5 - i), chunk.battery_count, "Wrong number of entries");
+		zassert_equal(3600 + i, bat_buf[0].bat, "Wrong entry read");
+
+		ret = data_store_commit();
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+
+	ret = data_store_read(&chunk);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+}
+
+static void test_reboot(void)
+{
+	int ret;
+
+	chunk_sizes_set(2);
+
+	for (int i = 0; i < 3; i++) {
+		ret = battery_write(3600 + i, 1000 * i);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_commit();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	/* Entries read but not committed before the reboot are read again. */
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	/* Uptime restarts from 0 after the reboot, 10 seconds later. */
+	date_time_mock_offset += 10000;
+
+	ret = data_store_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(1, chunk.battery_count, "Wrong number of entries");
+	zassert_equal(3602, bat_buf[0].bat, "Wrong entry read");
+	zassert_equal(2000 - 10000, bat_buf[0].bat_ts, "Timestamp is wrong");
+}
+
+static void test_overflow(void)
+{
+	int ret;
+
+	chunk_sizes_set(TEST_OVERFLOW_COUNT);
+
+	/* Send some entries, so that the last sent entry is erased when the partition is
+	 * full.
+	 */
+	for (int i = 0; i < 10; i++) {
+		ret = battery_write(i, i);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+
+	chunk.battery_size = 5;
+
+	ret = data_store_read(&chunk);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = data_store_commit();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	for (int i = 10; i < TEST_OVERFLOW_COUNT; i++) {
+		ret = battery_write(i, i);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+
+	for (int reboot = 0; reboot < 2; reboot++) {
+		chunk.battery_size = TEST_OVERFLOW_COUNT;
+
+		ret = data_store_read(&chunk);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+		/* The oldest entries are dropped, the newest are kept in order. */
+		zassert_true(chunk.battery_count < TEST_OVERFLOW_COUNT - 10,
+			     "Oldest entries are not dropped");
+		zassert_true(chunk.battery_count > TEST_OVERFLOW_COUNT / 4,
+			     "Too many entries are dropped");
+
+		for (size_t i = 0; i < chunk.battery_count; i++) {
+			zassert_equal(TEST_OVERFLOW_COUNT - chunk.battery_count + i,
+				      bat_buf[i].bat, "Wrong entry read");
+		}
+
+		ret = data_store_init();
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+	}
+}
+
+/* The partition is erased sector by sector as entries are sent. */
+static void test_write_commit_cycles(void)
+{
+	int ret;
+
+	chunk_sizes_set(TEST_BUFFER_COUNT);
+
+	for (int i = 0; i < 3 * TEST_OVERFLOW_COUNT; i++) {
+		ret = battery_write(i, i);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+		if (i % 7 != 6) {
+			continue;
+		}
+
+		ret = data_store_read(&chunk);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+		zassert_equal(7, chunk.battery_count, "Wrong number of entries");
+		zassert_equal((uint16_t)(i - 6), bat_buf[0].bat, "Wrong entry read");
+
+		ret = data_store_commit();
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+		if (i % 700 == 699) {
+			ret = data_store_init();
+			zassert_equal(0, ret, "Return value %d is wrong", ret);
+		}
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(data_store,
+		ztest_unit_test_setup_teardown(test_write_read, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_read_chunks, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_reboot, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_overflow, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_write_commit_cycles, test_setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(data_store);
+}
@@ -664,10 +664,18 @@ static void test_decode_configuration_data(void)
 
 /* Batch data */
 
-static void test_encode_batch_data_object(void)
-{
-	int ret;
-	struct cloud_data_battery battery[2] = {
+struct batch_data {
+	struct cloud_data_battery battery[2];
+	struct cloud_data_gps gps[2];
+	struct cloud_data_modem_dynamic modem_dynamic[2];
+	struct cloud_data_modem_static modem_static[2];
+	struct cloud_data_ui ui[2];
+	struct cloud_data_accelerometer accelerometer[2];
+	struct cloud_data_sensors environmental[2];
+};
+
+static const struct batch_data batch_template = {
+	.battery = {
 		[0].bat = 3600,
 		[0].bat_ts = 1000,
 		[0].queued = true,
@@ -675,8 +683,8 @@ static void test_encode_batch_data_object(void)
 		[1].bat = 3600,
 		[1].bat_ts = 1000,
 		[1].queued = true
-	};
-	struct cloud_data_gps gps[2] = {
+	},
+	.gps = {
 		[0].pvt.longi = 10,
 		[0].pvt.lat = 62,
 		[0].pvt.acc = 24,
@@ -696,8 +704,8 @@ static void test_encode_batch_data_object(void)
 		[1].gps_ts = 1000,
 		[1].queued = true,
 		[1].format = CLOUD_CODEC_GPS_FORMAT_PVT
-	};
-	struct cloud_data_modem_dynamic modem_dynamic[2] = {
+	},
+	.modem_dynamic = {
 		[0].rsrp = 20,
 		[0].area = 12,
 		[0].mccmnc = "24202",
@@ -723,8 +731,8 @@ static void test_encode_batch_data_object(void)
 		[1].rsrp_fresh = true,
 		[1].ip_address_fresh = true,
 		[1].mccmnc_fresh = true,
-	};
-	struct cloud_data_modem_static modem_static[2] = {
+	},
+	.modem_static = {
 		[0].bnd = 3,
 		[0].nw_nb_iot = 1,
 		[0].nw_gps = 1,
@@ -744,8 +752,8 @@ static void test_encode_batch_data_object(void)
 		[1].appv = "v1.0.0-development",
 		[1].ts = 1000,
 		[1].queued = true
-	};
-	struct cloud_data_ui ui[2] = {
+	},
+	.ui = {
 		[0].btn = 1,
 		[0].btn_ts = 1000,
 		[0].queued = true,
@@ -753,8 +761,8 @@ static void test_encode_batch_data_object(void)
 		[1].btn = 1,
 		[1].btn_ts = 1000,
 		[1].queued = true
-	};
-	struct cloud_data_accelerometer accelerometer[2] = {
+	},
+	.accelerometer = {
 		[0].values[0] = 1,
 		[0].values[1] = 2,
 		[0].values[2] = 3,
@@ -766,8 +774,8 @@ static void test_encode_batch_data_object(void)
 		[1].values[2] = 3,
 		[1].ts = 1000,
 		[1].queued = true
-	};
-	struct cloud_data_sensors environmental[2] = {
+	},
+	.environmental = {
 		[0].hum = 50,
 		[0].temp = 23,
 		[0].env_ts = 1000,
@@ -777,54 +785,60 @@ static void test_encode_batch_data_object(void)
 		[1].temp = 23,
 		[1].env_ts = 1000,
 		[1].queued = true
-	};
+	},
+};
+
+static void test_encode_batch_data_object(void)
+{
+	int ret;
+	struct batch_data batch = batch_template;
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_BATTERY,
-					 &battery,
-					 ARRAY_SIZE(battery),
+					 batch.battery,
+					 ARRAY_SIZE(batch.battery),
 					 DATA_BATTERY);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_UI,
-					 &ui,
-					 ARRAY_SIZE(ui),
+					 batch.ui,
+					 ARRAY_SIZE(batch.ui),
 					 DATA_BUTTON);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_GPS,
-					 &gps,
-					 ARRAY_SIZE(gps),
+					 batch.gps,
+					 ARRAY_SIZE(batch.gps),
 					 DATA_GPS);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_SENSOR,
-					 &environmental,
-					 ARRAY_SIZE(environmental),
+					 batch.environmental,
+					 ARRAY_SIZE(batch.environmental),
 					 DATA_ENVIRONMENTALS);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_ACCELEROMETER,
-					 &accelerometer,
-					 ARRAY_SIZE(accelerometer),
+					 batch.accelerometer,
+					 ARRAY_SIZE(batch.accelerometer),
 					 DATA_MOVEMENT);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_MODEM_DYNAMIC,
-					 &modem_dynamic,
-					 ARRAY_SIZE(modem_dynamic),
+					 batch.modem_dynamic,
+					 ARRAY_SIZE(batch.modem_dynamic),
 					 DATA_MODEM_DYNAMIC);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
 	ret = json_common_batch_data_add(dummy.root_obj,
 					 JSON_COMMON_MODEM_STATIC,
-					 &modem_static,
-					 ARRAY_SIZE(modem_static),
+					 batch.modem_static,
+					 ARRAY_SIZE(batch.modem_static),
 					 DATA_MODEM_STATIC);
 	zassert_equal(0, ret, "Return value %d is wrong", ret);
 
@@ -840,6 +854,411 @@ static void test_encode_batch_data_object(void)
 	zassert_equal(-EINVAL, ret, "Return value %d is wrong.", ret);
 }
 
+static void test_encode_batch_data_stream(void)
+{
+	int ret;
+	struct json_writer writer;
+	struct cloud_codec_data output = {0};
+	struct batch_data batch = batch_template;
+	const struct json_common_batch_section sections[] = {
+		{ JSON_COMMON_BATTERY, batch.battery, ARRAY_SIZE(batch.battery), DATA_BATTERY },
+		{ JSON_COMMON_UI, batch.ui, ARRAY_SIZE(batch.ui), DATA_BUTTON },
+		{ JSON_COMMON_GPS, batch.gps, ARRAY_SIZE(batch.gps), DATA_GPS },
+		{ JSON_COMMON_SENSOR, batch.environmental, ARRAY_SIZE(batch.environmental),
+		  DATA_ENVIRONMENTALS },
+		{ JSON_COMMON_ACCELEROMETER, batch.accelerometer, ARRAY_SIZE(batch.accelerometer),
+		  DATA_MOVEMENT },
+		{ JSON_COMMON_MODEM_DYNAMIC, batch.modem_dynamic, ARRAY_SIZE(batch.modem_dynamic),
+		  DATA_MODEM_DYNAMIC },
+		{ JSON_COMMON_MODEM_STATIC, batch.modem_static, ARRAY_SIZE(batch.modem_static),
+		  DATA_MODEM_STATIC },
+	};
+
+	ret = json_common_batch_data_encode(&output, sections, ARRAY_SIZE(sections));
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(strlen(TEST_VALIDATE_BATCH_JSON_SCHEMA), output.len, "Length is wrong");
+	zassert_equal(0, strcmp(TEST_VALIDATE_BATCH_JSON_SCHEMA, output.buf),
+		      "Encoded output is wrong");
+
+	cloud_codec_release_data(&output);
+
+	for (size_t i = 0; i < ARRAY_SIZE(batch.gps); i++) {
+		zassert_false(batch.gps[i].queued, "Entry is still queued");
+		zassert_false(batch.modem_static[i].queued, "Entry is still queued");
+	}
+
+	/* All entries have been encoded. */
+	ret = json_common_batch_data_encode(&output, sections, ARRAY_SIZE(sections));
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong.", ret);
+
+	/* An entry without fresh values is skipped, and the array is not written if it is the
+	 * only entry.
+	 */
+	batch.modem_dynamic[0].queued = true;
+	batch.modem_dynamic[0].rsrp_fresh = false;
+	batch.modem_dynamic[0].area_code_fresh = false;
+	batch.modem_dynamic[0].mccmnc_fresh = false;
+	batch.modem_dynamic[0].cell_id_fresh = false;
+	batch.modem_dynamic[0].ip_address_fresh = false;
+
+	ret = json_common_batch_data_encode(&output, sections, ARRAY_SIZE(sections));
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong.", ret);
+	zassert_false(batch.modem_dynamic[0].queued, "Entry is still queued");
+
+	/* Check for invalid inputs. */
+
+	ret = json_common_batch_data_write(NULL, -1, NULL, 0, "");
+	zassert_equal(-ENOMEM, ret, "Return value %d is wrong.", ret);
+
+	json_writer_init(&writer, NULL, 0, NULL, NULL);
+
+	ret = json_common_batch_data_write(&writer, -1, NULL, 0, NULL);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong.", ret);
+}
+
+/* Streaming JSON writer */
+
+static struct {
+	char buf[256];
+	size_t len;
+	size_t flush_count;
+} chunks;
+
+static int chunk_flush(const char *buf, size_t len, void *user_data)
+{
+	if (user_data != &chunks) {
+		return -EINVAL;
+	}
+
+	if (len > sizeof(chunks.buf) - chunks.len) {
+		return -ENOSPC;
+	}
+
+	memcpy(&chunks.buf[chunks.len], buf, len);
+	chunks.len += len;
+	chunks.flush_count++;
+
+	return 0;
+}
+
+static const char writer_string[] = "quote\" backslash\\ newline\n tab\t bell\a end";
+static const double writer_numbers[] = { 0, -0.0, -1, 0.1, 62.4213123, -3.5e-7,
+						1563968747123 };
+
+static void writer_values_write(struct json_writer *writer)
+{
+	json_writer_object_start(writer, NULL);
+	json_writer_str(writer, "str", writer_string);
+	json_writer_array_start(writer, "num");
+	for (size_t i = 0; i < ARRAY_SIZE(writer_numbers); i++) {
+		json_writer_number(writer, NULL, writer_numbers[i]);
+	}
+	json_writer_array_end(writer);
+	json_writer_object_start(writer, "obj");
+	json_writer_bool(writer, "t", true);
+	json_writer_bool(writer, "f", false);
+	json_writer_object_end(writer);
+	json_writer_array_start(writer, "empty");
+	json_writer_array_end(writer);
+	json_writer_object_end(writer);
+}
+
+static char *writer_values_print(void)
+{
+	char *buffer;
+	cJSON *root_obj = cJSON_CreateObject();
+	cJSON *array_obj = cJSON_CreateArray();
+	cJSON *obj = cJSON_CreateObject();
+
+	json_add_str(root_obj, "str", writer_string);
+	for (size_t i = 0; i < ARRAY_SIZE(writer_numbers); i++) {
+		json_add_obj_array(array_obj, cJSON_CreateNumber(writer_numbers[i]));
+	}
+	json_add_obj(root_obj, "num", array_obj);
+	json_add_bool(obj, "t", true);
+	json_add_bool(obj, "f", false);
+	json_add_obj(root_obj, "obj", obj);
+	json_add_obj(root_obj, "empty", cJSON_CreateArray());
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	cJSON_Delete(root_obj);
+
+	return buffer;
+}
+
+static void test_json_writer(void)
+{
+	int ret;
+	char buf[256];
+	char chunk[16];
+	struct json_writer writer;
+	char *expected = writer_values_print();
+
+	zassert_not_null(expected, "Printed JSON string is NULL");
+
+	/* Buffered output. */
+	json_writer_init(&writer, buf, sizeof(buf), NULL, NULL);
+	writer_values_write(&writer);
+	ret = json_writer_finish(&writer);
+	zassert_equal(strlen(expected), ret, "Return value %d is wrong", ret);
+	zassert_equal(0, strcmp(expected, buf), "Output is not identical to cJSON output");
+
+	/* Length measurement. */
+	json_writer_init(&writer, NULL, 0, NULL, NULL);
+	writer_values_write(&writer);
+	ret = json_writer_finish(&writer);
+	zassert_equal(strlen(expected), ret, "Return value %d is wrong", ret);
+
+	/* Chunked output. */
+	memset(&chunks, 0, sizeof(chunks));
+	json_writer_init(&writer, chunk, sizeof(chunk), chunk_flush, &chunks);
+	writer_values_write(&writer);
+	ret = json_writer_finish(&writer);
+	zassert_equal(strlen(expected), ret, "Return value %d is wrong", ret);
+	zassert_equal(ceiling_fraction(ret, sizeof(chunk)), chunks.flush_count,
+		      "Number of flushes is wrong");
+	zassert_equal(strlen(expected), chunks.len, "Length is wrong");
+	zassert_mem_equal(expected, chunks.buf, chunks.len,
+			  "Output is not identical to cJSON output");
+
+	/* Output not fitting the buffer. The null terminator must fit too. */
+	json_writer_init(&writer, buf, strlen(expected), NULL, NULL);
+	writer_values_write(&writer);
+	ret = json_writer_finish(&writer);
+	zassert_equal(-ENOMEM, ret, "Return value %d is wrong.", ret);
+
+	/* Flush error. */
+	json_writer_init(&writer, chunk, sizeof(chunk), chunk_flush, &chunks);
+	chunks.len = sizeof(chunks.buf);
+	writer_values_write(&writer);
+	ret = json_writer_finish(&writer);
+	zassert_equal(-ENOSPC, ret, "Return value %d is wrong.", ret);
+
+	/* Unclosed object. */
+	json_writer_init(&writer, buf, sizeof(buf), NULL, NULL);
+	json_writer_object_start(&writer, NULL);
+	ret = json_writer_finish(&writer);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong.", ret);
+
+	cJSON_FreeString(expected);
+}
+
+/* Benchmark comparing the cost of encoding a batch message with all ringbuffers of the data
+ * module full, at their default sizes, by building cJSON objects and by streaming.
+ *
+ * Note that on native_posix the cycle counter is driven by simulated time, so the encode time
+ * is only meaningful when run on hardware.
+ */
+
+#define BENCHMARK_GPS_COUNT		10
+#define BENCHMARK_SENSOR_COUNT		10
+#define BENCHMARK_MODEM_DYNAMIC_COUNT	3
+#define BENCHMARK_UI_COUNT		3
+#define BENCHMARK_ACCELEROMETER_COUNT	3
+#define BENCHMARK_BATTERY_COUNT		3
+
+/* Size of the header storing the size of each allocation, keeping the alignment. */
+#define BENCHMARK_ALLOC_HDR_SIZE	8
+
+static struct {
+	struct cloud_data_gps gps[BENCHMARK_GPS_COUNT];
+	struct cloud_data_sensors sensors[BENCHMARK_SENSOR_COUNT];
+	struct cloud_data_modem_dynamic modem_dynamic[BENCHMARK_MODEM_DYNAMIC_COUNT];
+	struct cloud_data_ui ui[BENCHMARK_UI_COUNT];
+	struct cloud_data_accelerometer accelerometer[BENCHMARK_ACCELEROMETER_COUNT];
+	struct cloud_data_battery battery[BENCHMARK_BATTERY_COUNT];
+} bench;
+
+static const struct json_common_batch_section bench_sections[] = {
+	{ JSON_COMMON_MODEM_DYNAMIC, bench.modem_dynamic, BENCHMARK_MODEM_DYNAMIC_COUNT,
+	  DATA_MODEM_DYNAMIC },
+	{ JSON_COMMON_GPS, bench.gps, BENCHMARK_GPS_COUNT, DATA_GPS },
+	{ JSON_COMMON_SENSOR, bench.sensors, BENCHMARK_SENSOR_COUNT, DATA_ENVIRONMENTALS },
+	{ JSON_COMMON_UI, bench.ui, BENCHMARK_UI_COUNT, DATA_BUTTON },
+	{ JSON_COMMON_BATTERY, bench.battery, BENCHMARK_BATTERY_COUNT, DATA_BATTERY },
+	{ JSON_COMMON_ACCELEROMETER, bench.accelerometer, BENCHMARK_ACCELEROMETER_COUNT,
+	  DATA_MOVEMENT },
+};
+
+static struct {
+	size_t allocs;
+	size_t used;
+	size_t peak;
+} heap_stats;
+
+static void *counting_malloc(size_t size)
+{
+	uint8_t *ptr = k_malloc(size + BENCHMARK_ALLOC_HDR_SIZE);
+
+	if (ptr == NULL) {
+		return NULL;
+	}
+
+	*(size_t *)ptr = size;
+
+	heap_stats.allocs++;
+	heap_stats.used += size;
+	heap_stats.peak = MAX(heap_stats.peak, heap_stats.used);
+
+	return ptr + BENCHMARK_ALLOC_HDR_SIZE;
+}
+
+static void counting_free(void *ptr)
+{
+	uint8_t *hdr = (uint8_t *)ptr - BENCHMARK_ALLOC_HDR_SIZE;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	heap_stats.used -= *(size_t *)hdr;
+	k_free(hdr);
+}
+
+static void bench_fill(void)
+{
+	memset(&bench, 0, sizeof(bench));
+
+	for (size_t i = 0; i < BENCHMARK_GPS_COUNT; i++) {
+		bench.gps[i].pvt.longi = 10.4273551 + i * 0.0001;
+		bench.gps[i].pvt.lat = 63.4214783 - i * 0.0001;
+		bench.gps[i].pvt.acc = 12.7;
+		bench.gps[i].pvt.alt = 171.4 + i;
+		bench.gps[i].pvt.spd = 0.31;
+		bench.gps[i].pvt.hdg = 176.2;
+		bench.gps[i].gps_ts = 1000 + i;
+		bench.gps[i].format = CLOUD_CODEC_GPS_FORMAT_PVT;
+		bench.gps[i].queued = true;
+	}
+
+	for (size_t i = 0; i < BENCHMARK_SENSOR_COUNT; i++) {
+		bench.sensors[i].temp = 22.8 + i * 0.1;
+		bench.sensors[i].hum = 47.3;
+		bench.sensors[i].env_ts = 1000 + i;
+		bench.sensors[i].queued = true;
+	}
+
+	for (size_t i = 0; i < BENCHMARK_MODEM_DYNAMIC_COUNT; i++) {
+		bench.modem_dynamic[i].rsrp = -80 - i;
+		bench.modem_dynamic[i].area = 2305;
+		strcpy(bench.modem_dynamic[i].mccmnc, "24202");
+		bench.modem_dynamic[i].cell = 33703719;
+		strcpy(bench.modem_dynamic[i].ip, "10.81.183.99");
+		bench.modem_dynamic[i].rsrp_fresh = true;
+		bench.modem_dynamic[i].area_code_fresh = true;
+		bench.modem_dynamic[i].mccmnc_fresh = true;
+		bench.modem_dynamic[i].cell_id_fresh = true;
+		bench.modem_dynamic[i].ip_address_fresh = true;
+		bench.modem_dynamic[i].ts = 1000 + i;
+		bench.modem_dynamic[i].queued = true;
+	}
+
+	for (size_t i = 0; i < BENCHMARK_UI_COUNT; i++) {
+		bench.ui[i].btn = 1;
+		bench.ui[i].btn_ts = 1000 + i;
+		bench.ui[i].queued = true;
+	}
+
+	for (size_t i = 0; i < BENCHMARK_ACCELEROMETER_COUNT; i++) {
+		bench.accelerometer[i].values[0] = 0.12 * i;
+		bench.accelerometer[i].values[1] = -9.81;
+		bench.accelerometer[i].values[2] = 0.4;
+		bench.accelerometer[i].ts = 1000 + i;
+		bench.accelerometer[i].queued = true;
+	}
+
+	for (size_t i = 0; i < BENCHMARK_BATTERY_COUNT; i++) {
+		bench.battery[i].bat = 3650 - i;
+		bench.battery[i].bat_ts = 1000 + i;
+		bench.battery[i].queued = true;
+	}
+}
+
+/* Encode the batch message in the same way as the cloud codecs do without streaming. */
+static char *bench_cjson_encode(void)
+{
+	int err;
+	char *buffer;
+	cJSON *root_obj = cJSON_CreateObject();
+
+	if (root_obj == NULL) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(bench_sections); i++) {
+		err = json_common_batch_data_add(root_obj, bench_sections[i].type,
+						 bench_sections[i].buf,
+						 bench_sections[i].buf_count,
+						 bench_sections[i].object_label);
+		if (err) {
+			cJSON_Delete(root_obj);
+			return NULL;
+		}
+	}
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	cJSON_Delete(root_obj);
+
+	return buffer;
+}
+
+static void test_batch_encode_benchmark(void)
+{
+	int ret;
+	uint32_t cycles;
+	struct cloud_codec_data output = {0};
+	char *cjson_buffer;
+	size_t cjson_allocs;
+	size_t cjson_peak;
+	uint32_t cjson_cycles;
+	cJSON_Hooks hooks = {
+		.malloc_fn = counting_malloc,
+		.free_fn = counting_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+
+	bench_fill();
+	memset(&heap_stats, 0, sizeof(heap_stats));
+
+	cycles = k_cycle_get_32();
+	cjson_buffer = bench_cjson_encode();
+	cjson_cycles = k_cycle_get_32() - cycles;
+
+	zassert_not_null(cjson_buffer, "Printed JSON string is NULL");
+
+	cjson_allocs = heap_stats.allocs;
+	cjson_peak = heap_stats.peak;
+
+	bench_fill();
+	memset(&heap_stats, 0, sizeof(heap_stats));
+
+	cycles = k_cycle_get_32();
+	ret = json_common_batch_data_encode(&output, bench_sections, ARRAY_SIZE(bench_sections));
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(strlen(cjson_buffer), output.len, "Length is wrong");
+	zassert_equal(0, strcmp(cjson_buffer, output.buf),
+		      "Output is not identical to cJSON output");
+
+	TC_PRINT("Encoding a %d byte batch message:\n", (int)output.len);
+	TC_PRINT("cJSON:     %d allocations, %d bytes heap peak, %u cycles\n",
+		 (int)cjson_allocs, (int)cjson_peak, cjson_cycles);
+	TC_PRINT("Streaming: %d allocations, %d bytes heap peak, %u cycles\n",
+		 (int)heap_stats.allocs, (int)heap_stats.peak, cycles);
+
+	zassert_equal(1, heap_stats.allocs, "Streaming encoder allocates more than the output");
+	zassert_equal(output.len + 1, heap_stats.peak, "Heap peak is larger than the output");
+	zassert_true(heap_stats.peak < cjson_peak, "Streaming does not reduce heap peak");
+
+	cJSON_free(cjson_buffer);
+	cJSON_free(output.buf);
+
+	/* Restore the default hooks. */
+	cJSON_Init();
+}
+
 /* Test used to verify encoding and decoding of data structures that contain floating point
  * values. Floating point values cannot be exactly represented in binary so they cannot be compared
  * with a predefined JSON string schema.
@@ -1164,6 +1583,13 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_encode_batch_data_object,
 					       test_setup_object,
 					       test_teardown_object),
+		ztest_unit_test(test_encode_batch_data_stream),
+
+		/* Streaming JSON writer */
+		ztest_unit_test(test_json_writer),
+
+		/* Batch encoding benchmark */
+		ztest_unit_test(test_batch_encode_benchmark),
 
 		/* GPS floating point values comparison */
 		ztest_unit_test_setup_teardown(test_floating_point_encoding_gps,
@@ -26,12 +26,18 @@
 extern "C" {
 #endif
 
+/** @brief Maximum number of HID reports of the same type sent to a subscriber
+ *  before the report sent event is received.
+ */
+#define HID_REPORT_PIPELINE_DEPTH_MAX 2
+
 
 /** @brief HID report event. */
 struct hid_report_event {
 	struct event_header header; /**< Event header. */
 
 	const void *subscriber; /**< Id of the report subscriber. */
+	uint32_t timestamp; /**< Time of the oldest input in the report, in hardware cycles. */
 	struct event_dyndata dyndata; /**< Report data. The first byte is a report id. */
 };
 
@@ -56,6 +62,7 @@ struct hid_report_sent_event {
 	const void *subscriber; /**< Id of the report subscriber. */
 	uint8_t report_id; /**< Report id. */
 	bool error; /**< If true error occured on send. */
+	uint32_t timestamp; /**< Time of the send completion, in hardware cycles. */
 };
 
 EVENT_TYPE_DECLARE(hid_report_sent_event);
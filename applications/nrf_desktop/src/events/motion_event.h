@@ -24,6 +24,7 @@ struct motion_event {
 
 	int16_t dx;
 	int16_t dy;
+	uint32_t timestamp; /**< Time of the sample, in hardware cycles. */
 };
 
 EVENT_TYPE_DECLARE(motion_event);
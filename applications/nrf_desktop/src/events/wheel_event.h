@@ -23,6 +23,7 @@ struct wheel_event {
 	struct event_header header;
 
 	int16_t wheel;
+	uint32_t timestamp; /**< Time of the rotation, in hardware cycles. */
 };
 
 EVENT_TYPE_DECLARE(wheel_event);
@@ -66,6 +66,7 @@ static void send_button_event(uint16_t key_id, bool pressed)
 
 	event->key_id = key_id;
 	event->pressed = pressed;
+	event->timestamp = k_cycle_get_32();
 	EVENT_SUBMIT(event);
 }
 
@@ -51,6 +51,7 @@ struct sensor_state {
 
 	enum state state;
 	bool sample;
+	uint32_t sample_timestamp;
 	uint8_t peer_count;
 	uint32_t option[MOTION_SENSOR_OPTION_COUNT];
 	uint32_t option_mask;
@@ -191,6 +192,7 @@ static void data_ready_handler(const struct device *dev, struct sensor_trigger *
 	case STATE_IDLE:
 		state.state = STATE_FETCHING;
 		state.sample = true;
+		state.sample_timestamp = k_cycle_get_32();
 		/* Fall-through */
 
 	case STATE_DISCONNECTED:
@@ -219,7 +221,7 @@ static void data_ready_handler(const struct device *dev, struct sensor_trigger *
 	k_spin_unlock(&state.lock, key);
 }
 
-static int motion_read(bool send_event)
+static int motion_read(bool send_event, uint32_t timestamp)
 {
 	struct sensor_value value_x;
 	struct sensor_value value_y;
@@ -256,6 +258,7 @@ static int motion_read(bool send_event)
 
 	event->dx = value_x.val1;
 	event->dy = value_y.val1;
+	event->timestamp = timestamp;
 	EVENT_SUBMIT(event);
 
 	return err;
@@ -474,6 +477,7 @@ static void motion_thread_fn(void)
 
 	while (!err) {
 		bool send_event;
+		uint32_t timestamp;
 		uint32_t option_bm;
 
 		k_sem_take(&sem, K_FOREVER);
@@ -481,10 +485,11 @@ static void motion_thread_fn(void)
 		k_spinlock_key_t key = k_spin_lock(&state.lock);
 		send_event = (state.state == STATE_FETCHING) && state.sample;
 		state.sample = false;
+		timestamp = state.sample_timestamp;
 		option_bm = state.option_mask;
 		k_spin_unlock(&state.lock, key);
 
-		err = motion_read(send_event);
+		err = motion_read(send_event, timestamp);
 
 		bool no_motion = (err == -ENODATA);
 		if (unlikely(no_motion)) {
@@ -539,6 +544,7 @@ static bool event_handler(const struct event_header *eh)
 			k_spinlock_key_t key = k_spin_lock(&state.lock);
 			if (state.state == STATE_FETCHING) {
 				state.sample = true;
+				state.sample_timestamp = k_cycle_get_32();
 				k_sem_give(&sem);
 			}
 			k_spin_unlock(&state.lock, key);
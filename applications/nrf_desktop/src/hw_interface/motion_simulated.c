@@ -69,6 +69,7 @@ static void motion_event_send(int16_t dx, int16_t dy)
 
 	event->dx = dx;
 	event->dy = dy;
+	event->timestamp = k_cycle_get_32();
 	EVENT_SUBMIT(event);
 }
 
@@ -58,6 +58,8 @@ static int enable_qdec(enum state next_state);
 
 static void data_ready_handler(const struct device *dev, struct sensor_trigger *trig)
 {
+	uint32_t timestamp = k_cycle_get_32();
+
 	if (IS_ENABLED(CONFIG_ASSERT)) {
 		k_spinlock_key_t key = k_spin_lock(&lock);
 
@@ -89,6 +91,7 @@ static void data_ready_handler(const struct device *dev, struct sensor_trigger *
 	}
 
 	event->wheel = MAX(MIN(wheel, SCHAR_MAX), SCHAR_MIN);
+	event->timestamp = timestamp;
 
 	EVENT_SUBMIT(event);
 
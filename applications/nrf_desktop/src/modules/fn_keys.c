@@ -177,6 +177,7 @@ static bool button_event_handler(const struct button_event *event)
 		new_event->pressed = true;
 		new_event->key_id = FN_KEY_ID(KEY_COL(event->key_id),
 					      KEY_ROW(event->key_id));
+		new_event->timestamp = event->timestamp;
 		EVENT_SUBMIT(new_event);
 
 		return true;
@@ -202,6 +203,7 @@ static bool button_event_handler(const struct button_event *event)
 			new_event->pressed = false;
 			new_event->key_id = FN_KEY_ID(KEY_COL(event->key_id),
 						      KEY_ROW(event->key_id));
+			new_event->timestamp = event->timestamp;
 			EVENT_SUBMIT(new_event);
 
 			return true;
@@ -16,6 +16,7 @@
 
 #include "hid_report_desc.h"
 #include "config_channel_transport.h"
+#include "hid_report_merge.h"
 
 #include "hid_event.h"
 #include <caf/events/ble_common_event.h>
@@ -52,10 +53,35 @@ struct enqueued_reports {
 	uint8_t last_idx;
 };
 
+struct forward_stats {
+	uint32_t forwarded; /**< Reports submitted to the subscriber. */
+	uint32_t merged; /**< Reports merged into an enqueued report. */
+	uint32_t dropped; /**< Enqueued reports that were not sent. */
+};
+
+enum hid_forward_opt {
+	HID_FORWARD_OPT_FORWARDED,
+	HID_FORWARD_OPT_MERGED,
+	HID_FORWARD_OPT_DROPPED,
+	HID_FORWARD_OPT_RESET,
+
+	HID_FORWARD_OPT_COUNT
+};
+
+static const char * const opt_descr[] = {
+	[HID_FORWARD_OPT_FORWARDED] = "forwarded",
+	[HID_FORWARD_OPT_MERGED] = "merged",
+	[HID_FORWARD_OPT_DROPPED] = "dropped",
+	[HID_FORWARD_OPT_RESET] = "reset"
+};
+
+BUILD_ASSERT(ARRAY_SIZE(opt_descr) == HID_FORWARD_OPT_COUNT);
+
 struct subscriber {
 	const void *id;
 	uint32_t enabled_reports_bm;
 	struct enqueued_reports enqueued_reports;
+	struct forward_stats stats;
 	bool busy;
 	uint8_t last_peripheral_id;
 };
@@ -218,7 +244,8 @@ static struct enqueued_report *get_enqueued_report(struct enqueued_reports *enqu
 	return item;
 }
 
-static void drop_enqueued_reports(struct enqueued_reports *enqueued_reports,
+static void drop_enqueued_reports(struct subscriber *sub,
+				  struct enqueued_reports *enqueued_reports,
 				  size_t irep_idx)
 {
 	__ASSERT_NO_MSG(irep_idx < ARRAY_SIZE(enqueued_reports->reports));
@@ -230,6 +257,8 @@ static void drop_enqueued_reports(struct enqueued_reports *enqueued_reports,
 
 		k_free(item->report);
 		k_free(item);
+
+		sub->stats.dropped++;
 	}
 }
 
@@ -306,7 +335,38 @@ static void migrate_enqueued_reports(struct enqueued_reports *dst_reports,
 	}
 }
 
-static void enqueue_hid_report(struct enqueued_reports *enqueued_reports,
+static bool merge_hid_report(struct hid_report_event *dst,
+			     const struct hid_report_event *src)
+{
+	if (dst->dyndata.size != src->dyndata.size) {
+		return false;
+	}
+
+	uint8_t report_id = src->dyndata.data[0];
+	uint8_t *dst_data = &dst->dyndata.data[1];
+	const uint8_t *src_data = &src->dyndata.data[1];
+	size_t size = src->dyndata.size - sizeof(report_id);
+
+	switch (report_id) {
+	case REPORT_ID_MOUSE:
+		/* Relative axes are accumulated. */
+		return (size == REPORT_SIZE_MOUSE) &&
+		       hid_report_merge_mouse(dst_data, src_data);
+
+	case REPORT_ID_BOOT_MOUSE:
+		return (size == REPORT_SIZE_MOUSE_BOOT) &&
+		       hid_report_merge_boot_mouse(dst_data, src_data);
+
+	default:
+		/* Other reports hold an absolute state. A report that repeats
+		 * the newest enqueued state carries no new information.
+		 */
+		return !memcmp(dst_data, src_data, size);
+	}
+}
+
+static void enqueue_hid_report(struct subscriber *sub,
+			       struct enqueued_reports *enqueued_reports,
 			       size_t irep_idx,
 			       struct hid_report_event *report)
 {
@@ -316,12 +376,28 @@ static void enqueue_hid_report(struct enqueued_reports *enqueued_reports,
 
 	struct enqueued_report *item;
 
+	if (reports->count > 0) {
+		/* Try to merge with the newest enqueued report first. The
+		 * merged report keeps the timestamp of the older input.
+		 */
+		item = CONTAINER_OF(sys_slist_peek_tail(&reports->list),
+				    __typeof__(*item),
+				    node);
+
+		if (merge_hid_report(item->report, report)) {
+			k_free(report);
+			sub->stats.merged++;
+			return;
+		}
+	}
+
 	if (reports->count < MAX_ENQUEUED_ITEMS) {
 		item = k_malloc(sizeof(*item));
 	} else {
 		LOG_WRN("Enqueue dropped the oldest report");
 		item = get_enqueued_report(enqueued_reports, irep_idx);
 		k_free(item->report);
+		sub->stats.dropped++;
 	}
 
 	if (!item) {
@@ -366,6 +442,7 @@ static void forward_hid_report(struct hids_peripheral *per, uint8_t report_id,
 	struct hid_report_event *report = new_hid_report_event(size + sizeof(report_id));
 
 	report->subscriber = sub->id;
+	report->timestamp = k_cycle_get_32();
 
 	/* Forward report as is adding report id on the front. */
 	report->dyndata.data[0] = report_id;
@@ -376,9 +453,12 @@ static void forward_hid_report(struct hids_peripheral *per, uint8_t report_id,
 
 		EVENT_SUBMIT(report);
 		per->enqueued_reports.last_idx = irep_idx;
+		/* Let other peripherals go first when subscriber is busy. */
+		sub->last_peripheral_id = per - peripherals;
 		sub->busy = true;
+		sub->stats.forwarded++;
 	} else {
-		enqueue_hid_report(&per->enqueued_reports, irep_idx, report);
+		enqueue_hid_report(sub, &per->enqueued_reports, irep_idx, report);
 	}
 }
 
@@ -754,6 +834,11 @@ static bool handle_config_event(struct config_event *event)
 		return true;
 	}
 
+	/* Other local requests access the options of this module. */
+	if (event->recipient == CFG_CHAN_RECIPIENT_LOCAL) {
+		return false;
+	}
+
 	struct hids_peripheral *per = find_peripheral(event->recipient);
 
 	if (!per) {
@@ -879,6 +964,13 @@ static void disconnect_peripheral(struct hids_peripheral *per)
 				 &per->enqueued_reports);
 	__ASSERT_NO_MSG(!is_any_report_enqueued(&per->enqueued_reports));
 
+	const struct forward_stats *stats = &get_subscriber(per)->stats;
+
+	LOG_INF("Subscriber %p reports: %" PRIu32 " forwarded, %" PRIu32
+		" merged, %" PRIu32 " dropped",
+		get_subscriber(per)->id, stats->forwarded, stats->merged,
+		stats->dropped);
+
 	bt_hogp_release(&per->hogp);
 	/* Cancel cannot fail if executed from another work's context. */
 	(void)k_work_cancel_delayable(&per->read_rsp);
@@ -924,11 +1016,11 @@ static void disable_subscription(struct subscriber *sub, uint8_t report_id)
 			continue;
 		}
 
-		drop_enqueued_reports(&per->enqueued_reports, irep_idx);
+		drop_enqueued_reports(sub, &per->enqueued_reports, irep_idx);
 	}
 
 	/* And also this subscriber. */
-	drop_enqueued_reports(&sub->enqueued_reports, irep_idx);
+	drop_enqueued_reports(sub, &sub->enqueued_reports, irep_idx);
 }
 
 static void hogp_ready(struct bt_hogp *hids_c)
@@ -1022,7 +1114,60 @@ static void send_enqueued_report(struct subscriber *sub)
 		k_free(item);
 
 		sub->busy = true;
+		sub->stats.forwarded++;
+	}
+}
+
+static void update_config(const uint8_t opt_id, const uint8_t *data,
+			  const size_t size)
+{
+	switch (opt_id) {
+	case HID_FORWARD_OPT_RESET:
+		for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
+			memset(&subscribers[i].stats, 0,
+			       sizeof(subscribers[i].stats));
+		}
+		LOG_INF("Statistics reset");
+		break;
+
+	default:
+		LOG_WRN("Cannot set opt: %" PRIu8, opt_id);
+		break;
+	}
+}
+
+static void fetch_config(const uint8_t opt_id, uint8_t *data, size_t *size)
+{
+	/* A counter of every subscriber is fetched in one response. */
+	BUILD_ASSERT(ARRAY_SIZE(subscribers) * sizeof(uint32_t) <=
+		     CONFIG_CHANNEL_FETCHED_DATA_MAX_SIZE);
+
+	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
+		const struct forward_stats *stats = &subscribers[i].stats;
+		uint32_t cnt;
+
+		switch (opt_id) {
+		case HID_FORWARD_OPT_FORWARDED:
+			cnt = stats->forwarded;
+			break;
+
+		case HID_FORWARD_OPT_MERGED:
+			cnt = stats->merged;
+			break;
+
+		case HID_FORWARD_OPT_DROPPED:
+			cnt = stats->dropped;
+			break;
+
+		default:
+			LOG_WRN("Cannot fetch opt: %" PRIu8, opt_id);
+			return;
+		}
+
+		sys_put_le32(cnt, &data[i * sizeof(uint32_t)]);
 	}
+
+	*size = ARRAY_SIZE(subscribers) * sizeof(uint32_t);
 }
 
 static bool event_handler(const struct event_header *eh)
@@ -1150,11 +1295,15 @@ static bool event_handler(const struct event_header *eh)
 	}
 
 	if (IS_ENABLED(CONFIG_DESKTOP_CONFIG_CHANNEL_ENABLE)) {
-		if (is_config_event(eh)) {
-			return handle_config_event(cast_config_event(eh));
+		if (is_config_event(eh) &&
+		    handle_config_event(cast_config_event(eh))) {
+			return true;
 		}
 	}
 
+	GEN_CONFIG_EVENT_HANDLERS(STRINGIFY(MODULE), opt_descr, update_config,
+				  fetch_config);
+
 	/* If event is unhandled, unsubscribe. */
 	__ASSERT_NO_MSG(false);
 
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <sys/byteorder.h>
+
+#include "hid_event.h"
+#include "usb_event.h"
+#include "config_event.h"
+#include <caf/events/ble_common_event.h>
+
+#define MODULE hid_latency
+#include <caf/events/module_state_event.h>
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_DESKTOP_HID_LATENCY_LOG_LEVEL);
+
+#define BUCKET_COUNT		8
+#define BUCKET_BASE_US		CONFIG_DESKTOP_HID_LATENCY_BUCKET_US
+#define SUBSCRIBER_COUNT	CONFIG_DESKTOP_HID_LATENCY_SUBSCRIBER_COUNT
+
+/* Maximum number of reports of the same type sent to a subscriber at a time. */
+#define PIPELINE_DEPTH		HID_REPORT_PIPELINE_DEPTH_MAX
+
+enum transport {
+	TRANSPORT_BLE,
+	TRANSPORT_USB,
+
+	TRANSPORT_COUNT
+};
+
+enum stage {
+	STAGE_INPUT,
+	STAGE_SEND,
+	STAGE_TOTAL,
+
+	STAGE_COUNT
+};
+
+enum hid_latency_opt {
+	HID_LATENCY_OPT_BLE_INPUT,
+	HID_LATENCY_OPT_BLE_SEND,
+	HID_LATENCY_OPT_BLE_TOTAL,
+	HID_LATENCY_OPT_USB_INPUT,
+	HID_LATENCY_OPT_USB_SEND,
+	HID_LATENCY_OPT_USB_TOTAL,
+	HID_LATENCY_OPT_BUCKET,
+	HID_LATENCY_OPT_RESET,
+
+	HID_LATENCY_OPT_COUNT
+};
+
+static const char * const opt_descr[] = {
+	[HID_LATENCY_OPT_BLE_INPUT] = "ble_input",
+	[HID_LATENCY_OPT_BLE_SEND] = "ble_send",
+	[HID_LATENCY_OPT_BLE_TOTAL] = "ble_total",
+	[HID_LATENCY_OPT_USB_INPUT] = "usb_input",
+	[HID_LATENCY_OPT_USB_SEND] = "usb_send",
+	[HID_LATENCY_OPT_USB_TOTAL] = "usb_total",
+	[HID_LATENCY_OPT_BUCKET] = "bucket",
+	[HID_LATENCY_OPT_RESET] = "reset"
+};
+
+/* Histogram options follow the transport and stage order. */
+BUILD_ASSERT(HID_LATENCY_OPT_BUCKET == TRANSPORT_COUNT * STAGE_COUNT);
+BUILD_ASSERT(ARRAY_SIZE(opt_descr) == HID_LATENCY_OPT_COUNT);
+
+/* Histogram of a single stage is fetched in one response. */
+BUILD_ASSERT(BUCKET_COUNT * sizeof(uint16_t) <=
+	     CONFIG_CHANNEL_FETCHED_DATA_MAX_SIZE);
+
+struct report_timestamps {
+	uint32_t input; /**< Time of the oldest input in the report. */
+	uint32_t report; /**< Time of the report reception by the transport. */
+};
+
+struct report_fifo {
+	struct report_timestamps item[PIPELINE_DEPTH];
+	uint8_t first;
+	uint8_t count;
+};
+
+struct subscriber {
+	const void *id;
+	enum transport transport;
+	struct report_fifo fifo[REPORT_ID_COUNT];
+};
+
+static struct subscriber subscribers[SUBSCRIBER_COUNT];
+static uint16_t histogram[TRANSPORT_COUNT][STAGE_COUNT][BUCKET_COUNT];
+
+
+static struct subscriber *get_subscriber(const void *id)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
+		if (subscribers[i].id == id) {
+			return &subscribers[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void connect_subscriber(const void *id, enum transport transport)
+{
+	struct subscriber *sub = get_subscriber(NULL);
+
+	if (!sub) {
+		LOG_WRN("Cannot track subscriber %p", id);
+		return;
+	}
+
+	memset(sub, 0, sizeof(*sub));
+	sub->id = id;
+	sub->transport = transport;
+}
+
+static void disconnect_subscriber(const void *id)
+{
+	struct subscriber *sub = get_subscriber(id);
+
+	if (sub) {
+		sub->id = NULL;
+	}
+}
+
+static void record(enum transport transport, enum stage stage,
+		   uint32_t start, uint32_t end)
+{
+	uint32_t us = k_cyc_to_us_floor32(end - start);
+	uint32_t ratio = us / BUCKET_BASE_US;
+	size_t bucket = 0;
+
+	/* Bucket n holds latencies below BUCKET_BASE_US * 2^n. */
+	if (ratio > 0) {
+		bucket = MIN(32 - __builtin_clz(ratio), BUCKET_COUNT - 1);
+	}
+
+	uint16_t *cnt = &histogram[transport][stage][bucket];
+
+	if (*cnt < UINT16_MAX) {
+		(*cnt)++;
+	}
+}
+
+static void handle_hid_report_event(const struct hid_report_event *event)
+{
+	struct subscriber *sub = get_subscriber(event->subscriber);
+
+	if (!sub) {
+		return;
+	}
+
+	__ASSERT_NO_MSG(event->dyndata.size > 0);
+	uint8_t report_id = event->dyndata.data[0];
+
+	if (report_id >= ARRAY_SIZE(sub->fifo)) {
+		return;
+	}
+
+	struct report_fifo *fifo = &sub->fifo[report_id];
+
+	if (fifo->count == ARRAY_SIZE(fifo->item)) {
+		LOG_WRN("Report 0x%x to %p not tracked", report_id, sub->id);
+		return;
+	}
+
+	struct report_timestamps *ts =
+		&fifo->item[(fifo->first + fifo->count) % ARRAY_SIZE(fifo->item)];
+
+	/* The transport handles the report while the event is processed. */
+	ts->input = event->timestamp;
+	ts->report = k_cycle_get_32();
+	fifo->count++;
+
+	record(sub->transport, STAGE_INPUT, ts->input, ts->report);
+}
+
+static void handle_hid_report_sent_event(const struct hid_report_sent_event *event)
+{
+	struct subscriber *sub = get_subscriber(event->subscriber);
+
+	if (!sub || (event->report_id >= ARRAY_SIZE(sub->fifo))) {
+		return;
+	}
+
+	struct report_fifo *fifo = &sub->fifo[event->report_id];
+
+	if (fifo->count == 0) {
+		return;
+	}
+
+	const struct report_timestamps *ts = &fifo->item[fifo->first];
+
+	fifo->first = (fifo->first + 1) % ARRAY_SIZE(fifo->item);
+	fifo->count--;
+
+	if (event->error) {
+		return;
+	}
+
+	record(sub->transport, STAGE_SEND, ts->report, event->timestamp);
+	record(sub->transport, STAGE_TOTAL, ts->input, event->timestamp);
+}
+
+static void handle_ble_peer_event(const struct ble_peer_event *event)
+{
+	switch (event->state) {
+	case PEER_STATE_CONNECTED:
+		connect_subscriber(event->id, TRANSPORT_BLE);
+		break;
+
+	case PEER_STATE_DISCONNECTING:
+	case PEER_STATE_DISCONNECTED:
+		disconnect_subscriber(event->id);
+		break;
+
+	default:
+		/* Ignore. */
+		break;
+	}
+}
+
+static void handle_usb_hid_event(const struct usb_hid_event *event)
+{
+	if (event->enabled) {
+		connect_subscriber(event->id, TRANSPORT_USB);
+	} else {
+		disconnect_subscriber(event->id);
+	}
+}
+
+static void update_config(const uint8_t opt_id, const uint8_t *data,
+			  const size_t size)
+{
+	switch (opt_id) {
+	case HID_LATENCY_OPT_RESET:
+		memset(histogram, 0, sizeof(histogram));
+		LOG_INF("Histograms reset");
+		break;
+
+	default:
+		LOG_WRN("Cannot set opt: %" PRIu8, opt_id);
+		break;
+	}
+}
+
+static void fetch_config(const uint8_t opt_id, uint8_t *data, size_t *size)
+{
+	if (opt_id < HID_LATENCY_OPT_BUCKET) {
+		const uint16_t *cnt = histogram[opt_id / STAGE_COUNT][opt_id % STAGE_COUNT];
+
+		for (size_t i = 0; i < BUCKET_COUNT; i++) {
+			sys_put_le16(cnt[i], &data[i * sizeof(uint16_t)]);
+		}
+		*size = BUCKET_COUNT * sizeof(uint16_t);
+	} else if (opt_id == HID_LATENCY_OPT_BUCKET) {
+		sys_put_le32(BUCKET_BASE_US, data);
+		*size = sizeof(uint32_t);
+	} else {
+		LOG_WRN("Cannot fetch opt: %" PRIu8, opt_id);
+	}
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_hid_report_event(eh)) {
+		handle_hid_report_event(cast_hid_report_event(eh));
+
+		return false;
+	}
+
+	if (is_hid_report_sent_event(eh)) {
+		handle_hid_report_sent_event(cast_hid_report_sent_event(eh));
+
+		return false;
+	}
+
+	if (is_ble_peer_event(eh)) {
+		handle_ble_peer_event(cast_ble_peer_event(eh));
+
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_DESKTOP_USB_ENABLE) && is_usb_hid_event(eh)) {
+		handle_usb_hid_event(cast_usb_hid_event(eh));
+
+		return false;
+	}
+
+	if (is_module_state_event(eh)) {
+		const struct module_state_event *event =
+			cast_module_state_event(eh);
+
+		if (check_state(event, MODULE_ID(main), MODULE_STATE_READY)) {
+			module_set_state(MODULE_STATE_READY);
+		}
+
+		return false;
+	}
+
+	GEN_CONFIG_EVENT_HANDLERS(STRINGIFY(MODULE), opt_descr, update_config,
+				  fetch_config);
+
+	/* If event is unhandled, unsubscribe. */
+	__ASSERT_NO_MSG(false);
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, module_state_event);
+EVENT_SUBSCRIBE(MODULE, hid_report_event);
+EVENT_SUBSCRIBE(MODULE, hid_report_sent_event);
+EVENT_SUBSCRIBE(MODULE, ble_peer_event);
+#if CONFIG_DESKTOP_USB_ENABLE
+EVENT_SUBSCRIBE(MODULE, usb_hid_event);
+#endif
+EVENT_SUBSCRIBE_EARLY(MODULE, config_event);
@@ -69,6 +69,12 @@ enum state {
 
 #define AXIS_COUNT (IS_ENABLED(CONFIG_DESKTOP_HID_REPORT_MOUSE_SUPPORT) * MOUSE_REPORT_AXIS_COUNT)
 
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+  #define KEY_SLOT_COUNT	ARRAY_SIZE(hid_keymap)
+  #define KEY_BITMAP_SIZE	DIV_ROUND_UP(KEY_SLOT_COUNT, 32)
+  BUILD_ASSERT(KEY_SLOT_COUNT <= UINT8_MAX + 1, "Too many keys in hid_keymap");
+#endif
+
 
 /**@brief HID state item. */
 struct item {
@@ -80,14 +86,23 @@ struct item {
 struct items {
 	uint8_t item_count_max; /**< Maximal numer of items in this set. */
 	uint8_t item_count; /**< Current number of items in this set. */
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+	uint16_t slot_count; /**< Number of slots used by the keymap. */
+	uint16_t usage_id[KEY_SLOT_COUNT]; /**< Usage ID of each slot, sorted. */
+	int16_t value[KEY_SLOT_COUNT]; /**< Value of each slot. */
+	uint32_t bitmap[KEY_BITMAP_SIZE]; /**< Slots with a non-zero value. */
+#else
 	struct item item[ITEM_COUNT]; /**< Items set. Browse from the end. */
+#endif
 };
 
 /**@brief Enqueued HID state item. */
 struct item_event {
 	sys_snode_t node; /**< Event queue linked list node. */
-	struct item item; /**< HID state item which has been enqueued. */
+	const struct hid_keymap *map; /**< Key mapping of the item. */
+	int16_t value; /**< HID value. */
 	uint32_t timestamp; /**< HID event timestamp. */
+	uint32_t origin; /**< Input timestamp, in hardware cycles. */
 };
 
 /**@brief Event queue. */
@@ -107,6 +122,8 @@ struct report_data {
 	struct eventq eventq;
 	struct axis_data axes;
 	bool update_needed;
+	bool input_pending;
+	uint32_t input_timestamp;
 	struct report_state *linked_rs;
 };
 
@@ -137,6 +154,11 @@ static uint8_t report_data_index[REPORT_ID_COUNT];
 static uint8_t report_state_index[REPORT_ID_COUNT];
 static struct hid_state state;
 
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+/* Slot of each hid_keymap entry in the items of its report. */
+static uint8_t keymap_slot[ARRAY_SIZE(hid_keymap)];
+#endif
+
 
 static bool report_send(struct report_data *rd, bool check_state, bool send_always);
 
@@ -203,6 +225,7 @@ static struct hid_keymap *hid_keymap_get(uint16_t key_id)
 	return map;
 }
 
+#ifndef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
 /**@brief Compare two usage values. */
 static int usage_id_compare(const void *a, const void *b)
 {
@@ -211,6 +234,7 @@ static int usage_id_compare(const void *a, const void *b)
 
 	return (p_a->usage_id - p_b->usage_id);
 }
+#endif
 
 static void eventq_reset(struct eventq *eventq)
 {
@@ -255,7 +279,8 @@ static struct item_event *eventq_get(struct eventq *eventq)
 	return CONTAINER_OF(node, struct item_event, node);
 }
 
-static void eventq_append(struct eventq *eventq, uint16_t usage_id, int16_t value)
+static void eventq_append(struct eventq *eventq, const struct hid_keymap *map,
+			  int16_t value, uint32_t origin)
 {
 	struct item_event *hid_event = k_malloc(sizeof(*hid_event));
 
@@ -266,9 +291,10 @@ static void eventq_append(struct eventq *eventq, uint16_t usage_id, int16_t valu
 		return;
 	}
 
-	hid_event->item.usage_id = usage_id;
-	hid_event->item.value = value;
+	hid_event->map = map;
+	hid_event->value = value;
 	hid_event->timestamp = k_uptime_get_32();
+	hid_event->origin = origin;
 
 	/* Add a new event to the queue. */
 	sys_slist_append(&eventq->root, &hid_event->node);
@@ -328,16 +354,16 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 	sys_snode_t *tmp_safe;
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&eventq->root, cur, tmp_safe) {
-		const struct item cur_item =
-			CONTAINER_OF(cur, struct item_event, node)->item;
+		const struct item_event *cur_event =
+			CONTAINER_OF(cur, struct item_event, node);
 
-		if (cur_item.value > 0) {
+		if (cur_event->value > 0) {
 			/* Every key down must be paired with key up.
 			 * Set hit count to value as we just detected
 			 * first key down for this usage.
 			 */
 
-			unsigned int hit_count = cur_item.value;
+			unsigned int hit_count = cur_event->value;
 			sys_snode_t *j = cur;
 			size_t j_pos = cur_pos;
 
@@ -347,13 +373,14 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 					break;
 				}
 
-				const struct item item =
+				const struct item_event *event =
 					CONTAINER_OF(j,
 						     struct item_event,
-						     node)->item;
+						     node);
 
-				if (cur_item.usage_id == item.usage_id) {
-					hit_count += item.value;
+				if (cur_event->map->usage_id ==
+				    event->map->usage_id) {
+					hit_count += event->value;
 
 					if (hit_count == 0) {
 						/* All events with this usage
@@ -391,6 +418,7 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 	}
 }
 
+#ifndef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
 static void sort_by_usage_id(struct item items[], size_t array_size)
 {
 	for (size_t k = 0; k < array_size; k++) {
@@ -409,10 +437,17 @@ static void sort_by_usage_id(struct item items[], size_t array_size)
 		}
 	}
 }
+#endif
 
 static void clear_items(struct items *items)
 {
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+	/* Slot usage IDs are set at init and kept. */
+	memset(items->value, 0, sizeof(items->value));
+	memset(items->bitmap, 0, sizeof(items->bitmap));
+#else
 	memset(items->item, 0, sizeof(items->item));
+#endif
 	items->item_count = 0;
 }
 
@@ -430,6 +465,26 @@ static void clear_report_data(struct report_data *rd)
 	eventq_reset(&rd->eventq);
 
 	rd->update_needed = false;
+	rd->input_pending = false;
+}
+
+static void input_timestamp_set(struct report_data *rd, uint32_t timestamp)
+{
+	/* Reports carry the timestamp of the oldest input they contain. */
+	if (!rd->input_pending) {
+		rd->input_timestamp = timestamp;
+		rd->input_pending = true;
+	}
+}
+
+static uint32_t input_timestamp_get(const struct report_data *rd)
+{
+	if (rd->input_pending) {
+		return rd->input_timestamp;
+	}
+
+	/* Report does not contain new input, e.g. it refreshes the state. */
+	return k_cycle_get_32();
 }
 
 static struct report_state *get_report_state(struct subscriber *subscriber,
@@ -466,9 +521,84 @@ static struct subscriber *get_subscriber(const void *subscriber_id)
 	return NULL;
 }
 
-static bool key_value_set(struct items *items, uint16_t usage_id, int16_t value)
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+static bool key_value_set(struct items *items, const struct hid_keymap *map,
+			  int16_t value)
+{
+	const size_t slot = keymap_slot[map - hid_keymap];
+	int16_t *slot_value = &items->value[slot];
+	uint32_t *bitmap_word = &items->bitmap[slot / 32];
+	const uint32_t bit = BIT(slot % 32);
+
+	bool update_needed = false;
+
+	__ASSERT_NO_MSG(slot < items->slot_count);
+	__ASSERT_NO_MSG(items->usage_id[slot] == map->usage_id);
+	__ASSERT_NO_MSG(items->item_count_max > 0);
+
+	/* Report equal to zero brings no change. This should never happen. */
+	__ASSERT_NO_MSG(value != 0);
+
+	if (*slot_value != 0) {
+		/* Item is present - update its value. */
+		*slot_value += value;
+		if (*slot_value == 0) {
+			__ASSERT_NO_MSG(items->item_count != 0);
+			items->item_count -= 1;
+			*bitmap_word &= ~bit;
+		}
+
+		update_needed = true;
+	} else if (value < 0) {
+		/* For items with absolute value, the value is used as
+		 * a reference counter and must not fall below zero. This
+		 * could happen if a key up event is lost and the state
+		 * receives an unpaired key down event.
+		 */
+	} else if (items->item_count >= items->item_count_max) {
+		/* Configuration should allow the HID module to hold data
+		 * about the maximum number of simultaneously pressed keys.
+		 * Generate a warning if an item cannot be recorded.
+		 */
+		LOG_WRN("No place on the list to store HID item!");
+	} else {
+		/* Record this value change. */
+		*slot_value = value;
+		*bitmap_word |= bit;
+		items->item_count += 1;
+
+		update_needed = true;
+	}
+
+	return update_needed;
+}
+
+/**@brief Get usage IDs of the recorded items, starting from the highest. */
+static size_t items_usage_get(const struct items *items, uint16_t *usage_id,
+			      size_t max)
+{
+	size_t cnt = 0;
+
+	for (size_t i = ARRAY_SIZE(items->bitmap); (i > 0) && (cnt < max); i--) {
+		uint32_t bits = items->bitmap[i - 1];
+
+		while (bits && (cnt < max)) {
+			size_t bit = 31 - __builtin_clz(bits);
+
+			bits &= ~BIT(bit);
+			usage_id[cnt] = items->usage_id[(i - 1) * 32 + bit];
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+#else
+static bool key_value_set(struct items *items, const struct hid_keymap *map,
+			  int16_t value)
 {
 	const uint8_t prev_item_count = items->item_count;
+	const uint16_t usage_id = map->usage_id;
 
 	bool update_needed = false;
 	struct item *p_item;
@@ -533,6 +663,29 @@ static bool key_value_set(struct items *items, uint16_t usage_id, int16_t value)
 	return update_needed;
 }
 
+/**@brief Get usage IDs of the recorded items, starting from the highest. */
+static size_t items_usage_get(const struct items *items, uint16_t *usage_id,
+			      size_t max)
+{
+	size_t cnt = 0;
+
+	/* Items are sorted, with free slots at the beginning of the array. */
+	for (size_t i = ARRAY_SIZE(items->item); (i > 0) && (cnt < max); i--) {
+		const struct item *item = &items->item[i - 1];
+
+		if (!item->usage_id) {
+			break;
+		}
+
+		__ASSERT_NO_MSG(item->value > 0);
+		usage_id[cnt] = item->usage_id;
+		cnt++;
+	}
+
+	return cnt;
+}
+#endif
+
 static void send_report_keyboard(uint8_t report_id, struct report_data *rd)
 {
 	__ASSERT_NO_MSG((IS_ENABLED(CONFIG_DESKTOP_HID_REPORT_KEYBOARD_SUPPORT) &&
@@ -558,6 +711,7 @@ static void send_report_keyboard(uint8_t report_id, struct report_data *rd)
 	struct hid_report_event *event = new_hid_report_event(sizeof(report_id) + REPORT_SIZE_KEYBOARD_KEYS);
 
 	event->subscriber = rd->linked_rs->subscriber->id;
+	event->timestamp = input_timestamp_get(rd);
 
 	event->dyndata.data[0] = report_id;
 	event->dyndata.data[2] = 0; /* Reserved byte */
@@ -565,27 +719,21 @@ static void send_report_keyboard(uint8_t report_id, struct report_data *rd)
 	uint8_t modifier_bm = 0;
 	uint8_t *keys = &event->dyndata.data[3];
 
-	const size_t max = ARRAY_SIZE(rd->items.item);
+	uint16_t usage_id[ITEM_COUNT];
+	const size_t max = items_usage_get(&rd->items, usage_id, ARRAY_SIZE(usage_id));
 	size_t cnt = 0;
 	for (size_t i = 0; (i < max) && (cnt < KEYBOARD_REPORT_KEY_COUNT_MAX); i++) {
-		struct item item = rd->items.item[max - i - 1];
-
-		if (item.usage_id) {
-			__ASSERT_NO_MSG(item.value > 0);
-			if (item.usage_id <= KEYBOARD_REPORT_LAST_KEY) {
-				__ASSERT_NO_MSG(item.usage_id <= UINT8_MAX);
-				keys[cnt] = item.usage_id;
-				cnt++;
-			} else if ((item.usage_id >= KEYBOARD_REPORT_FIRST_MODIFIER) &&
-				   (item.usage_id <= KEYBOARD_REPORT_LAST_MODIFIER)) {
-				/* Make sure any key bitmask will fit into modifiers. */
-				BUILD_ASSERT(KEYBOARD_REPORT_LAST_MODIFIER - KEYBOARD_REPORT_FIRST_MODIFIER < 8);
-				modifier_bm |= BIT(item.usage_id - KEYBOARD_REPORT_FIRST_MODIFIER);
-			} else {
-				LOG_WRN("Undefined usage 0x%x", item.usage_id);
-			}
+		if (usage_id[i] <= KEYBOARD_REPORT_LAST_KEY) {
+			__ASSERT_NO_MSG(usage_id[i] <= UINT8_MAX);
+			keys[cnt] = usage_id[i];
+			cnt++;
+		} else if ((usage_id[i] >= KEYBOARD_REPORT_FIRST_MODIFIER) &&
+			   (usage_id[i] <= KEYBOARD_REPORT_LAST_MODIFIER)) {
+			/* Make sure any key bitmask will fit into modifiers. */
+			BUILD_ASSERT(KEYBOARD_REPORT_LAST_MODIFIER - KEYBOARD_REPORT_FIRST_MODIFIER < 8);
+			modifier_bm |= BIT(usage_id[i] - KEYBOARD_REPORT_FIRST_MODIFIER);
 		} else {
-			break;
+			LOG_WRN("Undefined usage 0x%x", usage_id[i]);
 		}
 	}
 
@@ -626,17 +774,15 @@ static void send_report_mouse(uint8_t report_id, struct report_data *rd)
 
 	/* Traverse pressed keys and build mouse buttons bitmask */
 	uint8_t button_bm = 0;
-	for (size_t i = 0; i < ARRAY_SIZE(rd->items.item); i++) {
-		struct item item = rd->items.item[i];
+	uint16_t usage_id[ITEM_COUNT];
+	const size_t cnt = items_usage_get(&rd->items, usage_id, ARRAY_SIZE(usage_id));
 
-		if (item.usage_id) {
-			__ASSERT_NO_MSG(item.usage_id <= 8);
-			__ASSERT_NO_MSG(item.value > 0);
+	for (size_t i = 0; i < cnt; i++) {
+		__ASSERT_NO_MSG(usage_id[i] <= 8);
 
-			uint8_t mask = 1 << (item.usage_id - 1);
+		uint8_t mask = 1 << (usage_id[i] - 1);
 
-			button_bm |= mask;
-		}
+		button_bm |= mask;
 	}
 
 
@@ -646,6 +792,7 @@ static void send_report_mouse(uint8_t report_id, struct report_data *rd)
 	struct hid_report_event *event = new_hid_report_event(sizeof(report_id) + REPORT_SIZE_MOUSE);
 
 	event->subscriber = rd->linked_rs->subscriber->id;
+	event->timestamp = input_timestamp_get(rd);
 
 	/* Convert to little-endian. */
 	uint8_t x_buff[sizeof(dx)];
@@ -694,17 +841,15 @@ static void send_report_boot_mouse(uint8_t report_id, struct report_data *rd)
 
 	/* Traverse pressed keys and build mouse buttons bitmask */
 	uint8_t button_bm = 0;
-	for (size_t i = 0; i < ARRAY_SIZE(rd->items.item); i++) {
-		struct item item = rd->items.item[i];
+	uint16_t usage_id[ITEM_COUNT];
+	const size_t cnt = items_usage_get(&rd->items, usage_id, ARRAY_SIZE(usage_id));
 
-		if (item.usage_id) {
-			__ASSERT_NO_MSG(item.usage_id <= 8);
-			__ASSERT_NO_MSG(item.value > 0);
+	for (size_t i = 0; i < cnt; i++) {
+		__ASSERT_NO_MSG(usage_id[i] <= 8);
 
-			uint8_t mask = 1 << (item.usage_id - 1);
+		uint8_t mask = 1 << (usage_id[i] - 1);
 
-			button_bm |= mask;
-		}
+		button_bm |= mask;
 	}
 
 
@@ -713,6 +858,7 @@ static void send_report_boot_mouse(uint8_t report_id, struct report_data *rd)
 	struct hid_report_event *event = new_hid_report_event(report_size);
 
 	event->subscriber = rd->linked_rs->subscriber->id;
+	event->timestamp = input_timestamp_get(rd);
 
 	event->dyndata.data[0] = report_id;
 	event->dyndata.data[1] = button_bm;
@@ -749,16 +895,17 @@ static void send_report_ctrl(uint8_t report_id, struct report_data *rd)
 	struct hid_report_event *event = new_hid_report_event(report_size);
 
 	event->subscriber = rd->linked_rs->subscriber->id;
+	event->timestamp = input_timestamp_get(rd);
 
 	/* Only one item can fit in the consumer control report. */
-	__ASSERT_NO_MSG(report_size == sizeof(report_id) +
-				       sizeof(rd->items.item[0].usage_id));
+	uint16_t usage_id = 0;
+
+	__ASSERT_NO_MSG(report_size == sizeof(report_id) + sizeof(usage_id));
 	event->dyndata.data[0] = report_id;
 
-	const size_t idx = ARRAY_SIZE(rd->items.item) - 1;
+	items_usage_get(&rd->items, &usage_id, 1);
 
-	sys_put_le16(rd->items.item[idx].usage_id,
-		     &event->dyndata.data[sizeof(report_id)]);
+	sys_put_le16(usage_id, &event->dyndata.data[sizeof(report_id)]);
 
 	EVENT_SUBMIT(event);
 
@@ -776,8 +923,12 @@ static bool update_report(struct report_data *rd)
 		__ASSERT_NO_MSG(event);
 
 		update_needed = key_value_set(&rd->items,
-					      event->item.usage_id,
-					      event->item.value);
+					      event->map,
+					      event->value);
+
+		if (update_needed) {
+			input_timestamp_set(rd, event->origin);
+		}
 
 		rd->update_needed = rd->update_needed || update_needed;
 
@@ -813,7 +964,7 @@ static bool report_send(struct report_data *rd, bool check_state, bool send_alwa
 		    (rs->report_id == REPORT_ID_SYSTEM_CTRL))  {
 			pipeline_depth = 1;
 		} else {
-			pipeline_depth = 2;
+			pipeline_depth = HID_REPORT_PIPELINE_DEPTH_MAX;
 		}
 
 		while ((rs->cnt < pipeline_depth) &&
@@ -848,6 +999,11 @@ static bool report_send(struct report_data *rd, bool check_state, bool send_alwa
 				break;
 			}
 
+			if (!rd->update_needed) {
+				/* All input was included in the report. */
+				rd->input_pending = false;
+			}
+
 			__ASSERT_NO_MSG(rs->cnt < UINT8_MAX);
 			rs->cnt++;
 			rs->subscriber->report_cnt++;
@@ -1134,8 +1290,8 @@ static void disconnect_subscriber(const void *subscriber_id)
 }
 
 /**@brief Enqueue event that updates a given usage. */
-static void enqueue(struct report_data *rd, uint16_t usage_id, int16_t value,
-		    bool connected)
+static void enqueue(struct report_data *rd, const struct hid_keymap *map,
+		    int16_t value, uint32_t origin, bool connected)
 {
 	eventq_cleanup(&rd->eventq, k_uptime_get_32());
 
@@ -1178,11 +1334,12 @@ static void enqueue(struct report_data *rd, uint16_t usage_id, int16_t value,
 		}
 	}
 
-	eventq_append(&rd->eventq, usage_id, value);
+	eventq_append(&rd->eventq, map, value, origin);
 }
 
 /**@brief Function for updating the value linked to the HID usage. */
-static void update_key(const struct hid_keymap *map, int16_t value)
+static void update_key(const struct hid_keymap *map, int16_t value,
+		       uint32_t timestamp)
 {
 	uint8_t report_id = map->report_id;
 
@@ -1197,16 +1354,74 @@ static void update_key(const struct hid_keymap *map, int16_t value)
 
 	if (!connected || !eventq_is_empty(&rd->eventq)) {
 		/* Report cannot be sent yet - enqueue this HID event. */
-		enqueue(rd, map->usage_id, value, connected);
+		enqueue(rd, map, value, timestamp, connected);
 	} else {
 		/* Update state and issue report generation event. */
-		if (key_value_set(&rd->items, map->usage_id, value)) {
+		if (key_value_set(&rd->items, map, value)) {
+			input_timestamp_set(rd, timestamp);
 			rd->update_needed = true;
 			report_send(rd, false, true);
 		}
 	}
 }
 
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+/**@brief Assign a slot to each usage in the hid_keymap.
+ *
+ * Slots are assigned in order of usage ID within each report, so that
+ * the reports list the keys in the same order as with sorted items. Keys
+ * mapped to the same usage share a slot.
+ */
+static void init_key_slots(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(hid_keymap); i++) {
+		const struct hid_keymap *map = &hid_keymap[i];
+
+		if (!map->usage_id ||
+		    (report_data_index[map->report_id] >= INPUT_REPORT_DATA_COUNT)) {
+			continue;
+		}
+
+		struct items *items = &get_report_data(map->report_id)->items;
+		size_t pos = 0;
+
+		while ((pos < items->slot_count) &&
+		       (items->usage_id[pos] < map->usage_id)) {
+			pos++;
+		}
+
+		if ((pos < items->slot_count) &&
+		    (items->usage_id[pos] == map->usage_id)) {
+			continue;
+		}
+
+		memmove(&items->usage_id[pos + 1], &items->usage_id[pos],
+			(items->slot_count - pos) * sizeof(items->usage_id[0]));
+		items->usage_id[pos] = map->usage_id;
+		items->slot_count++;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(hid_keymap); i++) {
+		const struct hid_keymap *map = &hid_keymap[i];
+
+		if (!map->usage_id ||
+		    (report_data_index[map->report_id] >= INPUT_REPORT_DATA_COUNT)) {
+			continue;
+		}
+
+		const struct items *items = &get_report_data(map->report_id)->items;
+		size_t slot = 0;
+
+		while (items->usage_id[slot] != map->usage_id) {
+			slot++;
+			__ASSERT_NO_MSG(slot < items->slot_count);
+		}
+
+		keymap_slot[i] = slot;
+	}
+}
+#endif
+
 static void init(void)
 {
 	if (IS_ENABLED(CONFIG_ASSERT)) {
@@ -1284,6 +1499,10 @@ static void init(void)
 
 	__ASSERT_NO_MSG(data_id == INPUT_REPORT_DATA_COUNT);
 	__ASSERT_NO_MSG(state_id == INPUT_REPORT_STATE_COUNT);
+
+#ifdef CONFIG_DESKTOP_HID_STATE_KEY_BITMAP
+	init_key_slots();
+#endif
 }
 
 static bool handle_motion_event(const struct motion_event *event)
@@ -1297,6 +1516,7 @@ static bool handle_motion_event(const struct motion_event *event)
 	rd->axes.axis[MOUSE_REPORT_AXIS_X] += event->dx;
 	rd->axes.axis[MOUSE_REPORT_AXIS_Y] += event->dy;
 	rd->update_needed = true;
+	input_timestamp_set(rd, event->timestamp);
 
 	report_send(rd, true, true);
 
@@ -1313,6 +1533,7 @@ static bool handle_wheel_event(const struct wheel_event *event)
 
 	rd->axes.axis[MOUSE_REPORT_AXIS_WHEEL] += event->wheel;
 	rd->update_needed = true;
+	input_timestamp_set(rd, event->timestamp);
 
 	report_send(rd, true, true);
 
@@ -1329,7 +1550,7 @@ static bool handle_button_event(const struct button_event *event)
 	} else {
 		/* Keydown increases ref counter, keyup decreases it. */
 		int16_t value = (event->pressed != false) ? (1) : (-1);
-		update_key(map, value);
+		update_key(map, value, event->timestamp);
 	}
 
 	return false;
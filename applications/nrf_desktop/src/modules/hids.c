@@ -148,6 +148,7 @@ static void hid_report_sent(const struct bt_conn *conn, uint8_t report_id, bool
 	event->report_id = report_id;
 	event->subscriber = conn;
 	event->error = error;
+	event->timestamp = k_cycle_get_32();
 
 	EVENT_SUBMIT(event);
 }
@@ -198,6 +198,7 @@ static void report_sent(const struct device *dev, bool error)
 	event->report_id = usb_hid->sent_report_id;
 	event->subscriber = usb_hid;
 	event->error = error;
+	event->timestamp = k_cycle_get_32();
 	EVENT_SUBMIT(event);
 
 	/* Used to assert if previous report was sent before sending new one. */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/types.h>
+#include <sys/util.h>
+
+#include "hid_report_mouse.h"
+#include "hid_report_merge.h"
+
+static int16_t mouse_xy_get(const uint8_t *data, size_t axis)
+{
+	uint16_t val;
+
+	/* Axes are 12-bit signed values packed into three bytes. */
+	if (axis == MOUSE_REPORT_AXIS_X) {
+		val = data[0] | ((data[1] & 0x0f) << 8);
+	} else {
+		val = (data[1] >> 4) | (data[2] << 4);
+	}
+
+	return (val & BIT(11)) ? (int16_t)(val | 0xf000) : (int16_t)val;
+}
+
+static void mouse_xy_set(uint8_t *data, int16_t x, int16_t y)
+{
+	data[0] = x & 0xff;
+	data[1] = ((y << 4) & 0xf0) | ((x >> 8) & 0x0f);
+	data[2] = (y >> 4) & 0xff;
+}
+
+bool hid_report_merge_mouse(uint8_t *dst, const uint8_t *src)
+{
+	BUILD_ASSERT(REPORT_SIZE_MOUSE == 5, "Invalid report size");
+
+	/* Button state must be kept to preserve clicks. */
+	if (dst[0] != src[0]) {
+		return false;
+	}
+
+	int16_t wheel = (int8_t)dst[1] + (int8_t)src[1];
+	int16_t x = mouse_xy_get(&dst[2], MOUSE_REPORT_AXIS_X) +
+		    mouse_xy_get(&src[2], MOUSE_REPORT_AXIS_X);
+	int16_t y = mouse_xy_get(&dst[2], MOUSE_REPORT_AXIS_Y) +
+		    mouse_xy_get(&src[2], MOUSE_REPORT_AXIS_Y);
+
+	/* Do not merge if part of the movement would be lost. */
+	if ((wheel < MOUSE_REPORT_WHEEL_MIN) || (wheel > MOUSE_REPORT_WHEEL_MAX) ||
+	    (x < MOUSE_REPORT_XY_MIN) || (x > MOUSE_REPORT_XY_MAX) ||
+	    (y < MOUSE_REPORT_XY_MIN) || (y > MOUSE_REPORT_XY_MAX)) {
+		return false;
+	}
+
+	dst[1] = wheel;
+	mouse_xy_set(&dst[2], x, y);
+
+	return true;
+}
+
+bool hid_report_merge_boot_mouse(uint8_t *dst, const uint8_t *src)
+{
+	BUILD_ASSERT(REPORT_SIZE_MOUSE_BOOT == 3, "Invalid report size");
+
+	if (dst[0] != src[0]) {
+		return false;
+	}
+
+	int16_t x = (int8_t)dst[1] + (int8_t)src[1];
+	int16_t y = (int8_t)dst[2] + (int8_t)src[2];
+
+	if ((x < MOUSE_REPORT_XY_MIN_BOOT) || (x > MOUSE_REPORT_XY_MAX_BOOT) ||
+	    (y < MOUSE_REPORT_XY_MIN_BOOT) || (y > MOUSE_REPORT_XY_MAX_BOOT)) {
+		return false;
+	}
+
+	dst[1] = x;
+	dst[2] = y;
+
+	return true;
+}
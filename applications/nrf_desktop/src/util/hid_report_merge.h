@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_REPORT_MERGE_H_
+#define _HID_REPORT_MERGE_H_
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Merge mouse report into an older mouse report.
+ *
+ * Relative movement of the wheel and the axes is accumulated. The reports
+ * are merged only if the button state is the same and the accumulated values
+ * are in range of the report.
+ *
+ * @param[in,out] dst	Mouse report data without report ID.
+ * @param[in]     src	Newer mouse report data without report ID.
+ *
+ * @return true if the reports were merged, false otherwise. The dst report is
+ *         not modified if the reports were not merged.
+ */
+bool hid_report_merge_mouse(uint8_t *dst, const uint8_t *src);
+
+/**
+ * @brief Merge boot mouse report into an older boot mouse report.
+ *
+ * @param[in,out] dst	Boot mouse report data.
+ * @param[in]     src	Newer boot mouse report data.
+ *
+ * @return true if the reports were merged, false otherwise. The dst report is
+ *         not modified if the reports were not merged.
+ */
+bool hid_report_merge_boot_mouse(uint8_t *dst, const uint8_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HID_REPORT_MERGE_H_ */
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* The HID forward module is connected to two synthetic peripherals and a
+ * single subscriber. Events are passed to the module directly and the
+ * submitted HID reports are recorded. The subscriber stays busy until the
+ * test acknowledges a report, so reports of both peripherals are enqueued,
+ * merged and dropped by the module in the meantime.
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <sys/byteorder.h>
+#include <bluetooth/services/hogp.h>
+
+#define MODULE main
+#include <caf/events/module_state_event.h>
+
+#include <caf/events/ble_common_event.h>
+#include <caf/events/power_event.h>
+#include "ble_event.h"
+#include "config_event.h"
+#include "hid_event.h"
+#include "config_channel_transport.h"
+
+#define PERIPHERAL_CNT		2
+#define REPORT_LOG_SIZE		16
+#define REPORT_SIZE_MAX		(1 + REPORT_SIZE_KEYBOARD_KEYS)
+#define MAX_ENQUEUED_ITEMS	CONFIG_DESKTOP_HID_FORWARD_MAX_ENQUEUED_REPORTS
+
+/* Options of the module, in the order of their descriptions. */
+enum forward_opt {
+	OPT_FORWARDED,
+	OPT_MERGED,
+	OPT_DROPPED,
+	OPT_RESET
+};
+
+EVENT_TYPE_DEFINE(module_state_event);
+EVENT_TYPE_DEFINE(ble_discovery_complete_event);
+EVENT_TYPE_DEFINE(ble_peer_event);
+EVENT_TYPE_DEFINE(ble_peer_operation_event);
+EVENT_TYPE_DEFINE(hid_report_event);
+EVENT_TYPE_DEFINE(hid_report_sent_event);
+EVENT_TYPE_DEFINE(hid_report_subscription_event);
+EVENT_TYPE_DEFINE(power_down_event);
+EVENT_TYPE_DEFINE(wake_up_event);
+EVENT_TYPE_DEFINE(config_event);
+
+/* The module initializes when the BLE state module is ready. */
+const void * const MODULE_ID_PTR_VAR(ble_state) = "ble_state";
+
+extern const struct event_listener __event_listener_hid_forward;
+
+struct peripheral {
+	uint8_t conn; /* Address used as the connection. */
+	struct bt_hogp_rep_info reps[2];
+	struct bt_gatt_dm dm;
+};
+
+struct report {
+	size_t size;
+	uint8_t data[REPORT_SIZE_MAX];
+};
+
+static struct peripheral peripherals[PERIPHERAL_CNT];
+static uint8_t subscriber; /* Address used as the subscriber ID. */
+
+static struct report report_log[REPORT_LOG_SIZE];
+static size_t report_cnt;
+static bool report_pending;
+static struct config_event *config_rsp;
+
+/* Configuration channel requests are not forwarded to the peripherals. */
+int config_channel_report_parse(const uint8_t *buffer, size_t length,
+				struct config_event *event)
+{
+	return -ENOTSUP;
+}
+
+int config_channel_report_fill(uint8_t *buffer, const size_t length,
+			       const struct config_event *event)
+{
+	return -ENOTSUP;
+}
+
+void event_submit_stub(struct event_header *eh)
+{
+	if (is_hid_report_event(eh)) {
+		struct hid_report_event *event = cast_hid_report_event(eh);
+
+		zassert_equal_ptr(event->subscriber, &subscriber,
+				  "Wrong subscriber");
+		zassert_false(report_pending, "Subscriber is busy");
+		zassert_true(report_cnt < ARRAY_SIZE(report_log),
+			     "Report log overflow");
+		zassert_true(event->dyndata.size <= REPORT_SIZE_MAX,
+			     "Report too long");
+
+		report_log[report_cnt].size = event->dyndata.size;
+		memcpy(report_log[report_cnt].data, event->dyndata.data,
+		       event->dyndata.size);
+		report_cnt++;
+		report_pending = true;
+	} else if (is_config_event(eh)) {
+		zassert_is_null(config_rsp, "Unexpected configuration response");
+		config_rsp = cast_config_event(eh);
+		zassert_false(config_rsp->is_request, "Request submitted");
+
+		/* The response is freed by the test. */
+		return;
+	} else {
+		zassert_true(is_module_state_event(eh), "Unexpected %s submitted",
+			     eh->type_id->name);
+	}
+
+	k_free(eh);
+}
+
+/* The module runs in cooperative threads (Bluetooth and system workqueue).
+ * Locking the scheduler makes the test thread non-preemptible as well.
+ */
+static void event_send(struct event_header *eh)
+{
+	k_sched_lock();
+	__event_listener_hid_forward.notification(eh);
+	k_sched_unlock();
+}
+
+static void subscription_send(uint8_t report_id, bool enabled)
+{
+	struct hid_report_subscription_event *event =
+		new_hid_report_subscription_event();
+
+	event->subscriber = &subscriber;
+	event->report_id = report_id;
+	event->enabled = enabled;
+
+	event_send(&event->header);
+	k_free(event);
+}
+
+static void peripheral_connect(struct peripheral *per)
+{
+	per->reps[0] = (struct bt_hogp_rep_info) {
+		.id = REPORT_ID_MOUSE,
+		.type = BT_HIDS_REPORT_TYPE_INPUT,
+		.size = REPORT_SIZE_MOUSE,
+	};
+	per->reps[1] = (struct bt_hogp_rep_info) {
+		.id = REPORT_ID_KEYBOARD_KEYS,
+		.type = BT_HIDS_REPORT_TYPE_INPUT,
+		.size = REPORT_SIZE_KEYBOARD_KEYS,
+	};
+
+	per->dm.conn = (struct bt_conn *)&per->conn;
+	per->dm.reps = per->reps;
+	per->dm.rep_cnt = ARRAY_SIZE(per->reps);
+
+	struct ble_discovery_complete_event *event =
+		new_ble_discovery_complete_event();
+
+	memset(event->hwid, per - peripherals, sizeof(event->hwid));
+	event->dm = &per->dm;
+
+	event_send(&event->header);
+	k_free(event);
+
+	zassert_not_null(per->dm.hogp, "Peripheral not registered");
+
+	k_sched_lock();
+	per->dm.hogp->params->ready_cb(per->dm.hogp);
+	k_sched_unlock();
+}
+
+static void report_send(struct peripheral *per, uint8_t report_id,
+			const uint8_t *data)
+{
+	struct bt_hogp_rep_info *rep = bt_hogp_rep_find(per->dm.hogp,
+							BT_HIDS_REPORT_TYPE_INPUT,
+							report_id);
+
+	zassert_not_null(rep, "Report not found");
+	zassert_not_null(rep->read_cb, "Report not subscribed");
+
+	k_sched_lock();
+	rep->read_cb(per->dm.hogp, rep, 0, data);
+	k_sched_unlock();
+}
+
+static void mouse_send(struct peripheral *per, int8_t wheel, int16_t x,
+		       int16_t y)
+{
+	/* Buttons, wheel and two 12-bit axes. */
+	const uint8_t data[REPORT_SIZE_MOUSE] = {
+		0x00,
+		wheel,
+		x & 0xff,
+		((y << 4) & 0xf0) | ((x >> 8) & 0x0f),
+		(y >> 4) & 0xff,
+	};
+
+	report_send(per, REPORT_ID_MOUSE, data);
+}
+
+static void keyboard_send(struct peripheral *per, uint8_t usage)
+{
+	uint8_t data[REPORT_SIZE_KEYBOARD_KEYS] = {0};
+
+	data[2] = usage;
+
+	report_send(per, REPORT_ID_KEYBOARD_KEYS, data);
+}
+
+static bool report_ack(void)
+{
+	if (!report_pending) {
+		return false;
+	}
+
+	struct hid_report_sent_event *event = new_hid_report_sent_event();
+
+	event->subscriber = &subscriber;
+	event->report_id = report_log[report_cnt - 1].data[0];
+	event->error = false;
+	event->timestamp = 0;
+
+	report_pending = false;
+
+	event_send(&event->header);
+	k_free(event);
+
+	return true;
+}
+
+static void reports_ack(void)
+{
+	while (report_ack()) {
+	}
+}
+
+static struct config_event *config_request(uint8_t status, uint8_t opt)
+{
+	struct config_event *event = new_config_event(0);
+	uint8_t opt_field = opt + 1;
+
+	event->transport_id = 0;
+	event->is_request = true;
+	/* The HID forward module is the only configuration channel module. */
+	event->event_id = MOD_FIELD_SET(0) | OPT_FIELD_SET(opt_field);
+	event->recipient = CFG_CHAN_RECIPIENT_LOCAL;
+	event->status = status;
+
+	return event;
+}
+
+static uint32_t stat_get(enum forward_opt opt)
+{
+	struct config_event *event = config_request(CONFIG_STATUS_FETCH, opt);
+
+	event_send(&event->header);
+	k_free(event);
+
+	zassert_not_null(config_rsp, "No response");
+	zassert_equal(config_rsp->status, CONFIG_STATUS_SUCCESS, "Fetch failed");
+	zassert_equal(config_rsp->dyndata.size, sizeof(uint32_t),
+		      "Wrong counter size");
+
+	uint32_t cnt = sys_get_le32(config_rsp->dyndata.data);
+
+	k_free(config_rsp);
+	config_rsp = NULL;
+
+	return cnt;
+}
+
+static void stats_check(uint32_t forwarded, uint32_t merged, uint32_t dropped)
+{
+	zassert_equal(stat_get(OPT_FORWARDED), forwarded, "Wrong forwarded count");
+	zassert_equal(stat_get(OPT_MERGED), merged, "Wrong merged count");
+	zassert_equal(stat_get(OPT_DROPPED), dropped, "Wrong dropped count");
+}
+
+static void stats_reset(void)
+{
+	struct config_event *event = config_request(CONFIG_STATUS_SET, OPT_RESET);
+
+	event_send(&event->header);
+	k_free(event);
+
+	zassert_not_null(config_rsp, "No response");
+	zassert_equal(config_rsp->status, CONFIG_STATUS_SUCCESS, "Reset failed");
+
+	k_free(config_rsp);
+	config_rsp = NULL;
+}
+
+static void log_reset(void)
+{
+	report_cnt = 0;
+}
+
+static void report_check(size_t idx, const uint8_t *expected, size_t size)
+{
+	zassert_true(idx < report_cnt, "Report %zu not sent", idx);
+	zassert_equal(report_log[idx].size, size, "Wrong size of report %zu", idx);
+	zassert_mem_equal(report_log[idx].data, expected, size,
+			  "Wrong report %zu", idx);
+}
+
+static void test_init(void)
+{
+	struct module_state_event *event = new_module_state_event();
+
+	event->module_id = MODULE_ID(ble_state);
+	event->state = MODULE_STATE_READY;
+
+	event_send(&event->header);
+	k_free(event);
+
+	for (size_t i = 0; i < ARRAY_SIZE(peripherals); i++) {
+		peripheral_connect(&peripherals[i]);
+	}
+
+	subscription_send(REPORT_ID_MOUSE, true);
+	subscription_send(REPORT_ID_KEYBOARD_KEYS, true);
+
+	stats_check(0, 0, 0);
+}
+
+/* Mouse reports are merged into the newest enqueued mouse report, and a
+ * keyboard report that repeats the newest enqueued state is skipped. The
+ * enqueued reports are sent alternately from both peripherals, starting with
+ * the one that was not served last.
+ */
+static void test_merge_order(void)
+{
+	struct peripheral *a = &peripherals[0];
+	struct peripheral *b = &peripherals[1];
+
+	stats_reset();
+	log_reset();
+
+	/* Sent right away, the subscriber is busy afterwards. */
+	mouse_send(a, 0, 1, 0);
+
+	mouse_send(a, 0, 2, 1);
+	mouse_send(a, 1, 3, -2);
+	keyboard_send(b, 0x04);
+	keyboard_send(b, 0x04);
+	mouse_send(b, 0, 0, 4);
+	keyboard_send(a, 0x05);
+	keyboard_send(b, 0x00);
+
+	zassert_equal(report_cnt, 1, "Reports sent while subscriber is busy");
+	reports_ack();
+
+	const uint8_t expected[][REPORT_SIZE_MAX] = {
+		{ REPORT_ID_MOUSE, 0x00, 0x00, 0x01, 0x00, 0x00 },
+		{ REPORT_ID_KEYBOARD_KEYS, 0x00, 0x00, 0x04 },
+		{ REPORT_ID_KEYBOARD_KEYS, 0x00, 0x00, 0x05 },
+		{ REPORT_ID_MOUSE, 0x00, 0x00, 0x00, 0x40, 0x00 },
+		/* Axes accumulated to x = 5, y = -1, wheel = 1. */
+		{ REPORT_ID_MOUSE, 0x00, 0x01, 0x05, 0xf0, 0xff },
+		{ REPORT_ID_KEYBOARD_KEYS, 0x00, 0x00, 0x00 },
+	};
+	const size_t expected_size[] = {
+		1 + REPORT_SIZE_MOUSE,
+		1 + REPORT_SIZE_KEYBOARD_KEYS,
+		1 + REPORT_SIZE_KEYBOARD_KEYS,
+		1 + REPORT_SIZE_MOUSE,
+		1 + REPORT_SIZE_MOUSE,
+		1 + REPORT_SIZE_KEYBOARD_KEYS,
+	};
+
+	zassert_equal(report_cnt, ARRAY_SIZE(expected), "Wrong number of reports");
+
+	for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		report_check(i, expected[i], expected_size[i]);
+	}
+
+	stats_check(6, 2, 0);
+}
+
+/* The oldest enqueued report is dropped when the queue of a peripheral is
+ * full.
+ */
+static void test_drop(void)
+{
+	struct peripheral *a = &peripherals[0];
+
+	stats_reset();
+	log_reset();
+
+	/* Sent right away, the subscriber is busy afterwards. */
+	keyboard_send(a, 0x10);
+
+	for (uint8_t usage = 0x11; usage <= 0x11 + MAX_ENQUEUED_ITEMS; usage++) {
+		keyboard_send(a, usage);
+	}
+
+	reports_ack();
+
+	zassert_equal(report_cnt, 1 + MAX_ENQUEUED_ITEMS, "Wrong number of reports");
+
+	uint8_t expected[REPORT_SIZE_MAX] = { REPORT_ID_KEYBOARD_KEYS };
+
+	expected[3] = 0x10;
+	report_check(0, expected, sizeof(expected));
+
+	/* The report with usage 0x11 was dropped. */
+	for (size_t i = 1; i < report_cnt; i++) {
+		expected[3] = 0x11 + i;
+		report_check(i, expected, sizeof(expected));
+	}
+
+	stats_check(1 + MAX_ENQUEUED_ITEMS, 0, 1);
+
+	stats_reset();
+	stats_check(0, 0, 0);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hid_forward_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_merge_order),
+			 ztest_unit_test(test_drop)
+			 );
+
+	ztest_run_test_suite(hid_forward_tests);
+}
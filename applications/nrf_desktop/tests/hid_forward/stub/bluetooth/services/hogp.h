@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_HOGP_H_
+#define BT_HOGP_H_
+
+/* HID Service client replacement used to build the HID forward module
+ * directly.
+ *
+ * The test acts as the peripherals. The discovery result lists the reports of
+ * a peripheral and the test calls the callback of a subscribed input report to
+ * send a HID report. Reports can not be read or written.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/types.h>
+#include <bluetooth/gatt.h>
+#include <bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum bt_hids_report_type {
+	BT_HIDS_REPORT_TYPE_INPUT = 0x01,
+	BT_HIDS_REPORT_TYPE_OUTPUT = 0x02,
+	BT_HIDS_REPORT_TYPE_FEATURE = 0x03
+};
+
+struct bt_hogp;
+struct bt_hogp_rep_info;
+
+typedef uint8_t (*bt_hogp_read_cb)(struct bt_hogp *hogp,
+				   struct bt_hogp_rep_info *rep,
+				   uint8_t err,
+				   const uint8_t *data);
+
+typedef void (*bt_hogp_write_cb)(struct bt_hogp *hogp,
+				 struct bt_hogp_rep_info *rep,
+				 uint8_t err);
+
+typedef void (*bt_hogp_ready_cb)(struct bt_hogp *hogp);
+
+typedef void (*bt_hogp_prep_fail_cb)(struct bt_hogp *hogp, int err);
+
+typedef void (*bt_hogp_pm_update_cb)(struct bt_hogp *hogp);
+
+struct bt_hogp_init_params {
+	bt_hogp_ready_cb ready_cb;
+	bt_hogp_prep_fail_cb prep_error_cb;
+	bt_hogp_pm_update_cb pm_update_cb;
+};
+
+struct bt_hogp_rep_info {
+	uint8_t id;
+	enum bt_hids_report_type type;
+	size_t size;
+	bt_hogp_read_cb read_cb; /* Set when the input report is subscribed. */
+};
+
+/* Discovery result of a peripheral, filled in by the test. */
+struct bt_gatt_dm {
+	struct bt_conn *conn;
+	struct bt_hogp_rep_info *reps;
+	size_t rep_cnt;
+	struct bt_hogp *hogp; /* Set when the handles are assigned. */
+};
+
+struct bt_hogp {
+	const struct bt_hogp_init_params *params;
+	struct bt_conn *conn;
+	struct bt_hogp_rep_info *reps;
+	size_t rep_cnt;
+};
+
+static inline struct bt_conn *bt_gatt_dm_conn_get(struct bt_gatt_dm *dm)
+{
+	return dm->conn;
+}
+
+static inline void bt_hogp_init(struct bt_hogp *hogp,
+				const struct bt_hogp_init_params *params)
+{
+	memset(hogp, 0, sizeof(*hogp));
+	hogp->params = params;
+}
+
+static inline int bt_hogp_handles_assign(struct bt_gatt_dm *dm,
+					 struct bt_hogp *hogp)
+{
+	hogp->conn = dm->conn;
+	hogp->reps = dm->reps;
+	hogp->rep_cnt = dm->rep_cnt;
+	dm->hogp = hogp;
+
+	return 0;
+}
+
+static inline void bt_hogp_release(struct bt_hogp *hogp)
+{
+	hogp->conn = NULL;
+	hogp->reps = NULL;
+	hogp->rep_cnt = 0;
+}
+
+static inline bool bt_hogp_assign_check(const struct bt_hogp *hogp)
+{
+	return hogp->conn != NULL;
+}
+
+static inline bool bt_hogp_ready_check(const struct bt_hogp *hogp)
+{
+	return hogp->conn != NULL;
+}
+
+static inline struct bt_conn *bt_hogp_conn(const struct bt_hogp *hogp)
+{
+	return hogp->conn;
+}
+
+static inline struct bt_hogp_rep_info *bt_hogp_rep_next(struct bt_hogp *hogp,
+							 const struct bt_hogp_rep_info *rep)
+{
+	size_t idx = (rep == NULL) ? 0 : (rep - hogp->reps) + 1;
+
+	return (idx < hogp->rep_cnt) ? &hogp->reps[idx] : NULL;
+}
+
+static inline struct bt_hogp_rep_info *bt_hogp_rep_find(struct bt_hogp *hogp,
+							 enum bt_hids_report_type type,
+							 uint8_t id)
+{
+	for (size_t i = 0; i < hogp->rep_cnt; i++) {
+		if ((hogp->reps[i].type == type) && (hogp->reps[i].id == id)) {
+			return &hogp->reps[i];
+		}
+	}
+
+	return NULL;
+}
+
+static inline uint8_t bt_hogp_rep_id(const struct bt_hogp_rep_info *rep)
+{
+	return rep->id;
+}
+
+static inline enum bt_hids_report_type bt_hogp_rep_type(const struct bt_hogp_rep_info *rep)
+{
+	return rep->type;
+}
+
+static inline size_t bt_hogp_rep_size(const struct bt_hogp_rep_info *rep)
+{
+	return rep->size;
+}
+
+static inline int bt_hogp_rep_subscribe(struct bt_hogp *hogp,
+					struct bt_hogp_rep_info *rep,
+					bt_hogp_read_cb func)
+{
+	rep->read_cb = func;
+
+	return 0;
+}
+
+static inline int bt_hogp_rep_read(struct bt_hogp *hogp,
+				   struct bt_hogp_rep_info *rep,
+				   bt_hogp_read_cb func)
+{
+	return -ENOTSUP;
+}
+
+static inline int bt_hogp_rep_write(struct bt_hogp *hogp,
+				    struct bt_hogp_rep_info *rep,
+				    bt_hogp_write_cb func,
+				    const void *data, uint8_t length)
+{
+	return -ENOTSUP;
+}
+
+static inline int bt_hogp_rep_write_wo_rsp(struct bt_hogp *hogp,
+					   struct bt_hogp_rep_info *rep,
+					   const void *data, uint8_t length,
+					   bt_hogp_write_cb func)
+{
+	return -ENOTSUP;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BT_HOGP_H_ */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Mouse reports enqueued by the HID forward module are merged by accumulating
+ * the relative movement. The merge must be refused if the button state differs
+ * or if any accumulated value does not fit in the report.
+ */
+
+#include <string.h>
+#include <ztest.h>
+
+#include "hid_report_mouse.h"
+#include "hid_report_merge.h"
+
+
+static void mouse_report_set(uint8_t *data, uint8_t buttons, int8_t wheel,
+			     int16_t x, int16_t y)
+{
+	data[0] = buttons;
+	data[1] = wheel;
+	data[2] = x & 0xff;
+	data[3] = ((y << 4) & 0xf0) | ((x >> 8) & 0x0f);
+	data[4] = (y >> 4) & 0xff;
+}
+
+static void check_mouse_merge(uint8_t buttons, int8_t dst_wheel, int16_t dst_x,
+			      int16_t dst_y, int8_t src_wheel, int16_t src_x,
+			      int16_t src_y)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE];
+	uint8_t src[REPORT_SIZE_MOUSE];
+	uint8_t expected[REPORT_SIZE_MOUSE];
+
+	mouse_report_set(dst, buttons, dst_wheel, dst_x, dst_y);
+	mouse_report_set(src, buttons, src_wheel, src_x, src_y);
+	mouse_report_set(expected, buttons, dst_wheel + src_wheel,
+			 dst_x + src_x, dst_y + src_y);
+
+	zassert_true(hid_report_merge_mouse(dst, src), "Reports not merged");
+	zassert_mem_equal(dst, expected, sizeof(dst), "Wrong merged report");
+}
+
+static void check_mouse_no_merge(uint8_t dst_buttons, int8_t dst_wheel,
+				 int16_t dst_x, int16_t dst_y,
+				 uint8_t src_buttons, int8_t src_wheel,
+				 int16_t src_x, int16_t src_y)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE];
+	uint8_t src[REPORT_SIZE_MOUSE];
+	uint8_t expected[REPORT_SIZE_MOUSE];
+
+	mouse_report_set(dst, dst_buttons, dst_wheel, dst_x, dst_y);
+	mouse_report_set(src, src_buttons, src_wheel, src_x, src_y);
+	memcpy(expected, dst, sizeof(expected));
+
+	zassert_false(hid_report_merge_mouse(dst, src), "Reports merged");
+	zassert_mem_equal(dst, expected, sizeof(dst), "Report modified");
+}
+
+static void check_boot_mouse_merge(uint8_t buttons, int8_t dst_x, int8_t dst_y,
+				   int8_t src_x, int8_t src_y)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE_BOOT] = {buttons, dst_x, dst_y};
+	uint8_t src[REPORT_SIZE_MOUSE_BOOT] = {buttons, src_x, src_y};
+	uint8_t expected[REPORT_SIZE_MOUSE_BOOT] = {
+		buttons, dst_x + src_x, dst_y + src_y
+	};
+
+	zassert_true(hid_report_merge_boot_mouse(dst, src),
+		     "Reports not merged");
+	zassert_mem_equal(dst, expected, sizeof(dst), "Wrong merged report");
+}
+
+static void check_boot_mouse_no_merge(uint8_t dst_buttons, int8_t dst_x,
+				      int8_t dst_y, uint8_t src_buttons,
+				      int8_t src_x, int8_t src_y)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE_BOOT] = {dst_buttons, dst_x, dst_y};
+	uint8_t src[REPORT_SIZE_MOUSE_BOOT] = {src_buttons, src_x, src_y};
+	uint8_t expected[REPORT_SIZE_MOUSE_BOOT];
+
+	memcpy(expected, dst, sizeof(expected));
+
+	zassert_false(hid_report_merge_boot_mouse(dst, src), "Reports merged");
+	zassert_mem_equal(dst, expected, sizeof(dst), "Report modified");
+}
+
+static void test_mouse_merge(void)
+{
+	check_mouse_merge(0x00, 0, 0, 0, 0, 0, 0);
+	check_mouse_merge(0x01, 1, 10, -10, 2, 20, -20);
+	check_mouse_merge(0x05, -3, -100, 300, 5, 150, -400);
+	check_mouse_merge(0x00, 0, -1, -1, 0, -1, -1);
+
+	/* Accumulated values reach the limits of the report. */
+	check_mouse_merge(0x00, 0x7E, 0x7FE, -0x7FE, 1, 1, -1);
+	check_mouse_merge(0x00, -0x7E, -0x7FE, 0x7FE, -1, -1, 1);
+	check_mouse_merge(0x00, 0x7F, 0x7FF, -0x7FF, -0x7F, -0x7FF, 0x7FF);
+}
+
+static void test_mouse_no_merge(void)
+{
+	/* Button state differs. */
+	check_mouse_no_merge(0x00, 1, 1, 1, 0x01, 1, 1, 1);
+	check_mouse_no_merge(0x01, 0, 0, 0, 0x00, 0, 0, 0);
+
+	/* Wheel overflow. */
+	check_mouse_no_merge(0x00, 0x7F, 0, 0, 0x00, 1, 0, 0);
+	check_mouse_no_merge(0x00, -0x7F, 0, 0, 0x00, -1, 0, 0);
+
+	/* X axis overflow. */
+	check_mouse_no_merge(0x00, 0, 0x7FF, 0, 0x00, 0, 1, 0);
+	check_mouse_no_merge(0x00, 0, -0x7FF, 0, 0x00, 0, -2, 0);
+
+	/* Y axis overflow. */
+	check_mouse_no_merge(0x00, 0, 0, 0x400, 0x00, 0, 0, 0x400);
+	check_mouse_no_merge(0x00, 0, 0, -0x7FF, 0x00, 0, 0, -0x7FF);
+
+	/* Only one of the values overflows. */
+	check_mouse_no_merge(0x00, 1, 1, 0x7FF, 0x00, 1, 1, 1);
+}
+
+static void test_boot_mouse_merge(void)
+{
+	check_boot_mouse_merge(0x00, 0, 0, 0, 0);
+	check_boot_mouse_merge(0x02, 10, -10, 20, -20);
+	check_boot_mouse_merge(0x00, 0x7E, -0x7F, 1, 0x7F);
+	check_boot_mouse_merge(0x00, -0x7F, 0x7F, -1, -0x7F);
+}
+
+static void test_boot_mouse_no_merge(void)
+{
+	/* Button state differs. */
+	check_boot_mouse_no_merge(0x00, 1, 1, 0x04, 1, 1);
+
+	/* X axis overflow. */
+	check_boot_mouse_no_merge(0x00, 0x7F, 0, 0x00, 1, 0);
+	check_boot_mouse_no_merge(0x00, -0x80, 0, 0x00, -1, 0);
+
+	/* Y axis overflow. */
+	check_boot_mouse_no_merge(0x00, 0, 0x40, 0x00, 0, 0x40);
+	check_boot_mouse_no_merge(0x00, 0, -0x40, 0x00, 0, -0x41);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hid_report_merge_tests,
+			 ztest_unit_test(test_mouse_merge),
+			 ztest_unit_test(test_mouse_no_merge),
+			 ztest_unit_test(test_boot_mouse_merge),
+			 ztest_unit_test(test_boot_mouse_no_merge)
+			 );
+
+	ztest_run_test_suite(hid_report_merge_tests);
+}
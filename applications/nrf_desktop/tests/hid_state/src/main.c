@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* The HID state module is built for each key state tracking method (sorted
+ * items and key bitmap) and for keyboard reports of 6, 20 and 100 keys. Events
+ * are passed to the module directly and the submitted HID reports are
+ * recorded, so that both methods can be checked to generate identical reports.
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <sys/byteorder.h>
+
+#define MODULE main
+#include <caf/events/module_state_event.h>
+
+#include <caf/events/button_event.h>
+#include <caf/events/ble_common_event.h>
+#include "motion_event.h"
+#include "wheel_event.h"
+#include "hid_event.h"
+#include "usb_event.h"
+
+#include "hid_keymap_def.h"
+
+#define RANDOM_EVENT_CNT	20000
+#define BENCHMARK_CNT		1000
+#define REPORT_LOG_SIZE		1024
+#define REPORT_PENDING_MAX	8
+#define REPORT_SIZE_MAX		(3 + 100)
+
+EVENT_TYPE_DEFINE(module_state_event);
+EVENT_TYPE_DEFINE(button_event);
+EVENT_TYPE_DEFINE(motion_event);
+EVENT_TYPE_DEFINE(wheel_event);
+EVENT_TYPE_DEFINE(hid_report_event);
+EVENT_TYPE_DEFINE(hid_report_sent_event);
+EVENT_TYPE_DEFINE(hid_report_subscription_event);
+EVENT_TYPE_DEFINE(ble_peer_event);
+EVENT_TYPE_DEFINE(usb_hid_event);
+
+extern const struct event_listener __event_listener_hid_state_sorted_6;
+extern const struct event_listener __event_listener_hid_state_bitmap_6;
+extern const struct event_listener __event_listener_hid_state_sorted_20;
+extern const struct event_listener __event_listener_hid_state_bitmap_20;
+extern const struct event_listener __event_listener_hid_state_sorted_100;
+extern const struct event_listener __event_listener_hid_state_bitmap_100;
+
+struct engine {
+	const struct event_listener *listener;
+	size_t key_cnt;
+
+	bool connected;
+	uint8_t pending_id[REPORT_PENDING_MAX];
+	size_t pending_cnt;
+
+	bool record;
+	size_t report_cnt;
+	uint32_t report_timestamp; /* Of the first recorded report. */
+	size_t log_len;
+	uint8_t log[REPORT_LOG_SIZE];
+};
+
+#define ENGINE(_method, _key_cnt) {					\
+		.listener = &_CONCAT(__event_listener_hid_state_,	\
+				     _method##_##_key_cnt),		\
+		.key_cnt = _key_cnt,					\
+		.record = true,						\
+	}
+
+/* Engines are listed in pairs of sorted items and key bitmap. */
+static struct engine engines[] = {
+	ENGINE(sorted, 6),
+	ENGINE(bitmap, 6),
+	ENGINE(sorted, 20),
+	ENGINE(bitmap, 20),
+	ENGINE(sorted, 100),
+	ENGINE(bitmap, 100),
+};
+
+static struct engine *active_engine;
+static uint8_t peer;
+static struct hid_report_sent_event *sent_event;
+static uint32_t rand_state = 0x2545F491;
+
+
+static uint32_t rand_get(void)
+{
+	/* Fixed sequence, so that failures can be reproduced. */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+void event_submit_stub(struct event_header *eh)
+{
+	struct engine *engine = active_engine;
+
+	zassert_not_null(engine, "Event submitted outside of a handler");
+	zassert_true(is_hid_report_event(eh), "Unexpected %s submitted",
+		     eh->type_id->name);
+
+	struct hid_report_event *event = cast_hid_report_event(eh);
+
+	zassert_equal_ptr(event->subscriber, &peer, "Wrong subscriber");
+	zassert_true(engine->pending_cnt < ARRAY_SIZE(engine->pending_id),
+		     "Too many reports in flight");
+
+	engine->pending_id[engine->pending_cnt] = event->dyndata.data[0];
+	engine->pending_cnt++;
+
+	if (!engine->report_cnt) {
+		engine->report_timestamp = event->timestamp;
+	}
+	engine->report_cnt++;
+
+	if (engine->record) {
+		zassert_true(engine->log_len + event->dyndata.size <=
+			     sizeof(engine->log), "Report log overflow");
+		memcpy(&engine->log[engine->log_len], event->dyndata.data,
+		       event->dyndata.size);
+		engine->log_len += event->dyndata.size;
+	}
+
+	k_free(event);
+}
+
+static void event_send(struct engine *engine, struct event_header *eh)
+{
+	active_engine = engine;
+	engine->listener->notification(eh);
+	active_engine = NULL;
+}
+
+static void button_send(struct engine *engine, uint16_t key_id, bool pressed,
+			uint32_t timestamp)
+{
+	struct button_event *event = new_button_event();
+
+	event->key_id = key_id;
+	event->pressed = pressed;
+	event->timestamp = timestamp;
+
+	event_send(engine, &event->header);
+	k_free(event);
+}
+
+static bool report_ack(struct engine *engine)
+{
+	if (!engine->pending_cnt) {
+		return false;
+	}
+
+	sent_event->subscriber = &peer;
+	sent_event->report_id = engine->pending_id[0];
+	sent_event->error = false;
+	sent_event->timestamp = 0;
+
+	engine->pending_cnt--;
+	memmove(&engine->pending_id[0], &engine->pending_id[1],
+		engine->pending_cnt * sizeof(engine->pending_id[0]));
+
+	event_send(engine, &sent_event->header);
+
+	return true;
+}
+
+static void reports_ack(struct engine *engine)
+{
+	while (report_ack(engine)) {
+	}
+}
+
+static void subscription_send(struct engine *engine, uint8_t report_id,
+			      bool enabled)
+{
+	struct hid_report_subscription_event *event =
+		new_hid_report_subscription_event();
+
+	event->subscriber = &peer;
+	event->report_id = report_id;
+	event->enabled = enabled;
+
+	event_send(engine, &event->header);
+	k_free(event);
+}
+
+static void peer_state_send(struct engine *engine, enum peer_state state)
+{
+	struct ble_peer_event *event = new_ble_peer_event();
+
+	event->id = &peer;
+	event->state = state;
+
+	event_send(engine, &event->header);
+	k_free(event);
+}
+
+static void log_reset(struct engine *engine)
+{
+	engine->report_cnt = 0;
+	engine->log_len = 0;
+}
+
+static void peer_connect(struct engine *engine)
+{
+	peer_state_send(engine, PEER_STATE_CONNECTED);
+	subscription_send(engine, REPORT_ID_KEYBOARD_KEYS, true);
+	subscription_send(engine, REPORT_ID_CONSUMER_CTRL, true);
+	engine->connected = true;
+}
+
+static void peer_disconnect(struct engine *engine)
+{
+	peer_state_send(engine, PEER_STATE_DISCONNECTED);
+	engine->pending_cnt = 0;
+	engine->connected = false;
+}
+
+/* Keyboard report expected for the given number of presses of each usage. */
+static size_t keyboard_report_get(const struct engine *engine,
+				  const uint8_t *usage_cnt, uint8_t *report)
+{
+	size_t cnt = 0;
+
+	report[0] = REPORT_ID_KEYBOARD_KEYS;
+	report[1] = 0;
+	report[2] = 0;
+
+	for (size_t usage = UINT8_MAX; usage > 0; usage--) {
+		if (!usage_cnt[usage]) {
+			continue;
+		}
+
+		if ((usage >= KEYBOARD_REPORT_FIRST_MODIFIER) &&
+		    (usage <= KEYBOARD_REPORT_LAST_MODIFIER)) {
+			report[1] |= BIT(usage - KEYBOARD_REPORT_FIRST_MODIFIER);
+		} else {
+			report[3 + cnt] = usage;
+			cnt++;
+		}
+	}
+
+	zassert_true(cnt <= engine->key_cnt, "Too many keys in the model");
+	memset(&report[3 + cnt], 0, engine->key_cnt - cnt);
+
+	return 3 + engine->key_cnt;
+}
+
+static void test_init(void)
+{
+	sent_event = new_hid_report_sent_event();
+
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+		struct module_state_event *event = new_module_state_event();
+
+		event->module_id = MODULE_ID(main);
+		event->state = MODULE_STATE_READY;
+
+		event_send(&engines[i], &event->header);
+		k_free(event);
+	}
+}
+
+/* Reports are acknowledged before the next key event, so every change of the
+ * pressed usages is reported right away. The expected reports follow the rules
+ * of the HID state: a press of a new usage is ignored when the report is full,
+ * a release of a usage that is not pressed is ignored and keys mapped to the
+ * same usage are counted.
+ */
+static void test_key_reports(void)
+{
+	static uint8_t usage_cnt[REPORT_ID_COUNT][UINT8_MAX + 1];
+	size_t usage_total[REPORT_ID_COUNT];
+	uint8_t report[REPORT_SIZE_MAX];
+
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+		struct engine *engine = &engines[i];
+
+		memset(usage_cnt, 0, sizeof(usage_cnt));
+		memset(usage_total, 0, sizeof(usage_total));
+
+		peer_connect(engine);
+		reports_ack(engine);
+
+		/* Release a key that is not pressed, press all keys and
+		 * release them in the same order.
+		 */
+		for (uint32_t step = 0; step <= 2 * TEST_KEY_ID_COUNT; step++) {
+			bool pressed = (step > 0) && (step <= TEST_KEY_ID_COUNT);
+			uint16_t key_id = (step > 0) ?
+					  ((step - 1) % TEST_KEY_ID_COUNT) : 0;
+			const struct hid_keymap *map = &hid_keymap[key_id];
+			uint8_t *cnt = &usage_cnt[map->report_id][map->usage_id];
+			size_t *total = &usage_total[map->report_id];
+			size_t max = (map->report_id == REPORT_ID_CONSUMER_CTRL) ?
+				     CONSUMER_CTRL_REPORT_KEY_COUNT_MAX :
+				     engine->key_cnt;
+			bool update = false;
+
+			zassert_equal(map->key_id, key_id, "Invalid test keymap");
+
+			if (!map->usage_id) {
+				/* Key is not mapped. */
+			} else if (*cnt > 0) {
+				if (pressed) {
+					*cnt += 1;
+				} else {
+					*cnt -= 1;
+					*total -= (*cnt == 0);
+				}
+				update = true;
+			} else if (pressed && (*total < max)) {
+				*cnt = 1;
+				*total += 1;
+				update = true;
+			}
+
+			log_reset(engine);
+			button_send(engine, key_id, pressed, step);
+
+			if (!update) {
+				zassert_equal(engine->report_cnt, 0,
+					      "Unexpected report for key %u",
+					      key_id);
+				continue;
+			}
+
+			size_t size;
+			size_t copies;
+
+			if (map->report_id == REPORT_ID_CONSUMER_CTRL) {
+				report[0] = REPORT_ID_CONSUMER_CTRL;
+				sys_put_le16(*cnt ? map->usage_id : 0, &report[1]);
+				size = 3;
+				copies = 1;
+			} else {
+				size = keyboard_report_get(engine,
+					usage_cnt[REPORT_ID_KEYBOARD_KEYS], report);
+				/* Over Bluetooth, the keyboard report is sent
+				 * twice to fill the pipeline.
+				 */
+				copies = 2;
+			}
+
+			zassert_equal(engine->report_cnt, copies,
+				      "Wrong number of reports for key %u", key_id);
+			zassert_equal(engine->report_timestamp, step,
+				      "Wrong report timestamp");
+			zassert_equal(engine->log_len, copies * size,
+				      "Wrong report size");
+
+			for (size_t j = 0; j < copies; j++) {
+				zassert_mem_equal(&engine->log[j * size], report, size,
+						  "Wrong report for key %u", key_id);
+			}
+
+			reports_ack(engine);
+		}
+
+		peer_disconnect(engine);
+	}
+}
+
+static void engines_compare(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i += 2) {
+		struct engine *sorted = &engines[i];
+		struct engine *bitmap = &engines[i + 1];
+
+		zassert_equal(sorted->report_cnt, bitmap->report_cnt,
+			      "Different number of reports");
+		zassert_equal(sorted->pending_cnt, bitmap->pending_cnt,
+			      "Different number of reports in flight");
+		zassert_equal(sorted->log_len, bitmap->log_len,
+			      "Different report sizes");
+		zassert_mem_equal(sorted->log, bitmap->log, sorted->log_len,
+				  "Different reports");
+	}
+}
+
+/* Random key presses, releases, report acknowledgments and reconnections are
+ * passed to all engines. Both methods must generate the same reports after
+ * every event.
+ */
+static void test_random_events(void)
+{
+	static bool key_pressed[TEST_KEY_ID_COUNT];
+	size_t report_cnt = 0;
+
+	for (uint32_t step = 1; step <= RANDOM_EVENT_CNT; step++) {
+		uint32_t rnd = rand_get();
+		uint32_t choice = rnd % 100;
+		uint16_t key_id = (rnd >> 8) % TEST_KEY_ID_COUNT;
+		bool connected = engines[0].connected;
+
+		/* Keys are released more often than pressed, so that the
+		 * reports are not always full. Key releases are also sent for
+		 * keys that are not pressed.
+		 */
+		bool pressed = !key_pressed[key_id] && !((rnd >> 24) % 4);
+
+		for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+			struct engine *engine = &engines[i];
+
+			log_reset(engine);
+
+			if (!connected && (choice < 10)) {
+				peer_connect(engine);
+			} else if (connected && (choice < 1)) {
+				reports_ack(engine);
+				peer_disconnect(engine);
+			} else if (connected && (choice < 30)) {
+				report_ack(engine);
+			} else if (connected && (choice < 35)) {
+				reports_ack(engine);
+			} else {
+				button_send(engine, key_id, pressed, step);
+			}
+		}
+
+		if (choice >= 35) {
+			key_pressed[key_id] = pressed;
+		}
+
+		engines_compare();
+		report_cnt += engines[0].report_cnt;
+	}
+
+	TC_PRINT("%u random events, %zu reports\n", RANDOM_EVENT_CNT,
+		 report_cnt);
+
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+		if (engines[i].connected) {
+			reports_ack(&engines[i]);
+			peer_disconnect(&engines[i]);
+		}
+	}
+}
+
+/* Press and release a key while all other keys of the keyboard report are
+ * held. The timings are only meaningful on hardware.
+ */
+static void test_key_benchmark(void)
+{
+	uint32_t ns[ARRAY_SIZE(engines)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+		struct engine *engine = &engines[i];
+		uint16_t key_id = engine->key_cnt - 1;
+
+		engine->record = false;
+		peer_connect(engine);
+		reports_ack(engine);
+
+		for (uint16_t held_key_id = 0; held_key_id < key_id; held_key_id++) {
+			button_send(engine, held_key_id, true, 0);
+			reports_ack(engine);
+		}
+
+		struct button_event *press = new_button_event();
+		struct button_event *release = new_button_event();
+
+		press->key_id = key_id;
+		press->pressed = true;
+		release->key_id = key_id;
+		release->pressed = false;
+
+		log_reset(engine);
+
+		uint32_t cycles = k_cycle_get_32();
+
+		for (size_t j = 0; j < BENCHMARK_CNT; j++) {
+			press->timestamp = cycles;
+			event_send(engine, &press->header);
+			reports_ack(engine);
+
+			release->timestamp = cycles;
+			event_send(engine, &release->header);
+			reports_ack(engine);
+		}
+
+		cycles = k_cycle_get_32() - cycles;
+		ns[i] = k_cyc_to_ns_floor64(cycles) / (2 * BENCHMARK_CNT);
+
+		/* Each key event fills the pipeline with two reports. */
+		zassert_equal(engine->report_cnt, 4 * BENCHMARK_CNT,
+			      "Wrong number of reports");
+
+		engine->record = true;
+		k_free(press);
+		k_free(release);
+
+		peer_disconnect(engine);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(engines); i += 2) {
+		TC_PRINT("%3zu keys: sorted %u ns, bitmap %u ns per key event\n",
+			 engines[i].key_cnt, ns[i], ns[i + 1]);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hid_state_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_key_reports),
+			 ztest_unit_test(test_random_events),
+			 ztest_unit_test(test_key_benchmark)
+			 );
+
+	ztest_run_test_suite(hid_state_tests);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _EVENT_MANAGER_H_
+#define _EVENT_MANAGER_H_
+
+/* Event manager replacement used to build the HID state module directly.
+ *
+ * Events are not queued. The test passes each event to the listener
+ * synchronously and every submitted event is handed to event_submit_stub.
+ */
+
+#include <zephyr.h>
+#include <zephyr/types.h>
+#include <sys/util.h>
+#include <sys/__assert.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct event_type {
+	const char *name;
+};
+
+struct event_header {
+	const struct event_type *type_id;
+};
+
+struct event_dyndata {
+	size_t size;
+	uint8_t data[];
+};
+
+struct event_listener {
+	const char *name;
+	bool (*notification)(const struct event_header *eh);
+};
+
+/* Implemented by the test. Called instead of submitting the event. */
+void event_submit_stub(struct event_header *eh);
+
+#define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
+
+#define _EVENT_TYPE_DECLARE_COMMON(ename)					\
+	extern const struct event_type _CONCAT(__event_type_, ename);		\
+	static inline bool _CONCAT(is_, ename)(const struct event_header *eh)	\
+	{									\
+		return (eh->type_id == _EVENT_ID(ename));			\
+	}									\
+	static inline struct ename *_CONCAT(cast_, ename)(const struct event_header *eh) \
+	{									\
+		__ASSERT_NO_MSG(eh->type_id == _EVENT_ID(ename));		\
+		return CONTAINER_OF(eh, struct ename, header);			\
+	}
+
+#define EVENT_TYPE_DECLARE(ename)						\
+	_EVENT_TYPE_DECLARE_COMMON(ename)					\
+	static inline struct ename *_CONCAT(new_, ename)(void)			\
+	{									\
+		struct ename *event = k_malloc(sizeof(*event));			\
+										\
+		__ASSERT(event, "Event Manager OOM error");			\
+		event->header.type_id = _EVENT_ID(ename);			\
+		return event;							\
+	}
+
+#define EVENT_TYPE_DYNDATA_DECLARE(ename)					\
+	_EVENT_TYPE_DECLARE_COMMON(ename)					\
+	static inline struct ename *_CONCAT(new_, ename)(size_t size)		\
+	{									\
+		struct ename *event = k_malloc(sizeof(*event) + size);		\
+										\
+		__ASSERT(event, "Event Manager OOM error");			\
+		event->header.type_id = _EVENT_ID(ename);			\
+		event->dyndata.size = size;					\
+		return event;							\
+	}
+
+#define EVENT_TYPE_DEFINE(ename)						\
+	const struct event_type _CONCAT(__event_type_, ename) = {		\
+		.name = STRINGIFY(ename),					\
+	}
+
+#define EVENT_LISTENER(lname, cb_fn)						\
+	const struct event_listener _CONCAT(__event_listener_, lname) = {	\
+		.name = STRINGIFY(lname),					\
+		.notification = (cb_fn),					\
+	}
+
+/* Subscriptions are implied, the test only sends subscribed events. */
+#define EVENT_SUBSCRIBE_EARLY(lname, ename) \
+	extern const struct event_type _CONCAT(__event_type_, ename)
+#define EVENT_SUBSCRIBE(lname, ename) \
+	extern const struct event_type _CONCAT(__event_type_, ename)
+#define EVENT_SUBSCRIBE_FINAL(lname, ename) \
+	extern const struct event_type _CONCAT(__event_type_, ename)
+
+#define EVENT_SUBMIT(event) event_submit_stub(&(event)->header)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EVENT_MANAGER_H_ */
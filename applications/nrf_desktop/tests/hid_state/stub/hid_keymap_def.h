@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "hid_keymap.h"
+
+/* HID keymap of the test, included by the HID state module and by the test.
+ * The key IDs are used by the test as indexes of the keymap.
+ */
+
+#define TEST_KEY_ID_MODIFIER	0x0062
+#define TEST_KEY_ID_ALIAS	0x006A
+#define TEST_KEY_ID_CONSUMER	0x0070
+#define TEST_KEY_ID_NO_USAGE	0x0072
+#define TEST_KEY_ID_COUNT	0x0073
+
+static const struct hid_keymap hid_keymap[] = {
+	/* Keyboard keys, from A to Application. */
+	{ 0x0000, 0x0004, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0001, 0x0005, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0002, 0x0006, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0003, 0x0007, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0004, 0x0008, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0005, 0x0009, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0006, 0x000A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0007, 0x000B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0008, 0x000C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0009, 0x000D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000A, 0x000E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000B, 0x000F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000C, 0x0010, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000D, 0x0011, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000E, 0x0012, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x000F, 0x0013, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0010, 0x0014, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0011, 0x0015, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0012, 0x0016, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0013, 0x0017, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0014, 0x0018, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0015, 0x0019, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0016, 0x001A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0017, 0x001B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0018, 0x001C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0019, 0x001D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001A, 0x001E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001B, 0x001F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001C, 0x0020, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001D, 0x0021, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001E, 0x0022, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x001F, 0x0023, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0020, 0x0024, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0021, 0x0025, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0022, 0x0026, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0023, 0x0027, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0024, 0x0028, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0025, 0x0029, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0026, 0x002A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0027, 0x002B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0028, 0x002C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0029, 0x002D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002A, 0x002E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002B, 0x002F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002C, 0x0030, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002D, 0x0031, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002E, 0x0032, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x002F, 0x0033, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0030, 0x0034, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0031, 0x0035, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0032, 0x0036, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0033, 0x0037, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0034, 0x0038, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0035, 0x0039, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0036, 0x003A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0037, 0x003B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0038, 0x003C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0039, 0x003D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003A, 0x003E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003B, 0x003F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003C, 0x0040, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003D, 0x0041, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003E, 0x0042, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x003F, 0x0043, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0040, 0x0044, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0041, 0x0045, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0042, 0x0046, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0043, 0x0047, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0044, 0x0048, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0045, 0x0049, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0046, 0x004A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0047, 0x004B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0048, 0x004C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0049, 0x004D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004A, 0x004E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004B, 0x004F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004C, 0x0050, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004D, 0x0051, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004E, 0x0052, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x004F, 0x0053, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0050, 0x0054, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0051, 0x0055, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0052, 0x0056, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0053, 0x0057, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0054, 0x0058, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0055, 0x0059, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0056, 0x005A, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0057, 0x005B, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0058, 0x005C, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0059, 0x005D, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005A, 0x005E, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005B, 0x005F, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005C, 0x0060, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005D, 0x0061, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005E, 0x0062, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x005F, 0x0063, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0060, 0x0064, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0061, 0x0065, REPORT_ID_KEYBOARD_KEYS },
+
+	/* Keyboard modifiers. */
+	{ 0x0062, 0x00E0, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0063, 0x00E1, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0064, 0x00E2, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0065, 0x00E3, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0066, 0x00E4, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0067, 0x00E5, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0068, 0x00E6, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x0069, 0x00E7, REPORT_ID_KEYBOARD_KEYS },
+
+	/* Second set of keys mapped to the first usages. */
+	{ 0x006A, 0x0004, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x006B, 0x0005, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x006C, 0x0006, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x006D, 0x0007, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x006E, 0x0008, REPORT_ID_KEYBOARD_KEYS },
+	{ 0x006F, 0x0009, REPORT_ID_KEYBOARD_KEYS },
+
+	/* Consumer Control volume up and volume down. */
+	{ 0x0070, 0x00E9, REPORT_ID_CONSUMER_CTRL },
+	{ 0x0071, 0x00EA, REPORT_ID_CONSUMER_CTRL },
+
+	/* Key without usage. */
+	{ 0x0072, 0x0000, REPORT_ID_KEYBOARD_KEYS },
+};
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_REPORT_DESC_H_
+#define _HID_REPORT_DESC_H_
+
+/* Report IDs and formats of the nRF Desktop configuration, with the number
+ * of keys in the keyboard report set by KEYBOARD_KEY_COUNT.
+ */
+
+#include <stddef.h>
+#include <zephyr/types.h>
+#include <toolchain/common.h>
+#include <sys/util.h>
+
+#include "hid_report_mouse.h"
+#include "hid_report_system_ctrl.h"
+#include "hid_report_consumer_ctrl.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef KEYBOARD_KEY_COUNT
+#define KEYBOARD_KEY_COUNT		6
+#endif
+
+#define REPORT_SIZE_KEYBOARD_KEYS	(KEYBOARD_KEY_COUNT + 2) /* bytes */
+
+#define KEYBOARD_REPORT_LAST_KEY	0x65 /* Keyboard Application */
+#define KEYBOARD_REPORT_FIRST_MODIFIER	0xE0 /* Keyboard Left Ctrl */
+#define KEYBOARD_REPORT_LAST_MODIFIER	0xE7 /* Keyboard Right GUI */
+#define KEYBOARD_REPORT_KEY_COUNT_MAX	KEYBOARD_KEY_COUNT
+
+enum report_id {
+	REPORT_ID_RESERVED,
+
+	REPORT_ID_MOUSE,
+	REPORT_ID_KEYBOARD_KEYS,
+	REPORT_ID_SYSTEM_CTRL,
+	REPORT_ID_CONSUMER_CTRL,
+
+	REPORT_ID_KEYBOARD_LEDS,
+
+	REPORT_ID_USER_CONFIG,
+	REPORT_ID_USER_CONFIG_OUT,
+
+	REPORT_ID_VENDOR_IN,
+	REPORT_ID_VENDOR_OUT,
+
+	REPORT_ID_BOOT_MOUSE,
+	REPORT_ID_BOOT_KEYBOARD,
+
+	REPORT_ID_COUNT
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HID_REPORT_DESC_H_ */
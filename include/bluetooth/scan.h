@@ -108,6 +108,21 @@ struct bt_scan_filter_info {
 	uint8_t cnt;
 };
 
+/**@brief Advertising report deduplication statistics.
+ */
+struct bt_scan_dedup_stats {
+	/** Reports dropped as duplicates. */
+	uint32_t hit;
+
+	/** Reports passed on because the device was not cached, the data
+	 *  changed or the re-report interval elapsed.
+	 */
+	uint32_t miss;
+
+	/** Cache entries reused for new devices. */
+	uint32_t evicted;
+};
+
 /**@brief Filter status structure.
  */
 struct bt_filter_status {
@@ -543,6 +558,23 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+/**@brief Get the advertising report deduplication statistics.
+ *
+ * @param[out] stats Deduplication statistics.
+ *
+ * @retval 0 If the operation was successful. Otherwise, a (negative) error
+ *	     code is returned.
+ */
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats);
+
+/**@brief Clear the advertising report deduplication cache.
+ *
+ * @details Use this function to remove all devices from the cache
+ *          and reset the statistics. The next report of every
+ *          device is passed to the application.
+ */
+void bt_scan_dedup_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
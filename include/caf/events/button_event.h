@@ -33,6 +33,9 @@ struct button_event {
 
 	/** Information if the button was pressed or released. */
 	bool pressed;
+
+	/** Time of the state change, in hardware cycles (k_cycle_get_32). */
+	uint32_t timestamp;
 };
 
 #ifdef __cplusplus
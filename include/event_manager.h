@@ -82,6 +82,39 @@ struct event_dyndata {
 };
 
 
+/** @def EVENT_LISTENER_STATS_BUCKET_CNT
+ *
+ * @brief Number of buckets in the listener execution time histogram.
+ */
+#define EVENT_LISTENER_STATS_BUCKET_CNT 16
+
+
+/** @brief Event listener execution time statistics.
+ *
+ * Statistics are collected for every listener when
+ * @option{CONFIG_EVENT_MANAGER_LISTENER_STATS} is enabled.
+ * Execution time is measured in cycles of the DWT cycle counter if
+ * available, or in cycles of the system timer otherwise.
+ */
+struct event_listener_stats {
+	/** Histogram of execution times. Bucket i counts notifications
+	 *  that took less than 2^(i + 1 + shift) cycles, where shift is
+	 *  @option{CONFIG_EVENT_MANAGER_LISTENER_STATS_BUCKET_SHIFT}.
+	 *  The last bucket counts all longer notifications.
+	 */
+	uint32_t hist[EVENT_LISTENER_STATS_BUCKET_CNT];
+
+	/** Total execution time. */
+	uint64_t total;
+
+	/** Maximum execution time. */
+	uint32_t max;
+
+	/** Number of notifications. */
+	uint32_t cnt;
+};
+
+
 /** @brief Event listener.
  *
  * All event listeners must be defined using @ref EVENT_LISTENER.
@@ -93,6 +126,11 @@ struct event_listener {
 	/** Pointer to the function that is called when an event
 	 *  is handled. */
 	bool (*notification)(const struct event_header *eh);
+
+#ifdef CONFIG_EVENT_MANAGER_LISTENER_STATS
+	/** Execution time statistics of this listener. */
+	struct event_listener_stats *stats;
+#endif
 };
 
 
@@ -122,6 +160,56 @@ struct event_info {
 };
 
 
+/** @brief Event queue.
+ *
+ * All event queues must be defined using @ref EVENT_QUEUE_DEFINE.
+ */
+struct event_queue {
+	/** Name of this queue. */
+	const char *name;
+
+	/** Workqueue processing events of this queue. */
+	struct k_work_q *work_q;
+
+	/** Stack of the workqueue thread. */
+	k_thread_stack_t *stack;
+
+	/** Size of the workqueue thread stack. */
+	size_t stack_size;
+
+	/** Priority of the workqueue thread. */
+	int prio;
+
+	/** List of events waiting to be processed. */
+	sys_slist_t eventq;
+
+	/** Work item processing events. */
+	struct k_work work;
+
+	/** Bool indicating if the workqueue is started. */
+	bool started;
+};
+
+
+/** @brief Event memory pool.
+ *
+ * Pool is defined for every event type when
+ * @option{CONFIG_EVENT_MANAGER_EVENT_POOL} is enabled.
+ */
+struct event_pool {
+	/** Memory slab used to allocate events. */
+	struct k_mem_slab *slab;
+
+	/** Maximum number of slab blocks used at the same time. */
+	uint32_t max_used;
+
+	/** Number of events allocated from heap because the slab was
+	 *  exhausted or the event did not fit in the slab block.
+	 */
+	uint32_t heap_alloc_cnt;
+};
+
+
 /** @brief Event type.
  */
 struct event_type {
@@ -144,6 +232,22 @@ struct event_type {
 
 	/** Logging and formatting information. */
 	const struct event_info *ev_info;
+
+	/** Queue used to process events of this type. NULL for the default
+	 *  queue processed by the system workqueue.
+	 */
+	struct event_queue *queue;
+
+	/** Function merging a submitted event into the last queued event
+	 *  of the same type. NULL if events of this type are not coalescable.
+	 */
+	bool (*merge)(struct event_header *queued,
+		      const struct event_header *eh);
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+	/** Memory pool used to allocate events of this type. */
+	struct event_pool *pool;
+#endif
 };
 
 
@@ -258,7 +362,103 @@ extern const struct event_type __stop_event_types[];
  * @param ev_info_struct   Data structure describing the event type.
  */
 #define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct) \
-	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, NULL, NULL)
+
+
+/** Define a coalescable event type.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but a submitted event of
+ * the defined type can be merged into the previous event of the same type
+ * if that event is still waiting in the queue and no other event was
+ * submitted to the queue in between. The merged event is freed and
+ * listeners are notified only about the queued event.
+ *
+ * The merge function is called with the Event Manager lock held, so that
+ * the queued event is not processed while it is modified. The function may
+ * be called from an interrupt, runs with interrupts locked, and must be
+ * short. It must not block, submit events or free any of the events. It must
+ * return true if the submitted event was merged into the queued one, or false
+ * if both events must be processed separately.
+ *
+ * Only the events that are queued are traced as submitted by the profiler.
+ * A merged event is neither traced as submitted nor executed.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param merge_fn         Function merging a submitted event into
+ *                         the queued one.
+ */
+#define EVENT_TYPE_DEFINE_COALESCABLE(ename, init_log_en, log_fn, ev_info_struct, merge_fn) \
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, NULL, merge_fn)
+
+
+/** Define an event queue.
+ *
+ * Events of types assigned to the queue are processed in order of
+ * submission by a dedicated workqueue thread. Events of different queues
+ * are processed independently, so a burst of events in one queue does not
+ * delay processing of events in a queue with a higher thread priority.
+ * Events of types defined with @ref EVENT_TYPE_DEFINE are processed
+ * by the system workqueue.
+ *
+ * @note Listeners of events processed by different queues can be called
+ *       from different threads and must protect the shared data.
+ *
+ * @param qname       Name of the queue.
+ * @param thread_prio Priority of the workqueue thread.
+ * @param stack_size  Stack size of the workqueue thread.
+ */
+#define EVENT_QUEUE_DEFINE(qname, thread_prio, stack_size) \
+	_EVENT_QUEUE_DEFINE(qname, thread_prio, stack_size)
+
+
+/** Declare an event queue.
+ *
+ * This macro provides declarations required for an event queue to be used
+ * in event type definitions in other source files.
+ *
+ * @param qname  Name of the queue.
+ */
+#define EVENT_QUEUE_DECLARE(qname) _EVENT_QUEUE_DECLARE(qname)
+
+
+/** Define an event type processed by a dedicated event queue.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but events of the defined
+ * type are processed by the given queue instead of the system workqueue.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param qname            Name of the queue defined with
+ *                         @ref EVENT_QUEUE_DEFINE.
+ */
+#define EVENT_TYPE_DEFINE_ON_QUEUE(ename, init_log_en, log_fn, ev_info_struct, qname) \
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, _EVENT_QUEUE(qname), NULL)
+
+
+/** Define a coalescable event type processed by a dedicated event queue.
+ *
+ * This macro combines @ref EVENT_TYPE_DEFINE_COALESCABLE and
+ * @ref EVENT_TYPE_DEFINE_ON_QUEUE.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param merge_fn         Function merging a submitted event into
+ *                         the queued one.
+ * @param qname            Name of the queue defined with
+ *                         @ref EVENT_QUEUE_DEFINE.
+ */
+#define EVENT_TYPE_DEFINE_COALESCABLE_ON_QUEUE(ename, init_log_en, log_fn, ev_info_struct, merge_fn, qname) \
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, _EVENT_QUEUE(qname), merge_fn)
 
 
 /** Verify if an event ID is valid.
@@ -273,6 +473,19 @@ extern const struct event_type __stop_event_types[];
 	__ASSERT_NO_MSG((id >= __start_event_types) && (id < __stop_event_types))
 
 
+/** Allocate an event from the memory pool of the given event type.
+ *
+ * If the pool is exhausted or the event does not fit in the pool block,
+ * the event is allocated from the heap.
+ *
+ * @param et    Pointer to the event type.
+ * @param size  Size of the event, including dynamic data.
+ *
+ * @return Pointer to the allocated memory or NULL on failure.
+ */
+void *_event_pool_alloc(const struct event_type *et, size_t size);
+
+
 /** Submit an event to the Event Manager.
  *
  * @param eh  Pointer to the event header element in the event object.
@@ -289,6 +502,29 @@ void _event_submit(struct event_header *eh);
 #define EVENT_SUBMIT(event) _event_submit(&event->header)
 
 
+/** Submit a batch of events to the Event Manager.
+ *
+ * Events are submitted in the array order. Consecutive events processed
+ * by the same event queue are added to the queue under a single lock.
+ *
+ * @param ehs  Array of pointers to the event header elements in the event
+ *             objects.
+ * @param cnt  Number of events in the array.
+ */
+void _event_submit_batch(struct event_header **ehs, size_t cnt);
+
+
+/** Submit a batch of events.
+ *
+ * This helper macro simplifies the batch event submission.
+ *
+ * @param ehs  Array of pointers to the event header elements in the event
+ *             objects.
+ * @param cnt  Number of events in the array.
+ */
+#define EVENT_SUBMIT_BATCH(ehs, cnt) _event_submit_batch(ehs, cnt)
+
+
 /** Initialize the Event Manager.
  *
  * @retval 0 If the operation was successful.
@@ -21,8 +21,10 @@
 extern "C" {
 #endif
 
+#include <kernel.h>
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 /**
  * @brief AT command return codes
@@ -54,6 +56,55 @@ enum at_cmd_state {
  */
 typedef void (*at_cmd_handler_t)(const char *response);
 
+struct at_cmd_async;
+
+/**
+ * @typedef at_cmd_async_handler_t
+ *
+ * Handler called when an asynchronous AT command request completes. The result
+ * of the command is stored in the @p req structure.
+ *
+ * @param req      Completed request.
+ * @param response Null terminated string containing the modem response
+ *                 without the final result code. Empty if the command was
+ *                 not executed.
+ */
+typedef void (*at_cmd_async_handler_t)(struct at_cmd_async *req,
+				       const char *response);
+
+/**
+ * @brief Asynchronous AT command request.
+ *
+ * The request must remain valid until it is completed.
+ */
+struct at_cmd_async {
+	/** Pointer to null terminated AT command string. */
+	const char *cmd;
+
+	/** Buffer to put the response in. NULL pointer is allowed. */
+	char *resp;
+
+	/** Length of the response buffer. */
+	size_t resp_size;
+
+	/** Completion handler. NULL pointer is allowed. */
+	at_cmd_async_handler_t handler;
+
+	/** User data, not used by the driver. */
+	void *user_data;
+
+	/** State of the command, valid after completion. */
+	enum at_cmd_state state;
+
+	/** Return code of the command, valid after completion. Same as the
+	 *  return value of at_cmd_write().
+	 */
+	int code;
+
+	/** Internal: signalled on completion. */
+	struct k_sem done;
+};
+
 /**@brief Initialize or recover the AT command driver.
  *
  * @return Zero on success, non-zero otherwise.
@@ -132,6 +183,68 @@ int at_cmd_write(const char *const cmd,
 		 size_t buf_len,
 		 enum at_cmd_state *state);
 
+/**
+ * @brief Function to queue a batch of AT commands without waiting for the
+ *        responses.
+ *
+ * The commands are queued next to each other, so commands from other callers
+ * are not executed in between. Each command is written to the modem as soon
+ * as the previous one completes (or earlier, see
+ * @option{CONFIG_AT_CMD_PIPELINE_DEPTH}), without a round trip to the caller.
+ * The result of every command is reported through the request handler and can
+ * be awaited using at_cmd_async_wait().
+ *
+ * @param reqs        Array of requests.
+ * @param count       Number of requests, at most
+ *                    @option{CONFIG_AT_CMD_QUEUE_LEN}.
+ * @param transaction If true, the commands following a failed command are
+ *                    not written to the modem and complete with the
+ *                    @ref AT_CMD_ERROR_QUEUE state and -ECANCELED code.
+ *                    Commands already awaiting a response are still
+ *                    executed.
+ *
+ * @note The handler runs from at_cmd's thread, or from the caller's context
+ *       if the command could not be written. It must not call at_cmd_write,
+ *       as that would lead to a deadlock.
+ *
+ * @retval 0 If the commands were queued.
+ * @retval -EINVAL is returned if any of the commands is invalid or the batch
+ *         is too large.
+ * @retval -EHOSTDOWN is returned if the Modem library is shutdown.
+ */
+int at_cmd_write_batch(struct at_cmd_async *reqs, size_t count,
+		       bool transaction);
+
+/**
+ * @brief Function to queue an AT command without waiting for the response.
+ *
+ * Equivalent to at_cmd_write_batch() with a single request.
+ *
+ * @param req Request.
+ *
+ * @return Zero on success, negative error code otherwise.
+ */
+int at_cmd_write_async(struct at_cmd_async *req);
+
+/**
+ * @brief Function to wait for the completion of an asynchronous AT command.
+ *
+ * Can be called multiple times for the same request.
+ *
+ * @param req     Request queued with at_cmd_write_async() or
+ *                at_cmd_write_batch().
+ * @param timeout Waiting period.
+ * @param state   Pointer to enum @em at_cmd_state variable that can hold
+ *                the state of the command. NULL pointer is allowed.
+ *
+ * @retval -EAGAIN is returned if the command did not complete in time.
+ * @retval -EHOSTDOWN is returned if the Modem library was shut down before
+ *         the command completed.
+ * @return Return code of the command, same as for at_cmd_write(), otherwise.
+ */
+int at_cmd_async_wait(struct at_cmd_async *req, k_timeout_t timeout,
+		      enum at_cmd_state *state);
+
 /**
  * @brief Function to set AT command global notification handler
  *
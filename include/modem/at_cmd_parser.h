@@ -106,6 +106,47 @@ int at_parser_max_params_from_str(const char *at_params_str,
 int at_parser_params_from_str(const char *at_params_str, char **next_param_str,
 			      struct at_param_list *const list);
 
+/**
+ * @brief Parse AT command or response parameters from a string without
+ *        copying them.
+ *
+ * This function parses the parameters from @p at_params_str and describes
+ * each of them with a view referencing its characters in @p at_params_str.
+ * No memory is allocated and no value is converted while parsing. Values
+ * are converted when they are accessed with the at_params_view getters, so
+ * parameters that are not used are not converted at all.
+ *
+ * @p at_params_str must remain valid and unchanged for as long as the views
+ * are used. Views that do not correspond to a parameter are set to
+ * @ref AT_PARAM_TYPE_INVALID.
+ *
+ * If an error is returned by the parser, the content of @p views should be
+ * ignored.
+ *
+ * @param at_params_str  AT parameters as a null-terminated string, no longer
+ *                       than UINT16_MAX characters.
+ *
+ * @param next_param_str In the case a string contains multiple notifications,
+ *                       the parser will stop parsing when it is done parsing
+ *                       the first notification, and return the remainder of
+ *                       the string in this pointer. The return code will be
+ *                       EAGAIN. If multinotification is not used, this
+ *                       pointer can be set to NULL.
+ *
+ * @param views          Array where the parameter views are stored.
+ * @param max_views      Number of elements in @p views.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EAGAIN New notification detected in string re-run the parser
+ *                 with the string pointed to by @p next_param_str.
+ * @retval -E2BIG  @p views cannot hold all detected parameters in string.
+ *                 The array will contain the maximum number of parameters
+ *                 possible.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_views_from_str(const char *at_params_str, char **next_param_str,
+			     struct at_param_view *views, size_t max_views);
+
 enum at_cmd_type {
 	/** Unknown command, indicates that the actual command type could not
 	 *  be resolved.
@@ -78,6 +78,50 @@ int at_notif_register_handler(void *context, at_notif_handler_t handler);
  */
 int at_notif_deregister_handler(void *context, at_notif_handler_t handler);
 
+/**
+ * @brief Function to register AT command notification handler for
+ *        notifications with the given prefix
+ *
+ * The handler is called only for notifications starting with @p prefix
+ * followed by a colon, for example "+CEREG" for "+CEREG: 5". Notifications are
+ * routed to prefix handlers by a hash table lookup, so such handlers do not
+ * slow down the dispatching of other notifications. Prefix handlers are called
+ * before the handlers registered with @ref at_notif_register_handler().
+ *
+ * @note  If the same combination of prefix, context and handler exists in the
+ *        memory, then the request will be ignored and command execution will
+ *        be regarded as finished successfully.
+ *
+ * @param prefix  Notification prefix, without the colon. Up to
+ *                @option{CONFIG_AT_NOTIF_PREFIX_MAX_LEN} characters.
+ * @param context Pointer to context provided by the module which has
+ *                registered the handler.
+ * @param handler Pointer to a received notification handler function of type
+ *                @ref at_notif_handler_t.
+ *
+ * @retval 0            If command execution was successful.
+ * @retval -ENOBUFS     If memory cannot be allocated.
+ * @retval -EINVAL      If handler is a NULL pointer or prefix is invalid.
+ */
+int at_notif_register_prefix_handler(const char *prefix, void *context,
+				     at_notif_handler_t handler);
+
+/**
+ * @brief Function to de-register AT command notification handler registered
+ *        for a prefix
+ *
+ * @param prefix  Notification prefix used to register the handler.
+ * @param context Pointer to context provided by the module which has
+ *                registered the handler.
+ * @param handler Pointer to a received notification handler function of type
+ *                @ref at_notif_handler_t.
+ *
+ * @retval 0            If command execution was successful.
+ * @retval -EINVAL      If handler is a NULL pointer or prefix is invalid.
+ */
+int at_notif_deregister_prefix_handler(const char *prefix, void *context,
+				       at_notif_handler_t handler);
+
 /** @} */
 
 #ifdef __cplusplus
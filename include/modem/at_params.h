@@ -74,6 +74,28 @@ struct at_param_list {
 	struct at_param *params;
 };
 
+/**
+ * @brief View of a parameter in a parsed AT string.
+ *
+ * A view references the characters of a parameter in the string it was
+ * parsed from, instead of holding a copy of its value. The value is only
+ * converted when accessed with the at_params_view getters, which take the
+ * parsed string as an argument. The string must therefore remain valid and
+ * unchanged for as long as the views are used.
+ */
+struct at_param_view {
+	/** Parameter type. */
+	enum at_param_type type;
+	/** Offset of the parameter in the parsed string. */
+	uint16_t offset;
+	/**
+	 * Length of the parameter in the parsed string. For strings, it does
+	 * not include the quotes. For arrays, it does not include the
+	 * parentheses.
+	 */
+	uint16_t len;
+};
+
 /**
  * @brief Create a list of parameters.
  *
@@ -316,6 +338,96 @@ uint32_t at_params_valid_count_get(const struct at_param_list *list);
 enum at_param_type at_params_type_get(const struct at_param_list *list,
 				      size_t index);
 
+/**
+ * @brief Get a parameter view value as an integer number.
+ *
+ * @param[in] str     String the view was parsed from.
+ * @param[in] view    Parameter view.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_view_int_get(const char *str, const struct at_param_view *view,
+			   int32_t *value);
+
+/**
+ * @brief Get a parameter view value as an signed 64-bit integer number.
+ *
+ * @param[in] str     String the view was parsed from.
+ * @param[in] view    Parameter view.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_view_int64_get(const char *str, const struct at_param_view *view,
+			     int64_t *value);
+
+/**
+ * @brief Get a parameter view value as a string.
+ *
+ * The string parameter value is copied to the buffer.
+ * @p len must be bigger than the string length, or an error is returned.
+ * The copied string is not null-terminated.
+ *
+ * To access the string without copying it, use
+ * @ref at_params_view_string_ptr_get.
+ *
+ * @param[in] str       String the view was parsed from.
+ * @param[in] view      Parameter view.
+ * @param[in] value     Pointer to the buffer where to copy the value.
+ * @param[in,out] len   Available space in @p value, returns actual length
+ *                      copied into string buffer in bytes.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_view_string_get(const char *str,
+			      const struct at_param_view *view,
+			      char *value, size_t *len);
+
+/**
+ * @brief Get a pointer to a parameter view string value.
+ *
+ * The returned string is not null-terminated. Its length is given by the
+ * @c len field of the view.
+ *
+ * @param[in] str     String the view was parsed from.
+ * @param[in] view    Parameter view.
+ *
+ * @return Pointer to the string value, or NULL if the parameter is not a
+ *         string.
+ */
+static inline const char *at_params_view_string_ptr_get(
+	const char *str, const struct at_param_view *view)
+{
+	if (str == NULL || view == NULL ||
+	    view->type != AT_PARAM_TYPE_STRING) {
+		return NULL;
+	}
+
+	return str + view->offset;
+}
+
+/**
+ * @brief Get a parameter view value as an array.
+ *
+ * The array values are converted into the buffer.
+ * @p len must be bigger than the array size, or an error is returned.
+ *
+ * @param[in] str       String the view was parsed from.
+ * @param[in] view      Parameter view.
+ * @param[in] array     Pointer to the buffer where to convert the values.
+ * @param[in,out] len   Available space in @p array, returns actual length
+ *                      converted into array buffer in bytes.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_view_array_get(const char *str, const struct at_param_view *view,
+			     uint32_t *array, size_t *len);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -230,6 +230,9 @@ int modem_info_json_object_encode(struct modem_param_info *modem,
  *
  * The data is stored in the provided info structure.
  *
+ * If @option{CONFIG_MODEM_INFO_CACHE} is enabled, the parameters not
+ * available in the cache are requested with a single batch of AT commands.
+ *
  * @param modem_param Pointer to the storage parameters.
  *
  * @retval 0 If the operation was successful.
@@ -237,6 +240,18 @@ int modem_info_json_object_encode(struct modem_param_info *modem,
  */
 int modem_info_params_get(struct modem_param_info *modem_param);
 
+/** @brief Invalidate the cached modem information.
+ *
+ * The information is requested from the modem the next time it is read.
+ * Call this function after changing the modem configuration in a way
+ * that is not reported by a notification, for example the system mode.
+ */
+#if defined(CONFIG_MODEM_INFO_CACHE)
+void modem_info_cache_invalidate(void);
+#else
+static inline void modem_info_cache_invalidate(void) {}
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
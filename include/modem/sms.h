@@ -40,6 +40,18 @@ enum sms_type {
  */
 #define SMS_MAX_PAYLOAD_LEN_CHARS 160
 
+/**
+ * @brief Maximum length of the payload given to the listeners in number of characters.
+ *
+ * @details When concatenated messages are reassembled, this is the length of a message
+ * with the maximum number of parts.
+ */
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+#define SMS_MAX_DATA_LEN_CHARS (SMS_MAX_PAYLOAD_LEN_CHARS * CONFIG_SMS_CONCAT_MAX_PARTS)
+#else
+#define SMS_MAX_DATA_LEN_CHARS SMS_MAX_PAYLOAD_LEN_CHARS
+#endif
+
 /**
  * @brief Maximum length of SMS address, i.e., phone number, in characters
  * as specified in 3GPP TS 23.040 Section 9.1.2.3.
@@ -145,12 +157,16 @@ struct sms_data {
 	 * @details Reserving enough bytes for maximum number of characters
 	 * but the length of the received payload is in payload_len variable.
 	 *
+	 * If CONFIG_SMS_CONCAT_REASSEMBLY is enabled, this contains the payload of
+	 * all parts of a concatenated message and the concatenation information
+	 * in the header is cleared.
+	 *
 	 * Generally the message is of text type in which case you can treat it as string.
 	 * However, header may contain information that determines it for specific purpose,
 	 * e.g., via application port information, in which case it should be treated as
 	 * specified for that purpose.
 	 */
-	uint8_t payload[SMS_MAX_PAYLOAD_LEN_CHARS + 1];
+	uint8_t payload[SMS_MAX_DATA_LEN_CHARS + 1];
 };
 
 /** @brief SMS listener callback function. */
@@ -59,7 +59,7 @@ enum download_client_evt_id {
 	 * network socket as necessary before re-attempting the download.
 	 */
 	DOWNLOAD_CLIENT_EVT_ERROR,
-	/** Download complete. */
+	/** Download complete. The event contains the download statistics. */
 	DOWNLOAD_CLIENT_EVT_DONE,
 };
 
@@ -68,6 +68,28 @@ struct download_fragment {
 	size_t len;
 };
 
+/**
+ * @brief Download statistics.
+ */
+struct download_client_stats {
+	/** Download duration, in milliseconds. */
+	uint32_t duration_ms;
+	/** Number of bytes downloaded. */
+	size_t bytes;
+	/** Goodput, in bytes per second. */
+	uint32_t goodput;
+	/** Number of requests sent, including retransmissions. */
+	uint32_t requests;
+	/** Number of retransmitted requests (CoAP only). */
+	uint32_t retransmissions;
+	/** Smoothed round-trip time, in milliseconds (CoAP only). */
+	uint32_t rtt_ms;
+	/** Minimum round-trip time, in milliseconds (CoAP only). */
+	uint32_t rtt_min_ms;
+	/** Block size at the end of the download, in bytes (CoAP only). */
+	uint16_t block_size;
+};
+
 /**
  * @brief Download client event.
  */
@@ -80,6 +102,8 @@ struct download_client_evt {
 		int error;
 		/** Fragment data. */
 		struct download_fragment fragment;
+		/** Download statistics. */
+		struct download_client_stats stats;
 	};
 };
 
@@ -126,6 +150,31 @@ struct download_client_cfg {
 typedef int (*download_client_callback_t)(
 	const struct download_client_evt *event);
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) && \
+	(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW > 1)
+/**
+ * @brief Block requested when several CoAP block requests are in flight.
+ */
+struct download_client_coap_slot {
+	/** Offset of the block in the file. */
+	size_t offset;
+	/** Time the request was last sent, in milliseconds. */
+	int64_t sent_ms;
+	/** Message ID of the request. */
+	uint16_t id;
+	/** Length of the received payload. */
+	uint16_t len;
+	/** Block size exponent (SZX). */
+	uint8_t szx;
+	/** Number of times the request was sent. */
+	uint8_t tx_cnt;
+	/** Whether the block has been received. */
+	bool received;
+	/** Received payload. */
+	uint8_t data[16 << CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE];
+};
+#endif
+
 /**
  * @brief Download client instance.
  */
@@ -159,13 +208,56 @@ struct download_client {
 		bool has_header;
 		/** The server has closed the connection. */
 		bool connection_close;
+		/** Offset of the first byte not yet requested,
+		 * when range requests are pipelined.
+		 */
+		size_t requested;
+		/** Payload length of the response being received. */
+		size_t frag_len;
+		/** Number of bytes of the next response received
+		 * after the current fragment.
+		 */
+		size_t surplus;
 	} http;
 
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
+		/** Time the last request was sent, in milliseconds. */
+		int64_t sent_ms;
+		/** Offset of the block last requested. */
+		size_t requested;
+		/** Whether the last request was a retransmission. */
+		bool retransmitted;
+		/** Smoothed round-trip time, in milliseconds. */
+		uint32_t srtt_ms;
+		/** Round-trip time variation, in milliseconds. */
+		uint32_t rttvar_ms;
+		/** Retransmission timeout, in milliseconds. */
+		uint32_t rto_ms;
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) && \
+	(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW > 1)
+		/** Blocks in flight or received out of order. */
+		struct download_client_coap_slot
+			slots[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW];
+		/** Index of the slot holding the next block to deliver. */
+		uint8_t head;
+		/** Number of slots in use. */
+		uint8_t count;
+		/** Block size exponent (SZX) of the next requests. */
+		uint8_t szx;
+		/** Blocks received without loss since the last adaptation. */
+		uint8_t clean_cnt;
+		/** Time the block size was last reduced, in milliseconds. */
+		int64_t shrink_ms;
+#endif
 	} coap;
 
+	/** Statistics of the current download. */
+	struct download_client_stats stats;
+	/** Time the current download started, in milliseconds. */
+	int64_t start_ms;
+
 	/** Internal thread ID. */
 	k_tid_t tid;
 	/** Internal download thread. */
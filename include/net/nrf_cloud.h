@@ -59,6 +59,13 @@ enum nrf_cloud_evt_type {
 	NRF_CLOUD_EVT_TRANSPORT_DISCONNECTED,
 	/** The device should be restarted to apply a firmware upgrade */
 	NRF_CLOUD_EVT_FOTA_DONE,
+	/** The device received a fragment of data that is larger than the
+	 * payload buffer. The position of the fragment is given in
+	 * @ref nrf_cloud_evt.fragment.
+	 * Only used if @option{CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS} is
+	 * enabled.
+	 */
+	NRF_CLOUD_EVT_RX_DATA_FRAGMENT,
 	/** There was an error communicating with the cloud. */
 	NRF_CLOUD_EVT_ERROR = 0xFF
 };
@@ -144,6 +151,14 @@ struct nrf_cloud_data {
 	const void *ptr;
 };
 
+/**@brief Position of a fragment in received data. */
+struct nrf_cloud_rx_fragment {
+	/** Offset of the fragment in the data. */
+	uint32_t offset;
+	/** Total length of the data. */
+	uint32_t total_len;
+};
+
 /**@brief MQTT topic. */
 struct nrf_cloud_topic {
 	/** Length of the topic. */
@@ -194,6 +209,10 @@ struct nrf_cloud_evt {
 	struct nrf_cloud_data data;
 	/** Topic on which data was received. */
 	struct nrf_cloud_topic topic;
+	/** Position of the received data, for
+	 * @ref NRF_CLOUD_EVT_RX_DATA_FRAGMENT.
+	 */
+	struct nrf_cloud_rx_fragment fragment;
 };
 
 /**@brief Structure used to send pre-encoded data to nRF Cloud. */
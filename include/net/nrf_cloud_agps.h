@@ -22,6 +22,22 @@ extern "C" {
  * @{
  */
 
+/**@brief Statistics of the last processed A-GPS data. */
+struct nrf_cloud_agps_stats {
+	/** Number of elements decoded. */
+	uint16_t elements;
+	/** Number of writes to the modem. */
+	uint16_t writes;
+	/** Number of elements skipped, because the satellite was not
+	 *  requested.
+	 */
+	uint16_t skipped;
+	/** Time spent decoding the data, in microseconds. */
+	uint32_t decode_time_us;
+	/** Time spent writing the data to the modem, in microseconds. */
+	uint32_t inject_time_us;
+};
+
 /**@brief Requests specified A-GPS data from nRF Cloud.
  *
  * @param request Structure containing specified A-GPS data to be requested.
@@ -47,6 +63,46 @@ int nrf_cloud_agps_request_all(void);
  */
 int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket);
 
+/**@brief Processes a fragment of binary A-GPS data received from nRF Cloud.
+ *
+ * Used for A-GPS data that is received in
+ * @ref NRF_CLOUD_EVT_RX_DATA_FRAGMENT events. The fragments must be given
+ * in order. Each element is injected as soon as it has been received, and an
+ * element that is split between two fragments is kept until the rest of it
+ * is received.
+ *
+ * @param buf Pointer to the fragment.
+ * @param buf_len Length of the fragment.
+ * @param offset Offset of the fragment in the A-GPS data. A fragment with
+ *		 offset 0 starts processing of new A-GPS data.
+ * @param total_len Total length of the A-GPS data.
+ * @param socket Pointer to GNSS socket to which A-GPS data will be injected.
+ *		 If NULL, the nRF9160 GPS driver is used to inject the data.
+ *		 Only used for the first fragment.
+ *
+ * @return 0 if successful, otherwise a (negative) error code.
+ */
+int nrf_cloud_agps_process_fragment(const char *buf, size_t buf_len,
+				    size_t offset, size_t total_len,
+				    const int *socket);
+
+/**@brief Aborts processing of A-GPS data received in fragments.
+ *
+ * Releases the A-GPS injection for other users when the rest of the data will
+ * not be received, for example because the connection was lost. The nRF Cloud
+ * library calls this function when the transport is disconnected. Data that is
+ * not received to the end is also aborted after
+ * @option{CONFIG_NRF_CLOUD_AGPS_FRAGMENT_TIMEOUT} seconds without a fragment.
+ * Does nothing if no fragmented data is being processed.
+ */
+void nrf_cloud_agps_process_abort(void);
+
+/**@brief Get statistics of the last processed A-GPS data.
+ *
+ * @param stats Pointer to the structure that the statistics are copied to.
+ */
+void nrf_cloud_agps_stats_get(struct nrf_cloud_agps_stats *stats);
+
 /**@brief Query which A-GPS elements were actually received
  *
  * @param received_elements return copy of requested elements received
@@ -32,6 +32,9 @@ LOG_MODULE_REGISTER(at_cmd, CONFIG_AT_CMD_LOG_LEVEL);
 enum at_cmd_flags {
 	AT_CMD_BUF_CMD = 1 << 0,	/* Command is buffered by at_cmd */
 	AT_CMD_SYNC = 1 << 1,		/* Command is synchronous */
+	AT_CMD_ASYNC = 1 << 2,		/* Command completes a request */
+	AT_CMD_TXN = 1 << 3,		/* Command is part of a transaction */
+	AT_CMD_TXN_END = 1 << 4,	/* Last command of a transaction */
 };
 
 /* Metadata for a queued AT command */
@@ -39,6 +42,7 @@ struct cmd_item  {
 	char *cmd;			/* Pointer to 0-terminated command */
 	char *resp;			/* Pointer to response buffer */
 	at_cmd_handler_t callback;	/* Callback to execute on result */
+	struct at_cmd_async *async;	/* Request to complete on result */
 	size_t resp_size;		/* Size of response buffer */
 	enum at_cmd_flags flags;	/* Flags describing the request */
 };
@@ -61,13 +65,23 @@ static atomic_t shutdown_mode;
 /* Mutex to guard the at_cmd init from simultaneous entry. */
 static K_MUTEX_DEFINE(at_cmd_init_mutex);
 
-/* Structure holding current command. current_cmd.cmd=NULL signifies no cmd. */
-static struct cmd_item current_cmd;
+/* Commands written to the socket and awaiting a response, oldest first.
+ * Responses are received in the order the commands were written.
+ */
+static struct cmd_item inflight[CONFIG_AT_CMD_PIPELINE_DEPTH];
+static size_t inflight_head;
+static size_t inflight_cnt;
 K_MUTEX_DEFINE(current_cmd_mutex);
 
+/* Set when a command of a transaction fails, until the transaction ends. */
+static bool txn_aborted;
+
 /* Queue for queued command metadata */
 K_MSGQ_DEFINE(commands, sizeof(struct cmd_item), CONFIG_AT_CMD_QUEUE_LEN, 4);
 
+/* Mutex to keep commands of a batch next to each other in the queue */
+K_MUTEX_DEFINE(commands_put_mutex);
+
 /* Message queue to return the result in the case of a synchronous call */
 K_MSGQ_DEFINE(response_sync, sizeof(struct resp_item), 1, 4);
 K_MUTEX_DEFINE(response_sync_get);
@@ -178,51 +192,129 @@ static inline int at_write(const char *const cmd)
 	return 0;
 }
 
+/* Return the oldest command awaiting a response, if any. */
+static struct cmd_item *current_cmd(void)
+{
+	return inflight_cnt ? &inflight[inflight_head] : NULL;
+}
+
 /* Clear the current command safely */
 static void complete_cmd(void)
 {
 	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
-	current_cmd.cmd = NULL;
+	inflight_head = (inflight_head + 1) % ARRAY_SIZE(inflight);
+	inflight_cnt--;
 	k_mutex_unlock(&current_cmd_mutex);
 }
 
+/* Pass the result of a command to the waiting caller or request. */
+static void dispatch_result(const struct cmd_item *item, const char *buf,
+			    const struct resp_item *resp)
+{
+	if (item->flags & AT_CMD_TXN) {
+		if (resp->code != 0) {
+			txn_aborted = true;
+		}
+		if (item->flags & AT_CMD_TXN_END) {
+			txn_aborted = false;
+		}
+	}
+
+	if (item->flags & AT_CMD_SYNC) {
+		LOG_DBG("Enqueueing response for sync call");
+		k_msgq_put(&response_sync, resp, K_FOREVER);
+	}
+
+	if (item->flags & AT_CMD_ASYNC) {
+		struct at_cmd_async *req = item->async;
+
+		req->state = resp->state;
+		req->code = resp->code;
+		if (req->handler != NULL) {
+			req->handler(req, buf);
+		}
+		k_sem_give(&req->done);
+	}
+}
+
 /*
- * Atomically load a new command if appropriate, then write it to the socket.
- * The operations are repeated until the queue is empty or a command is pending
- * a response. This function is called both from the socket thread and calling
- * context.
+ * Atomically load new commands if appropriate, then write them to the socket.
+ * The operations are repeated until the queue is empty or the maximum number
+ * of commands is pending a response. This function is called both from the
+ * socket thread and calling context.
  */
 static void load_cmd_and_write(void)
 {
 	int ret;
 	struct resp_item resp;
+	struct cmd_item *item;
 
 	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
-	do {
-		ret = 0;
+	while (inflight_cnt < ARRAY_SIZE(inflight)) {
+		item = &inflight[(inflight_head + inflight_cnt) %
+				 ARRAY_SIZE(inflight)];
 
-		/* Do not load a new command if already loaded or none queued */
-		if (current_cmd.cmd != NULL ||
-		    k_msgq_get(&commands, &current_cmd, K_NO_WAIT) != 0) {
+		if (k_msgq_get(&commands, item, K_NO_WAIT) != 0) {
 			break;
 		}
 
-		ret = at_write(current_cmd.cmd);
+		/* Skip the rest of a failed transaction */
+		if ((item->flags & AT_CMD_TXN) && txn_aborted) {
+			ret = -ECANCELED;
+			resp.state = AT_CMD_ERROR_QUEUE;
+		} else {
+			ret = at_write(item->cmd);
+			resp.state = AT_CMD_ERROR_WRITE;
+		}
 
-		if (current_cmd.flags & AT_CMD_BUF_CMD) {
-			k_free(current_cmd.cmd);
+		if (item->flags & AT_CMD_BUF_CMD) {
+			k_free(item->cmd);
 		}
 
 		/* If write failed, make an error response and complete cmd */
 		if (ret != 0) {
-			resp.state = AT_CMD_ERROR_WRITE;
 			resp.code = ret;
-			if (current_cmd.flags & AT_CMD_SYNC) {
-				k_msgq_put(&response_sync, &resp, K_FOREVER);
-			}
-			complete_cmd();
+			dispatch_result(item, "", &resp);
+			continue;
 		}
-	} while (ret != 0);
+
+		inflight_cnt++;
+	}
+	k_mutex_unlock(&current_cmd_mutex);
+}
+
+/*
+ * Complete all commands awaiting a response or still queued with the given
+ * error, so that no caller waits for a response that will never come.
+ * Called from the socket thread only.
+ */
+static void abort_all_cmds(int err)
+{
+	struct resp_item resp = {
+		.state = AT_CMD_ERROR_READ,
+		.code = err,
+	};
+	struct cmd_item item;
+
+	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
+
+	while (inflight_cnt > 0) {
+		dispatch_result(&inflight[inflight_head], "", &resp);
+		inflight_head = (inflight_head + 1) % ARRAY_SIZE(inflight);
+		inflight_cnt--;
+	}
+	inflight_head = 0;
+
+	resp.state = AT_CMD_ERROR_QUEUE;
+	while (k_msgq_get(&commands, &item, K_NO_WAIT) == 0) {
+		if (item.flags & AT_CMD_BUF_CMD) {
+			k_free(item.cmd);
+		}
+		dispatch_result(&item, "", &resp);
+	}
+
+	txn_aborted = false;
+
 	k_mutex_unlock(&current_cmd_mutex);
 }
 
@@ -232,6 +324,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 	static size_t payload_len;
 	static struct resp_item ret;
 	static char buf[CONFIG_AT_CMD_RESPONSE_MAX_LEN];
+	struct cmd_item *cmd;
 
 	ARG_UNUSED(arg1);
 	ARG_UNUSED(arg2);
@@ -246,6 +339,13 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 		LOG_DBG("Listening on socket");
 		bytes_read = recv(common_socket_fd, buf, sizeof(buf), 0);
 
+		/* Only the socket thread removes commands, so the pointer stays
+		 * valid after the mutex is released.
+		 */
+		k_mutex_lock(&current_cmd_mutex, K_FOREVER);
+		cmd = current_cmd();
+		k_mutex_unlock(&current_cmd_mutex);
+
 		/* Initialize the response */
 		ret.code  = 0;
 		ret.state = AT_CMD_OK;
@@ -256,6 +356,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 			if (errno == EHOSTDOWN) {
 				LOG_DBG("AT host is going down, sleeping");
 				atomic_set(&shutdown_mode, 1);
+				abort_all_cmds(-EHOSTDOWN);
 				close(common_socket_fd);
 				nrf_modem_lib_shutdown_wait();
 				LOG_DBG("AT host available, "
@@ -304,36 +405,35 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 		payload_len = get_return_code(buf, bytes_read, &ret);
 
 		/* Verify the buffer size if provided, and copy the message */
-		if (current_cmd.cmd != NULL &&
-		    current_cmd.resp != NULL &&
+		if (cmd != NULL &&
+		    cmd->resp != NULL &&
 		    ret.state != AT_CMD_NOTIFICATION) {
-			if (current_cmd.resp_size < payload_len) {
+			if (cmd->resp_size < payload_len) {
 				LOG_ERR("Response buffer not large enough");
 				ret.code  = -EMSGSIZE;
 				goto next;
 			}
-			memcpy(current_cmd.resp, buf, payload_len);
+			memcpy(cmd->resp, buf, payload_len);
 		}
 
 		/* Call the relevant callback, if any */
 		if (ret.state == AT_CMD_NOTIFICATION &&
 		    notification_handler != NULL) {
 			notification_handler(buf);
-		} else if (current_cmd.callback != NULL) {
-			current_cmd.callback(buf);
+		} else if (cmd != NULL && cmd->callback != NULL) {
+			cmd->callback(buf);
 		}
 
 next:
-		/* Dispatch response for sync call */
-		if (current_cmd.cmd != NULL &&
-		    current_cmd.flags & AT_CMD_SYNC &&
-		    ret.state != AT_CMD_NOTIFICATION) {
-			LOG_DBG("Enqueueing response for sync call");
-			k_msgq_put(&response_sync, &ret, K_FOREVER);
-		}
-
 		/* We have now handled a command if it was not a notification */
-		if (ret.state != AT_CMD_NOTIFICATION) {
+		if (cmd != NULL && ret.state != AT_CMD_NOTIFICATION) {
+			/* No valid response to pass on after an error */
+			if (ret.code < 0) {
+				buf[0] = '\0';
+			}
+
+			/* Dispatch response for sync call or async request */
+			dispatch_result(cmd, buf, &ret);
 			complete_cmd();
 		}
 	}
@@ -367,9 +467,12 @@ int at_cmd_write_with_callback(const char *const cmd,
 
 	command.resp = NULL;
 	command.callback = handler;
+	command.async = NULL;
 	command.flags = AT_CMD_BUF_CMD;
 
+	k_mutex_lock(&commands_put_mutex, K_FOREVER);
 	ret = k_msgq_put(&commands, &command, K_FOREVER);
+	k_mutex_unlock(&commands_put_mutex);
 	if (ret) {
 		return ret;
 	}
@@ -414,13 +517,16 @@ int at_cmd_write(const char *const cmd,
 	command.resp = buf;
 	command.resp_size = buf_len;
 	command.callback = NULL;
+	command.async = NULL;
 	command.flags = AT_CMD_SYNC;
 
 	/* Ensure we get our own AT response, not an old one */
 	k_mutex_lock(&response_sync_get, K_FOREVER);
 
 	/* We borrow the return code field from the currently unused response */
+	k_mutex_lock(&commands_put_mutex, K_FOREVER);
 	ret.code = k_msgq_put(&commands, &command, K_FOREVER);
+	k_mutex_unlock(&commands_put_mutex);
 	if (ret.code) {
 		LOG_ERR("Could not enqueue cmd, error %d", ret.code);
 		if (state) {
@@ -442,6 +548,90 @@ int at_cmd_write(const char *const cmd,
 	return ret.code;
 }
 
+int at_cmd_write_batch(struct at_cmd_async *reqs, size_t count,
+		       bool transaction)
+{
+	struct cmd_item command;
+
+	if (atomic_get(&shutdown_mode) == 1) {
+		return -EHOSTDOWN;
+	}
+
+	__ASSERT(k_current_get() != socket_tid,
+		 "at_cmd deadlock: socket thread blocking self\n");
+
+	if (reqs == NULL || count == 0 || count > CONFIG_AT_CMD_QUEUE_LEN) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (check_cmd(reqs[i].cmd)) {
+			LOG_ERR("Invalid command");
+			return -EINVAL;
+		}
+	}
+
+	k_mutex_lock(&commands_put_mutex, K_FOREVER);
+
+	for (size_t i = 0; i < count; i++) {
+		struct at_cmd_async *req = &reqs[i];
+
+		k_sem_init(&req->done, 0, 1);
+		req->state = AT_CMD_ERROR_QUEUE;
+		req->code = -EINPROGRESS;
+
+		/* This cast is safe; we do not free cmd without AT_CMD_BUF_CMD */
+		command.cmd = (char *)req->cmd;
+		command.resp = req->resp;
+		command.resp_size = req->resp_size;
+		command.callback = NULL;
+		command.async = req;
+		command.flags = AT_CMD_ASYNC;
+
+		if (transaction) {
+			command.flags |= AT_CMD_TXN;
+			if (i == count - 1) {
+				command.flags |= AT_CMD_TXN_END;
+			}
+		}
+
+		/* The socket thread consumes the queue without taking the
+		 * mutex, so there is always room eventually.
+		 */
+		k_msgq_put(&commands, &command, K_FOREVER);
+	}
+
+	k_mutex_unlock(&commands_put_mutex);
+
+	load_cmd_and_write();
+
+	return 0;
+}
+
+int at_cmd_write_async(struct at_cmd_async *req)
+{
+	return at_cmd_write_batch(req, 1, false);
+}
+
+int at_cmd_async_wait(struct at_cmd_async *req, k_timeout_t timeout,
+		      enum at_cmd_state *state)
+{
+	int err = k_sem_take(&req->done, timeout);
+
+	if (err) {
+		return err;
+	}
+
+	/* Keep the request completed for subsequent calls */
+	k_sem_give(&req->done);
+
+	if (state) {
+		*state = req->state;
+	}
+
+	return req->code;
+}
+
 void at_cmd_set_notification_handler(at_cmd_handler_t handler)
 {
 	LOG_DBG("Setting notification handler to %p", handler);
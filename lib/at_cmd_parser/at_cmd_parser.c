@@ -41,6 +41,51 @@ static enum at_parser_state state;
 
 static bool set_type_string;
 
+/* Destination of the parsed parameters. Either a parameter list holding
+ * copies of the values, or an array of views into the parsed string.
+ */
+struct param_sink {
+	struct at_param_list *list;
+	struct at_param_view *views;
+	size_t view_cnt;
+	const char *base;
+};
+
+static void sink_view_put(const struct param_sink *sink, int index,
+			  enum at_param_type type, const char *start,
+			  size_t len)
+{
+	if (index >= sink->view_cnt) {
+		return;
+	}
+
+	sink->views[index] = (struct at_param_view) {
+		.type = type,
+		.offset = start - sink->base,
+		.len = len,
+	};
+}
+
+static void sink_string_put(const struct param_sink *sink, int index,
+			    const char *start, size_t len)
+{
+	if (sink->list) {
+		at_params_string_put(sink->list, index, start, len);
+	} else {
+		sink_view_put(sink, index, AT_PARAM_TYPE_STRING, start, len);
+	}
+}
+
+static void sink_empty_put(const struct param_sink *sink, int index,
+			   const char *pos)
+{
+	if (sink->list) {
+		at_params_empty_put(sink->list, index);
+	} else {
+		sink_view_put(sink, index, AT_PARAM_TYPE_EMPTY, pos, 0);
+	}
+}
+
 static inline void set_new_state(enum at_parser_state new_state)
 {
 	state = new_state;
@@ -158,7 +203,7 @@ static int at_parse_detect_type(const char **str, int index)
 }
 
 static int at_parse_process_element(const char **str, int index,
-				    struct at_param_list *const list)
+				    const struct param_sink *sink)
 {
 	const char *tmpstr = *str;
 
@@ -173,8 +218,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
 	} else if (state == COMMAND) {
 		const char *start_ptr = tmpstr;
 
@@ -184,8 +228,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
 
 		/* Skip read/test special characters. */
 		if ((*tmpstr == AT_CMD_SEPARATOR) &&
@@ -196,7 +239,7 @@ static int at_parse_process_element(const char **str, int index,
 		}
 
 	} else if (state == OPTIONAL) {
-		at_params_empty_put(list, index);
+		sink_empty_put(sink, index, tmpstr);
 
 	} else if (state == STRING) {
 		const char *start_ptr = tmpstr;
@@ -205,8 +248,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
 
 		tmpstr++;
 	} else if (state == QUOTED_STRING) {
@@ -216,8 +258,19 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
+
+		tmpstr++;
+	} else if (state == ARRAY && !sink->list) {
+		/* Array values are converted when accessed. */
+		const char *start_ptr = tmpstr;
+
+		while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr)) {
+			tmpstr++;
+		}
+
+		sink_view_put(sink, index, AT_PARAM_TYPE_ARRAY, start_ptr,
+			      tmpstr - start_ptr);
 
 		tmpstr++;
 	} else if (state == ARRAY) {
@@ -248,16 +301,31 @@ static int at_parse_process_element(const char **str, int index,
 			}
 		}
 
-		at_params_array_put(list, index, tmparray, i * sizeof(uint32_t));
+		at_params_array_put(sink->list, index, tmparray,
+				    i * sizeof(uint32_t));
 
 		tmpstr++;
+	} else if (state == NUMBER && !sink->list) {
+		/* Number values are converted when accessed. */
+		const char *start_ptr = tmpstr;
+
+		if (*tmpstr == '-' || *tmpstr == '+') {
+			tmpstr++;
+		}
+
+		while (isdigit((int)*tmpstr)) {
+			tmpstr++;
+		}
+
+		sink_view_put(sink, index, AT_PARAM_TYPE_NUM_INT, start_ptr,
+			      tmpstr - start_ptr);
 	} else if (state == NUMBER) {
 		char *next;
 		int64_t value = (int64_t)strtoll(tmpstr, &next, 10);
 
 		tmpstr = next;
 
-		at_params_int_put(list, index, value);
+		at_params_int_put(sink->list, index, value);
 	} else if (state == SMS_PDU) {
 		const char *start_ptr = tmpstr;
 
@@ -265,8 +333,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
 	} else if (state == CLAC) {
 		const char *start_ptr = tmpstr;
 
@@ -274,8 +341,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		sink_string_put(sink, index, start_ptr, tmpstr - start_ptr);
 	}
 
 	*str = tmpstr;
@@ -287,7 +353,7 @@ static int at_parse_process_element(const char **str, int index,
  * Parameters cannot be null. String must be null terminated.
  */
 static int at_parse_param(const char **at_params_str,
-			  struct at_param_list *const list,
+			  const struct param_sink *sink,
 			  const size_t max_params)
 {
 	int index = 0;
@@ -312,7 +378,7 @@ static int at_parse_param(const char **at_params_str,
 			index = 0;
 		}
 
-		if (at_parse_process_element(&str, index, list) == -1) {
+		if (at_parse_process_element(&str, index, sink) == -1) {
 			break;
 		}
 
@@ -332,7 +398,7 @@ static int at_parse_param(const char **at_params_str,
 				}
 
 				if (at_parse_process_element(&str, index,
-							     list) == -1) {
+							     sink) == -1) {
 					break;
 				}
 			}
@@ -386,6 +452,9 @@ int at_parser_max_params_from_str(const char *at_params_str,
 				  size_t max_params_count)
 {
 	int err = 0;
+	const struct param_sink sink = {
+		.list = list,
+	};
 
 	if (at_params_str == NULL || list == NULL || list->params == NULL) {
 		return -EINVAL;
@@ -395,7 +464,39 @@ int at_parser_max_params_from_str(const char *at_params_str,
 
 	max_params_count = MIN(max_params_count, list->param_count);
 
-	err = at_parse_param(&at_params_str, list, max_params_count);
+	err = at_parse_param(&at_params_str, &sink, max_params_count);
+
+	if (next_param_str) {
+		*next_param_str = (char *)at_params_str;
+	}
+
+	return err;
+}
+
+int at_parser_views_from_str(const char *at_params_str, char **next_param_str,
+			     struct at_param_view *views, size_t max_views)
+{
+	int err = 0;
+	const struct param_sink sink = {
+		.views = views,
+		.view_cnt = max_views,
+		.base = at_params_str,
+	};
+
+	if (at_params_str == NULL || views == NULL || max_views == 0) {
+		return -EINVAL;
+	}
+
+	/* Offsets and lengths of views are 16-bit. */
+	if (strlen(at_params_str) > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < max_views; i++) {
+		views[i].type = AT_PARAM_TYPE_INVALID;
+	}
+
+	err = at_parse_param(&at_params_str, &sink, max_views);
 
 	if (next_param_str) {
 		*next_param_str = (char *)at_params_str;
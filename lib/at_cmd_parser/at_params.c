@@ -5,6 +5,7 @@
  */
 
 #include <limits.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -438,3 +439,95 @@ enum at_param_type at_params_type_get(const struct at_param_list *list,
 
 	return param->type;
 }
+
+int at_params_view_int64_get(const char *str, const struct at_param_view *view,
+			     int64_t *value)
+{
+	if (str == NULL || view == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	if (view->type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	*value = (int64_t)strtoll(str + view->offset, NULL, 10);
+	return 0;
+}
+
+int at_params_view_int_get(const char *str, const struct at_param_view *view,
+			   int32_t *value)
+{
+	int64_t int_val;
+	int err = at_params_view_int64_get(str, view, &int_val);
+
+	if (err) {
+		return err;
+	}
+
+	if ((int_val > INT32_MAX) || (int_val < INT32_MIN)) {
+		return -EINVAL;
+	}
+
+	*value = (int32_t)int_val;
+	return 0;
+}
+
+int at_params_view_string_get(const char *str,
+			      const struct at_param_view *view,
+			      char *value, size_t *len)
+{
+	if (str == NULL || view == NULL || value == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	if (view->type != AT_PARAM_TYPE_STRING) {
+		return -EINVAL;
+	}
+
+	if (*len < view->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, str + view->offset, view->len);
+	*len = view->len;
+
+	return 0;
+}
+
+int at_params_view_array_get(const char *str, const struct at_param_view *view,
+			     uint32_t *array, size_t *len)
+{
+	if (str == NULL || view == NULL || array == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	if (view->type != AT_PARAM_TYPE_ARRAY) {
+		return -EINVAL;
+	}
+
+	const char *pos = str + view->offset;
+	const char *end = pos + view->len;
+	size_t count = 0;
+
+	while (pos < end) {
+		char *next;
+
+		if ((count + 1) * sizeof(uint32_t) > *len) {
+			return -ENOMEM;
+		}
+
+		array[count++] = (uint32_t)strtoul(pos, &next, 10);
+		pos = next;
+
+		/* Skip to the next value. */
+		while (pos < end && *pos != ',') {
+			pos++;
+		}
+		pos++;
+	}
+
+	*len = count * sizeof(uint32_t);
+
+	return 0;
+}
@@ -10,51 +10,147 @@
 #include <init.h>
 #include <modem/at_cmd.h>
 #include <modem/at_notif.h>
-#include <sys/slist.h>
+#include <string.h>
 
 LOG_MODULE_REGISTER(at_notif, CONFIG_AT_NOTIF_LOG_LEVEL);
 
+#define PREFIX_BUCKET_CNT CONFIG_AT_NOTIF_PREFIX_BUCKETS
+
+BUILD_ASSERT((PREFIX_BUCKET_CNT & (PREFIX_BUCKET_CNT - 1)) == 0,
+	     "Number of prefix buckets must be a power of two");
+
+/* Serializes handler list modifications. Notifications are dispatched
+ * without taking the mutex.
+ */
 static K_MUTEX_DEFINE(list_mtx);
 
 /**@brief Link list element for notification handler. */
 struct notif_handler {
-	sys_snode_t        node;
+	struct notif_handler *next;
 	void               *ctx;
 	at_notif_handler_t handler;
+	/* Zero length for handlers receiving all notifications. */
+	uint8_t            prefix_len;
+	char               prefix[CONFIG_AT_NOTIF_PREFIX_MAX_LEN];
 };
 
-static sys_slist_t handler_list;
+/* Handlers receiving all notifications. */
+static struct notif_handler *handler_list;
+
+/* Handlers receiving notifications with a given prefix, hashed by prefix. */
+static struct notif_handler *prefix_buckets[PREFIX_BUCKET_CNT];
+
+/* Number of dispatches in progress and the thread dispatching, used to
+ * delay freeing removed handlers until no dispatch can reference them.
+ */
+static atomic_t readers;
+static k_tid_t dispatch_thread;
+
+/* Threads waiting for the dispatches in progress to complete. The condition
+ * variable is signalled with list_mtx held by the last reader.
+ */
+static atomic_t waiters;
+static K_CONDVAR_DEFINE(readers_done);
+
+/* Removed handlers that could not be freed yet. */
+static struct notif_handler *retired_list;
+
+static struct notif_handler *list_next(struct notif_handler *const *link)
+{
+	return __atomic_load_n(link, __ATOMIC_ACQUIRE);
+}
+
+static void list_link(struct notif_handler **link, struct notif_handler *node)
+{
+	__atomic_store_n(link, node, __ATOMIC_RELEASE);
+}
+
+/**@brief Length of the notification prefix, up to the first colon. */
+static size_t notif_prefix_len(const char *notif)
+{
+	size_t len = 0;
+
+	while (notif[len] != ':' && notif[len] != '\0' &&
+	       notif[len] != '\r' && notif[len] != ' ') {
+		len++;
+	}
+
+	return len;
+}
+
+/**@brief FNV-1a hash of the prefix mapped to a bucket. */
+static struct notif_handler **prefix_bucket(const char *prefix, size_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)prefix[i];
+		hash *= 16777619U;
+	}
+
+	return &prefix_buckets[hash & (PREFIX_BUCKET_CNT - 1)];
+}
 
+static struct notif_handler **handler_head(const char *prefix, size_t len)
+{
+	return (len == 0) ? &handler_list : prefix_bucket(prefix, len);
+}
 
 /**
  * @brief Find the handler from the notification list.
  *
- * @return The node or NULL if not found and its previous node in @p prev_out.
+ * @return The link pointing to the node or NULL if not found.
  */
-static struct notif_handler *find_node(struct notif_handler **prev_out,
+static struct notif_handler **find_node(const char *prefix, size_t len,
 	void *ctx, at_notif_handler_t handler)
 {
-	struct notif_handler *prev = NULL, *curr, *tmp;
+	struct notif_handler **link = handler_head(prefix, len);
+
+	for (; *link != NULL; link = &(*link)->next) {
+		struct notif_handler *curr = *link;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&handler_list, curr, tmp, node) {
-		if (curr->ctx == ctx && curr->handler == handler) {
-			*prev_out = prev;
-			return curr;
+		if (curr->ctx == ctx && curr->handler == handler &&
+		    curr->prefix_len == len &&
+		    (len == 0 || !strncmp(curr->prefix, prefix, len))) {
+			return link;
 		}
-		prev = curr;
 	}
 	return NULL;
 }
 
+/**@brief Free removed handlers if no dispatch can reference them.
+ *
+ * Must be called with list_mtx held.
+ */
+static void free_retired(void)
+{
+	struct notif_handler *curr = retired_list;
+
+	if (atomic_get(&readers) != 0) {
+		return;
+	}
+
+	retired_list = NULL;
+
+	while (curr != NULL) {
+		struct notif_handler *next = curr->next;
+
+		k_free(curr);
+		curr = next;
+	}
+}
+
 /**@brief Add the handler in the notification list if not already present. */
-static int append_notif_handler(void *ctx, at_notif_handler_t handler)
+static int append_notif_handler(const char *prefix, size_t len, void *ctx,
+				at_notif_handler_t handler)
 {
 	struct notif_handler *to_ins;
+	struct notif_handler **link;
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if handler is already registered. */
-	if (find_node(&to_ins, ctx, handler) != NULL) {
+	if (find_node(prefix, len, ctx, handler) != NULL) {
 		LOG_DBG("Handler already registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
 		return 0;
@@ -69,53 +165,118 @@ static int append_notif_handler(void *ctx, at_notif_handler_t handler)
 	memset(to_ins, 0, sizeof(struct notif_handler));
 	to_ins->ctx     = ctx;
 	to_ins->handler = handler;
+	to_ins->prefix_len = len;
+	if (len > 0) {
+		memcpy(to_ins->prefix, prefix, len);
+	}
 
-	/* Insert handler in the list. */
-	sys_slist_append(&handler_list, &to_ins->node);
+	/* Append the fully initialized handler to the list, so that a
+	 * concurrent dispatch sees either the old or the new list.
+	 */
+	for (link = handler_head(prefix, len); *link != NULL;
+	     link = &(*link)->next) {
+	}
+	list_link(link, to_ins);
+
+	free_retired();
 	k_mutex_unlock(&list_mtx);
 	return 0;
 }
 
 /**@brief Remove the handler from the notification list if registered. */
-static int remove_notif_handler(void *ctx, at_notif_handler_t handler)
+static int remove_notif_handler(const char *prefix, size_t len, void *ctx,
+				at_notif_handler_t handler)
 {
-	struct notif_handler *curr, *prev = NULL;
+	struct notif_handler *curr;
+	struct notif_handler **link;
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if the handler is registered before removing it. */
-	curr = find_node(&prev, ctx, handler);
-	if (curr == NULL) {
+	link = find_node(prefix, len, ctx, handler);
+	if (link == NULL) {
 		LOG_WRN("Handler not registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
 		return 0;
 	}
 
-	/* Remove the handler from the list. */
-	sys_slist_remove(&handler_list, &prev->node, &curr->node);
-	k_free(curr);
+	/* Unlink the handler. A concurrent dispatch may still use it, but its
+	 * next pointer remains valid until the handler is freed.
+	 */
+	curr = *link;
+	list_link(link, curr->next);
+
+	if (k_current_get() == dispatch_thread) {
+		/* Removed from a handler, free after the dispatch. */
+		curr->next = retired_list;
+		retired_list = curr;
+		k_mutex_unlock(&list_mtx);
+		return 0;
+	}
+
+	/* Handlers may register other handlers, so the mutex is released
+	 * while waiting for the dispatches in progress to complete.
+	 */
+	atomic_inc(&waiters);
+	while (atomic_get(&readers) != 0) {
+		k_condvar_wait(&readers_done, &list_mtx, K_FOREVER);
+	}
+	atomic_dec(&waiters);
 
 	k_mutex_unlock(&list_mtx);
+	k_free(curr);
+
 	return 0;
 }
 
+static void dispatch_list(struct notif_handler *const *head,
+			  const char *response, const char *prefix, size_t len)
+{
+	for (struct notif_handler *curr = list_next(head); curr != NULL;
+	     curr = list_next(&curr->next)) {
+		/* Other prefixes may share the bucket. */
+		if (curr->prefix_len != len ||
+		    (len > 0 && strncmp(curr->prefix, prefix, len))) {
+			continue;
+		}
+
+		LOG_DBG(" - ctx=0x%08X, handler=0x%08X", (uint32_t)curr->ctx,
+			(uint32_t)curr->handler);
+		curr->handler(curr->ctx, response);
+	}
+}
+
 /**@brief AT command notifications handler. */
 static void notif_dispatch(const char *response)
 {
-	struct notif_handler *curr, *tmp;
+	size_t len = notif_prefix_len(response);
 
-	k_mutex_lock(&list_mtx, K_FOREVER);
+	atomic_inc(&readers);
+	dispatch_thread = k_current_get();
 
-	/* Dispatch notifications to all registered handlers */
+	/* Dispatch notifications to handlers registered for the prefix,
+	 * then to handlers registered for all notifications.
+	 */
 	LOG_DBG("Dispatching events:");
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&handler_list, curr, tmp, node) {
-		LOG_DBG(" - ctx=0x%08X, handler=0x%08X", (uint32_t)curr->ctx,
-			(uint32_t)curr->handler);
-		curr->handler(curr->ctx, response);
+	if (len > 0 && len <= CONFIG_AT_NOTIF_PREFIX_MAX_LEN) {
+		dispatch_list(prefix_bucket(response, len), response,
+			      response, len);
 	}
+	dispatch_list(&handler_list, response, NULL, 0);
 	LOG_DBG("Done");
 
-	k_mutex_unlock(&list_mtx);
+	dispatch_thread = NULL;
+	atomic_dec(&readers);
+
+	/* The mutex is taken only if there is a handler to free or a thread
+	 * waiting for the dispatch to complete.
+	 */
+	if (retired_list != NULL || atomic_get(&waiters) != 0) {
+		k_mutex_lock(&list_mtx, K_FOREVER);
+		free_retired();
+		k_condvar_broadcast(&readers_done);
+		k_mutex_unlock(&list_mtx);
+	}
 }
 
 static int module_init(const struct device *dev)
@@ -132,7 +293,6 @@ static int module_init(const struct device *dev)
 	initialized = true;
 
 	LOG_DBG("Initialization");
-	sys_slist_init(&handler_list);
 	at_cmd_set_notification_handler(notif_dispatch);
 	return 0;
 }
@@ -149,7 +309,7 @@ int at_notif_register_handler(void *context, at_notif_handler_t handler)
 			(uint32_t)context, (uint32_t)handler);
 		return -EINVAL;
 	}
-	return append_notif_handler(context, handler);
+	return append_notif_handler(NULL, 0, context, handler);
 }
 
 int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
@@ -159,7 +319,46 @@ int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
 			(uint32_t)context, (uint32_t)handler);
 		return -EINVAL;
 	}
-	return remove_notif_handler(context, handler);
+	return remove_notif_handler(NULL, 0, context, handler);
+}
+
+static int check_prefix(const char *prefix)
+{
+	if (prefix == NULL) {
+		return -EINVAL;
+	}
+
+	size_t len = notif_prefix_len(prefix);
+
+	if (len == 0 || len > CONFIG_AT_NOTIF_PREFIX_MAX_LEN ||
+	    prefix[len] != '\0') {
+		LOG_ERR("Invalid prefix");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int at_notif_register_prefix_handler(const char *prefix, void *context,
+				     at_notif_handler_t handler)
+{
+	if (handler == NULL || check_prefix(prefix)) {
+		LOG_ERR("Invalid handler (context=0x%08X, handler=0x%08X)",
+			(uint32_t)context, (uint32_t)handler);
+		return -EINVAL;
+	}
+	return append_notif_handler(prefix, strlen(prefix), context, handler);
+}
+
+int at_notif_deregister_prefix_handler(const char *prefix, void *context,
+				       at_notif_handler_t handler)
+{
+	if (handler == NULL || check_prefix(prefix)) {
+		LOG_ERR("Invalid handler (context=0x%08X, handler=0x%08X)",
+			(uint32_t)context, (uint32_t)handler);
+		return -EINVAL;
+	}
+	return remove_notif_handler(prefix, strlen(prefix), context, handler);
 }
 
 #ifdef CONFIG_AT_NOTIF_SYS_INIT
@@ -173,28 +173,14 @@ static const char *const at_notifs[] = {
 
 BUILD_ASSERT(ARRAY_SIZE(at_notifs) == LTE_LC_NOTIF_COUNT);
 
-static bool is_relevant_notif(const char *notif, enum lte_lc_notif_type *type)
-{
-	for (size_t i = 0; i < ARRAY_SIZE(at_notifs); i++) {
-		if (strncmp(at_notifs[i], notif,
-			    strlen(at_notifs[i])) == 0) {
-			/* The notification type matches the array index */
-			*type = i;
-
-			return true;
-		}
-	}
-
-	return false;
-}
-
 static void at_handler(void *context, const char *response)
 {
-	ARG_UNUSED(context);
-
 	int err;
 	bool notify = false;
-	enum lte_lc_notif_type notif_type;
+	/* The handler is registered for each prefix in at_notifs, with the
+	 * notification type as context.
+	 */
+	enum lte_lc_notif_type notif_type = POINTER_TO_UINT(context);
 	struct lte_lc_evt evt = {0};
 
 	if (response == NULL) {
@@ -202,11 +188,6 @@ static void at_handler(void *context, const char *response)
 		return;
 	}
 
-	/* Only proceed with parsing if notification is relevant */
-	if (!is_relevant_notif(response, &notif_type)) {
-		return;
-	}
-
 	switch (notif_type) {
 	case LTE_LC_NOTIF_CEREG: {
 		static enum lte_lc_nw_reg_status prev_reg_status =
@@ -462,49 +443,82 @@ static void at_handler(void *context, const char *response)
 static int enable_notifications(void)
 {
 	int err;
-	char buf_sub[35];
-
-	/* +CEREG notifications, level 5 */
-	err = at_cmd_write(cereg_5_subscribe, NULL, 0, NULL);
-	if (err) {
-		LOG_ERR("Failed to subscribe to CEREG notifications");
-		return err;
-	}
+	char xt3412_sub[35];
+	char xmodemsleep_sub[35];
+	struct at_cmd_async reqs[4] = {
+		/* +CEREG notifications, level 5 */
+		{ .cmd = cereg_5_subscribe },
+		/* +CSCON notifications */
+		{ .cmd = cscon },
+	};
+	struct at_cmd_async *xt3412_req = NULL;
+	struct at_cmd_async *xmodemsleep_req = NULL;
+	size_t req_cnt = 2;
 
 	if (IS_ENABLED(CONFIG_LTE_LC_TAU_PRE_WARNING_NOTIFICATIONS)) {
-		snprintk(buf_sub,
-			 sizeof(buf_sub),
+		snprintk(xt3412_sub,
+			 sizeof(xt3412_sub),
 			 AT_XT3412_SUB,
 			 CONFIG_LTE_LC_TAU_PRE_WARNING_TIME_MS,
 			 CONFIG_LTE_LC_TAU_PRE_WARNING_THRESHOLD_MS);
 
 		/* %XT3412 notifications subscribe */
-		err = at_cmd_write(buf_sub, NULL, 0, NULL);
-		if (err) {
-			LOG_WRN("%s failed (%d), TAU pre-warning notifications are not enabled",
-				log_strdup(buf_sub), err);
-			LOG_WRN("%s is supported in nRF9160 modem >= v1.3.0", log_strdup(buf_sub));
-		}
+		xt3412_req = &reqs[req_cnt++];
+		xt3412_req->cmd = xt3412_sub;
 	}
 
 	if (IS_ENABLED(CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS)) {
-		snprintk(buf_sub,
-			 sizeof(buf_sub),
+		snprintk(xmodemsleep_sub,
+			 sizeof(xmodemsleep_sub),
 			 AT_XMODEMSLEEP_SUB,
 			 CONFIG_LTE_LC_MODEM_SLEEP_PRE_WARNING_TIME_MS,
 			 CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS_THRESHOLD_MS);
 
 		/* %XMODEMSLEEP notifications subscribe */
-		err = at_cmd_write(buf_sub, NULL, 0, NULL);
+		xmodemsleep_req = &reqs[req_cnt++];
+		xmodemsleep_req->cmd = xmodemsleep_sub;
+	}
+
+	/* Subscriptions are independent, so they are queued at once instead of
+	 * waiting for each response in turn.
+	 */
+	err = at_cmd_write_batch(reqs, req_cnt, false);
+	if (err) {
+		LOG_ERR("Failed to queue notification subscriptions");
+		return err;
+	}
+
+	err = at_cmd_async_wait(&reqs[0], K_FOREVER, NULL);
+	if (err) {
+		LOG_ERR("Failed to subscribe to CEREG notifications");
+		/* Other requests are still referenced by the driver */
+		for (size_t i = 1; i < req_cnt; i++) {
+			(void)at_cmd_async_wait(&reqs[i], K_FOREVER, NULL);
+		}
+		return err;
+	}
+
+	if (xt3412_req) {
+		err = at_cmd_async_wait(xt3412_req, K_FOREVER, NULL);
+		if (err) {
+			LOG_WRN("%s failed (%d), TAU pre-warning notifications are not enabled",
+				log_strdup(xt3412_sub), err);
+			LOG_WRN("%s is supported in nRF9160 modem >= v1.3.0",
+				log_strdup(xt3412_sub));
+		}
+	}
+
+	if (xmodemsleep_req) {
+		err = at_cmd_async_wait(xmodemsleep_req, K_FOREVER, NULL);
 		if (err) {
 			LOG_WRN("%s failed (%d), modem sleep notifications are not enabled",
-				log_strdup(buf_sub), err);
-			LOG_WRN("%s is supported in nRF9160 modem >= v1.3.0", log_strdup(buf_sub));
+				log_strdup(xmodemsleep_sub), err);
+			LOG_WRN("%s is supported in nRF9160 modem >= v1.3.0",
+				log_strdup(xmodemsleep_sub));
 		}
 	}
 
-	/* +CSCON notifications */
-	err = at_cmd_write(cscon, NULL, 0, NULL);
+	err = at_cmd_async_wait(&reqs[1], K_FOREVER, NULL);
 	if (err) {
 		char buf[50];
 
@@ -550,10 +564,14 @@ static int init_and_config(void)
 		LOG_DBG("Default system mode is used: %d", sys_mode_current);
 	}
 
-	err = at_notif_register_handler(NULL, at_handler);
-	if (err) {
-		LOG_ERR("Can't register AT handler, error: %d", err);
-		return err;
+	for (size_t i = 0; i < ARRAY_SIZE(at_notifs); i++) {
+		err = at_notif_register_prefix_handler(at_notifs[i],
+						       UINT_TO_POINTER(i),
+						       at_handler);
+		if (err) {
+			LOG_ERR("Can't register AT handler, error: %d", err);
+			return err;
+		}
 	}
 
 	if ((sys_mode_current != sys_mode_target) ||
@@ -760,7 +778,11 @@ int lte_lc_deinit(void)
 {
 	if (is_initialized) {
 		is_initialized = false;
-		at_notif_deregister_handler(NULL, at_handler);
+		for (size_t i = 0; i < ARRAY_SIZE(at_notifs); i++) {
+			at_notif_deregister_prefix_handler(at_notifs[i],
+							   UINT_TO_POINTER(i),
+							   at_handler);
+		}
 		return lte_lc_func_mode_set(LTE_LC_FUNC_MODE_POWER_OFF);
 	}
 
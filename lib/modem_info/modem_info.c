@@ -18,6 +18,8 @@
 #include <zephyr/types.h>
 #include <logging/log.h>
 
+#include "modem_info_cache.h"
+
 LOG_MODULE_REGISTER(modem_info);
 
 #define INVALID_DESCRIPTOR	-1
@@ -343,11 +345,6 @@ static const struct modem_info_data *const modem_data[] = {
 static rsrp_cb_t modem_info_rsrp_cb;
 static struct at_param_list m_param_list;
 
-static bool is_cesq_notification(const char *buf, size_t len)
-{
-	return strstr(buf, AT_CMD_CESQ_RESP) ? true : false;
-}
-
 static void flip_iccid_string(char *buf)
 {
 	uint8_t current_char;
@@ -362,6 +359,15 @@ static void flip_iccid_string(char *buf)
 	}
 }
 
+static int modem_info_cmd_write(const char *cmd, char *buf, size_t buf_len)
+{
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		return modem_info_cache_cmd_write(cmd, buf, buf_len);
+	}
+
+	return at_cmd_write(cmd, buf, buf_len, NULL);
+}
+
 static int modem_info_parse(const struct modem_info_data *modem_data,
 			    const char *buf)
 {
@@ -431,10 +437,9 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EINVAL;
 	}
 
-	err = at_cmd_write(modem_data[info]->cmd,
-			   recv_buf,
-			   CONFIG_MODEM_INFO_BUFFER_SIZE,
-			   NULL);
+	err = modem_info_cmd_write(modem_data[info]->cmd,
+				   recv_buf,
+				   CONFIG_MODEM_INFO_BUFFER_SIZE);
 
 	if (err != 0) {
 		return -EIO;
@@ -478,10 +483,9 @@ int modem_info_string_get(enum modem_info info, char *buf,
 		return -EINVAL;
 	}
 
-	err = at_cmd_write(modem_data[info]->cmd,
-			  recv_buf,
-			  CONFIG_MODEM_INFO_BUFFER_SIZE,
-			  NULL);
+	err = modem_info_cmd_write(modem_data[info]->cmd,
+				   recv_buf,
+				   CONFIG_MODEM_INFO_BUFFER_SIZE);
 
 	/* modem_info does not yet support array objects, so here we handle
 	 * the supported bands independently as a string
@@ -602,10 +606,7 @@ static void modem_info_rsrp_subscribe_handler(void *context, const char *respons
 	uint16_t param_value;
 	int err;
 
-	if (!is_cesq_notification(response, strlen(response))) {
-		return;
-	}
-
+	/* Only %CESQ notifications are routed to this handler. */
 	const struct modem_info_data rsrp_notify_data = {
 		.cmd		= AT_CMD_CESQ,
 		.data_name	= RSRP_DATA_NAME,
@@ -636,7 +637,7 @@ int modem_info_rsrp_register(rsrp_cb_t cb)
 {
 	modem_info_rsrp_cb = cb;
 
-	int rc = at_notif_register_handler(NULL,
+	int rc = at_notif_register_prefix_handler(AT_CMD_CESQ_RESP, NULL,
 		modem_info_rsrp_subscribe_handler);
 	if (rc != 0) {
 		LOG_ERR("Can't register handler rc=%d", rc);
@@ -650,6 +651,26 @@ int modem_info_rsrp_register(rsrp_cb_t cb)
 	return 0;
 }
 
+#if defined(CONFIG_MODEM_INFO_CACHE)
+int modem_info_prefetch(const enum modem_info *info, size_t count)
+{
+	const char *cmds[MODEM_INFO_COUNT];
+
+	if (count > ARRAY_SIZE(cmds)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (info[i] >= MODEM_INFO_COUNT) {
+			return -EINVAL;
+		}
+		cmds[i] = modem_data[info[i]]->cmd;
+	}
+
+	return modem_info_cache_refresh(cmds, count);
+}
+#endif
+
 int modem_info_init(void)
 {
 	int err = 0;
@@ -660,5 +681,9 @@ int modem_info_init(void)
 					  CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP);
 	}
 
+	if (!err && IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		err = modem_info_cache_init();
+	}
+
 	return err;
 }
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <modem/at_cmd.h>
+#include <modem/at_notif.h>
+#include <modem/modem_info.h>
+#include <logging/log.h>
+
+#include "modem_info_cache.h"
+
+LOG_MODULE_REGISTER(modem_info_cache);
+
+#define NETWORK_TTL_MS (CONFIG_MODEM_INFO_CACHE_NETWORK_TTL * MSEC_PER_SEC)
+#define MEASUREMENT_TTL_MS \
+	(CONFIG_MODEM_INFO_CACHE_MEASUREMENT_TTL * MSEC_PER_SEC)
+
+/* Notifications invalidating cache entries, the bit position is the index
+ * of the notification prefix.
+ */
+enum cache_urc {
+	URC_CEREG	 = BIT(0),
+	URC_XMODEMSLEEP	 = BIT(1),
+	URC_CESQ	 = BIT(2),
+	URC_XSIM	 = BIT(3),
+};
+
+static const char *const urc_prefixes[] = {
+	"+CEREG", "%XMODEMSLEEP", "%CESQ", "%XSIM",
+};
+
+enum cache_class {
+	/* Does not change while the modem firmware is running. */
+	CLASS_STATIC,
+	/* Does not change until the SIM card is changed. */
+	CLASS_SIM,
+	/* Changes with the network registration. */
+	CLASS_NETWORK,
+	/* Changes continuously. */
+	CLASS_MEASUREMENT,
+};
+
+struct cache_entry {
+	const char *cmd;
+	enum cache_class class;
+	uint8_t urcs;
+	/* Incremented by the notifications invalidating the entry. The entry
+	 * is valid only if the response was requested in the current epoch,
+	 * so a notification received while the response is being requested
+	 * invalidates it.
+	 */
+	atomic_t epoch;
+	atomic_val_t resp_epoch;
+	bool valid;
+	int64_t updated_ms;
+	char resp[CONFIG_MODEM_INFO_BUFFER_SIZE];
+};
+
+#define CACHE_ENTRY(_cmd, _class, _urcs) \
+	{ .cmd = _cmd, .class = _class, .urcs = _urcs }
+
+/* Responses to the AT commands issued by the library. The commands not
+ * listed here, like AT+CCLK?, are never cached.
+ */
+static struct cache_entry entries[] = {
+	CACHE_ENTRY("AT+CESQ", CLASS_MEASUREMENT, URC_CESQ | URC_CEREG),
+	CACHE_ENTRY("AT%XCBAND", CLASS_NETWORK, URC_CEREG | URC_XMODEMSLEEP),
+	CACHE_ENTRY("AT%XCBAND=?", CLASS_STATIC, 0),
+	CACHE_ENTRY("AT+CEMODE?", CLASS_NETWORK, URC_CEREG),
+	CACHE_ENTRY("AT+COPS?", CLASS_NETWORK, URC_CEREG | URC_XMODEMSLEEP),
+	CACHE_ENTRY("AT+CEREG?", CLASS_NETWORK, URC_CEREG | URC_XMODEMSLEEP),
+	CACHE_ENTRY("AT+CGDCONT?", CLASS_NETWORK, URC_CEREG | URC_XMODEMSLEEP),
+	CACHE_ENTRY("AT%XSIM?", CLASS_SIM, URC_XSIM),
+	CACHE_ENTRY("AT%XVBAT", CLASS_MEASUREMENT, 0),
+	CACHE_ENTRY("AT%XTEMP?", CLASS_MEASUREMENT, 0),
+	CACHE_ENTRY("AT+CGMR", CLASS_STATIC, 0),
+	CACHE_ENTRY("AT+CRSM=176,12258,0,0,10", CLASS_SIM, URC_XSIM),
+	CACHE_ENTRY("AT%XSYSTEMMODE?", CLASS_NETWORK, URC_CEREG),
+	CACHE_ENTRY("AT+CIMI", CLASS_SIM, URC_XSIM),
+	CACHE_ENTRY("AT+CGSN", CLASS_STATIC, 0),
+};
+
+/* Protects the responses. Not taken by the notification handler, which runs
+ * in the AT command driver thread while the responses are being requested.
+ */
+static K_MUTEX_DEFINE(cache_lock);
+
+static struct cache_entry *entry_get(const char *cmd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!strcmp(entries[i].cmd, cmd)) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool entry_fresh(const struct cache_entry *entry, int64_t now)
+{
+	int64_t ttl_ms;
+
+	if (!entry->valid ||
+	    entry->resp_epoch != atomic_get(&entry->epoch)) {
+		return false;
+	}
+
+	switch (entry->class) {
+	case CLASS_NETWORK:
+		ttl_ms = NETWORK_TTL_MS;
+		break;
+	case CLASS_MEASUREMENT:
+		ttl_ms = MEASUREMENT_TTL_MS;
+		break;
+	default:
+		return true;
+	}
+
+	return ttl_ms == 0 || now - entry->updated_ms < ttl_ms;
+}
+
+static void entry_update(struct cache_entry *entry, atomic_val_t epoch)
+{
+	entry->valid = true;
+	entry->resp_epoch = epoch;
+	entry->updated_ms = k_uptime_get();
+}
+
+static void notif_handler(void *context, const char *response)
+{
+	uint8_t urc = POINTER_TO_UINT(context);
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].urcs & urc) {
+			atomic_inc(&entries[i].epoch);
+		}
+	}
+}
+
+int modem_info_cache_init(void)
+{
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(urc_prefixes); i++) {
+		err = at_notif_register_prefix_handler(urc_prefixes[i],
+						       UINT_TO_POINTER(BIT(i)),
+						       notif_handler);
+		if (err) {
+			LOG_ERR("Can't register handler for %s, err %d",
+				urc_prefixes[i], err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+void modem_info_cache_invalidate(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		atomic_inc(&entries[i].epoch);
+	}
+}
+
+int modem_info_cache_cmd_write(const char *cmd, char *buf, size_t buf_len)
+{
+	int err;
+	atomic_val_t epoch;
+	struct cache_entry *entry = entry_get(cmd);
+
+	if (entry == NULL || buf == NULL || buf_len == 0) {
+		return at_cmd_write(cmd, buf, buf_len, NULL);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (entry_fresh(entry, k_uptime_get())) {
+		LOG_DBG("Cache hit: %s", log_strdup(cmd));
+	} else {
+		epoch = atomic_get(&entry->epoch);
+		entry->valid = false;
+
+		err = at_cmd_write(cmd, entry->resp, sizeof(entry->resp), NULL);
+		if (err) {
+			k_mutex_unlock(&cache_lock);
+			return err;
+		}
+
+		entry_update(entry, epoch);
+	}
+
+	strncpy(buf, entry->resp, buf_len - 1);
+	buf[buf_len - 1] = '\0';
+
+	k_mutex_unlock(&cache_lock);
+
+	return 0;
+}
+
+int modem_info_cache_refresh(const char *const *cmds, size_t count)
+{
+	/* Protected by cache_lock */
+	static struct at_cmd_async reqs[ARRAY_SIZE(entries)];
+	static struct cache_entry *stale[ARRAY_SIZE(entries)];
+	static atomic_val_t epochs[ARRAY_SIZE(entries)];
+	struct cache_entry *entry;
+	size_t stale_cnt = 0;
+	size_t batch_len;
+	int64_t now;
+	int err = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	now = k_uptime_get();
+	for (size_t i = 0; i < count; i++) {
+		entry = entry_get(cmds[i]);
+		if (entry == NULL || entry_fresh(entry, now)) {
+			continue;
+		}
+
+		/* Several information types share the same command */
+		for (size_t j = 0; j < stale_cnt; j++) {
+			if (stale[j] == entry) {
+				entry = NULL;
+				break;
+			}
+		}
+		if (entry == NULL) {
+			continue;
+		}
+
+		epochs[stale_cnt] = atomic_get(&entry->epoch);
+		entry->valid = false;
+		stale[stale_cnt] = entry;
+		reqs[stale_cnt] = (struct at_cmd_async) {
+			.cmd = entry->cmd,
+			.resp = entry->resp,
+			.resp_size = sizeof(entry->resp),
+		};
+		stale_cnt++;
+	}
+
+	if (stale_cnt > 0) {
+		LOG_DBG("Refreshing %d cache entries", stale_cnt);
+	}
+
+	for (size_t i = 0; i < stale_cnt; i += batch_len) {
+		batch_len = MIN(stale_cnt - i, CONFIG_AT_CMD_QUEUE_LEN);
+
+		err = at_cmd_write_batch(&reqs[i], batch_len, false);
+		if (err) {
+			LOG_ERR("Can't queue AT commands, err %d", err);
+			break;
+		}
+
+		for (size_t j = i; j < i + batch_len; j++) {
+			if (at_cmd_async_wait(&reqs[j], K_FOREVER, NULL) == 0) {
+				entry_update(stale[j], epochs[j]);
+			} else {
+				/* The command is issued again when read */
+				LOG_DBG("%s failed", log_strdup(reqs[j].cmd));
+			}
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MODEM_INFO_CACHE_H__
+#define MODEM_INFO_CACHE_H__
+
+#include <stddef.h>
+#include <modem/modem_info.h>
+
+/* Register the notification handlers invalidating the cache. */
+int modem_info_cache_init(void);
+
+/* Same as at_cmd_write(), but answered from the cache when the response
+ * to the command is cached and still valid.
+ */
+int modem_info_cache_cmd_write(const char *cmd, char *buf, size_t buf_len);
+
+/* Refresh the cache entries of the given commands that are not valid,
+ * using a single batch of AT commands.
+ */
+int modem_info_cache_refresh(const char *const *cmds, size_t count);
+
+/* Refresh the cache entries needed to read the given information types. */
+int modem_info_prefetch(const enum modem_info *info, size_t count);
+
+#endif /* MODEM_INFO_CACHE_H__ */
@@ -11,6 +11,8 @@
 #include <modem/at_params.h>
 #include <logging/log.h>
 
+#include "modem_info_cache.h"
+
 LOG_MODULE_REGISTER(modem_info_params);
 
 int modem_info_params_init(struct modem_param_info *modem)
@@ -128,6 +130,52 @@ static int modem_data_get(struct lte_param *param)
 	return 0;
 }
 
+/* Refresh the stale cached data with a single batch of AT commands,
+ * instead of one command at a time when reading each parameter.
+ */
+static void modem_data_prefetch(void)
+{
+	enum modem_info info[MODEM_INFO_COUNT];
+	size_t count = 0;
+	int ret;
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)) {
+		info[count++] = MODEM_INFO_CUR_BAND;
+		info[count++] = MODEM_INFO_SUP_BAND;
+		info[count++] = MODEM_INFO_IP_ADDRESS;
+		info[count++] = MODEM_INFO_UE_MODE;
+		info[count++] = MODEM_INFO_OPERATOR;
+		info[count++] = MODEM_INFO_CELLID;
+		info[count++] = MODEM_INFO_AREA_CODE;
+		info[count++] = MODEM_INFO_LTE_MODE;
+		info[count++] = MODEM_INFO_NBIOT_MODE;
+		info[count++] = MODEM_INFO_GPS_MODE;
+		info[count++] = MODEM_INFO_APN;
+	}
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM)) {
+		info[count++] = MODEM_INFO_UICC;
+		if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM_ICCID)) {
+			info[count++] = MODEM_INFO_ICCID;
+		}
+		if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM_IMSI)) {
+			info[count++] = MODEM_INFO_IMSI;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_DEVICE)) {
+		info[count++] = MODEM_INFO_FW_VERSION;
+		info[count++] = MODEM_INFO_BATTERY;
+		info[count++] = MODEM_INFO_IMEI;
+	}
+
+	/* On failure, the data is requested when reading each parameter */
+	ret = modem_info_prefetch(info, count);
+	if (ret) {
+		LOG_WRN("Modem data not prefetched: %d", ret);
+	}
+}
+
 int modem_info_params_get(struct modem_param_info *modem)
 {
 	int ret;
@@ -136,6 +184,10 @@ int modem_info_params_get(struct modem_param_info *modem)
 		return -EINVAL;
 	}
 
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		modem_data_prefetch();
+	}
+
 	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)) {
 		ret = modem_data_get(&modem->network.current_band);
 		ret += modem_data_get(&modem->network.sup_band);
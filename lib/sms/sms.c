@@ -17,6 +17,7 @@
 #include "sms_submit.h"
 #include "sms_deliver.h"
 #include "sms_at.h"
+#include "sms_concat.h"
 #include "sms_internal.h"
 
 LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
@@ -106,6 +107,15 @@ void sms_at_handler(void *context, const char *at_notif)
 		return;
 	}
 
+	/* Hold back parts of concatenated messages until the whole message is received. */
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY) &&
+	    sms_data_info.type == SMS_TYPE_DELIVER &&
+	    sms_data_info.header.deliver.concatenated.present &&
+	    !sms_concat_add(&sms_data_info)) {
+		k_work_submit(&sms_ack_work);
+		return;
+	}
+
 	/* Notify all subscribers. */
 	LOG_DBG("Valid SMS notification decoded");
 	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
@@ -282,6 +292,10 @@ static void sms_uninit(void)
 	/* Cleanup resources. */
 	at_params_list_free(&resp_list);
 
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY)) {
+		sms_concat_reset();
+	}
+
 	sms_client_registered = false;
 }
 
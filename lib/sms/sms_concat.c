@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <modem/sms.h>
+#include <logging/log.h>
+
+#include "sms_concat.h"
+
+LOG_MODULE_DECLARE(sms, CONFIG_SMS_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_SMS_CONCAT_POOL_SIZE >= CONFIG_SMS_CONCAT_MAX_PARTS - 1,
+	     "Pool cannot hold the parts of a message with the maximum number of parts");
+
+/** @brief Reassembly timeout in milliseconds. */
+#define SMS_CONCAT_TIMEOUT_MS (CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC)
+
+/**
+ * @brief Memory pool for the stored parts, shared by all messages being reassembled.
+ *
+ * @details The last part of a message is not stored, because the message is reassembled
+ * into the buffer in which it is received.
+ */
+K_MEM_SLAB_DEFINE(sms_concat_slab, SMS_MAX_PAYLOAD_LEN_CHARS, CONFIG_SMS_CONCAT_POOL_SIZE, 4);
+
+/** @brief Concatenated message being reassembled. */
+struct sms_concat_msg {
+	/** @brief Indicates whether the message is being reassembled. */
+	bool in_use;
+	/** @brief Uptime when the first received part arrived. */
+	int64_t start_time;
+	/** @brief Order in which the reassembly of the messages was started. */
+	uint32_t order;
+	/**
+	 * @brief Header of the first part, or of the first received part
+	 * until the first part arrives.
+	 */
+	struct sms_deliver_header header;
+	/** @brief Bitmask of the received parts, bit 0 being the first part. */
+	uint32_t received;
+	/** @brief Number of received parts. */
+	uint8_t received_cnt;
+	/** @brief Payloads of the received parts, allocated from the pool. */
+	uint8_t *parts[CONFIG_SMS_CONCAT_MAX_PARTS];
+	/** @brief Payload lengths of the received parts. */
+	uint8_t part_len[CONFIG_SMS_CONCAT_MAX_PARTS];
+};
+
+static struct sms_concat_msg msgs[CONFIG_SMS_CONCAT_MAX_MSGS];
+
+/** @brief Counter for ordering the messages, as several may start within the same tick. */
+static uint32_t msg_order;
+
+static void msg_free(struct sms_concat_msg *msg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msg->parts); i++) {
+		if (msg->parts[i] != NULL) {
+			k_mem_slab_free(&sms_concat_slab, (void **)&msg->parts[i]);
+		}
+	}
+
+	memset(msg, 0, sizeof(*msg));
+}
+
+static struct sms_concat_msg *msg_find(const struct sms_deliver_header *header)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].in_use &&
+		    msgs[i].header.concatenated.ref_number == header->concatenated.ref_number &&
+		    msgs[i].header.concatenated.total_msgs == header->concatenated.total_msgs &&
+		    strcmp(msgs[i].header.originating_address.address_str,
+			   header->originating_address.address_str) == 0) {
+			return &msgs[i];
+		}
+	}
+
+	return NULL;
+}
+
+/** @brief Find the message whose reassembly was started first. */
+static struct sms_concat_msg *msg_oldest(const struct sms_concat_msg *exclude)
+{
+	struct sms_concat_msg *oldest = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (!msgs[i].in_use || &msgs[i] == exclude) {
+			continue;
+		}
+		if (oldest == NULL || (int32_t)(msgs[i].order - oldest->order) < 0) {
+			oldest = &msgs[i];
+		}
+	}
+
+	return oldest;
+}
+
+static void msg_evict(struct sms_concat_msg *msg)
+{
+	LOG_WRN("Dropping concatenated message %d, %d of %d parts received",
+		msg->header.concatenated.ref_number, msg->received_cnt,
+		msg->header.concatenated.total_msgs);
+
+	msg_free(msg);
+}
+
+static void msg_expire(int64_t now)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].in_use && now - msgs[i].start_time > SMS_CONCAT_TIMEOUT_MS) {
+			LOG_WRN("Concatenated message timed out");
+			msg_evict(&msgs[i]);
+		}
+	}
+}
+
+static struct sms_concat_msg *msg_alloc(const struct sms_deliver_header *header, int64_t now)
+{
+	struct sms_concat_msg *msg = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (!msgs[i].in_use) {
+			msg = &msgs[i];
+			break;
+		}
+	}
+
+	if (msg == NULL) {
+		msg = msg_oldest(NULL);
+		msg_evict(msg);
+	}
+
+	msg->in_use = true;
+	msg->start_time = now;
+	msg->order = msg_order++;
+	msg->header = *header;
+
+	return msg;
+}
+
+static int part_store(struct sms_concat_msg *msg, uint8_t idx, const struct sms_data *data)
+{
+	struct sms_concat_msg *victim;
+	void *block;
+
+	/* Make room by dropping the oldest other messages if the pool is exhausted. */
+	while (k_mem_slab_alloc(&sms_concat_slab, &block, K_NO_WAIT) != 0) {
+		victim = msg_oldest(msg);
+		if (victim == NULL) {
+			return -ENOMEM;
+		}
+		msg_evict(victim);
+	}
+
+	memcpy(block, data->payload, data->payload_len);
+	msg->parts[idx] = block;
+	msg->part_len[idx] = data->payload_len;
+
+	return 0;
+}
+
+/**
+ * @brief Reassemble the message into the buffer holding its last received part.
+ *
+ * @details The last received part is first moved to its final position, after which
+ * the stored parts are copied around it.
+ */
+static void msg_reassemble(struct sms_concat_msg *msg, uint8_t idx, struct sms_data *data)
+{
+	uint16_t offset = 0;
+	uint16_t pos = 0;
+
+	for (uint8_t i = 0; i < idx; i++) {
+		offset += msg->part_len[i];
+	}
+
+	memmove(&data->payload[offset], data->payload, data->payload_len);
+	msg->part_len[idx] = data->payload_len;
+
+	for (uint8_t i = 0; i < msg->header.concatenated.total_msgs; i++) {
+		if (i != idx) {
+			memcpy(&data->payload[pos], msg->parts[i], msg->part_len[i]);
+		}
+		pos += msg->part_len[i];
+	}
+
+	data->payload_len = pos;
+	data->payload[pos] = '\0';
+
+	data->header.deliver = msg->header;
+	memset(&data->header.deliver.concatenated, 0, sizeof(struct sms_udh_concat));
+
+	LOG_DBG("Concatenated message %d reassembled, length %d",
+		msg->header.concatenated.ref_number, pos);
+
+	msg_free(msg);
+}
+
+bool sms_concat_add(struct sms_data *data)
+{
+	struct sms_deliver_header *header = &data->header.deliver;
+	uint8_t total = header->concatenated.total_msgs;
+	uint8_t idx = header->concatenated.seq_number - 1;
+	struct sms_concat_msg *msg;
+	int64_t now;
+
+	if (total == 1) {
+		memset(&header->concatenated, 0, sizeof(struct sms_udh_concat));
+		return true;
+	}
+
+	if (total > CONFIG_SMS_CONCAT_MAX_PARTS) {
+		LOG_WRN("Concatenated message with %d parts cannot be reassembled", total);
+		return true;
+	}
+
+	now = k_uptime_get();
+	msg_expire(now);
+
+	msg = msg_find(header);
+	if (msg == NULL) {
+		msg = msg_alloc(header, now);
+	}
+
+	if (msg->received & BIT(idx)) {
+		LOG_DBG("Duplicate part %d of concatenated message %d",
+			idx + 1, header->concatenated.ref_number);
+		return false;
+	}
+
+	if (idx == 0) {
+		msg->header = *header;
+	}
+
+	if (msg->received_cnt == total - 1) {
+		msg_reassemble(msg, idx, data);
+		return true;
+	}
+
+	if (part_store(msg, idx, data)) {
+		LOG_ERR("No memory for concatenated message %d", header->concatenated.ref_number);
+		msg_free(msg);
+		return false;
+	}
+
+	msg->received |= BIT(idx);
+	msg->received_cnt++;
+
+	return false;
+}
+
+void sms_concat_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].in_use) {
+			msg_free(&msgs[i]);
+		}
+	}
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SMS_CONCAT_INCLUDE_H_
+#define _SMS_CONCAT_INCLUDE_H_
+
+#include <stdbool.h>
+
+/* Forward declaration */
+struct sms_data;
+
+/**
+ * @brief Add a received part of a concatenated SMS message to the reassembly.
+ *
+ * @details The part is stored until all parts of the message have been received.
+ * When the last part is added, the whole message is reassembled into @p data, its
+ * header is set to the header of the first part, and the concatenation information
+ * is cleared. Parts are accepted in any order, and duplicate parts are ignored.
+ *
+ * Parts of messages with more parts than CONFIG_SMS_CONCAT_MAX_PARTS are not
+ * reassembled but left unmodified in @p data.
+ *
+ * @param[in,out] data Received part. Contains the reassembled message on return if
+ *                     the message is complete.
+ *
+ * @retval true @p data should be delivered to the listeners.
+ * @retval false The part was stored or dropped and there is nothing to deliver.
+ */
+bool sms_concat_add(struct sms_data *data);
+
+/**
+ * @brief Drop all messages being reassembled and release their memory.
+ */
+void sms_concat_reset(void);
+
+#endif
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/byteorder.h>
 #include "string_conversion.h"
 
 #define STR_MAX_CHARACTERS      160
@@ -14,6 +15,10 @@
 #define STR_7BIT_CODE_MASK      0x7F
 #define STR_7BIT_ESCAPE_CODE    0x1B
 
+/* Packing is done in groups of 8 septets, which fit exactly into 7 bytes. */
+#define STR_GROUP_CHARS         8
+#define STR_GROUP_BYTES         7
+
 /**
  * @brief Conversion table from ASCII (with ISO-8859-15 extension) to GSM 7 bit
  * Default Alphabet character set (3GPP TS 23.038 chapter 6.2.1).
@@ -159,6 +164,76 @@ static const uint8_t gsm7bit_to_ascii_table[256] = {
 	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,  /* 248-255/ext 120-127  */
 };
 
+/**
+ * @brief Output of septets, optionally packed on the fly.
+ *
+ * @details When packing, septets are collected into a 56 bit accumulator which is
+ * written out as 7 bytes once it is full, so the conversion and the packing are done
+ * in a single pass over the data.
+ */
+struct septet_writer {
+	uint8_t *out;
+	uint64_t acc;
+	uint8_t bits;
+	uint8_t bytes;
+	uint8_t chars;
+	bool packing;
+};
+
+/**
+ * @brief Store the given group of 8 septets, packed into 56 bits, as 7 bytes.
+ */
+static inline void group_store(uint8_t *out, uint64_t group)
+{
+	group = sys_cpu_to_le64(group);
+	memcpy(out, &group, STR_GROUP_BYTES);
+}
+
+/**
+ * @brief Load 7 bytes containing a group of 8 packed septets.
+ */
+static inline uint64_t group_load(const uint8_t *in)
+{
+	uint64_t group = 0;
+
+	memcpy(&group, in, STR_GROUP_BYTES);
+	return sys_le64_to_cpu(group);
+}
+
+static inline void septet_put(struct septet_writer *w, uint8_t septet)
+{
+	if (!w->packing) {
+		w->out[w->chars++] = septet;
+		return;
+	}
+
+	w->acc |= (uint64_t)septet << w->bits;
+	w->bits += 7;
+	w->chars++;
+
+	if (w->bits == STR_GROUP_CHARS * 7) {
+		group_store(w->out + w->bytes, w->acc);
+		w->bytes += STR_GROUP_BYTES;
+		w->acc = 0;
+		w->bits = 0;
+	}
+}
+
+static inline void septet_flush(struct septet_writer *w)
+{
+	if (!w->packing) {
+		w->bytes = w->chars;
+		return;
+	}
+
+	/* Write the remaining septets, padded to a full byte. */
+	while (w->bits > 0) {
+		w->out[w->bytes++] = (uint8_t)w->acc;
+		w->acc >>= 8;
+		w->bits = (w->bits > 8) ? w->bits - 8 : 0;
+	}
+}
+
 uint8_t string_conversion_ascii_to_gsm7bit(
 	const uint8_t *data,
 	uint8_t  data_len,
@@ -167,49 +242,43 @@ uint8_t string_conversion_ascii_to_gsm7bit(
 	uint8_t *out_chars,
 	bool     packing)
 {
+	struct septet_writer w = {
+		.out = out_data,
+		.packing = packing,
+	};
 	uint8_t index_ascii = 0;
-	uint8_t index_7bit = 0;
-	uint8_t out_bytes_tmp = 0;
 	uint8_t char_7bit;
-	uint8_t char_ascii;
 
 	if ((data == NULL) || (out_data == NULL)) {
 		return 0;
 	}
 
 	for (index_ascii = 0; index_ascii < data_len; index_ascii++) {
-		char_ascii = data[index_ascii];
-		char_7bit = ascii_to_7bit_table[char_ascii];
+		char_7bit = ascii_to_7bit_table[data[index_ascii]];
 
 		if ((char_7bit & STR_7BIT_ESCAPE_IND) == 0) {
 			/* Character is in default alphabet table */
-			if (index_7bit < STR_MAX_CHARACTERS) {
-				out_data[index_7bit++] = char_7bit;
-			} else {
+			if (w.chars >= STR_MAX_CHARACTERS) {
 				break;
 			}
+			septet_put(&w, char_7bit);
 		} else {
 			/* Character is in default extension table */
-			if (index_7bit < STR_MAX_CHARACTERS - 1) {
-				out_data[index_7bit++] = STR_7BIT_ESCAPE_CODE;
-				out_data[index_7bit++] = (char_7bit & STR_7BIT_CODE_MASK);
-			} else {
+			if (w.chars >= STR_MAX_CHARACTERS - 1) {
 				break;
 			}
+			septet_put(&w, STR_7BIT_ESCAPE_CODE);
+			septet_put(&w, char_7bit & STR_7BIT_CODE_MASK);
 		}
 	}
 
-	if (packing == true) {
-		out_bytes_tmp = string_conversion_7bit_sms_packing(out_data, index_7bit);
-	} else {
-		out_bytes_tmp = index_7bit;
-	}
+	septet_flush(&w);
 
 	if (out_bytes != NULL) {
-		*out_bytes = out_bytes_tmp;
+		*out_bytes = w.bytes;
 	}
 	if (out_chars != NULL) {
-		*out_chars = index_7bit;
+		*out_chars = w.chars;
 	}
 	return index_ascii;
 }
@@ -293,14 +362,36 @@ uint8_t string_conversion_gsm7bit_to_ascii(
  */
 uint8_t string_conversion_7bit_sms_packing(uint8_t *data, uint8_t data_len)
 {
-	uint8_t src = 0;
-	uint8_t dst = 0;
+	uint16_t src = 0;
+	uint16_t dst = 0;
 	uint8_t shift = 0;
+	uint64_t group;
 
 	if (data == NULL) {
 		return 0;
 	}
 
+	/* Pack full groups of 8 septets into 7 bytes at a time. The septets are gathered
+	 * from the 8 bytes by halving the number of lanes in each step. The whole group
+	 * is loaded before it is stored, and the destination never overtakes the source,
+	 * so packing in place is safe.
+	 */
+	for (; data_len - src >= STR_GROUP_CHARS;
+	     src += STR_GROUP_CHARS, dst += STR_GROUP_BYTES) {
+		memcpy(&group, &data[src], sizeof(group));
+		group = sys_le64_to_cpu(group);
+
+		group = (group & 0x007F007F007F007FULL) |
+			((group & 0x7F007F007F007F00ULL) >> 1);
+		group = (group & 0x00003FFF00003FFFULL) |
+			((group & 0x3FFF00003FFF0000ULL) >> 2);
+		group = (group & 0x000000000FFFFFFFULL) |
+			((group & 0x0FFFFFFF00000000ULL) >> 4);
+
+		group_store(&data[dst], group);
+	}
+
+	/* Remaining septets, which start at a byte boundary again. */
 	while (src < data_len) {
 		data[dst] = data[src] >> shift;
 		src++;
@@ -325,29 +416,44 @@ uint8_t string_conversion_7bit_sms_unpacking(
 	uint8_t *unpacked,
 	uint8_t num_char)
 {
-	uint8_t shift = 1;
-	uint8_t index_pack = 1;
-	uint8_t index_char = 0;
+	uint16_t index_pack = 0;
+	uint16_t index_char = 0;
+	uint8_t bit_pos;
+	uint8_t shift;
+	uint64_t group;
 
 	if ((packed == NULL) || (unpacked == NULL) || (num_char == 0)) {
 		return 0;
 	}
 
-	unpacked[0] = packed[0] & STR_7BIT_CODE_MASK;
-	index_char++;
+	/* Unpack full groups of 7 bytes into 8 septets at a time, spreading the 56 bits
+	 * over twice the number of lanes in each step.
+	 */
+	for (; num_char - index_char >= STR_GROUP_CHARS;
+	     index_char += STR_GROUP_CHARS, index_pack += STR_GROUP_BYTES) {
+		group = group_load(&packed[index_pack]);
+
+		group = (group & 0x000000000FFFFFFFULL) |
+			((group << 4) & 0x0FFFFFFF00000000ULL);
+		group = (group & 0x00003FFF00003FFFULL) |
+			((group << 2) & 0x3FFF00003FFF0000ULL);
+		group = (group & 0x007F007F007F007FULL) |
+			((group << 1) & 0x7F007F007F007F00ULL);
+
+		group = sys_cpu_to_le64(group);
+		memcpy(&unpacked[index_char], &group, sizeof(group));
+	}
 
-	while (index_char < num_char) {
-		unpacked[index_char] =
-			(packed[index_pack] << shift) | (packed[index_pack - 1] >> (8 - shift));
-		unpacked[index_char] &= STR_7BIT_CODE_MASK;
+	/* Remaining septets. A septet spans two bytes unless it starts at bit 0 or 1. */
+	for (; index_char < num_char; index_char++) {
+		bit_pos = (index_char % STR_GROUP_CHARS) * 7;
+		shift = bit_pos % 8;
 
-		shift++;
-		if (shift == 8) {
-			shift = 0;
-		} else {
-			index_pack++;
+		unpacked[index_char] = packed[index_pack + bit_pos / 8] >> shift;
+		if (shift > 1) {
+			unpacked[index_char] |= packed[index_pack + bit_pos / 8 + 1] << (8 - shift);
 		}
-		index_char++;
+		unpacked[index_char] &= STR_7BIT_CODE_MASK;
 	}
 
 	return index_char;
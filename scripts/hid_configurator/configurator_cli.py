@@ -15,6 +15,7 @@ from modules.config import change_config, fetch_config
 from modules.dfu import DfuImage
 from modules.dfu import fwinfo, fwreboot, dfu_transfer
 from modules.led_stream import send_continuous_led_stream
+from modules.latency import fetch_latency, reset_latency, latency_to_str
 try:
     from modules.music_led_stream import send_music_led_stream
 except ImportError as e:
@@ -146,6 +147,22 @@ def perform_fwreboot(dev, args):
         print('FW reboot request failed')
 
 
+def perform_latency(dev, args):
+    if args.reset:
+        if reset_latency(dev):
+            print('Latency histograms reset')
+        else:
+            print('Latency histograms reset failed')
+        return
+
+    latency = fetch_latency(dev)
+
+    if latency:
+        print(latency_to_str(*latency))
+    else:
+        print('Latency request failed')
+
+
 def perform_led_stream(dev, args):
     if args.file is not None:
         try:
@@ -178,6 +195,11 @@ def parse_arguments():
     sp_commands.add_parser('fwinfo', help='Obtain information about FW image')
     sp_commands.add_parser('fwreboot', help='Request FW reboot')
 
+    parser_latency = sp_commands.add_parser('latency',
+                                            help='Show HID input latency histograms')
+    parser_latency.add_argument('--reset', help='Reset the histograms',
+                                action='store_true')
+
     parser_stream = sp_commands.add_parser('led_stream',
                                     help='Send continuous LED effects stream')
     parser_stream.add_argument('led_id', type=int, help='Stream LED ID')
@@ -254,6 +276,7 @@ configurator.ALLOWED_COMMANDS = {
     'fwinfo' : perform_fwinfo,
     'fwreboot' : perform_fwreboot,
     'config' : perform_config,
+    'latency' : perform_latency,
     'led_stream' : perform_led_stream
 }
 
@@ -0,0 +1,57 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import struct
+import logging
+
+from NrfHidDevice import EVENT_DATA_LEN_MAX
+
+LATENCY_MODULE = 'hid_latency'
+LATENCY_HISTOGRAMS = ['ble_input', 'ble_send', 'ble_total',
+                      'usb_input', 'usb_send', 'usb_total']
+LATENCY_BUCKET_COUNT = 8
+
+
+def bucket_labels(bucket_us):
+    labels = []
+    for i in range(LATENCY_BUCKET_COUNT - 1):
+        labels.append('<{:.1f}ms'.format(bucket_us * (1 << i) / 1000))
+    labels.append('>={:.1f}ms'.format(bucket_us * (1 << (LATENCY_BUCKET_COUNT - 2)) / 1000))
+    return labels
+
+
+def fetch_latency(dev):
+    success, fetched_data = dev.config_get(LATENCY_MODULE, 'bucket')
+    if not success or not fetched_data:
+        return None
+
+    fmt = '<I'
+    assert struct.calcsize(fmt) <= EVENT_DATA_LEN_MAX
+    bucket_us = struct.unpack(fmt, fetched_data)[0]
+
+    fmt = '<{}H'.format(LATENCY_BUCKET_COUNT)
+    assert struct.calcsize(fmt) <= EVENT_DATA_LEN_MAX
+
+    histograms = {}
+    for name in LATENCY_HISTOGRAMS:
+        success, fetched_data = dev.config_get(LATENCY_MODULE, name)
+        if not success or fetched_data is None or len(fetched_data) != struct.calcsize(fmt):
+            logging.debug('Cannot fetch {}'.format(name))
+            return None
+        histograms[name] = struct.unpack(fmt, fetched_data)
+
+    return bucket_us, histograms
+
+
+def reset_latency(dev):
+    return dev.config_set(LATENCY_MODULE, 'reset', None)
+
+
+def latency_to_str(bucket_us, histograms):
+    labels = bucket_labels(bucket_us)
+    lines = ['{:<10}'.format('') + ''.join('{:>10}'.format(l) for l in labels)]
+    for name, counts in histograms.items():
+        lines.append('{:<10}'.format(name) + ''.join('{:>10}'.format(c) for c in counts))
+    return '\n'.join(lines)
@@ -0,0 +1,263 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""Round-trip tests of trace_decoder.py on synthetic traces.
+
+Run with: python3 -m unittest test_trace_decoder
+"""
+
+import trace_decoder
+import numpy as np
+import argparse
+import io
+import json
+import os
+import random
+import struct
+import tempfile
+import unittest
+
+
+EVENT_TYPES = {
+    0: ('event_processing_start', ['u32'], ['mem_address']),
+    1: ('event_processing_end', ['u32'], ['mem_address']),
+    2: ('button_event', ['u32', 'u8', 's8'],
+        ['mem_address', 'key_id', 'pressed']),
+    3: ('ping', [], []),
+    4: ('req', ['u32'], ['id']),
+    5: ('rsp', ['u32', 's32'], ['id', 'status']),
+}
+
+MS_PER_TICK = 0.5
+
+
+def write_info_file(filename):
+    with open(filename, 'w') as wr:
+        for type_id, (name, data_types, labels) in EVENT_TYPES.items():
+            wr.write(','.join([name, str(type_id)] + data_types + labels))
+            wr.write('\n')
+        wr.write('\n')
+
+
+def encode(records):
+    buf = bytearray()
+    for type_id, ts, args in records:
+        buf += struct.pack('<BI', type_id, ts % 2**32)
+        buf += struct.pack('<{}I'.format(len(args)), *args)
+    return bytes(buf)
+
+
+def synthetic_trace(cnt, seed):
+    """Generate records with unwrapped timestamps.
+
+    Timestamps start close to the 32-bit overflow, so the trace wraps.
+    """
+    rnd = random.Random(seed)
+    records = []
+    ts = 2**32 - 1000
+    free = list(range(0x20000000, 0x20000000 + 8 * 16, 16))
+    queued = []
+    processing = []
+    req_ids = []
+
+    for _ in range(cnt):
+        ts += rnd.randint(0, 20)
+        choice = rnd.random()
+        if choice < 0.25 and free:
+            addr = free.pop(rnd.randrange(len(free)))
+            queued.append(addr)
+            records.append((2, ts, [addr, rnd.randint(0, 255),
+                                    rnd.randint(0, 1)]))
+        elif choice < 0.45 and queued:
+            addr = queued.pop(0)
+            processing.append(addr)
+            records.append((0, ts, [addr]))
+        elif choice < 0.65 and processing:
+            addr = processing.pop()
+            free.append(addr)
+            records.append((1, ts, [addr]))
+        elif choice < 0.75:
+            records.append((3, ts, []))
+        elif choice < 0.85:
+            req_id = rnd.randint(0, 20)
+            req_ids.append(req_id)
+            records.append((4, ts, [req_id]))
+        else:
+            req_id = rnd.choice(req_ids) if req_ids and rnd.random() < 0.8 \
+                else rnd.randint(0, 20)
+            records.append((5, ts, [req_id, rnd.randint(0, 2**32 - 1)]))
+    return records
+
+
+def reference_durations(records, pairs):
+    """Match events record by record, as the stats are defined."""
+    res = dict()
+    submitted = dict()
+    processing = dict()
+    pair_starts = dict((key, dict()) for key in pairs)
+
+    def add(name, metric, value):
+        res.setdefault((name, metric), []).append(value)
+
+    for type_id, ts, args in records:
+        name = EVENT_TYPES[type_id][0]
+        res.setdefault((name, 'interval'), [])
+        if not args:
+            continue
+        addr = args[0]
+
+        for (start_id, end_id), starts in pair_starts.items():
+            if type_id == start_id:
+                starts[addr] = ts
+            elif type_id == end_id and addr in starts:
+                add(EVENT_TYPES[start_id][0] + ':' + EVENT_TYPES[end_id][0],
+                    'duration', ts - starts.pop(addr))
+
+        if type_id == 0:
+            if addr in submitted:
+                submit_type, submit_ts = submitted.pop(addr)
+                add(EVENT_TYPES[submit_type][0], 'submit_to_start',
+                    ts - submit_ts)
+                processing[addr] = (submit_type, ts)
+        elif type_id == 1:
+            if addr in processing:
+                start_type, start_ts = processing.pop(addr)
+                add(EVENT_TYPES[start_type][0], 'processing', ts - start_ts)
+        else:
+            submitted[addr] = (type_id, ts)
+
+    last = dict()
+    for type_id, ts, _ in records:
+        name = EVENT_TYPES[type_id][0]
+        if type_id in last:
+            add(name, 'interval', ts - last[type_id])
+        last[type_id] = ts
+
+    return dict((key, values) for key, values in res.items() if values)
+
+
+class TraceDecoderTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.info_file = os.path.join(self.tmp.name, 'info.txt')
+        write_info_file(self.info_file)
+        self.event_types = trace_decoder.read_event_types(self.info_file)
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def decode(self, records, chunk_size, pairs=(), columns=None):
+        data_file = os.path.join(self.tmp.name, 'data.bin')
+        with open(data_file, 'wb') as wr:
+            wr.write(encode(records))
+
+        args = argparse.Namespace(data_file=data_file,
+                                  info_file=self.info_file,
+                                  pair=list(pairs), chunk_size=chunk_size,
+                                  columns=columns)
+        return trace_decoder.decode_trace(args, MS_PER_TICK,
+                                          trace_decoder.logging.ERROR)
+
+    def test_columns(self):
+        records = synthetic_trace(3000, seed=1)
+        columns = os.path.join(self.tmp.name, 'columns')
+        # Chunk size not aligned to any record size splits records.
+        summary = self.decode(records, chunk_size=37, columns=columns)
+        self.assertEqual(summary['records'], len(records))
+
+        with open(os.path.join(columns, 'event_types.json'), 'r') as rd:
+            meta = json.load(rd)
+        self.assertEqual(meta['ms_per_timestamp_tick'], MS_PER_TICK)
+
+        for type_id, (name, data_types, labels) in EVENT_TYPES.items():
+            expected = [r for r in records if r[0] == type_id]
+            type_dir = os.path.join(columns, name)
+            if not expected:
+                self.assertFalse(os.path.exists(type_dir))
+                continue
+
+            column_types = meta[str(type_id)]['columns']
+            ts = np.fromfile(os.path.join(type_dir, 'timestamp.bin'),
+                             dtype=column_types['timestamp'])
+            self.assertEqual(ts.tolist(), [r[1] for r in expected])
+
+            for i, label in enumerate(labels):
+                col = np.fromfile(os.path.join(type_dir, label + '.bin'),
+                                  dtype=column_types[label])
+                raw = [r[2][i] for r in expected]
+                if data_types[i].startswith('s'):
+                    raw = [v - 2**32 if v >= 2**31 else v for v in raw]
+                self.assertEqual(col.tolist(), raw)
+
+    def test_stats(self):
+        records = synthetic_trace(5000, seed=2)
+        pairs = [('req', 'rsp')]
+        expected = reference_durations(records, [(4, 5)])
+
+        for chunk_size in (5, 64, 2**20):
+            summary = self.decode(records, chunk_size,
+                                  pairs=[':'.join(p) for p in pairs])
+            events = summary['events']
+
+            found = set()
+            for name, metrics in events.items():
+                for metric, s in metrics.items():
+                    found.add((name, metric))
+                    values = expected[(name, metric)]
+                    self.assertEqual(s['count'], len(values))
+                    self.assertAlmostEqual(s['min_ms'],
+                                           min(values) * MS_PER_TICK)
+                    self.assertAlmostEqual(s['max_ms'],
+                                           max(values) * MS_PER_TICK)
+                    self.assertAlmostEqual(
+                        s['mean_ms'],
+                        sum(values) / len(values) * MS_PER_TICK)
+            self.assertEqual(found, set(expected))
+
+    def test_timestamp_wrap(self):
+        records = [(3, 2**32 - 2, []), (3, 2**32 + 1, []),
+                   (3, 2**32 + 2**31 + 10, []), (3, 2 * 2**32 + 3, [])]
+        summary = self.decode(records, chunk_size=3)
+        interval = summary['events']['ping']['interval']
+        self.assertEqual(interval['count'], 3)
+        self.assertAlmostEqual(interval['min_ms'], 3 * MS_PER_TICK)
+        self.assertAlmostEqual(interval['mean_ms'],
+                               (2**32 + 5) / 3 * MS_PER_TICK)
+
+    def test_incomplete_record(self):
+        records = synthetic_trace(100, seed=3)
+        decoder = trace_decoder.TraceDecoder(self.event_types, 16,
+                                             trace_decoder.logging.CRITICAL)
+        decoded = []
+        decoder.decode(io.BytesIO(encode(records)[:-1]),
+                       lambda res: decoded.extend(res[0].tolist()))
+        self.assertEqual(decoded, [r[0] for r in records[:-1]])
+
+    def test_unknown_type(self):
+        data = encode([(3, 0, []), (4, 1, [7])]) + b'\x09' + bytes(8)
+        decoder = trace_decoder.TraceDecoder(self.event_types, 1024)
+        with self.assertRaisesRegex(ValueError, 'ID 9 at byte 14'):
+            decoder.decode(io.BytesIO(data), lambda res: None)
+
+    def test_orphans(self):
+        pending_max = trace_decoder.PENDING_MAX
+        trace_decoder.PENDING_MAX = 4
+        try:
+            # Ten requests are never answered, one is sent twice.
+            records = [(4, i, [i]) for i in range(10)]
+            records += [(4, 10, [9]), (5, 11, [9]), (5, 12, [0])]
+            summary = self.decode(records, chunk_size=9,
+                                  pairs=['req:rsp'])
+        finally:
+            trace_decoder.PENDING_MAX = pending_max
+
+        self.assertEqual(summary['orphans']['req:rsp'], 7)
+        duration = summary['events']['req:rsp']['duration']
+        self.assertEqual(duration['count'], 1)
+        self.assertAlmostEqual(duration['max_ms'], MS_PER_TICK)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,730 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from events import EventType
+from rtt_nordic_config import RttNordicConfig
+import numpy as np
+import argparse
+import logging
+import json
+import math
+import os
+import sys
+
+
+EVENT_PROCESSING_START = 'event_processing_start'
+EVENT_PROCESSING_END = 'event_processing_end'
+
+TIMESTAMP_SIZE = 4
+ARG_SIZE = 4
+TIMESTAMP_RAW_MAX = RttNordicConfig['timestamp_raw_max']
+
+# Relative accuracy of percentiles reported by LatencyHistogram.
+HISTOGRAM_ACCURACY = 0.01
+# Durations above 2^48 ticks do not fit in the histogram.
+HISTOGRAM_MAX_TICKS = 2**48
+
+PERCENTILES = (50, 90, 99, 99.9)
+
+# Maximum number of unmatched start events kept per matched metric.
+PENDING_MAX = 2**16
+# Record boundaries are followed in strides of 2^SPLIT_STRIDE_LOG2 records.
+SPLIT_STRIDE_LOG2 = 3
+
+
+def percentile_key(p):
+    return 'p{:g}_ms'.format(p)
+
+
+def read_event_types(filename):
+    """Parse event descriptions as sent over the profiler info channel.
+
+    Every line is formatted as: name,id,type1,...,typeN,label1,...,labelN.
+    An empty line ends the description.
+    """
+    event_types = dict()
+    with open(filename, 'r') as rd:
+        for line in rd:
+            desc = line.rstrip('\r\n')
+            if len(desc) == 0:
+                break
+
+            desc_fields = desc.split(',')
+            arg_cnt = (len(desc_fields) - 2) // 2
+            event_types[int(desc_fields[1])] = EventType(
+                desc_fields[0],
+                desc_fields[2:2 + arg_cnt],
+                desc_fields[2 + arg_cnt:])
+    return event_types
+
+
+class LatencyHistogram():
+    """Log-linear histogram with bounded memory usage.
+
+    Values are stored in buckets whose width grows with the value, so every
+    percentile is reported with a relative error below HISTOGRAM_ACCURACY
+    regardless of the number of samples.
+    """
+
+    GROWTH = math.log1p(2 * HISTOGRAM_ACCURACY)
+    BUCKET_CNT = int(math.log(HISTOGRAM_MAX_TICKS) / GROWTH) + 2
+
+    def __init__(self):
+        self.buckets = np.zeros(self.BUCKET_CNT, dtype=np.uint64)
+        self.cnt = 0
+        self.min = None
+        self.max = None
+        self.sum = 0
+
+    @classmethod
+    def _bucket_idx(cls, values):
+        # Bucket 0 holds zero durations.
+        idx = np.zeros(len(values), dtype=np.int64)
+        nonzero = values > 0
+        idx[nonzero] = np.log(values[nonzero]) // cls.GROWTH + 1
+        return np.minimum(idx, cls.BUCKET_CNT - 1)
+
+    @classmethod
+    def _bucket_value(cls, idx):
+        if idx == 0:
+            return 0
+        # Geometric middle of the bucket.
+        return math.exp((idx - 0.5) * cls.GROWTH)
+
+    def add(self, values):
+        values = np.asarray(values, dtype=np.float64)
+        if len(values) == 0:
+            return
+
+        self.buckets += np.bincount(self._bucket_idx(values),
+                                    minlength=self.BUCKET_CNT).astype(np.uint64)
+        self.cnt += len(values)
+        self.sum += float(values.sum())
+        vmin = float(values.min())
+        vmax = float(values.max())
+        self.min = vmin if self.min is None else min(self.min, vmin)
+        self.max = vmax if self.max is None else max(self.max, vmax)
+
+    def percentile(self, p):
+        if self.cnt == 0:
+            return None
+        rank = math.ceil(p / 100 * self.cnt)
+        cumsum = np.cumsum(self.buckets)
+        idx = int(np.searchsorted(cumsum, max(rank, 1)))
+        return min(max(self._bucket_value(idx), self.min), self.max)
+
+    def summary(self, ms_per_tick):
+        if self.cnt == 0:
+            return None
+        res = {
+            'count': self.cnt,
+            'min_ms': self.min * ms_per_tick,
+            'max_ms': self.max * ms_per_tick,
+            'mean_ms': self.sum / self.cnt * ms_per_tick,
+        }
+        for p in PERCENTILES:
+            res[percentile_key(p)] = self.percentile(p) * ms_per_tick
+        return res
+
+
+class ColumnWriter():
+    """Write decoded events to one raw little-endian file per column.
+
+    Every event type gets its own directory with a timestamp column (uint64,
+    ticks with overflows unwrapped) and one column per event argument. Columns
+    can be loaded without parsing using numpy.fromfile or numpy.memmap with
+    the data type stored in event_types.json.
+    """
+
+    def __init__(self, out_dir, event_types):
+        self.out_dir = out_dir
+        self.event_types = event_types
+        self.files = dict()
+
+        os.makedirs(out_dir, exist_ok=True)
+
+    def _column_files(self, type_id):
+        if type_id not in self.files:
+            et = self.event_types[type_id]
+            type_dir = os.path.join(self.out_dir, et.name)
+            os.makedirs(type_dir, exist_ok=True)
+
+            files = [open(os.path.join(type_dir, 'timestamp.bin'), 'wb')]
+            for label in et.data_descriptions:
+                files.append(open(os.path.join(type_dir, label + '.bin'),
+                                  'wb'))
+            self.files[type_id] = files
+        return self.files[type_id]
+
+    def write(self, type_id, timestamps, args):
+        files = self._column_files(type_id)
+        timestamps.astype('<u8').tofile(files[0])
+        for i in range(args.shape[1]):
+            np.ascontiguousarray(args[:, i]).tofile(files[i + 1])
+
+    def close(self, ms_per_tick):
+        for files in self.files.values():
+            for f in files:
+                f.close()
+
+        meta = dict()
+        for type_id, et in self.event_types.items():
+            meta[type_id] = et.serialize()
+            meta[type_id]['columns'] = dict(
+                [('timestamp', '<u8')] +
+                [(label, arg_dtype(data_type)) for label, data_type
+                 in zip(et.data_descriptions, et.data_types)])
+        meta['ms_per_timestamp_tick'] = ms_per_tick
+
+        with open(os.path.join(self.out_dir, 'event_types.json'), 'w') as wr:
+            json.dump(meta, wr, indent=4)
+
+
+def arg_dtype(data_type):
+    # Every argument is sent as a 32-bit value.
+    return '<i4' if data_type.startswith('s') else '<u4'
+
+
+class PendingStarts():
+    """Unmatched start events carried over between chunks.
+
+    At most one start is kept per memory address. The number of kept starts
+    is limited to PENDING_MAX; the oldest starts are dropped when the limit is
+    exceeded. Starts that are dropped or overwritten by a later start with the
+    same address are counted as orphans.
+    """
+
+    def __init__(self):
+        self.addr = np.zeros(0, dtype=np.int64)
+        self.ts = np.zeros(0, dtype=np.int64)
+        self.tag = np.zeros(0, dtype=np.int64)
+        self.orphans = 0
+
+    def __len__(self):
+        return len(self.addr)
+
+    def match(self, addr, ts, tag, is_start):
+        """Match every end with the preceding start of the same address.
+
+        All arrays describe start and end events in their order of
+        occurrence. Returns indices of matched ends, tags of the matching
+        starts and the durations.
+        """
+        pending_cnt = len(self.addr)
+        addr = np.concatenate((self.addr, addr))
+        ts = np.concatenate((self.ts, ts))
+        tag = np.concatenate((self.tag, tag))
+        is_start = np.concatenate((np.ones(pending_cnt, dtype=bool), is_start))
+        if len(addr) == 0:
+            return (np.zeros(0, dtype=np.int64), np.zeros(0, dtype=np.int64),
+                    np.zeros(0, dtype=np.int64))
+
+        # Stable sort keeps the order of occurrence within every address.
+        order = np.argsort(addr, kind='stable')
+        addr = addr[order]
+        ts = ts[order]
+        tag = tag[order]
+        is_start = is_start[order]
+
+        same_addr = addr[1:] == addr[:-1]
+        matched = same_addr & is_start[:-1] & ~is_start[1:]
+        end_idx = order[1:][matched] - pending_cnt
+        durations = ts[1:][matched] - ts[:-1][matched]
+        start_tags = tag[:-1][matched]
+
+        # Only the last start of an address may be matched in later chunks.
+        last = np.append(~same_addr, True)
+        keep = is_start & last
+        self.orphans += int(np.count_nonzero(
+            is_start[:-1] & same_addr & is_start[1:]))
+
+        self.addr = addr[keep]
+        self.ts = ts[keep]
+        self.tag = tag[keep]
+        if len(self.addr) > PENDING_MAX:
+            newest = np.sort(np.argsort(self.ts, kind='stable')[-PENDING_MAX:])
+            self.orphans += len(self.addr) - PENDING_MAX
+            self.addr = self.addr[newest]
+            self.ts = self.ts[newest]
+            self.tag = self.tag[newest]
+
+        return end_idx, start_tags, durations
+
+
+class TraceStats():
+    """Statistics calculated in a single pass over the decoded events.
+
+    For every event type, the time between consecutive occurrences is
+    tracked. For Event Manager events, the time from submission to the
+    processing start and the processing time are tracked as well. Custom
+    pairs of event types are matched using their first argument.
+    """
+
+    def __init__(self, event_types, pairs):
+        self.event_types = event_types
+        self.name_to_id = dict((et.name, type_id)
+                               for type_id, et in event_types.items())
+
+        self.interval = dict()
+        self.last_timestamp = dict()
+
+        self.proc_start_id = self.name_to_id.get(EVENT_PROCESSING_START)
+        self.proc_end_id = self.name_to_id.get(EVENT_PROCESSING_END)
+        self.submit_latency = dict()
+        self.proc_time = dict()
+        # Submissions waiting for the processing start.
+        self.submitted = PendingStarts()
+        # Processing starts waiting for the processing end.
+        self.processing = PendingStarts()
+
+        self.pairs = dict()
+        self.pair_starts = dict()
+        for start_name, end_name in pairs:
+            if start_name not in self.name_to_id or \
+               end_name not in self.name_to_id:
+                raise ValueError("Unknown event in pair {}:{}".format(
+                                 start_name, end_name))
+            if start_name == end_name:
+                raise ValueError("Event pair {}:{} must consist of "
+                                 "different events".format(start_name,
+                                                           end_name))
+            start_id = self.name_to_id[start_name]
+            end_id = self.name_to_id[end_name]
+            self.pairs[(start_id, end_id)] = LatencyHistogram()
+            self.pair_starts[(start_id, end_id)] = PendingStarts()
+
+    def _histogram(self, hists, type_id):
+        if type_id not in hists:
+            hists[type_id] = LatencyHistogram()
+        return hists[type_id]
+
+    def _add_grouped(self, hists, tags, values):
+        for tag in np.unique(tags):
+            self._histogram(hists, int(tag)).add(values[tags == tag])
+
+    def update_type(self, type_id, timestamps):
+        """Update statistics with occurrences of a single event type."""
+        if len(timestamps) == 0:
+            return
+
+        intervals = np.diff(timestamps)
+        if type_id in self.last_timestamp:
+            intervals = np.insert(intervals, 0,
+                                  timestamps[0] - self.last_timestamp[type_id])
+        self.last_timestamp[type_id] = timestamps[-1]
+        self._histogram(self.interval, type_id).add(intervals)
+
+    def update_sequence(self, type_ids, timestamps, addresses, with_addr):
+        """Match related events in their order of occurrence.
+
+        Only events with with_addr set carry a memory address.
+        """
+        type_ids = type_ids[with_addr].astype(np.int64)
+        timestamps = timestamps[with_addr]
+        addresses = addresses[with_addr]
+
+        for key, pending in self.pair_starts.items():
+            start_id, end_id = key
+            is_start = type_ids == start_id
+            sel = is_start | (type_ids == end_id)
+            _, _, durations = pending.match(addresses[sel], timestamps[sel],
+                                            type_ids[sel], is_start[sel])
+            self.pairs[key].add(durations)
+
+        if self.proc_start_id is None:
+            return
+
+        is_proc_start = type_ids == self.proc_start_id
+        is_proc_end = type_ids == self.proc_end_id
+        # Any other event with an address may be an Event Manager event
+        # submission. Memory address is reused only after the event is
+        # processed.
+        is_submit = ~is_proc_start & ~is_proc_end
+
+        sel = np.flatnonzero(is_submit | is_proc_start)
+        end_idx, submit_types, latency = self.submitted.match(
+            addresses[sel], timestamps[sel], type_ids[sel], is_submit[sel])
+        self._add_grouped(self.submit_latency, submit_types, latency)
+
+        # Only processing starts matched with a submission are tracked.
+        started = sel[end_idx]
+        is_started = np.zeros(len(type_ids), dtype=bool)
+        is_started[started] = True
+        started_types = np.zeros(len(type_ids), dtype=np.int64)
+        started_types[started] = submit_types
+
+        sel = np.flatnonzero(is_started | is_proc_end)
+        _, proc_types, proc_time = self.processing.match(
+            addresses[sel], timestamps[sel], started_types[sel],
+            is_started[sel])
+        self._add_grouped(self.proc_time, proc_types, proc_time)
+
+    def orphans(self):
+        """Number of start events dropped without a matching end."""
+        res = {
+            'submitted': self.submitted.orphans,
+            'processing': self.processing.orphans,
+        }
+        for (start_id, end_id), pending in self.pair_starts.items():
+            res[self.event_types[start_id].name + ':' +
+                self.event_types[end_id].name] = pending.orphans
+        return res
+
+    def summary(self, ms_per_tick):
+        res = dict()
+
+        def add(name, metric, hist):
+            s = hist.summary(ms_per_tick)
+            if s is not None:
+                res.setdefault(name, dict())[metric] = s
+
+        for type_id, hist in self.interval.items():
+            add(self.event_types[type_id].name, 'interval', hist)
+        for type_id, hist in self.submit_latency.items():
+            add(self.event_types[type_id].name, 'submit_to_start', hist)
+        for type_id, hist in self.proc_time.items():
+            add(self.event_types[type_id].name, 'processing', hist)
+        for (start_id, end_id), hist in self.pairs.items():
+            add(self.event_types[start_id].name + ':' +
+                self.event_types[end_id].name, 'duration', hist)
+
+        return res
+
+
+class TraceDecoder():
+    """Streaming decoder of the Nordic profiler binary protocol.
+
+    Every record consists of a 1-byte event type ID, a 4-byte timestamp and
+    4 bytes per event argument, all little-endian. Data is processed in
+    chunks, so memory usage does not depend on the trace length.
+    """
+
+    def __init__(self, event_types, chunk_size, log_lvl=logging.WARNING):
+        self.event_types = event_types
+        self.chunk_size = chunk_size
+
+        self.record_dtype = dict()
+        self.record_size = np.zeros(256, dtype=np.int64)
+        for type_id, et in event_types.items():
+            fields = [('type_id', 'u1'), ('timestamp', '<u4')]
+            if len(et.data_types) > 0:
+                fields.append(('args', '<u4', (len(et.data_types),)))
+            self.record_dtype[type_id] = np.dtype(fields)
+            self.record_size[type_id] = self.record_dtype[type_id].itemsize
+
+        self.timestamp_overflows = 0
+        self.last_timestamp_raw = None
+        self.record_cnt = 0
+        self.byte_cnt = 0
+
+        self.logger = logging.getLogger('Trace Decoder')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter(
+            '[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+    def _split_records(self, data):
+        """Find offsets and type IDs of all complete records in data.
+
+        Record boundaries form a chain, where every record gives the offset
+        of the next one. The chain is followed in strides of
+        2^SPLIT_STRIDE_LOG2 records and the records in between are filled in
+        with precomputed jump tables.
+        """
+        end = len(data)
+        if end == 0:
+            return np.zeros(0, dtype=np.int64), np.zeros(0, dtype=np.uint8), 0
+
+        # Offset of the record following a record starting at every byte.
+        # Records of unknown type point to themselves.
+        jump = np.empty(end + 1, dtype=np.int32)
+        np.minimum(np.arange(end, dtype=np.int32) +
+                   self.record_size[data].astype(np.int32), end,
+                   out=jump[:end])
+        jump[end] = end
+
+        jumps = [jump]
+        for _ in range(SPLIT_STRIDE_LOG2):
+            jumps.append(jumps[-1][jumps[-1]])
+        stride = jumps.pop()
+
+        stride_starts = []
+        pos = 0
+        while pos != end:
+            stride_starts.append(pos)
+            next_pos = int(stride[pos])
+            if next_pos == pos:
+                break
+            pos = next_pos
+
+        step = np.arange(1 << SPLIT_STRIDE_LOG2)
+        offsets = np.repeat(stride_starts, len(step))
+        step = np.tile(step, len(stride_starts))
+        for level, jump in enumerate(jumps):
+            sel = (step >> level) & 1 == 1
+            offsets[sel] = jump[offsets[sel]]
+
+        # Chain stops at the end of data or at the first unknown record.
+        stop = np.flatnonzero((offsets == end) |
+                              np.append(False, offsets[1:] == offsets[:-1]))
+        if len(stop) > 0:
+            offsets = offsets[:stop[0]]
+
+        type_ids = data[offsets]
+        sizes = self.record_size[type_ids]
+        if len(sizes) > 0 and sizes[-1] == 0:
+            raise ValueError("Unknown event type ID {} at byte {}".format(
+                             type_ids[-1], self.byte_cnt + offsets[-1]))
+
+        record_ends = offsets + sizes
+        if len(offsets) > 0 and record_ends[-1] > end:
+            offsets = offsets[:-1]
+            type_ids = type_ids[:-1]
+            record_ends = record_ends[:-1]
+
+        consumed = int(record_ends[-1]) if len(offsets) > 0 else 0
+        return offsets, type_ids, consumed
+
+    def _unwrap_timestamps(self, raw):
+        """Convert 32-bit timestamps to monotonic 64-bit values.
+
+        Timestamps of consecutive records can only go backwards on overflow.
+        """
+        raw = raw.astype(np.int64)
+        prev = np.empty_like(raw)
+        prev[1:] = raw[:-1]
+        prev[0] = raw[0] if self.last_timestamp_raw is None \
+            else self.last_timestamp_raw
+
+        wraps = np.cumsum(prev - raw > TIMESTAMP_RAW_MAX // 2)
+        res = raw + (wraps + self.timestamp_overflows) * TIMESTAMP_RAW_MAX
+
+        self.timestamp_overflows += int(wraps[-1])
+        self.last_timestamp_raw = int(raw[-1])
+        return res
+
+    def _records(self, data, offsets, type_id):
+        """Load records of a single event type as a structured array."""
+        dtype = self.record_dtype[type_id]
+        idx = offsets[:, None] + np.arange(dtype.itemsize)
+        return np.frombuffer(data[idx], dtype=dtype)
+
+    def _decode_chunk(self, buf):
+        data = np.frombuffer(buf, dtype=np.uint8)
+        offsets, type_ids, consumed = self._split_records(data)
+        if len(offsets) == 0:
+            return None, consumed
+
+        records = dict()
+        raw_timestamps = np.empty(len(offsets), dtype=np.uint32)
+        first_args = np.zeros(len(offsets), dtype=np.uint32)
+        for type_id in np.unique(type_ids):
+            type_id = int(type_id)
+            mask = type_ids == type_id
+            rec = self._records(data, offsets[mask], type_id)
+            raw_timestamps[mask] = rec['timestamp']
+            if 'args' in rec.dtype.names:
+                first_args[mask] = rec['args'][:, 0]
+            records[type_id] = (mask, rec)
+
+        timestamps = self._unwrap_timestamps(raw_timestamps)
+
+        decoded = dict()
+        for type_id, (mask, rec) in records.items():
+            # Arguments are kept as raw 32-bit words. Signed arguments are
+            # reinterpreted when the columns are loaded.
+            if 'args' in rec.dtype.names:
+                args = rec['args']
+            else:
+                args = np.zeros((len(rec), 0), dtype=np.uint32)
+            decoded[type_id] = (timestamps[mask], args)
+
+        self.record_cnt += len(offsets)
+        return (type_ids, timestamps, first_args, decoded), consumed
+
+    def decode(self, stream, on_chunk):
+        """Decode the stream and call on_chunk for every decoded chunk."""
+        pending = b''
+
+        while True:
+            chunk = stream.read(self.chunk_size)
+            if not chunk:
+                break
+
+            buf = pending + chunk
+            res, consumed = self._decode_chunk(buf)
+            self.byte_cnt += consumed
+            pending = buf[consumed:]
+
+            if res is not None:
+                on_chunk(res)
+                self.logger.info("Decoded {} records".format(self.record_cnt))
+
+        if len(pending) > 0:
+            self.logger.warning("Trace ends with incomplete record "
+                                "({} bytes)".format(len(pending)))
+
+
+def decode_trace(args, ms_per_tick, log_lvl):
+    event_types = read_event_types(args.info_file)
+    pairs = [tuple(p.split(':')) for p in args.pair]
+    if any(len(p) != 2 for p in pairs):
+        raise ValueError("Event pair must be formatted as START:END")
+
+    decoder = TraceDecoder(event_types, args.chunk_size, log_lvl)
+    stats = TraceStats(event_types, pairs)
+    columns = ColumnWriter(args.columns, event_types) if args.columns \
+        else None
+
+    # Only events with arguments may carry a memory address.
+    has_address = np.zeros(256, dtype=bool)
+    for type_id, et in event_types.items():
+        has_address[type_id] = len(et.data_types) > 0
+
+    def on_chunk(res):
+        type_ids, timestamps, first_args, decoded = res
+
+        for type_id, (ts, type_args) in decoded.items():
+            stats.update_type(type_id, ts)
+            if columns is not None:
+                columns.write(type_id, ts, type_args)
+
+        stats.update_sequence(type_ids, timestamps,
+                              first_args.astype(np.int64),
+                              has_address[type_ids])
+
+    if args.data_file == '-':
+        decoder.decode(sys.stdin.buffer, on_chunk)
+    else:
+        with open(args.data_file, 'rb') as rd:
+            decoder.decode(rd, on_chunk)
+
+    if columns is not None:
+        columns.close(ms_per_tick)
+
+    summary = {
+        'records': decoder.record_cnt,
+        'ms_per_timestamp_tick': ms_per_tick,
+        'orphans': stats.orphans(),
+        'events': stats.summary(ms_per_tick),
+    }
+    return summary
+
+
+def print_summary(summary):
+    print("Records: {}".format(summary['records']))
+    for name, cnt in sorted(summary['orphans'].items()):
+        if cnt > 0:
+            print("Unmatched {} events dropped: {}".format(name, cnt))
+    header = "{:<48} {:<16} {:>9}".format("Event", "Metric", "Count")
+    for p in PERCENTILES:
+        header += " {:>10}".format("p{:g}[ms]".format(p))
+    header += " {:>10}".format("max[ms]")
+    print(header)
+
+    for name, metrics in sorted(summary['events'].items()):
+        for metric, s in sorted(metrics.items()):
+            line = "{:<48} {:<16} {:>9}".format(name, metric, s['count'])
+            for p in PERCENTILES:
+                line += " {:>10.3f}".format(s[percentile_key(p)])
+            line += " {:>10.3f}".format(s['max_ms'])
+            print(line)
+
+
+def compare_stats(base, new, threshold, percentiles):
+    """Return list of metrics that regressed by more than threshold [%]."""
+    regressions = []
+
+    for name, metrics in sorted(new['events'].items()):
+        for metric, s in sorted(metrics.items()):
+            base_s = base['events'].get(name, dict()).get(metric)
+            if base_s is None:
+                continue
+
+            for p in percentiles:
+                key = percentile_key(p)
+                if base_s[key] <= 0:
+                    continue
+                change = (s[key] - base_s[key]) / base_s[key] * 100
+                if change > threshold:
+                    regressions.append((name, metric, key, base_s[key],
+                                        s[key], change))
+
+    return regressions
+
+
+def load_summary(filename):
+    with open(filename, 'r') as rd:
+        return json.load(rd)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decoding binary Nordic profiler traces and calculating stats.')
+    parser.add_argument('--log', help='Log level')
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.required = True
+
+    decode_parser = subparsers.add_parser(
+        'decode', help='Decode trace and calculate stats in a single pass')
+    decode_parser.add_argument('data_file',
+                               help='Binary data file (- for stdin)')
+    decode_parser.add_argument('info_file', help='Event descriptions file')
+    decode_parser.add_argument('--columns',
+                               help='Output directory for decoded columns')
+    decode_parser.add_argument('--stats', help='Output json file for stats')
+    decode_parser.add_argument('--pair', action='append', default=[],
+                               help='Pair of events matched by first '
+                                    'argument (START:END)')
+    decode_parser.add_argument('--chunk_size', type=int, default=2**20,
+                               help='Number of bytes processed at once')
+    decode_parser.add_argument('--ms_per_tick', type=float,
+                               default=RttNordicConfig['ms_per_timestamp_tick'],
+                               help='Duration of timestamp tick [ms]')
+
+    compare_parser = subparsers.add_parser(
+        'compare', help='Compare stats of two traces')
+    compare_parser.add_argument('base_stats', help='Stats of reference trace')
+    compare_parser.add_argument('new_stats', help='Stats of compared trace')
+    compare_parser.add_argument('--threshold', type=float, default=10,
+                                help='Allowed increase of percentile [%%]')
+    compare_parser.add_argument('--percentile', type=float, action='append',
+                                help='Compared percentile (default: 50, 99)')
+
+    args = parser.parse_args()
+
+    if args.log is not None:
+        log_lvl_number = int(getattr(logging, args.log.upper(), None))
+    else:
+        log_lvl_number = logging.WARNING
+
+    if args.command == 'decode':
+        summary = decode_trace(args, args.ms_per_tick, log_lvl_number)
+        print_summary(summary)
+        if args.stats:
+            with open(args.stats, 'w') as wr:
+                json.dump(summary, wr, indent=4)
+
+    elif args.command == 'compare':
+        percentiles = args.percentile or [50, 99]
+        unknown = [p for p in percentiles if p not in PERCENTILES]
+        if unknown:
+            parser.error("Percentile must be one of: {}".format(
+                         ", ".join(str(p) for p in PERCENTILES)))
+
+        regressions = compare_stats(load_summary(args.base_stats),
+                                    load_summary(args.new_stats),
+                                    args.threshold, percentiles)
+        for name, metric, key, base_val, new_val, change in regressions:
+            print("{} {} {}: {:.3f}ms -> {:.3f}ms (+{:.1f}%)".format(
+                  name, metric, key, base_val, new_val, change))
+        if regressions:
+            sys.exit(1)
+        print("No regressions found")
+
+if __name__ == "__main__":
+    main()
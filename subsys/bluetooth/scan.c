@@ -18,6 +18,11 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Size of a hash index for the given number of entries. The index is kept
+ * at most half full to keep the probe sequences short.
+ */
+#define INDEX_SIZE(cnt) (2 * (cnt) + 1)
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
@@ -55,6 +60,11 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Indexes of the names in lexicographical order. */
+	uint8_t order[CONFIG_BT_SCAN_NAME_CNT];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -76,6 +86,11 @@ struct bt_scan_short_name_filter {
 		uint8_t min_len;
 	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Indexes of the short names in lexicographical order. */
+	uint8_t order[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Short name filter counter. */
 	uint8_t cnt;
 
@@ -89,6 +104,11 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Hash index of the addresses. */
+	uint16_t index[INDEX_SIZE(CONFIG_BT_SCAN_ADDRESS_CNT)];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +140,11 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Hash index of the UUIDs expanded to 128 bits. */
+	uint16_t index[INDEX_SIZE(CONFIG_BT_SCAN_UUID_CNT)];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -194,6 +219,9 @@ struct bt_scan_filters {
 	 * matched to generate an event.
 	 */
 	bool all_mode;
+
+	/* Number of enabled filter types. */
+	uint8_t enabled_cnt;
 };
 
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
@@ -225,11 +253,57 @@ struct conn_blocklist {
 	/* Array of the blocklist devices. */
 	bt_addr_le_t addr[CONFIG_BT_SCAN_BLOCKLIST_LEN];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Hash index of the blocklist devices. */
+	uint16_t index[INDEX_SIZE(CONFIG_BT_SCAN_BLOCKLIST_LEN)];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Blocklist device count. */
 	uint32_t count;
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+/* Advertising report deduplication cache entry. */
+struct dedup_entry {
+	/* Node in the least recently seen list. */
+	sys_dnode_t lru_node;
+
+	/* Node in the address hash bucket. */
+	sys_snode_t bucket_node;
+
+	/* Advertiser address. */
+	bt_addr_le_t addr;
+
+	/* Hash of the last reported advertising data. */
+	uint32_t ad_hash;
+
+	/* Time of the last report passed to the application in ms. */
+	uint32_t reported;
+
+	/* Scan responses are cached separately from advertising data. */
+	bool scan_rsp;
+};
+
+/* Advertising report deduplication cache. */
+struct dedup_cache {
+	/* Array of the cache entries. */
+	struct dedup_entry entry[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Entries hashed by the advertiser address. */
+	sys_slist_t bucket[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Used entries, the most recently seen first. */
+	sys_dlist_t lru;
+
+	/* Used entry count. */
+	size_t count;
+
+	/* Cache statistics. */
+	struct bt_scan_dedup_stats stats;
+};
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -264,10 +338,142 @@ static struct bt_scan {
 	struct conn_blocklist blocklist;
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Advertising report deduplication cache. */
+	struct dedup_cache dedup;
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 } bt_scan;
 
 static sys_slist_t callback_list;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX || CONFIG_BT_SCAN_DEDUP
+static uint32_t data_hash(const uint8_t *data, size_t len)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static uint32_t addr_hash(const bt_addr_le_t *addr)
+{
+	uint32_t hash = data_hash(addr->a.val, sizeof(addr->a.val));
+
+	return hash ^ addr->type;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX || CONFIG_BT_SCAN_DEDUP */
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+/* Filter hash indexes use open addressing with linear probing. A slot holds
+ * the filter position increased by one, zero marks an empty slot. Filters are
+ * only removed all at once, so there is no need for deleted slot markers.
+ */
+static void index_insert(uint16_t *index, size_t size, uint32_t hash,
+			 size_t pos)
+{
+	size_t slot = hash % size;
+
+	while (index[slot] != 0) {
+		slot = (slot + 1) % size;
+	}
+
+	index[slot] = pos + 1;
+}
+
+static int index_find(const uint16_t *index, size_t size, uint32_t hash,
+		      bool (*match)(size_t pos, const void *key),
+		      const void *key)
+{
+	for (size_t slot = hash % size; index[slot] != 0;
+	     slot = (slot + 1) % size) {
+		size_t pos = index[slot] - 1;
+
+		if (match(pos, key)) {
+			return pos;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static uint32_t uuid_hash(const struct bt_uuid *uuid)
+{
+	/* Base UUID used to expand 16-bit and 32-bit UUIDs, in little-endian. */
+	static const uint8_t uuid_base[BT_SCAN_UUID_128_SIZE] = {
+		0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+		0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	uint8_t val[BT_SCAN_UUID_128_SIZE];
+
+	/* Equal UUIDs of different types must have the same hash. */
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		memcpy(val, uuid_base, sizeof(val));
+		sys_put_le16(BT_UUID_16(uuid)->val, &val[12]);
+		break;
+
+	case BT_UUID_TYPE_32:
+		memcpy(val, uuid_base, sizeof(val));
+		sys_put_le32(BT_UUID_32(uuid)->val, &val[12]);
+		break;
+
+	case BT_UUID_TYPE_128:
+		memcpy(val, BT_UUID_128(uuid)->val, sizeof(val));
+		break;
+
+	default:
+		__ASSERT_NO_MSG(false);
+		return 0;
+	}
+
+	return data_hash(val, sizeof(val));
+}
+
+/* Names are ordered using the same comparison as the name filters, so all
+ * names starting with the advertised name form a continuous range.
+ */
+static void order_insert(uint8_t *order, size_t cnt,
+			 const char *(*name_get)(size_t pos), size_t max_len)
+{
+	const char *name = name_get(cnt);
+	size_t i = cnt;
+
+	while ((i > 0) && (strncmp(name_get(order[i - 1]), name, max_len) > 0)) {
+		order[i] = order[i - 1];
+		i--;
+	}
+
+	order[i] = cnt;
+}
+
+static size_t order_lower_bound(const uint8_t *order, size_t cnt,
+				const char *(*name_get)(size_t pos),
+				const uint8_t *data, uint8_t data_len)
+{
+	size_t low = 0;
+	size_t high = cnt;
+
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+
+		if (strncmp(name_get(order[mid]), (const char *)data,
+			    data_len) < 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 void bt_scan_cb_register(struct bt_scan_cb *cb)
 {
 	if (!cb) {
@@ -327,12 +533,25 @@ static void notify_connecting_error(struct bt_scan_device_info *device_info)
 }
 
 #if CONFIG_BT_SCAN_BLOCKLIST
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static bool blocklist_addr_match(size_t pos, const void *key)
+{
+	return bt_addr_le_cmp(&bt_scan.blocklist.addr[pos], key) == 0;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool blocklist_device_check(const bt_addr_le_t *addr)
 {
 	bool blocklist_device = false;
 
 	k_mutex_lock(&scan_mutex, K_FOREVER);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	blocklist_device = index_find(bt_scan.blocklist.index,
+				      ARRAY_SIZE(bt_scan.blocklist.index),
+				      addr_hash(addr), blocklist_addr_match,
+				      addr) >= 0;
+#else
 	for (size_t i = 0; i < bt_scan.blocklist.count; i++) {
 		if (bt_addr_le_cmp(&bt_scan.blocklist.addr[i], addr) == 0) {
 			blocklist_device = true;
@@ -340,6 +559,7 @@ static bool blocklist_device_check(const bt_addr_le_t *addr)
 			break;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	k_mutex_unlock(&scan_mutex);
 
@@ -347,6 +567,127 @@ static bool blocklist_device_check(const bt_addr_le_t *addr)
 }
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+/* Remove all devices from the cache. The statistics are kept. */
+static void dedup_entries_clear(void)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+
+	cache->count = 0;
+	sys_dlist_init(&cache->lru);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->bucket); i++) {
+		sys_slist_init(&cache->bucket[i]);
+	}
+}
+
+static void dedup_reset(void)
+{
+	memset(&bt_scan.dedup.stats, 0, sizeof(bt_scan.dedup.stats));
+	dedup_entries_clear();
+}
+
+static sys_slist_t *dedup_bucket(const bt_addr_le_t *addr)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+
+	return &cache->bucket[addr_hash(addr) % ARRAY_SIZE(cache->bucket)];
+}
+
+static struct dedup_entry *dedup_find(const bt_addr_le_t *addr, bool scan_rsp)
+{
+	struct dedup_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(dedup_bucket(addr), entry, bucket_node) {
+		if ((entry->scan_rsp == scan_rsp) &&
+		    (bt_addr_le_cmp(&entry->addr, addr) == 0)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct dedup_entry *dedup_add(const bt_addr_le_t *addr, bool scan_rsp)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+	struct dedup_entry *entry;
+
+	if (cache->count < ARRAY_SIZE(cache->entry)) {
+		entry = &cache->entry[cache->count];
+		cache->count++;
+	} else {
+		/* Reuse the least recently seen entry. */
+		entry = CONTAINER_OF(sys_dlist_peek_tail(&cache->lru),
+				     struct dedup_entry, lru_node);
+
+		sys_dlist_remove(&entry->lru_node);
+		sys_slist_find_and_remove(dedup_bucket(&entry->addr),
+					  &entry->bucket_node);
+		cache->stats.evicted++;
+	}
+
+	bt_addr_le_copy(&entry->addr, addr);
+	entry->scan_rsp = scan_rsp;
+
+	sys_slist_prepend(dedup_bucket(addr), &entry->bucket_node);
+	sys_dlist_prepend(&cache->lru, &entry->lru_node);
+
+	return entry;
+}
+
+static bool dedup_check(const struct bt_le_scan_recv_info *info,
+			const struct net_buf_simple *ad)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+	bool scan_rsp = (info->adv_props & BT_GAP_ADV_PROP_SCAN_RESPONSE) != 0;
+	uint32_t ad_hash = data_hash(ad->data, ad->len);
+	uint32_t now = k_uptime_get_32();
+	bool duplicate = false;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	struct dedup_entry *entry = dedup_find(info->addr, scan_rsp);
+
+	if (entry) {
+		sys_dlist_remove(&entry->lru_node);
+		sys_dlist_prepend(&cache->lru, &entry->lru_node);
+
+		/* Changed data is reported immediately. */
+		duplicate = (entry->ad_hash == ad_hash) &&
+			    ((now - entry->reported) <
+			     CONFIG_BT_SCAN_DEDUP_INTERVAL);
+	} else {
+		entry = dedup_add(info->addr, scan_rsp);
+	}
+
+	if (duplicate) {
+		cache->stats.hit++;
+	} else {
+		cache->stats.miss++;
+
+		entry->ad_hash = ad_hash;
+		entry->reported = now;
+	}
+
+	k_mutex_unlock(&scan_mutex);
+
+	return duplicate;
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+/* Reports dropped before a change of the filters or a scan restart could
+ * match now, so the next report of every device is passed on.
+ */
+static void dedup_restart(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	dedup_entries_clear();
+	k_mutex_unlock(&scan_mutex);
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 static void attempts_filter_force_add(struct conn_attempts_filter *filter,
 				      const bt_addr_le_t *addr)
@@ -501,11 +842,32 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 	}
 }
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static bool addr_filter_match(size_t pos, const void *key)
+{
+	return bt_addr_le_cmp(&bt_scan.scan_filters.addr.target_addr[pos],
+			      key) == 0;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			     struct bt_scan_control *control)
 {
 	const bt_addr_le_t *addr =
 			bt_scan.scan_filters.addr.target_addr;
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	int pos = index_find(bt_scan.scan_filters.addr.index,
+			     ARRAY_SIZE(bt_scan.scan_filters.addr.index),
+			     addr_hash(target_addr), addr_filter_match,
+			     target_addr);
+
+	if (pos >= 0) {
+		control->filter_status.addr.addr = &addr[pos];
+
+		return true;
+	}
+#else
 	uint8_t counter = bt_scan.scan_filters.addr.cnt;
 
 	for (size_t i = 0; i < counter; i++) {
@@ -515,6 +877,7 @@ static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			return true;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	return false;
 }
@@ -560,6 +923,12 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	index_insert(bt_scan.scan_filters.addr.index,
+		     ARRAY_SIZE(bt_scan.scan_filters.addr.index),
+		     addr_hash(target_addr), counter);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
 
@@ -580,6 +949,13 @@ static bool adv_name_cmp(const uint8_t *data,
 	return strncmp(target_name, data, data_len) == 0;
 }
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static const char *name_get(size_t pos)
+{
+	return bt_scan.scan_filters.name.target_name[pos];
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool adv_name_compare(const struct bt_data *data,
 			     struct bt_scan_control *control)
 {
@@ -588,6 +964,28 @@ static bool adv_name_compare(const struct bt_data *data,
 	uint8_t counter = bt_scan.scan_filters.name.cnt;
 	uint8_t data_len = data->data_len;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	int found = -ENOENT;
+
+	/* Take the first added name out of the matching range. */
+	for (size_t i = order_lower_bound(name_filter->order, counter,
+					  name_get, data->data, data_len);
+	     (i < counter) && adv_name_cmp(data->data, data_len,
+					   name_get(name_filter->order[i]));
+	     i++) {
+		if ((found < 0) || (name_filter->order[i] < found)) {
+			found = name_filter->order[i];
+		}
+	}
+
+	if (found >= 0) {
+		control->filter_status.name.name =
+			name_filter->target_name[found];
+		control->filter_status.name.len = data_len;
+
+		return true;
+	}
+#else
 	/* Compare the name found with the name filter. */
 	for (size_t i = 0; i < counter; i++) {
 		if (adv_name_cmp(data->data,
@@ -601,6 +999,7 @@ static bool adv_name_compare(const struct bt_data *data,
 			return true;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	return false;
 }
@@ -652,6 +1051,11 @@ static int scan_name_filter_add(const char *name)
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	order_insert(bt_scan.scan_filters.name.order, counter, name_get,
+		     CONFIG_BT_SCAN_NAME_MAX_LEN);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", name);
@@ -672,6 +1076,13 @@ static bool adv_short_name_cmp(const uint8_t *data,
 	return false;
 }
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static const char *short_name_get(size_t pos)
+{
+	return bt_scan.scan_filters.short_name.name[pos].target_name;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool adv_short_name_compare(const struct bt_data *data,
 				   struct bt_scan_control *control)
 {
@@ -680,6 +1091,31 @@ static bool adv_short_name_compare(const struct bt_data *data,
 	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
 	uint8_t data_len = data->data_len;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	int found = -ENOENT;
+
+	/* Take the first added name out of the matching range. */
+	for (size_t i = order_lower_bound(name_filter->order, counter,
+					  short_name_get, data->data, data_len);
+	     (i < counter) && adv_name_cmp(data->data, data_len,
+					   short_name_get(name_filter->order[i]));
+	     i++) {
+		size_t pos = name_filter->order[i];
+
+		if ((data_len >= name_filter->name[pos].min_len) &&
+		    ((found < 0) || ((int)pos < found))) {
+			found = pos;
+		}
+	}
+
+	if (found >= 0) {
+		control->filter_status.short_name.name =
+			name_filter->name[found].target_name;
+		control->filter_status.short_name.len = data_len;
+
+		return true;
+	}
+#else
 	/* Compare the name found with the name filters. */
 	for (size_t i = 0; i < counter; i++) {
 		if (adv_short_name_cmp(data->data,
@@ -694,6 +1130,7 @@ static bool adv_short_name_compare(const struct bt_data *data,
 			return true;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	return false;
 }
@@ -752,6 +1189,11 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	       short_name->name,
 	       name_len);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	order_insert(short_name_filter->order, counter, short_name_get,
+		     CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.short_name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", short_name->name);
@@ -759,27 +1201,31 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+static uint8_t uuid_len_get(uint8_t uuid_type)
 {
-	uint8_t uuid_len;
-
 	switch (uuid_type) {
 	case BT_UUID_TYPE_16:
-		uuid_len = sizeof(uint16_t);
-		break;
+		return sizeof(uint16_t);
 
 	case BT_UUID_TYPE_32:
-		uuid_len = sizeof(uint32_t);
-		break;
+		return sizeof(uint32_t);
 
 	case BT_UUID_TYPE_128:
-		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
-		break;
+		return BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
 
 	default:
+		return 0;
+	}
+}
+
+static bool find_uuid(const uint8_t *data,
+		      uint8_t data_len,
+		      uint8_t uuid_type,
+		      const struct bt_scan_uuid *target_uuid)
+{
+	uint8_t uuid_len = uuid_len_get(uuid_type);
+
+	if (uuid_len == 0) {
 		return false;
 	}
 
@@ -798,6 +1244,57 @@ static bool find_uuid(const uint8_t *data,
 	return false;
 }
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static bool uuid_filter_match(size_t pos, const void *key)
+{
+	return bt_uuid_cmp(bt_scan.scan_filters.uuid.uuid[pos].uuid, key) == 0;
+}
+
+static bool adv_uuid_index_compare(const struct bt_data *data,
+				   uint8_t uuid_type,
+				   struct bt_scan_control *control)
+{
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	uint8_t uuid_len = uuid_len_get(uuid_type);
+	int match_pos = -ENOENT;
+
+	if (uuid_len == 0) {
+		return false;
+	}
+
+	/* Look up every advertised UUID instead of searching the advertising
+	 * data for every filter. As without the index, the first added filter
+	 * among the matching ones is reported.
+	 */
+	for (size_t i = 0; i + uuid_len <= data->data_len; i += uuid_len) {
+		struct bt_uuid_128 uuid;
+
+		if (!bt_uuid_create(&uuid.uuid, &data->data[i], uuid_len)) {
+			break;
+		}
+
+		int pos = index_find(uuid_filter->index,
+				     ARRAY_SIZE(uuid_filter->index),
+				     uuid_hash(&uuid.uuid), uuid_filter_match,
+				     &uuid.uuid);
+
+		if (pos >= 0 && (match_pos < 0 || pos < match_pos)) {
+			match_pos = pos;
+		}
+	}
+
+	if (match_pos < 0) {
+		return false;
+	}
+
+	control->filter_status.uuid.uuid[0] = uuid_filter->uuid[match_pos].uuid;
+	control->filter_status.uuid.count = 1;
+
+	return true;
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 			     struct bt_scan_control *control)
 {
@@ -808,6 +1305,13 @@ static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 	uint8_t data_len = data->data_len;
 	uint8_t uuid_match_cnt = 0;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* In the multifilter mode, every filter must be searched anyway. */
+	if (!all_filters_mode) {
+		return adv_uuid_index_compare(data, uuid_type, control);
+	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	for (size_t i = 0; i < counter; i++) {
 
 		if (find_uuid(data->data, data_len, uuid_type,
@@ -912,6 +1416,12 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	index_insert(bt_scan.scan_filters.uuid.index,
+		     ARRAY_SIZE(bt_scan.scan_filters.uuid.index),
+		     uuid_hash(uuid), counter);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -1206,6 +1716,10 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 
 	k_mutex_unlock(&scan_mutex);
 
+	if (!err) {
+		dedup_restart();
+	}
+
 	return err;
 }
 
@@ -1229,6 +1743,11 @@ void bt_scan_filter_remove_all(void)
 			&bt_scan.scan_filters.uuid;
 	uuid_filter->cnt = 0;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	memset(addr_filter->index, 0, sizeof(addr_filter->index));
+	memset(uuid_filter->index, 0, sizeof(uuid_filter->index));
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	struct bt_scan_appearance_filter *appearance_filter =
 			&bt_scan.scan_filters.appearance;
 	appearance_filter->cnt = 0;
@@ -1240,6 +1759,37 @@ void bt_scan_filter_remove_all(void)
 	k_mutex_unlock(&scan_mutex);
 }
 
+static uint8_t enabled_filters_count(void)
+{
+	uint8_t filter_cnt = 0;
+
+	if (is_addr_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_name_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_short_name_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_uuid_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_appearance_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_manufacturer_data_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	return filter_cnt;
+}
+
 void bt_scan_filter_disable(void)
 {
 	/* Disable all filters. */
@@ -1249,6 +1799,8 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+
+	bt_scan.scan_filters.enabled_cnt = 0;
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1291,6 +1843,11 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	/* Count the enabled filters once instead of on every report. */
+	filters->enabled_cnt = enabled_filters_count();
+
+	dedup_restart();
+
 	return 0;
 }
 
@@ -1362,6 +1919,10 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 	bt_conn_cb_register(&conn_callbacks);
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DEDUP
+	dedup_reset();
+#endif /* CONFIG_BT_SCAN_DEDUP */
 }
 
 void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
@@ -1369,35 +1930,6 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
-{
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
-}
-
 static bool adv_data_found(struct bt_data *data, void *user_data)
 {
 	struct bt_scan_control *scan_control =
@@ -1483,11 +2015,18 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	struct bt_scan_control scan_control;
 	struct net_buf_simple_state state;
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Drop repeated reports before any filtering is done. */
+	if (dedup_check(info, ad)) {
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	memset(&scan_control, 0, sizeof(scan_control));
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
 
-	check_enabled_filters(&scan_control);
+	scan_control.filter_cnt = bt_scan.scan_filters.enabled_cnt;
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
@@ -1533,6 +2072,8 @@ int bt_scan_start(enum bt_scan_type scan_type)
 		return -EINVAL;
 	}
 
+	dedup_restart();
+
 	/* Start the scanning. */
 	int err = bt_le_scan_start(&bt_scan.scan_param, NULL);
 
@@ -1590,6 +2131,11 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr)
 	} else {
 		bt_addr_le_copy(&bt_scan.blocklist.addr[bt_scan.blocklist.count],
 				addr);
+#if CONFIG_BT_SCAN_FILTER_INDEX
+		index_insert(bt_scan.blocklist.index,
+			     ARRAY_SIZE(bt_scan.blocklist.index),
+			     addr_hash(addr), bt_scan.blocklist.count);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 		bt_scan.blocklist.count++;
 		LOG_INF("Device %s added to the scanning blocklist",
 			log_strdup(addr_str));
@@ -1617,3 +2163,25 @@ void bt_scan_conn_attempts_filter_clear(void)
 	k_mutex_unlock(&scan_mutex);
 }
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DEDUP
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	*stats = bt_scan.dedup.stats;
+	k_mutex_unlock(&scan_mutex);
+
+	return 0;
+}
+
+void bt_scan_dedup_clear(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	dedup_reset();
+	k_mutex_unlock(&scan_mutex);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
@@ -45,6 +45,12 @@ static struct k_work_delayable matrix_scan;
 static struct k_work_delayable button_pressed;
 static enum state state;
 
+/* Time of the interrupt that started scanning. Used as the timestamp of the
+ * button events until the first state change is reported.
+ */
+static uint32_t irq_timestamp;
+static bool irq_timestamp_valid;
+
 
 static void scan_fn(struct k_work *work);
 
@@ -221,6 +227,9 @@ static void scan_fn(struct k_work *work)
 	__ASSERT_NO_MSG((state == STATE_SCANNING) ||
 			(state == STATE_SUSPENDING));
 
+	uint32_t timestamp = (irq_timestamp_valid) ? (irq_timestamp) :
+						     (k_cycle_get_32());
+
 	/* Get current state */
 	uint32_t raw_state[COLUMNS];
 	memset(raw_state, 0, sizeof(raw_state));
@@ -290,9 +299,11 @@ static void scan_fn(struct k_work *work)
 
 				event->key_id = KEY_ID(i, j);
 				event->pressed = is_pressed;
+				event->timestamp = timestamp;
 				EVENT_SUBMIT(event);
 
 				evt_limit++;
+				irq_timestamp_valid = false;
 
 				WRITE_BIT(settled_state[i], j, is_pressed);
 			}
@@ -312,6 +323,8 @@ static void scan_fn(struct k_work *work)
 
 		int err = 0;
 
+		irq_timestamp_valid = false;
+
 		/* Enable callbacks and switch state, then set pins */
 		switch (state) {
 		case STATE_SCANNING:
@@ -357,6 +370,9 @@ static void button_pressed_isr(const struct device *gpio_dev,
 {
 	int err = 0;
 
+	irq_timestamp = k_cycle_get_32();
+	irq_timestamp_valid = true;
+
 	/* Scanning will be scheduled, switch off pins */
 	if (set_cols(0x00000000)) {
 		LOG_ERR("Cannot control pins");
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr.h>
+#include <string.h>
 #include <logging/log.h>
 #include <storage/stream_flash.h>
 #include <stdio.h>
@@ -25,14 +26,16 @@ static const char *current_id;
 
 static char current_name_key[32];
 
+/* The progress that was last stored */
+static size_t stored_progress;
+
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
  */
-static int store_progress(void)
+static int store_progress(size_t bytes_written)
 {
 	int err;
-	size_t bytes_written = stream_flash_bytes_written(&stream);
 
 	err = settings_save_one(current_name_key, &bytes_written,
 				sizeof(bytes_written));
@@ -42,9 +45,52 @@ static int store_progress(void)
 		return err;
 	}
 
+	stored_progress = bytes_written;
+
 	return 0;
 }
 
+/**
+ * @brief Store the progress when the stream has moved on to a new flash page.
+ *
+ * Storing the progress after every write causes a settings write for each
+ * downloaded fragment. Instead, the start of the page that is being written is
+ * stored once, when writing to that page begins. The page is erased again if
+ * the stream is resumed from its start, so data written to it after the
+ * progress was stored is not a problem.
+ */
+static int checkpoint_progress(void)
+{
+	int err;
+	struct flash_pages_info page;
+	size_t bytes_written = stream_flash_bytes_written(&stream);
+	size_t page_progress;
+
+	if (bytes_written >= stream.available) {
+		return 0;
+	}
+
+	err = flash_get_page_info_by_offs(stream.fdev,
+					  stream.offset + bytes_written,
+					  &page);
+	if (err != 0) {
+		LOG_ERR("Error %d while getting page info", err);
+		return err;
+	}
+
+	if (page.start_offset > stream.offset) {
+		page_progress = page.start_offset - stream.offset;
+	} else {
+		page_progress = 0;
+	}
+
+	if (page_progress == stored_progress) {
+		return 0;
+	}
+
+	return store_progress(page_progress);
+}
+
 /**
  * @brief Function used by settings_load() to restore the stream_flash ctx.
  *	  See the Zephyr documentation of the settings subsystem for more
@@ -76,15 +122,135 @@ static int settings_set(const char *key, size_t len_rd,
 		}
 
 		/* Update the last erased page to avoid deleting already
-		 * written data.
+		 * written data. Progress stored at the start of a page may
+		 * have been followed by writes to that page, so it is erased
+		 * again.
 		 */
-		stream.last_erased_page_start_offset = page.start_offset;
+		if (stream.bytes_written == 0 ||
+		    absolute_offset == page.start_offset) {
+			stream.last_erased_page_start_offset = -1;
+		} else {
+			stream.last_erased_page_start_offset =
+				page.start_offset;
+		}
+
+		stored_progress = stream.bytes_written;
 	}
 
 	return 0;
 }
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+static int stream_write(const uint8_t *buf, size_t len)
+{
+	int err = stream_flash_buffered_write(&stream, buf, len, false);
+
+	if (err != 0) {
+		LOG_ERR("stream_flash_buffered_write error %d", err);
+		return err;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	int progress_err = checkpoint_progress();
+
+	if (progress_err != 0) {
+		/* Failing to store progress is not a critical error you'll just
+		 * be left to download a bit more if you fail and resume.
+		 */
+		LOG_WRN("Unable to store write progress: %d", progress_err);
+	}
+#endif
+
+	return 0;
+}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+
+#define ASYNC_BUF_SIZE CONFIG_DFU_TARGET_STREAM_ASYNC_BUF_SIZE
+
+/* Data is collected in one buffer while the flash writer thread writes the
+ * other one, so that the download is not stalled by flash erase and write.
+ */
+static uint8_t async_buf[2][ASYNC_BUF_SIZE];
+static size_t async_len[2];
+static int fill_idx;
+/* First write error of the writer thread, read by the caller at any time. */
+static atomic_t async_err;
+
+K_MSGQ_DEFINE(write_queue, sizeof(int), 2, 4);
+
+/* Number of free buffers, not counting the one being filled. The writer can
+ * finish a buffer before the next one is taken, so the count can reach two.
+ */
+K_SEM_DEFINE(buf_free, 1, 2);
+
+static void flash_writer_thread(void)
+{
+	int idx;
+	int err;
+
+	while (true) {
+		k_msgq_get(&write_queue, &idx, K_FOREVER);
+
+		if (atomic_get(&async_err) == 0) {
+			err = stream_write(async_buf[idx], async_len[idx]);
+			if (err != 0) {
+				atomic_set(&async_err, err);
+			}
+		}
+
+		k_sem_give(&buf_free);
+	}
+}
+
+K_THREAD_DEFINE(dfu_target_stream_writer,
+		CONFIG_DFU_TARGET_STREAM_ASYNC_STACK_SIZE,
+		flash_writer_thread, NULL, NULL, NULL,
+		CONFIG_DFU_TARGET_STREAM_ASYNC_THREAD_PRIORITY, 0, 0);
+
+static void async_submit(void)
+{
+	(void)k_msgq_put(&write_queue, &fill_idx, K_FOREVER);
+
+	/* Wait for the writer to be done with the other buffer */
+	k_sem_take(&buf_free, K_FOREVER);
+
+	fill_idx ^= 1;
+	async_len[fill_idx] = 0;
+}
+
+static int async_flush(void)
+{
+	if (async_len[fill_idx] > 0) {
+		async_submit();
+	}
+
+	/* The other buffer is free when the writer is idle */
+	k_sem_take(&buf_free, K_FOREVER);
+	k_sem_give(&buf_free);
+
+	return atomic_get(&async_err);
+}
+
+static int async_write(const uint8_t *buf, size_t len)
+{
+	while (len > 0 && atomic_get(&async_err) == 0) {
+		size_t chunk = MIN(len, ASYNC_BUF_SIZE - async_len[fill_idx]);
+
+		memcpy(&async_buf[fill_idx][async_len[fill_idx]], buf, chunk);
+		async_len[fill_idx] += chunk;
+		buf += chunk;
+		len -= chunk;
+
+		if (async_len[fill_idx] == ASYNC_BUF_SIZE) {
+			async_submit();
+		}
+	}
+
+	return atomic_get(&async_err);
+}
+#endif /* CONFIG_DFU_TARGET_STREAM_ASYNC */
+
 struct stream_flash_ctx *dfu_target_stream_get_stream(void)
 {
 	return &stream;
@@ -112,7 +278,14 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	async_len[fill_idx] = 0;
+	atomic_set(&async_err, 0);
+#endif
+
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	stored_progress = 0;
+
 	err = snprintf(current_name_key, sizeof(current_name_key), "%s/%s",
 		       MODULE, current_id);
 	if (err < 0 || err >= sizeof(current_name_key)) {
@@ -150,6 +323,13 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 
 int dfu_target_stream_offset_get(size_t *out)
 {
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	/* Write the data received so far, so that the offset includes it.
+	 * Errors are returned by the next write.
+	 */
+	(void)async_flush();
+#endif
+
 	*out = stream_flash_bytes_written(&stream);
 
 	return 0;
@@ -157,30 +337,30 @@ int dfu_target_stream_offset_get(size_t *out)
 
 int dfu_target_stream_write(const uint8_t *buf, size_t len)
 {
-	int err = stream_flash_buffered_write(&stream, buf, len, false);
-
-	if (err != 0) {
-		LOG_ERR("stream_flash_buffered_write error %d", err);
-		return err;
-	}
-
-#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
-	if (err != 0) {
-		/* Failing to store progress is not a critical error you'll just
-		 * be left to download a bit more if you fail and resume.
-		 */
-		LOG_WRN("Unable to store write progress: %d", err);
-	}
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	return async_write(buf, len);
+#else
+	return stream_write(buf, len);
 #endif
-
-	return err;
 }
 
 int dfu_target_stream_done(bool successful)
 {
 	int err = 0;
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	/* Write what has been received, also when the stream is not complete,
+	 * so that the stored progress includes it.
+	 */
+	int flush_err = async_flush();
+
+	if (flush_err != 0) {
+		LOG_ERR("Flash writer error %d", flush_err);
+		/* The stream can not be completed, keep the progress */
+		successful = false;
+	}
+#endif
+
 	if (successful) {
 		err = stream_flash_buffered_write(&stream, NULL, 0, true);
 		if (err != 0) {
@@ -199,7 +379,7 @@ int dfu_target_stream_done(bool successful)
 		/* The stream has not completed, store the progress so that
 		 * a new call to 'init' will pick up where we left off.
 		 */
-		err = store_progress();
+		err = store_progress(stream_flash_bytes_written(&stream));
 		if (err != 0) {
 			LOG_ERR("Unable to reset write progress: %d", err);
 		}
@@ -208,5 +388,11 @@ int dfu_target_stream_done(bool successful)
 
 	current_id = NULL;
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	if (flush_err != 0) {
+		return flush_err;
+	}
+#endif
+
 	return err;
 }
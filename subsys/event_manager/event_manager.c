@@ -11,6 +11,11 @@
 #include <event_manager.h>
 #include <logging/log.h>
 
+#if defined(CONFIG_EVENT_MANAGER_LISTENER_STATS) && \
+    defined(CONFIG_CPU_CORTEX_M_HAS_DWT)
+#include <arch/arm/aarch32/cortex_m/cmsis.h>
+#endif
+
 LOG_MODULE_REGISTER(event_manager, CONFIG_EVENT_MANAGER_LOG_LEVEL);
 
 
@@ -35,11 +40,30 @@ extern uint32_t event_manager_displayed_events;
 static uint32_t event_manager_displayed_events;
 #endif
 
+/* Number of event types is limited by the size of the displayed events
+ * bitmask.
+ */
+#define EVENT_TYPES_MAX (sizeof(event_manager_displayed_events) * 8)
+
 static uint16_t profiler_event_ids[IDS_COUNT];
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
 static struct k_spinlock lock;
 
+/* Listeners of all event types in order of notification. Listeners of
+ * event type with index i are located between dispatch_offsets[i] and
+ * dispatch_offsets[i + 1].
+ */
+static const struct event_listener **dispatch_table;
+static uint16_t dispatch_offsets[EVENT_TYPES_MAX + 1];
+
+/* Queue used by events not assigned to a dedicated queue. The events are
+ * processed by the system workqueue.
+ */
+static struct event_queue default_queue = {
+	.name = "default",
+	.eventq = SYS_SLIST_STATIC_INIT(&default_queue.eventq),
+	.work = Z_WORK_INITIALIZER(event_processor_fn),
+};
+
 
 static bool log_is_event_displayed(const struct event_type *et)
 {
@@ -80,23 +104,26 @@ static void log_event(const struct event_header *eh)
 	}
 }
 
-static void log_event_progress(const struct event_type *et,
+static bool log_is_event_handlers_displayed(const struct event_type *et)
+{
+	return IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENTS) &&
+	       IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENT_HANDLERS) &&
+	       log_is_event_displayed(et);
+}
+
+static void log_event_progress(bool log_handlers,
 			       const struct event_listener *el)
 {
-	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENTS) ||
-	    !IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENT_HANDLERS) ||
-	    !log_is_event_displayed(et)) {
+	if (!log_handlers) {
 		return;
 	}
 
 	LOG_INF("|\tnotifying %s", el->name);
 }
 
-static void log_event_consumed(const struct event_type *et)
+static void log_event_consumed(bool log_handlers)
 {
-	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENTS) ||
-	    !IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENT_HANDLERS) ||
-	    !log_is_event_displayed(et)) {
+	if (!log_handlers) {
 		return;
 	}
 
@@ -228,19 +255,298 @@ static int trace_event_init(void)
 	return 0;
 }
 
+#ifdef CONFIG_EVENT_MANAGER_LISTENER_STATS
+static void listener_stats_init(void)
+{
+#ifdef CONFIG_CPU_CORTEX_M_HAS_DWT
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static inline uint32_t listener_stats_cycles_get(void)
+{
+#ifdef CONFIG_CPU_CORTEX_M_HAS_DWT
+	return DWT->CYCCNT;
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+static void listener_stats_update(const struct event_listener *el,
+				  uint32_t start)
+{
+	uint32_t cycles = listener_stats_cycles_get() - start;
+	struct event_listener_stats *stats = el->stats;
+	int bucket = (cycles ? (31 - __builtin_clz(cycles)) : 0) -
+		     CONFIG_EVENT_MANAGER_LISTENER_STATS_BUCKET_SHIFT;
+
+	bucket = MIN(MAX(bucket, 0), EVENT_LISTENER_STATS_BUCKET_CNT - 1);
+
+	/* The statistics are diagnostic data. Locking is omitted to keep
+	 * the overhead low, so concurrent notifications of the same listener
+	 * from different event queues may be counted inaccurately.
+	 */
+	stats->hist[bucket]++;
+	stats->total += cycles;
+	stats->max = MAX(stats->max, cycles);
+	stats->cnt++;
+}
+#else
+static void listener_stats_init(void)
+{
+}
+
+static inline uint32_t listener_stats_cycles_get(void)
+{
+	return 0;
+}
+
+static void listener_stats_update(const struct event_listener *el,
+				  uint32_t start)
+{
+}
+#endif /* CONFIG_EVENT_MANAGER_LISTENER_STATS */
+
+static void dispatch_table_init(void)
+{
+	size_t event_cnt = __stop_event_types - __start_event_types;
+	size_t subs_cnt = 0;
+
+	if (event_cnt > EVENT_TYPES_MAX) {
+		LOG_WRN("Too many event types for dispatch table");
+		return;
+	}
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX; prio++) {
+			subs_cnt += et->subs_stop[prio] - et->subs_start[prio];
+		}
+	}
+
+	if ((subs_cnt == 0) || (subs_cnt > UINT16_MAX)) {
+		return;
+	}
+
+	const struct event_listener **table =
+		k_malloc(subs_cnt * sizeof(table[0]));
+
+	if (!table) {
+		/* Events are dispatched using subscriber sections. */
+		LOG_WRN("No memory for dispatch table");
+		return;
+	}
+
+	size_t pos = 0;
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		dispatch_offsets[et - __start_event_types] = pos;
+
+		for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX; prio++) {
+			for (const struct event_subscriber *es =
+					et->subs_start[prio];
+			     es != et->subs_stop[prio];
+			     es++) {
+				table[pos++] = es->listener;
+			}
+		}
+	}
+	dispatch_offsets[event_cnt] = pos;
+
+	dispatch_table = table;
+}
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+static struct k_spinlock pool_lock;
+
+static bool is_pool_block(const struct k_mem_slab *slab, const void *ptr)
+{
+	const char *buf_start = slab->buffer;
+	const char *buf_end = buf_start + slab->num_blocks * slab->block_size;
+
+	return ((const char *)ptr >= buf_start) && ((const char *)ptr < buf_end);
+}
+
+void *_event_pool_alloc(const struct event_type *et, size_t size)
+{
+	ASSERT_EVENT_ID(et);
+
+	struct event_pool *pool = et->pool;
+	void *mem = NULL;
+
+	__ASSERT_NO_MSG(pool);
+
+	k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+	if ((size <= pool->slab->block_size) &&
+	    !k_mem_slab_alloc(pool->slab, &mem, K_NO_WAIT)) {
+		uint32_t used = k_mem_slab_num_used_get(pool->slab);
+
+		if (used > pool->max_used) {
+			pool->max_used = used;
+		}
+	} else {
+		pool->heap_alloc_cnt++;
+	}
+
+	k_spin_unlock(&pool_lock, key);
+
+	if (!mem) {
+		mem = k_malloc(size);
+	}
+
+	return mem;
+}
+
+static void event_free(struct event_header *eh)
+{
+	struct event_pool *pool = eh->type_id->pool;
+
+	if (is_pool_block(pool->slab, eh)) {
+		k_mem_slab_free(pool->slab, (void **)&eh);
+	} else {
+		k_free(eh);
+	}
+}
+#else
+static void event_free(struct event_header *eh)
+{
+	k_free(eh);
+}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+static struct event_queue *get_queue(const struct event_type *et)
+{
+	return et->queue ? et->queue : &default_queue;
+}
+
+static void queue_work_submit(struct event_queue *queue)
+{
+	if (queue->work_q) {
+		k_work_submit_to_queue(queue->work_q, &queue->work);
+	} else {
+		k_work_submit(&queue->work);
+	}
+}
+
+static void queue_start(struct event_queue *queue)
+{
+	if (queue->started) {
+		return;
+	}
+
+	struct k_work_queue_config cfg = {
+		.name = queue->name,
+	};
+
+	k_work_init(&queue->work, event_processor_fn);
+	k_work_queue_start(queue->work_q, queue->stack, queue->stack_size,
+			   queue->prio, &cfg);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	queue->started = true;
+
+	/* Process events submitted before the queue was started. */
+	bool pending = !sys_slist_is_empty(&queue->eventq);
+
+	k_spin_unlock(&lock, key);
+
+	if (pending) {
+		queue_work_submit(queue);
+	}
+}
+
+static void queues_init(void)
+{
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		if (et->queue) {
+			queue_start(et->queue);
+		}
+	}
+}
+
+static bool notify_listener(const struct event_listener *el,
+			    const struct event_header *eh,
+			    bool log_handlers)
+{
+	__ASSERT_NO_MSG(el != NULL);
+	__ASSERT_NO_MSG(el->notification != NULL);
+
+	log_event_progress(log_handlers, el);
+
+	uint32_t start = listener_stats_cycles_get();
+	bool consumed = el->notification(eh);
+
+	listener_stats_update(el, start);
+
+	if (consumed) {
+		log_event_consumed(log_handlers);
+	}
+
+	return consumed;
+}
+
+static void notify_listeners(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	bool log_handlers = log_is_event_handlers_displayed(et);
+
+	if (dispatch_table) {
+		size_t event_idx = et - __start_event_types;
+		const struct event_listener **el =
+			&dispatch_table[dispatch_offsets[event_idx]];
+		const struct event_listener **el_end =
+			&dispatch_table[dispatch_offsets[event_idx + 1]];
+
+		while ((el != el_end) &&
+		       !notify_listener(*el, eh, log_handlers)) {
+			el++;
+		}
+
+		return;
+	}
+
+	/* Dispatch table is not initialized. */
+	bool consumed = false;
+
+	for (size_t prio = SUBS_PRIO_MIN;
+	     (prio <= SUBS_PRIO_MAX) && !consumed;
+	     prio++) {
+		for (const struct event_subscriber *es = et->subs_start[prio];
+		     (es != et->subs_stop[prio]) && !consumed;
+		     es++) {
+
+			__ASSERT_NO_MSG(es != NULL);
+
+			consumed = notify_listener(es->listener, eh,
+						   log_handlers);
+		}
+	}
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_queue *queue = CONTAINER_OF(work, struct event_queue,
+						 work);
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	if (sys_slist_is_empty(&queue->eventq)) {
 		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	sys_slist_merge_slist(&events, &queue->eventq);
 
 	k_spin_unlock(&lock, key);
 
@@ -254,42 +560,88 @@ static void event_processor_fn(struct k_work *work)
 
 		ASSERT_EVENT_ID(eh->type_id);
 
-		const struct event_type *et = eh->type_id;
-
 		trace_event_execution(eh, true);
 
 		log_event(eh);
 
-		bool consumed = false;
+		notify_listeners(eh);
 
-		for (size_t prio = SUBS_PRIO_MIN;
-		     (prio <= SUBS_PRIO_MAX) && !consumed;
-		     prio++) {
-			for (const struct event_subscriber *es =
-					et->subs_start[prio];
-			     (es != et->subs_stop[prio]) && !consumed;
-			     es++) {
+		trace_event_execution(eh, false);
+
+		event_free(eh);
+	}
+}
 
-				__ASSERT_NO_MSG(es != NULL);
+/* Merge the event into the last event in the queue if both events are of
+ * the same coalescable type. Must be called with the lock held.
+ *
+ * The merge function runs under the lock, so that the queued event cannot be
+ * taken by the event processor while it is modified. It may be called from
+ * an interrupt, with interrupts locked, and must not block or submit events.
+ */
+static bool event_coalesce(struct event_queue *queue,
+			   const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+
+	if (!et->merge) {
+		return false;
+	}
 
-				const struct event_listener *el = es->listener;
+	sys_snode_t *tail = sys_slist_peek_tail(&queue->eventq);
 
-				__ASSERT_NO_MSG(el != NULL);
-				__ASSERT_NO_MSG(el->notification != NULL);
+	if (!tail) {
+		return false;
+	}
+
+	struct event_header *queued = CONTAINER_OF(tail, struct event_header,
+						   node);
+
+	return (queued->type_id == et) && et->merge(queued, eh);
+}
+
+static void queue_append(struct event_queue *queue, struct event_header **ehs,
+			 size_t cnt)
+{
+	sys_slist_t merged = SYS_SLIST_STATIC_INIT(&merged);
 
-				log_event_progress(et, el);
+	for (size_t i = 0; i < cnt; i++) {
+		if (!ehs[i]->type_id->merge) {
+			trace_event_submission(ehs[i]);
+		}
+	}
 
-				consumed = el->notification(eh);
+	k_spinlock_key_t key = k_spin_lock(&lock);
 
-				if (consumed) {
-					log_event_consumed(et);
-				}
+	for (size_t i = 0; i < cnt; i++) {
+		if (event_coalesce(queue, ehs[i])) {
+			sys_slist_append(&merged, &ehs[i]->node);
+		} else {
+			/* Only coalescable events that are actually queued
+			 * are traced, before the processor can take them.
+			 */
+			if (ehs[i]->type_id->merge) {
+				trace_event_submission(ehs[i]);
 			}
+			sys_slist_append(&queue->eventq, &ehs[i]->node);
 		}
+	}
 
-		trace_event_execution(eh, false);
+	/* Dedicated queue processes events submitted before
+	 * initialization once it is started.
+	 */
+	bool started = !queue->work_q || queue->started;
 
-		k_free(eh);
+	k_spin_unlock(&lock, key);
+
+	sys_snode_t *node;
+
+	while (NULL != (node = sys_slist_get(&merged))) {
+		event_free(CONTAINER_OF(node, struct event_header, node));
+	}
+
+	if (started) {
+		queue_work_submit(queue);
 	}
 }
 
@@ -298,18 +650,42 @@ void _event_submit(struct event_header *eh)
 	__ASSERT_NO_MSG(eh);
 	ASSERT_EVENT_ID(eh->type_id);
 
-	trace_event_submission(eh);
+	queue_append(get_queue(eh->type_id), &eh, 1);
+}
 
-	k_spinlock_key_t key = k_spin_lock(&lock);
-	sys_slist_append(&eventq, &eh->node);
-	k_spin_unlock(&lock, key);
+void _event_submit_batch(struct event_header **ehs, size_t cnt)
+{
+	__ASSERT_NO_MSG(ehs);
+
+	for (size_t i = 0; i < cnt; i++) {
+		__ASSERT_NO_MSG(ehs[i]);
+		ASSERT_EVENT_ID(ehs[i]->type_id);
+	}
+
+	/* Consecutive events processed by the same queue are appended
+	 * under a single lock.
+	 */
+	size_t start = 0;
+
+	while (start < cnt) {
+		struct event_queue *queue = get_queue(ehs[start]->type_id);
+		size_t end = start + 1;
 
-	k_work_submit(&event_processor);
+		while ((end < cnt) && (get_queue(ehs[end]->type_id) == queue)) {
+			end++;
+		}
+
+		queue_append(queue, &ehs[start], end - start);
+		start = end;
+	}
 }
 
 int event_manager_init(void)
 {
+	dispatch_table_init();
 	log_event_init();
+	listener_stats_init();
+	queues_init();
 
 	return trace_event_init();
 }
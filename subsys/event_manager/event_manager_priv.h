@@ -82,6 +82,58 @@ extern "C" {
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+
+/* Name of the memory slab and of the pool descriptor of the given event. */
+#define _EVENT_POOL_SLAB(ename) _CONCAT(__event_pool_slab_, ename)
+#define _EVENT_POOL(ename) _CONCAT(__event_pool_, ename)
+
+/* Size of the single pool block of the given event. */
+#define _EVENT_POOL_BLOCK_SIZE(ename) _CONCAT(__event_pool_block_size_, ename)
+
+
+/* Declare the pool block size. Events with dynamic data reserve additional
+ * space for the data in every block. Larger events are allocated from heap.
+ */
+#define _EVENT_POOL_DECLARE(ename, dyndata_size)				\
+	enum {									\
+		_EVENT_POOL_BLOCK_SIZE(ename) =					\
+			ROUND_UP(sizeof(struct ename) + (dyndata_size),		\
+				 MAX(__alignof__(struct ename), sizeof(void *)))\
+	}
+
+
+/* Additional macro level is needed as K_MEM_SLAB_DEFINE concatenates
+ * the slab name.
+ */
+#define _EVENT_POOL_SLAB_DEFINE(sname, block_size, block_cnt)	\
+	K_MEM_SLAB_DEFINE(sname, block_size, block_cnt, sizeof(void *))
+
+
+/* Define the memory slab and the pool descriptor of the given event. */
+#define _EVENT_POOL_DEFINE(ename)						\
+	_EVENT_POOL_SLAB_DEFINE(_EVENT_POOL_SLAB(ename),			\
+				_EVENT_POOL_BLOCK_SIZE(ename),			\
+				CONFIG_EVENT_MANAGER_EVENT_POOL_BLOCK_COUNT);	\
+	static struct event_pool _EVENT_POOL(ename) = {				\
+		.slab = &_EVENT_POOL_SLAB(ename),				\
+	}
+
+#define _EVENT_POOL_INIT(ename) .pool = &_EVENT_POOL(ename),
+
+#define _EVENT_ALLOC(ename, size) _event_pool_alloc(_EVENT_ID(ename), (size))
+
+#else
+
+#define _EVENT_POOL_DECLARE(ename, dyndata_size)
+#define _EVENT_POOL_DEFINE(ename)
+#define _EVENT_POOL_INIT(ename)
+
+#define _EVENT_ALLOC(ename, size) k_malloc(size)
+
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -89,7 +141,8 @@ extern "C" {
 #define _EVENT_ALLOCATOR_FN(ename)					\
 	static inline struct ename *_CONCAT(new_, ename)(void)		\
 	{								\
-		struct ename *event = (struct ename *)k_malloc(sizeof(*event));\
+		struct ename *event =					\
+			(struct ename *)_EVENT_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,	\
 				 "");					\
 		if (unlikely(!event)) {					\
@@ -111,7 +164,8 @@ extern "C" {
 #define _EVENT_ALLOCATOR_DYNDATA_FN(ename)				\
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)	\
 	{								\
-		struct ename *event = (struct ename *)k_malloc(sizeof(*event) + size);\
+		struct ename *event =					\
+			(struct ename *)_EVENT_ALLOC(ename, sizeof(*event) + size);\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +		\
 				  sizeof(event->dyndata.size)) ==	\
 				 sizeof(*event), "");			\
@@ -196,11 +250,28 @@ extern "C" {
 			}
 
 
+#ifdef CONFIG_EVENT_MANAGER_LISTENER_STATS
+#define _EVENT_LISTENER_STATS(lname) _CONCAT(__event_listener_stats_, lname)
+
+#define _EVENT_LISTENER_STATS_DEFINE(lname) \
+	static struct event_listener_stats _EVENT_LISTENER_STATS(lname)
+
+#define _EVENT_LISTENER_STATS_INIT(lname) .stats = &_EVENT_LISTENER_STATS(lname),
+
+#else
+#define _EVENT_LISTENER_STATS_DEFINE(lname)
+#define _EVENT_LISTENER_STATS_INIT(lname)
+
+#endif /* CONFIG_EVENT_MANAGER_LISTENER_STATS */
+
+
 #define _EVENT_LISTENER(lname, notification_fn)					\
+	_EVENT_LISTENER_STATS_DEFINE(lname);					\
 	const struct event_listener _CONCAT(__event_listener_, lname) __used	\
 	__attribute__((__section__("event_listeners"))) = {			\
 		.name = STRINGIFY(lname),					\
 		.notification = (notification_fn),				\
+		_EVENT_LISTENER_STATS_INIT(lname)				\
 	}
 
 
@@ -213,16 +284,43 @@ extern "C" {
 
 #define _EVENT_TYPE_DECLARE(ename)					\
 	_EVENT_TYPE_DECLARE_COMMON(ename);				\
+	_EVENT_POOL_DECLARE(ename, 0);					\
 	_EVENT_ALLOCATOR_FN(ename)
 
 
 #define _EVENT_TYPE_DYNDATA_DECLARE(ename)				\
 	_EVENT_TYPE_DECLARE_COMMON(ename);				\
+	_EVENT_POOL_DECLARE(ename,					\
+		CONFIG_EVENT_MANAGER_EVENT_POOL_DYNDATA_SIZE);		\
 	_EVENT_ALLOCATOR_DYNDATA_FN(ename)
 
 
-#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)							\
+/* Pointer to event queue object. */
+#define _EVENT_QUEUE(qname) (&_CONCAT(__event_queue_, qname))
+
+
+#define _EVENT_QUEUE_DECLARE(qname)					\
+	extern struct event_queue _CONCAT(__event_queue_, qname)
+
+
+#define _EVENT_QUEUE_DEFINE(qname, thread_prio, stack_sz)			\
+	K_THREAD_STACK_DEFINE(_CONCAT(__event_queue_stack_, qname), stack_sz);	\
+	static struct k_work_q _CONCAT(__event_work_q_, qname);		\
+	struct event_queue _CONCAT(__event_queue_, qname) = {			\
+		.name		= STRINGIFY(qname),				\
+		.work_q		= &_CONCAT(__event_work_q_, qname),		\
+		.stack		= _CONCAT(__event_queue_stack_, qname),		\
+		.stack_size	= K_THREAD_STACK_SIZEOF(			\
+					_CONCAT(__event_queue_stack_, qname)),	\
+		.prio		= (thread_prio),				\
+		.eventq		= SYS_SLIST_STATIC_INIT(			\
+					&_CONCAT(__event_queue_, qname).eventq),\
+	}
+
+
+#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, equeue, merge_fn)				\
 	_EVENT_SUBSCRIBERS_DEFINE(ename);										\
+	_EVENT_POOL_DEFINE(ename);											\
 	const struct event_type _CONCAT(__event_type_, ename) __used							\
 	__attribute__((__section__("event_types"))) = {									\
 		.name				= STRINGIFY(ename),							\
@@ -239,6 +337,9 @@ extern "C" {
 		.init_log_enable		= init_log_en,								\
 		.log_event			= log_fn,								\
 		.ev_info			= ev_info_struct,							\
+		.queue				= equeue,								\
+		.merge				= merge_fn,								\
+		_EVENT_POOL_INIT(ename)											\
 	}
 
 
@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <shell/shell.h>
 #include <event_manager.h>
 
@@ -89,6 +90,88 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+static int show_pools(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Event Pools:\n");
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "|\tblock size\tused\tmax used\tblocks\theap allocs\n");
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+
+		const struct event_pool *pool = et->pool;
+
+		__ASSERT_NO_MSG(pool != NULL);
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t%zu\t\t%u\t%u\t\t%u\t%u\t[E:%s]\n",
+			      pool->slab->block_size,
+			      k_mem_slab_num_used_get(pool->slab),
+			      pool->max_used,
+			      pool->slab->num_blocks,
+			      pool->heap_alloc_cnt,
+			      et->name);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+#ifdef CONFIG_EVENT_MANAGER_LISTENER_STATS
+static int show_listener_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Listener execution time [cycles]:\n");
+
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+
+		__ASSERT_NO_MSG(el != NULL);
+		const struct event_listener_stats *stats = el->stats;
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[L:%s] cnt:%u avg:%u max:%u\n",
+			      el->name, stats->cnt,
+			      stats->cnt ? (uint32_t)(stats->total / stats->cnt) : 0,
+			      stats->max);
+
+		for (size_t i = 0; i < ARRAY_SIZE(stats->hist); i++) {
+			if (!stats->hist[i]) {
+				continue;
+			}
+
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|\t\t< %u:\t%u\n",
+				      (uint32_t)BIT(i + 1 +
+					  CONFIG_EVENT_MANAGER_LISTENER_STATS_BUCKET_SHIFT),
+				      stats->hist[i]);
+		}
+	}
+
+	return 0;
+}
+
+static int reset_listener_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+
+		__ASSERT_NO_MSG(el != NULL);
+		memset(el->stats, 0, sizeof(*el->stats));
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Listener statistics reset\n");
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_LISTENER_STATS */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -168,6 +251,16 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+	SHELL_COND_CMD_ARG(CONFIG_EVENT_MANAGER_EVENT_POOL, show_pools, NULL,
+			   "Show event pool statistics", show_pools, 0, 0),
+	SHELL_COND_CMD_ARG(CONFIG_EVENT_MANAGER_LISTENER_STATS,
+			   show_listener_stats, NULL,
+			   "Show listener execution time statistics",
+			   show_listener_stats, 0, 0),
+	SHELL_COND_CMD_ARG(CONFIG_EVENT_MANAGER_LISTENER_STATS,
+			   reset_listener_stats, NULL,
+			   "Reset listener execution time statistics",
+			   reset_listener_stats, 0, 0),
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(event_manager_displayed_events) * 8 - 1),
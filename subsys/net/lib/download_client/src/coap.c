@@ -4,7 +4,14 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <zephyr.h>
+#if defined(CONFIG_POSIX_API)
+#include <posix/sys/time.h>
+#include <posix/sys/socket.h>
+#else
+#include <net/socket.h>
+#endif
 #include <net/coap.h>
 #include <net/download_client.h>
 #include <logging/log.h>
@@ -14,17 +21,447 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 #define COAP_VER 1
 #define FILENAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE
 
+#define WINDOW CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW
+#define SZX_MAX CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE
+#define SZX_MIN COAP_BLOCK_64
+
+/* Retransmission timeout, in milliseconds (RFC 6298).
+ * The initial value is the CoAP ACK_TIMEOUT (RFC 7252).
+ */
+#define RTO_INIT_MS 2000
+#define RTO_MIN_MS 200
+#define RTO_MAX_MS 32000
+
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len);
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len);
 
 int coap_block_init(struct download_client *client, size_t from)
 {
 	coap_block_transfer_init(&client->coap.block_ctx,
 				 CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE, 0);
 	client->coap.block_ctx.current = from;
+	client->coap.requested = SIZE_MAX;
+	client->coap.srtt_ms = 0;
+	client->coap.rttvar_ms = 0;
+	client->coap.rto_ms = RTO_INIT_MS;
+	client->stats.block_size = coap_block_size_to_bytes(SZX_MAX);
+
+#if WINDOW > 1
+	client->coap.head = 0;
+	client->coap.count = 0;
+	client->coap.szx = SZX_MAX;
+	client->coap.clean_cnt = 0;
+	client->coap.shrink_ms = 0;
+#endif
+
+	return 0;
+}
+
+static void rtt_sample(struct download_client *client, uint32_t rtt_ms)
+{
+	uint32_t delta;
+
+	if (client->coap.srtt_ms == 0) {
+		client->coap.srtt_ms = rtt_ms;
+		client->coap.rttvar_ms = rtt_ms / 2;
+	} else {
+		delta = client->coap.srtt_ms > rtt_ms ?
+			client->coap.srtt_ms - rtt_ms :
+			rtt_ms - client->coap.srtt_ms;
+		client->coap.rttvar_ms = (3 * client->coap.rttvar_ms + delta) / 4;
+		client->coap.srtt_ms = (7 * client->coap.srtt_ms + rtt_ms) / 8;
+	}
+
+	client->coap.rto_ms = client->coap.srtt_ms +
+			      MAX(1, 4 * client->coap.rttvar_ms);
+	client->coap.rto_ms = MAX(client->coap.rto_ms, RTO_MIN_MS);
+	client->coap.rto_ms = MIN(client->coap.rto_ms, RTO_MAX_MS);
+
+	client->stats.rtt_ms = client->coap.srtt_ms;
+	if (client->stats.rtt_min_ms == 0 || rtt_ms < client->stats.rtt_min_ms) {
+		client->stats.rtt_min_ms = rtt_ms;
+	}
+}
+
+static int block_request_send(struct download_client *client,
+			      struct coap_block_context *block_ctx,
+			      uint16_t id)
+{
+	int err;
+	char file[FILENAME_SIZE];
+	struct coap_packet request;
+
+	err = coap_packet_init(
+		&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+		COAP_VER, COAP_TYPE_CON, 8, coap_next_token(),
+		COAP_METHOD_GET, id
+	);
+	if (err) {
+		LOG_ERR("Failed to init CoAP message, err %d", err);
+		return err;
+	}
+
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		return err;
+	}
+
+	err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+					file, strlen(file));
+	if (err) {
+		LOG_ERR("Unable add option to request");
+		return err;
+	}
+
+	err = coap_append_block2_option(&request, block_ctx);
+	if (err) {
+		LOG_ERR("Unable to add block2 option");
+		return err;
+	}
+
+	err = coap_append_size2_option(&request, block_ctx);
+	if (err) {
+		LOG_ERR("Unable to add size2 option");
+		return err;
+	}
+
+	LOG_DBG("CoAP next block: %d", block_ctx->current);
+
+	err = socket_send(client, client->buf, request.offset);
+	if (err) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	}
+
+	client->stats.requests++;
+
+	return 0;
+}
+
+#if WINDOW > 1
+static struct download_client_coap_slot *slot_get(
+	struct download_client *client, size_t i)
+{
+	return &client->coap.slots[(client->coap.head + i) % WINDOW];
+}
+
+static size_t slot_size(const struct download_client_coap_slot *slot)
+{
+	return coap_block_size_to_bytes(slot->szx);
+}
+
+/* Offset of the first byte after the blocks in the window */
+static size_t window_end(struct download_client *client)
+{
+	struct download_client_coap_slot *last;
+
+	if (client->coap.count == 0) {
+		return client->progress;
+	}
+
+	last = slot_get(client, client->coap.count - 1);
+
+	return last->offset + slot_size(last);
+}
+
+static int slot_request_send(struct download_client *client,
+			     struct download_client_coap_slot *slot)
+{
+	struct coap_block_context block_ctx = {
+		.block_size = slot->szx,
+		.current = slot->offset,
+	};
+
+	slot->sent_ms = k_uptime_get();
+	slot->tx_cnt++;
+
+	return block_request_send(client, &block_ctx, slot->id);
+}
+
+static void block_size_set(struct download_client *client, uint8_t szx)
+{
+	LOG_DBG("CoAP block size %d", coap_block_size_to_bytes(szx));
+
+	client->coap.szx = szx;
+	client->coap.clean_cnt = 0;
+	client->stats.block_size = coap_block_size_to_bytes(szx);
+}
+
+/* A block was lost: use smaller blocks, at most once per round-trip. */
+static void block_size_shrink(struct download_client *client, int64_t now)
+{
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE_ADAPTIVE)) {
+		return;
+	}
+
+	client->coap.clean_cnt = 0;
+
+	if (client->coap.szx > SZX_MIN &&
+	    now - client->coap.shrink_ms >= client->coap.srtt_ms) {
+		client->coap.shrink_ms = now;
+		block_size_set(client, client->coap.szx - 1);
+	}
+}
+
+/* A block was received without loss: use larger blocks after a run of
+ * such blocks, unless the round-trip time is increasing.
+ */
+static void block_size_grow(struct download_client *client)
+{
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE_ADAPTIVE)) {
+		return;
+	}
+
+	if (++client->coap.clean_cnt < 2 * WINDOW) {
+		return;
+	}
+
+	client->coap.clean_cnt = 0;
+
+	if (client->coap.szx < SZX_MAX &&
+	    client->coap.srtt_ms <= 2 * client->stats.rtt_min_ms) {
+		block_size_set(client, client->coap.szx + 1);
+	}
+}
+
+/* Wake up when the oldest outstanding request is due for retransmission,
+ * instead of waiting for the socket timeout.
+ */
+static void recv_timeout_set(struct download_client *client)
+{
+	int err;
+	uint32_t timeout_ms = client->coap.rto_ms;
+
+	if (CONFIG_DOWNLOAD_CLIENT_UDP_SOCK_TIMEO_MS > 0) {
+		timeout_ms = MIN(timeout_ms,
+				 CONFIG_DOWNLOAD_CLIENT_UDP_SOCK_TIMEO_MS);
+	}
+
+	struct timeval timeo = {
+		.tv_sec = (timeout_ms / 1000),
+		.tv_usec = (timeout_ms % 1000) * 1000,
+	};
+
+	err = setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeo,
+			 sizeof(timeo));
+	if (err) {
+		LOG_WRN("Failed to set socket timeout, errno %d", errno);
+	}
+}
+
+static int window_request_send(struct download_client *client)
+{
+	int err;
+	bool lost = false;
+	int64_t now = k_uptime_get();
+	struct download_client_coap_slot *slot;
+
+	/* Retransmit the requests whose timeout has expired */
+	for (size_t i = 0; i < client->coap.count; i++) {
+		slot = slot_get(client, i);
+
+		if (slot->received ||
+		    now - slot->sent_ms < client->coap.rto_ms) {
+			continue;
+		}
+
+		LOG_DBG("Retransmitting request for block at %d",
+			slot->offset);
+
+		err = slot_request_send(client, slot);
+		if (err) {
+			return err;
+		}
+
+		client->stats.retransmissions++;
+		lost = true;
+	}
+
+	if (lost) {
+		client->coap.rto_ms = MIN(2 * client->coap.rto_ms, RTO_MAX_MS);
+		block_size_shrink(client, now);
+	}
+
+	/* Request the next blocks. Until the file size is known,
+	 * only one block is requested.
+	 */
+	while (client->coap.count < WINDOW) {
+		size_t offset = window_end(client);
+		uint8_t szx = client->coap.szx;
+
+		if (client->file_size == 0 ?
+		    client->coap.count > 0 : offset >= client->file_size) {
+			break;
+		}
+
+		if (client->coap.count > 0) {
+			/* The block number is the offset in block size units */
+			while (offset % coap_block_size_to_bytes(szx)) {
+				szx--;
+			}
+		} else {
+			/* Resuming, possibly in the middle of a block */
+			offset -= offset % coap_block_size_to_bytes(szx);
+		}
+
+		slot = slot_get(client, client->coap.count);
+		*slot = (struct download_client_coap_slot) {
+			.offset = offset,
+			.szx = szx,
+			.id = coap_next_id(),
+		};
+
+		err = slot_request_send(client, slot);
+		if (err) {
+			return err;
+		}
+
+		client->coap.count++;
+	}
+
+	recv_timeout_set(client);
+
 	return 0;
 }
 
+/* Copy the blocks received in order to the buffer.
+ * Returns true if there are bytes to hand to the application.
+ */
+static bool window_deliver(struct download_client *client)
+{
+	struct download_client_coap_slot *slot;
+	size_t skip;
+	size_t len;
+
+	client->offset = 0;
+
+	while (client->coap.count > 0) {
+		slot = slot_get(client, 0);
+		if (!slot->received) {
+			break;
+		}
+
+		/* Skip any bytes already downloaded when resuming */
+		skip = MIN(client->progress - slot->offset, slot->len);
+		len = slot->len - skip;
+
+		if (client->offset + len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+			break;
+		}
+
+		memcpy(client->buf + client->offset, slot->data + skip, len);
+		client->offset += len;
+		client->progress += len;
+
+		client->coap.head = (client->coap.head + 1) % WINDOW;
+		client->coap.count--;
+	}
+
+	return client->offset > 0;
+}
+
+static int window_parse(struct download_client *client, size_t len)
+{
+	int err;
+	int block2;
+	int size2;
+	uint8_t szx;
+	size_t offset;
+	size_t i;
+	uint8_t response_code;
+	uint16_t payload_len;
+	uint16_t id;
+	const uint8_t *payload;
+	struct coap_packet response;
+	struct download_client_coap_slot *slot = NULL;
+
+	err = coap_packet_parse(&response, client->buf, len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to parse CoAP packet, err %d", err);
+		return -1;
+	}
+
+	/* Find the request this is the response to */
+	id = coap_header_get_id(&response);
+	for (i = 0; i < client->coap.count; i++) {
+		if (slot_get(client, i)->id == id) {
+			slot = slot_get(client, i);
+			break;
+		}
+	}
+
+	if (!slot || slot->received) {
+		LOG_DBG("Ignoring duplicate or late response, id %d", id);
+		return 1;
+	}
+
+	response_code = coap_header_get_code(&response);
+	if (response_code != COAP_RESPONSE_CODE_OK &&
+	    response_code != COAP_RESPONSE_CODE_CONTENT) {
+		LOG_ERR("Server responded with code 0x%x", response_code);
+		return -1;
+	}
+
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		LOG_ERR("No block2 option in response");
+		return -1;
+	}
+
+	/* Block2 option value: NUM (block number), M (more), SZX */
+	szx = block2 & 0x7;
+	offset = (block2 >> 4) * coap_block_size_to_bytes(szx);
+	if (offset != slot->offset || szx > slot->szx) {
+		LOG_ERR("Unexpected block in response");
+		return -1;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if (!payload || payload_len > coap_block_size_to_bytes(szx)) {
+		LOG_WRN("Invalid CoAP payload!");
+		return -1;
+	}
+
+	if (szx < slot->szx) {
+		/* The server uses smaller blocks. The following blocks
+		 * are requested again with the block size of the server.
+		 */
+		LOG_DBG("Server block size %d",
+			coap_block_size_to_bytes(szx));
+		slot->szx = szx;
+		client->coap.count = i + 1;
+		client->coap.szx = MIN(client->coap.szx, szx);
+		client->stats.block_size = coap_block_size_to_bytes(szx);
+	}
+
+	if (client->file_size == 0) {
+		size2 = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+		if (size2 > 0) {
+			client->file_size = size2;
+		} else if (!(block2 & 0x8)) {
+			client->file_size = offset + payload_len;
+		}
+		LOG_DBG("Total size: %d", client->file_size);
+	}
+
+	memcpy(slot->data, payload, payload_len);
+	slot->len = payload_len;
+	slot->received = true;
+
+	if (slot->tx_cnt == 1) {
+		rtt_sample(client, k_uptime_get() - slot->sent_ms);
+		block_size_grow(client);
+	}
+
+	return window_deliver(client) ? 0 : 1;
+}
+#endif /* WINDOW > 1 */
+
 int coap_block_update(struct download_client *client, struct coap_packet *pkt,
 		      size_t *blk_off)
 {
@@ -65,6 +502,10 @@ int coap_parse(struct download_client *client, size_t len)
 	const uint8_t *payload;
 	struct coap_packet response;
 
+#if WINDOW > 1
+	return window_parse(client, len);
+#endif
+
 	err = coap_packet_parse(&response, client->buf, len, NULL, 0);
 	if (err) {
 		LOG_ERR("Failed to parse CoAP packet, err %d", err);
@@ -102,60 +543,40 @@ int coap_parse(struct download_client *client, size_t len)
 	client->offset += payload_len - blk_off;
 	client->progress += payload_len - blk_off;
 
+	if (!client->coap.retransmitted) {
+		rtt_sample(client, k_uptime_get() - client->coap.sent_ms);
+	}
+	client->stats.block_size =
+		coap_block_size_to_bytes(client->coap.block_ctx.block_size);
+
 	return 0;
 }
 
 int coap_request_send(struct download_client *client)
 {
-	int err;
-	char file[FILENAME_SIZE];
-	struct coap_packet request;
+#if WINDOW > 1
+	return window_request_send(client);
+#endif
 
-	err = coap_packet_init(
-		&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-		COAP_VER, COAP_TYPE_CON, 8, coap_next_token(),
-		COAP_METHOD_GET, coap_next_id()
-	);
-	if (err) {
-		LOG_ERR("Failed to init CoAP message, err %d", err);
-		return err;
+	if (client->coap.requested == client->coap.block_ctx.current) {
+		client->coap.retransmitted = true;
+		client->stats.retransmissions++;
+	} else {
+		client->coap.retransmitted = false;
+		client->coap.requested = client->coap.block_ctx.current;
 	}
 
-	err = url_parse_file(client->file, file, sizeof(file));
-	if (err) {
-		return err;
-	}
+	client->coap.sent_ms = k_uptime_get();
 
-	err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
-					file, strlen(file));
-	if (err) {
-		LOG_ERR("Unable add option to request");
-		return err;
-	}
-
-	err = coap_append_block2_option(&request, &client->coap.block_ctx);
-	if (err) {
-		LOG_ERR("Unable to add block2 option");
-		return err;
-	}
-
-	err = coap_append_size2_option(&request, &client->coap.block_ctx);
-	if (err) {
-		LOG_ERR("Unable to add size2 option");
-		return err;
-	}
-
-	LOG_DBG("CoAP next block: %d", client->coap.block_ctx.current);
-
-	err = socket_send(client, request.offset);
-	if (err) {
-		LOG_ERR("Failed to send CoAP request, errno %d", errno);
-		return err;
-	}
-
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
-	}
+	return block_request_send(client, &client->coap.block_ctx,
+				  coap_next_id());
+}
 
-	return 0;
+bool coap_deliver(struct download_client *client)
+{
+#if WINDOW > 1
+	return window_deliver(client);
+#else
+	return false;
+#endif
 }
@@ -37,6 +37,7 @@ int http_get_request_send(struct download_client *client);
 
 int coap_block_init(struct download_client *client, size_t from);
 int coap_parse(struct download_client *client, size_t len);
+bool coap_deliver(struct download_client *client);
 int coap_request_send(struct download_client *client);
 
 static const char *str_family(int family)
@@ -362,13 +363,14 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len)
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len)
 {
 	int sent;
 	size_t off = 0;
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(client->fd, buf + off, len, 0);
 		if (sent <= 0) {
 			return -errno;
 		}
@@ -396,7 +398,7 @@ static int request_send(struct download_client *dl)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+static int fragment_evt_send(struct download_client *client)
 {
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
@@ -409,9 +411,33 @@ static int fragment_evt_send(const struct download_client *client)
 		}
 	};
 
+	client->stats.bytes += client->offset;
+
 	return client->callback(&evt);
 }
 
+static void done_evt_send(struct download_client *client)
+{
+	struct download_client_stats *stats = &client->stats;
+
+	stats->duration_ms = k_uptime_get() - client->start_ms;
+	if (stats->duration_ms > 0) {
+		stats->goodput = (uint64_t)stats->bytes * MSEC_PER_SEC /
+				 stats->duration_ms;
+	}
+
+	LOG_INF("%u bytes in %u ms (%u B/s), %u requests, "
+		"%u retransmissions", stats->bytes, stats->duration_ms,
+		stats->goodput, stats->requests, stats->retransmissions);
+
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_DONE,
+		.stats = *stats,
+	};
+
+	client->callback(&evt);
+}
+
 static int error_evt_send(const struct download_client *dl, int error)
 {
 	/* Error will be sent as negative. */
@@ -430,6 +456,11 @@ static int reconnect(struct download_client *dl)
 	int err;
 
 	LOG_INF("Reconnecting..");
+
+	/* Pipelined requests are lost with the connection */
+	dl->http.requested = dl->progress;
+	dl->http.surplus = 0;
+
 	err = download_client_disconnect(dl);
 	if (err) {
 		return err;
@@ -466,8 +497,16 @@ restart_and_suspend:
 		LOG_DBG("Receiving up to %d bytes at %p...",
 			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
 
-		len = recv(dl->fd, dl->buf + dl->offset,
-			   sizeof(dl->buf) - dl->offset, 0);
+		if (dl->http.surplus) {
+			/* Parse the beginning of the next pipelined response,
+			 * received together with the previous fragment.
+			 */
+			len = dl->http.surplus;
+			dl->http.surplus = 0;
+		} else {
+			len = recv(dl->fd, dl->buf + dl->offset,
+				   sizeof(dl->buf) - dl->offset, 0);
+		}
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
@@ -533,6 +572,12 @@ restart_and_suspend:
 			}
 		} else if (IS_ENABLED(CONFIG_COAP)) {
 			rc = coap_parse(client, len);
+			if (rc > 0) {
+				/* Block received out of order or duplicate,
+				 * send any request due for retransmission.
+				 */
+				goto send_again;
+			}
 		}
 
 		if (rc < 0) {
@@ -543,6 +588,7 @@ restart_and_suspend:
 			break;
 		}
 
+fragment:
 		if (dl->file_size) {
 			LOG_INF("Downloaded %u/%u bytes (%d%%)",
 				dl->progress, dl->file_size,
@@ -563,20 +609,27 @@ restart_and_suspend:
 
 		if (dl->progress == dl->file_size) {
 			LOG_INF("Download complete");
-			const struct download_client_evt evt = {
-				.id = DOWNLOAD_CLIENT_EVT_DONE,
-			};
-			dl->callback(&evt);
+			done_evt_send(dl);
 			/* Restart and suspend */
 			break;
 		}
 
+		/* Deliver the CoAP blocks already received, if any */
+		if ((dl->proto == IPPROTO_UDP || dl->proto == IPPROTO_DTLS_1_2) &&
+		    IS_ENABLED(CONFIG_COAP) && coap_deliver(dl)) {
+			goto fragment;
+		}
+
 		/* Attempt to reconnect if the connection was closed */
 		if (dl->http.connection_close) {
 			dl->http.connection_close = false;
 			reconnect(dl);
 		}
 
+		if (dl->http.surplus) {
+			memmove(dl->buf, dl->buf + dl->offset, dl->http.surplus);
+		}
+
 send_again:
 		dl->offset = 0;
 		/* Request next fragment, if necessary (HTTPS/CoAP) */
@@ -711,8 +764,13 @@ int download_client_start(struct download_client *client, const char *file,
 	client->file_size = 0;
 	client->progress = from;
 
+	memset(&client->stats, 0, sizeof(client->stats));
+	client->start_ms = k_uptime_get();
+
 	client->offset = 0;
 	client->http.has_header = false;
+	client->http.requested = from;
+	client->http.surplus = 0;
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
@@ -33,15 +33,44 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len);
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len);
 
-int http_get_request_send(struct download_client *client)
+static size_t frag_size(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static bool range_requests(const struct download_client *client)
+{
+	return client->proto == IPPROTO_TLS_1_2
+	    || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS);
+}
+
+static bool http_pipelined(const struct download_client *client)
+{
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH > 1
+	    && range_requests(client);
+}
+
+/* Send a GET request for the range starting at `from`,
+ * and return the offset of the last byte in range in `to`.
+ */
+static int http_range_request_send(struct download_client *client,
+				   size_t from, size_t *to)
 {
 	int err;
 	int len;
 	size_t off;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
+	/* Any bytes of the next response are kept in the buffer */
+	char *buf = client->buf + client->http.surplus;
+	size_t size = CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - client->http.surplus;
 
 	__ASSERT_NO_MSG(client->host);
 	__ASSERT_NO_MSG(client->file);
@@ -57,12 +86,7 @@ int http_get_request_send(struct download_client *client)
 	}
 
 	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
+	off = from + frag_size(client) - 1;
 
 	if (client->file_size != 0) {
 		/* Don't request bytes past the end of file */
@@ -73,32 +97,84 @@ int http_get_request_send(struct download_client *client)
 	 * When using HTTP, we request the whole resource to minimize
 	 * network usage (only one request/response are sent).
 	 */
-	if (client->proto == IPPROTO_TLS_1_2
-	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			GET_HTTPS_TEMPLATE, file, host, client->progress, off);
+	if (range_requests(client)) {
+		len = snprintf(buf, size,
+			GET_HTTPS_TEMPLATE, file, host, from, off);
 	} else {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			GET_HTTP_TEMPLATE, file, host, client->progress);
+		len = snprintf(buf, size,
+			GET_HTTP_TEMPLATE, file, host, from);
 	}
 
-	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
-		LOG_ERR("Cannot create GET request, buffer too small");
+	if (len < 0 || len > size) {
 		return -ENOMEM;
 	}
 
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+		LOG_HEXDUMP_DBG(buf, len, "HTTP request");
 	}
 
-	err = socket_send(client, len);
+	err = socket_send(client, buf, len);
 	if (err) {
 		LOG_ERR("Failed to send HTTP request, errno %d", errno);
 		return err;
 	}
 
+	client->stats.requests++;
+	*to = off;
+
+	return 0;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+	size_t to;
+	size_t window;
+
+	if (!http_pipelined(client)) {
+		err = http_range_request_send(client, client->progress, &to);
+		if (err == -ENOMEM) {
+			LOG_ERR("Cannot create GET request, buffer too small");
+		}
+
+		return err;
+	}
+
+	/* Requests are pipelined. Keep requesting fragments until the
+	 * window is full.
+	 */
+	window = CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH * frag_size(client);
+
+	while (client->file_size == 0 ||
+	       (client->http.requested < client->file_size &&
+		client->http.requested < client->progress + window)) {
+		err = http_range_request_send(client, client->http.requested,
+					      &to);
+		if (err == -ENOMEM &&
+		    client->http.requested > client->progress) {
+			/* Not enough space in the buffer next to the data
+			 * of the next response. The request is sent
+			 * after the next fragment.
+			 */
+			break;
+		}
+		if (err == -ENOMEM) {
+			LOG_ERR("Cannot create GET request, buffer too small");
+		}
+		if (err) {
+			return err;
+		}
+
+		client->http.requested = to + 1;
+
+		if (client->file_size == 0) {
+			/* Avoid requesting bytes past the end of file,
+			 * until the file size is known.
+			 */
+			break;
+		}
+	}
+
 	return 0;
 }
 
@@ -195,6 +271,8 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	}
 
 	client->http.has_header = true;
+	client->http.frag_len = MIN(frag_size(client),
+				    client->file_size - client->progress);
 
 	return 0;
 }
@@ -249,13 +327,24 @@ int http_parse(struct download_client *client, size_t len)
 	 * `offset` is less than `len` and it represents
 	 * the actual payload bytes.
 	 */
-	client->progress += MIN(client->offset, len);
+	len = MIN(client->offset, len);
+
+	/* When requests are pipelined, the buffer may contain the
+	 * beginning of the next response after the current fragment.
+	 * Those bytes are kept in the buffer and parsed once
+	 * the current fragment has been handed to the application.
+	 */
+	if (http_pipelined(client) && client->offset > client->http.frag_len) {
+		client->http.surplus = client->offset - client->http.frag_len;
+		client->offset = client->http.frag_len;
+		len -= client->http.surplus;
+	}
+
+	client->progress += len;
 
 	/* Have we received a whole fragment or the whole file? */
 	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	    client->offset < frag_size(client)) {
 		return 1;
 	}
 
@@ -47,7 +47,9 @@ static int callback(const struct download_client_evt *event)
 		}
 		break;
 	case DOWNLOAD_CLIENT_EVT_DONE:
-		shell_print(shell_instance, "done (%d bytes)", downloaded);
+		shell_print(shell_instance, "done (%d bytes, %u ms, %u B/s)",
+			    downloaded, event->stats.duration_ms,
+			    event->stats.goodput);
 		downloaded = 0;
 		break;
 	case DOWNLOAD_CLIENT_EVT_ERROR:
@@ -27,6 +27,9 @@ extern "C" {
 #define PGPS_PREDICTION_STORAGE_SIZE 2048
 #define PGPS_PREDICTION_PAD (PGPS_PREDICTION_STORAGE_SIZE - \
 			     sizeof(struct nrf_cloud_pgps_prediction))
+/* CRC-32 of the stored prediction, in the last bytes of its storage. */
+#define PGPS_CHECKSUM_SIZE sizeof(uint32_t)
+#define PGPS_CHECKSUM_OFFSET (PGPS_PREDICTION_STORAGE_SIZE - PGPS_CHECKSUM_SIZE)
 #define PGPS_SCHEMA_SIZE sizeof(((struct nrf_cloud_pgps_prediction *)0)->schema_version)
 #define PGPS_SENTINEL_SIZE sizeof(((struct nrf_cloud_pgps_prediction *)0)->sentinel)
 #define PGPS_PREDICTION_DL_SIZE (sizeof(struct nrf_cloud_pgps_prediction) - \
@@ -35,6 +35,7 @@ extern "C" {
 #define NUM_BLOCKS			NUM_PREDICTIONS
 #define BLOCK_SIZE			PGPS_PREDICTION_STORAGE_SIZE
 #define NO_BLOCK			-1
+#define NO_MAP_BLOCK			0xFFU
 
 struct gps_location {
 	int32_t latitude;
@@ -42,6 +43,17 @@ struct gps_location {
 	int64_t gps_sec;
 };
 
+/* Flash block of each stored prediction, saved so that the predictions do not
+ * need to be scanned after boot.
+ */
+struct prediction_map {
+	/* GPS time of the first prediction */
+	int64_t start_sec;
+	uint16_t count;
+	/* block number, or NO_MAP_BLOCK if the prediction is not stored */
+	uint8_t block[NUM_PREDICTIONS];
+};
+
 struct nrf_cloud_pgps_header;
 
 typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
@@ -49,6 +61,8 @@ typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
 /* settings functions */
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
+int npgps_save_prediction_map(const struct prediction_map *map);
+const struct prediction_map *npgps_get_saved_prediction_map(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
@@ -38,6 +38,10 @@ struct nct_dc_data {
 	struct nrf_cloud_data data;
 	struct nrf_cloud_topic topic;
 	uint32_t id;
+	/* Position of received data that is larger than the payload buffer.
+	 * The total length is 0 if the data is not fragmented.
+	 */
+	struct nrf_cloud_rx_fragment fragment;
 };
 
 struct nct_cc_data {
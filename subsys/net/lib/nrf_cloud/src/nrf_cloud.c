@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
+#include <string.h>
 #include <net/socket.h>
 #include <net/cloud.h>
 #include <net/nrf_cloud.h>
@@ -11,6 +12,9 @@
 #include "nrf_cloud_fsm.h"
 #include "nrf_cloud_transport.h"
 #include "nrf_cloud_mem.h"
+#if defined(CONFIG_NRF_CLOUD_AGPS)
+#include <net/nrf_cloud_agps.h>
+#endif
 
 #include <logging/log.h>
 
@@ -62,6 +66,10 @@ void nfsm_set_current_state_and_notify(enum nfsm_state state,
 	if ((evt != NULL) &&
 	    (evt->type == NRF_CLOUD_EVT_TRANSPORT_DISCONNECTED)) {
 		atomic_set(&transport_disconnected, 1);
+#if defined(CONFIG_NRF_CLOUD_AGPS)
+		/* The rest of fragmented A-GPS data will not be received. */
+		nrf_cloud_agps_process_abort();
+#endif
 	}
 
 	if ((app_event_handler != NULL) && (evt != NULL)) {
@@ -498,6 +506,50 @@ static int api_connect_error_translate(const int err)
 	}
 }
 
+#if defined(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS)
+/* Data received in fragments, which is reassembled for the cloud API. */
+static struct {
+	char *buf;
+	size_t len;
+} api_rx;
+
+static void api_rx_reset(void)
+{
+	nrf_cloud_free(api_rx.buf);
+	api_rx.buf = NULL;
+	api_rx.len = 0;
+}
+
+/* Add a fragment to the reassembled data. Returns true when the data is
+ * complete.
+ */
+static bool api_rx_fragment_add(const struct nrf_cloud_evt *nrf_cloud_evt)
+{
+	const struct nrf_cloud_rx_fragment *fragment = &nrf_cloud_evt->fragment;
+
+	if (fragment->offset == 0) {
+		api_rx_reset();
+
+		api_rx.buf = nrf_cloud_malloc(fragment->total_len);
+		if (api_rx.buf == NULL) {
+			LOG_ERR("Cannot allocate %d bytes for received data",
+				fragment->total_len);
+			return false;
+		}
+	} else if ((api_rx.buf == NULL) || (fragment->offset != api_rx.len)) {
+		/* The beginning of the data was dropped. */
+		api_rx_reset();
+		return false;
+	}
+
+	memcpy(&api_rx.buf[api_rx.len], nrf_cloud_evt->data.ptr,
+	       nrf_cloud_evt->data.len);
+	api_rx.len += nrf_cloud_evt->data.len;
+
+	return (api_rx.len == fragment->total_len);
+}
+#endif /* defined(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS) */
+
 static void api_event_handler(const struct nrf_cloud_evt *nrf_cloud_evt)
 {
 	struct cloud_backend_config *config = nrf_cloud_backend->config;
@@ -555,6 +607,9 @@ static void api_event_handler(const struct nrf_cloud_evt *nrf_cloud_evt)
 		LOG_DBG("NRF_CLOUD_EVT_TRANSPORT_DISCONNECTED");
 
 		atomic_set(&transport_disconnected, 1);
+#if defined(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS)
+		api_rx_reset();
+#endif
 		evt.data.err =
 			api_disconnect_status_translate(nrf_cloud_evt->status);
 		evt.type = CLOUD_EVT_DISCONNECTED;
@@ -581,6 +636,29 @@ static void api_event_handler(const struct nrf_cloud_evt *nrf_cloud_evt)
 
 		cloud_notify_event(nrf_cloud_backend, &evt, config->user_data);
 		break;
+	case NRF_CLOUD_EVT_RX_DATA_FRAGMENT:
+#if defined(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS)
+		/* The cloud API only notifies complete messages. */
+		if (!api_rx_fragment_add(nrf_cloud_evt)) {
+			break;
+		}
+
+		LOG_DBG("NRF_CLOUD_EVT_RX_DATA_FRAGMENT: %d bytes reassembled",
+			api_rx.len);
+
+		evt.type = CLOUD_EVT_DATA_RECEIVED;
+		evt.data.msg.buf = api_rx.buf;
+		evt.data.msg.len = api_rx.len;
+		evt.data.msg.endpoint.type = CLOUD_EP_MSG;
+		evt.data.msg.endpoint.str =
+			(char *)nrf_cloud_evt->topic.ptr;
+		evt.data.msg.endpoint.len = nrf_cloud_evt->topic.len;
+
+		cloud_notify_event(nrf_cloud_backend, &evt, config->user_data);
+
+		api_rx_reset();
+#endif
+		break;
 	case NRF_CLOUD_EVT_FOTA_DONE:
 		LOG_DBG("NRF_CLOUD_EVT_FOTA_DONE");
 
@@ -17,6 +17,7 @@
 #include <net/nrf_cloud_pgps.h>
 #endif
 #include <stdio.h>
+#include <sys/byteorder.h>
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(nrf_cloud_agps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
@@ -44,6 +45,14 @@ extern void agps_print(enum nrf_cloud_agps_type type, void *data);
 
 static K_SEM_DEFINE(agps_injection_active, 1, 1);
 
+/* Serializes access to the state of the data being processed between the
+ * processing functions and the abort of fragmented data.
+ */
+static K_MUTEX_DEFINE(stream_mutex);
+
+static void stream_timeout_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stream_timeout_work, stream_timeout_work_fn);
+
 static int fd = -1;
 static bool agps_print_enabled;
 static const struct device *gps_dev;
@@ -51,6 +60,64 @@ static bool json_initialized;
 static struct gps_agps_request processed;
 static atomic_t request_in_progress;
 
+/* Satellites for which ephemerides and almanacs were requested. Other
+ * satellites are not injected. A mask of 0 means that no satellites were
+ * requested, and all are injected.
+ */
+static struct gps_agps_request requested;
+
+/* Statistics of the last processed A-GPS data. */
+static struct {
+	uint16_t elements;
+	uint16_t writes;
+	uint16_t skipped;
+	uint32_t total_cycles;
+	uint32_t inject_cycles;
+} agps_stats;
+
+/* Length of the system clock element, which is followed by one TOW. */
+#define AGPS_SYSTEM_CLOCK_LEN \
+	(sizeof(struct nrf_cloud_agps_system_time) - \
+	 NRF_CLOUD_AGPS_MAX_SV_TOW * sizeof(struct nrf_cloud_agps_tow_element) + 4)
+
+/* Elements as they are laid out in the binary A-GPS data. */
+union agps_element {
+	struct nrf_cloud_agps_utc utc;
+	struct nrf_cloud_agps_ephemeris ephemeris;
+	struct nrf_cloud_agps_almanac almanac;
+	struct nrf_cloud_agps_klobuchar klobuchar;
+	uint8_t system_clock[AGPS_SYSTEM_CLOCK_LEN];
+	struct nrf_cloud_agps_tow_element tow;
+	struct nrf_cloud_agps_location location;
+	struct nrf_cloud_agps_integrity integrity;
+};
+
+/* State of the A-GPS data being processed, which is kept between fragments. */
+static struct {
+	/* Processing has started, and the injection semaphore is taken. */
+	bool active;
+	/* The data is received in fragments. */
+	bool fragmented;
+	/* Uptime when the last fragment was received. */
+	int64_t fragment_time;
+	/* An element of a type that is not handled has been found. */
+	bool finished;
+	/* Number of bytes of fragmented data that have been received. */
+	size_t received;
+	/* Type of the elements in the current array, and the number left.
+	 * The element type is only given once before the array.
+	 */
+	enum nrf_cloud_agps_type element_type;
+	uint16_t elements_left_to_process;
+	/* TOWs are collected and injected with the system clock. */
+	struct nrf_cloud_agps_system_time sys_time;
+	uint32_t sv_mask;
+	/* Start of an element that is split between fragments. */
+	char partial[NRF_CLOUD_AGPS_BIN_TYPE_SIZE +
+		     NRF_CLOUD_AGPS_BIN_COUNT_SIZE + sizeof(union agps_element)];
+	size_t partial_len;
+} stream;
+
 static enum gps_agps_type type_lookup_socket2gps[] = {
 	[NRF_GNSS_AGPS_UTC_PARAMETERS]	= GPS_AGPS_UTC_PARAMETERS,
 	[NRF_GNSS_AGPS_EPHEMERIDES]	= GPS_AGPS_EPHEMERIDES,
@@ -234,6 +301,7 @@ int nrf_cloud_agps_request(const struct gps_agps_request request)
 
 	atomic_set(&request_in_progress, 0);
 	memset(&processed, 0, sizeof(processed));
+	memset(&requested, 0, sizeof(requested));
 
 	if (request.utc) {
 		types[type_count++] = GPS_AGPS_UTC_PARAMETERS;
@@ -242,10 +310,12 @@ int nrf_cloud_agps_request(const struct gps_agps_request request)
 #if !defined(CONFIG_NRF_CLOUD_PGPS)
 	if (request.sv_mask_ephe) {
 		types[type_count++] = GPS_AGPS_EPHEMERIDES;
+		requested.sv_mask_ephe = request.sv_mask_ephe;
 	}
 
 	if (request.sv_mask_alm) {
 		types[type_count++] = GPS_AGPS_ALMANAC;
+		requested.sv_mask_alm = request.sv_mask_alm;
 	}
 #endif
 
@@ -334,6 +404,7 @@ static int send_to_modem(void *data, size_t data_len,
 			 nrf_gnss_agps_data_type_t type)
 {
 	int err;
+	uint32_t start = k_cycle_get_32();
 
 	if (agps_print_enabled) {
 		agps_print(type, data);
@@ -341,23 +412,33 @@ static int send_to_modem(void *data, size_t data_len,
 
 	/* At this point, GPS driver or app-provided socket is assumed. */
 	if (gps_dev) {
-		return gps_agps_write(gps_dev, type_socket2gps(type), data,
-				      data_len);
-	}
-
-	err = nrf_sendto(fd, data, data_len, 0, &type, sizeof(type));
-	if (err < 0) {
-		LOG_ERR("Failed to send AGPS data to modem, errno: %d", errno);
-		err = -errno;
+		err = gps_agps_write(gps_dev, type_socket2gps(type), data,
+				     data_len);
 	} else {
-		err = 0;
+		err = nrf_sendto(fd, data, data_len, 0, &type, sizeof(type));
+		if (err < 0) {
+			LOG_ERR("Failed to send AGPS data to modem, errno: %d",
+				errno);
+			err = -errno;
+		} else {
+			err = 0;
+		}
+
+		LOG_DBG("A-GSP data sent to modem");
 	}
 
-	LOG_DBG("A-GSP data sent to modem");
+	agps_stats.writes++;
+	agps_stats.inject_cycles += k_cycle_get_32() - start;
 
 	return err;
 }
 
+/* Check whether data for a satellite was requested. */
+static bool sv_requested(uint32_t sv_mask, uint8_t sv_id)
+{
+	return (sv_mask == 0) || (sv_mask & BIT(sv_id - 1));
+}
+
 static int copy_utc(nrf_gnss_agps_data_utc_t *dst,
 		    struct nrf_cloud_apgs_element *src)
 {
@@ -524,11 +605,18 @@ static int agps_send_to_modem(struct nrf_cloud_apgs_element *agps_data)
 	}
 	case NRF_CLOUD_AGPS_EPHEMERIDES: {
 		nrf_gnss_agps_data_ephemeris_t ephemeris;
+		int err;
 
-		processed.sv_mask_ephe |= (1 << (agps_data->ephemeris->sv_id - 1));
+		if (!sv_requested(requested.sv_mask_ephe,
+				  agps_data->ephemeris->sv_id)) {
+			agps_stats.skipped++;
+			return 0;
+		}
 #if defined(CONFIG_NRF_CLOUD_PGPS)
 		if (agps_data->ephemeris->health ==
 		    NRF_CLOUD_PGPS_EMPTY_EPHEM_HEALTH) {
+			processed.sv_mask_ephe |=
+				(1 << (agps_data->ephemeris->sv_id - 1));
 			LOG_DBG("Skipping empty ephemeris for sv %u",
 				agps_data->ephemeris->sv_id);
 			return 0;
@@ -538,19 +626,36 @@ static int agps_send_to_modem(struct nrf_cloud_apgs_element *agps_data)
 		LOG_DBG("A-GPS type: NRF_CLOUD_AGPS_EPHEMERIDES %d",
 			agps_data->ephemeris->sv_id);
 
-		return send_to_modem(&ephemeris, sizeof(ephemeris),
-				     NRF_GNSS_AGPS_EPHEMERIDES);
+		err = send_to_modem(&ephemeris, sizeof(ephemeris),
+				    NRF_GNSS_AGPS_EPHEMERIDES);
+		if (!err) {
+			processed.sv_mask_ephe |=
+				(1 << (agps_data->ephemeris->sv_id - 1));
+		}
+
+		return err;
 	}
 	case NRF_CLOUD_AGPS_ALMANAC: {
 		nrf_gnss_agps_data_almanac_t almanac;
+		int err;
 
-		processed.sv_mask_alm |= (1 << (agps_data->almanac->sv_id - 1));
+		if (!sv_requested(requested.sv_mask_alm,
+				  agps_data->almanac->sv_id)) {
+			agps_stats.skipped++;
+			return 0;
+		}
 		copy_almanac(&almanac, agps_data);
 		LOG_DBG("A-GPS type: NRF_CLOUD_AGPS_ALMANAC %d",
 			agps_data->almanac->sv_id);
 
-		return send_to_modem(&almanac, sizeof(almanac),
-				     NRF_GNSS_AGPS_ALMANAC);
+		err = send_to_modem(&almanac, sizeof(almanac),
+				    NRF_GNSS_AGPS_ALMANAC);
+		if (!err) {
+			processed.sv_mask_alm |=
+				(1 << (agps_data->almanac->sv_id - 1));
+		}
+
+		return err;
 	}
 	case NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION: {
 		nrf_gnss_agps_data_klobuchar_t klobuchar;
@@ -601,106 +706,288 @@ static int agps_send_to_modem(struct nrf_cloud_apgs_element *agps_data)
 	return 0;
 }
 
-static size_t get_next_agps_element(struct nrf_cloud_apgs_element *element,
-				    const char *buf)
+/* Length of an element of the given type, or 0 if the type is not handled. */
+static size_t agps_element_len(enum nrf_cloud_agps_type type)
+{
+	switch (type) {
+	case NRF_CLOUD_AGPS_UTC_PARAMETERS:
+		return sizeof(struct nrf_cloud_agps_utc);
+	case NRF_CLOUD_AGPS_EPHEMERIDES:
+		return sizeof(struct nrf_cloud_agps_ephemeris);
+	case NRF_CLOUD_AGPS_ALMANAC:
+		return sizeof(struct nrf_cloud_agps_almanac);
+	case NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION:
+		return sizeof(struct nrf_cloud_agps_klobuchar);
+	case NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK:
+		return AGPS_SYSTEM_CLOCK_LEN;
+	case NRF_CLOUD_AGPS_GPS_TOWS:
+		return sizeof(struct nrf_cloud_agps_tow_element);
+	case NRF_CLOUD_AGPS_LOCATION:
+		return sizeof(struct nrf_cloud_agps_location);
+	case NRF_CLOUD_AGPS_INTEGRITY:
+		return sizeof(struct nrf_cloud_agps_integrity);
+	default:
+		return 0;
+	}
+}
+
+/* Length of the next element, including the type and count that precede the
+ * first element of an array, or 0 if the type of the element is not handled.
+ */
+static size_t next_agps_element_len(const char *buf)
 {
-	static uint16_t elements_left_to_process;
-	static enum nrf_cloud_agps_type element_type;
-	size_t len = 0;
+	size_t len;
+
+	if (stream.elements_left_to_process > 0) {
+		return agps_element_len(stream.element_type);
+	}
+
+	len = agps_element_len(buf[NRF_CLOUD_AGPS_BIN_TYPE_OFFSET]);
+	if (len == 0) {
+		return 0;
+	}
 
+	return len + NRF_CLOUD_AGPS_BIN_TYPE_SIZE + NRF_CLOUD_AGPS_BIN_COUNT_SIZE;
+}
+
+static int get_next_agps_element(struct nrf_cloud_apgs_element *element,
+				 const char *buf)
+{
 	/* Check if there are more elements left in the array to process.
 	 * The element type is only given once before the array, and not for
 	 * each element.
 	 */
-	if (elements_left_to_process == 0) {
+	if (stream.elements_left_to_process == 0) {
 		element->type =
 			(enum nrf_cloud_agps_type)buf[NRF_CLOUD_AGPS_BIN_TYPE_OFFSET];
-		element_type = element->type;
-		elements_left_to_process =
-			*(uint16_t *)&buf[NRF_CLOUD_AGPS_BIN_COUNT_OFFSET] - 1;
-		len += NRF_CLOUD_AGPS_BIN_TYPE_SIZE +
-			NRF_CLOUD_AGPS_BIN_COUNT_SIZE;
+		stream.element_type = element->type;
+		stream.elements_left_to_process = sys_get_le16(
+			(const uint8_t *)&buf[NRF_CLOUD_AGPS_BIN_COUNT_OFFSET]);
+		if (stream.elements_left_to_process == 0) {
+			LOG_ERR("Empty A-GPS array of type %d", element->type);
+			return -EBADMSG;
+		}
+
+		stream.elements_left_to_process -= 1;
+		buf += NRF_CLOUD_AGPS_BIN_TYPE_SIZE +
+		       NRF_CLOUD_AGPS_BIN_COUNT_SIZE;
 	} else {
-		element->type = element_type;
-		elements_left_to_process -= 1;
+		element->type = stream.element_type;
+		stream.elements_left_to_process -= 1;
 	}
 
 	switch (element->type) {
 	case NRF_CLOUD_AGPS_UTC_PARAMETERS:
-		element->utc = (struct nrf_cloud_agps_utc *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_utc);
+		element->utc = (struct nrf_cloud_agps_utc *)buf;
 		break;
 	case NRF_CLOUD_AGPS_EPHEMERIDES:
-		element->ephemeris = (struct nrf_cloud_agps_ephemeris *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_ephemeris);
+		element->ephemeris = (struct nrf_cloud_agps_ephemeris *)buf;
 		break;
 	case NRF_CLOUD_AGPS_ALMANAC:
-		element->almanac = (struct nrf_cloud_agps_almanac *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_almanac);
+		element->almanac = (struct nrf_cloud_agps_almanac *)buf;
 		break;
 	case NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION:
 		element->ion_correction.klobuchar =
-			(struct nrf_cloud_agps_klobuchar *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_klobuchar);
+			(struct nrf_cloud_agps_klobuchar *)buf;
 		break;
 	case NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK:
 		element->time_and_tow =
-			(struct nrf_cloud_agps_system_time *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_system_time) -
-			sizeof(element->time_and_tow->sv_tow) + 4;
+			(struct nrf_cloud_agps_system_time *)buf;
 		break;
 	case NRF_CLOUD_AGPS_GPS_TOWS:
-		element->tow =
-			(struct nrf_cloud_agps_tow_element *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_tow_element);
+		element->tow = (struct nrf_cloud_agps_tow_element *)buf;
 		break;
 	case NRF_CLOUD_AGPS_LOCATION:
-		element->location = (struct nrf_cloud_agps_location *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_location);
+		element->location = (struct nrf_cloud_agps_location *)buf;
 		break;
 	case NRF_CLOUD_AGPS_INTEGRITY:
-		element->integrity =
-			(struct nrf_cloud_agps_integrity *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_integrity);
+		element->integrity = (struct nrf_cloud_agps_integrity *)buf;
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+/* The satellite ID is used as an index, and is checked before the element is
+ * used.
+ */
+static int agps_element_validate(const struct nrf_cloud_apgs_element *element)
+{
+	uint8_t sv_id;
+
+	switch (element->type) {
+	case NRF_CLOUD_AGPS_EPHEMERIDES:
+		sv_id = element->ephemeris->sv_id;
+		break;
+	case NRF_CLOUD_AGPS_ALMANAC:
+		sv_id = element->almanac->sv_id;
+		break;
+	case NRF_CLOUD_AGPS_GPS_TOWS:
+		sv_id = element->tow->sv_id;
 		break;
 	default:
-		LOG_DBG("Unhandled A-GPS data type: %d", element->type);
 		return 0;
 	}
 
-	return len;
+	if ((sv_id == 0) || (sv_id > NRF_CLOUD_AGPS_MAX_SV_TOW)) {
+		LOG_ERR("Invalid satellite ID %d in A-GPS data of type %d",
+			sv_id, element->type);
+		return -EBADMSG;
+	}
+
+	return 0;
 }
 
-int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
+/* Check complete A-GPS data before any of it is injected, so that invalid data
+ * is not injected in part.
+ */
+static int agps_data_validate(const char *buf, size_t buf_len)
+{
+	int err = 0;
+	size_t len;
+	struct nrf_cloud_apgs_element element;
+
+	while (buf_len > 0) {
+		len = next_agps_element_len(buf);
+		if (len == 0) {
+			break;
+		}
+
+		if (len > buf_len) {
+			LOG_ERR("A-GPS data ends in an incomplete element");
+			err = -EBADMSG;
+			break;
+		}
+
+		err = get_next_agps_element(&element, buf);
+		if (err) {
+			break;
+		}
+
+		err = agps_element_validate(&element);
+		if (err) {
+			break;
+		}
+
+		buf += len;
+		buf_len -= len;
+	}
+
+	if (!err && (stream.elements_left_to_process > 0)) {
+		LOG_ERR("A-GPS data ends in an incomplete array");
+		err = -EBADMSG;
+	}
+
+	/* The elements are decoded again when they are injected. */
+	stream.elements_left_to_process = 0;
+
+	return err;
+}
+
+static int agps_element_process(const char *buf)
 {
 	int err;
 	struct nrf_cloud_apgs_element element = {0};
-	struct nrf_cloud_agps_system_time sys_time = {0};
-	uint32_t sv_mask = 0;
-	size_t parsed_len = 0;
-	uint8_t version;
 
+	err = get_next_agps_element(&element, buf);
+	if (err) {
+		return err;
+	}
 
-	err = k_sem_take(&agps_injection_active, K_FOREVER);
+	err = agps_element_validate(&element);
 	if (err) {
-		LOG_ERR("A-GPS injection already active.");
 		return err;
 	}
-	LOG_DBG("A-GPS_injection_active LOCKED");
 
-	version = buf[NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_INDEX];
-	parsed_len += NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE;
+	agps_stats.elements++;
 
-	if (version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) {
-		LOG_ERR("Cannot parse schema version: %d", version);
-		return -EBADMSG;
+	if (element.type == NRF_CLOUD_AGPS_GPS_TOWS) {
+		memcpy(&stream.sys_time.sv_tow[element.tow->sv_id - 1],
+			element.tow,
+			sizeof(stream.sys_time.sv_tow[0]));
+		if (element.tow->flags || element.tow->tlm) {
+			stream.sv_mask |= 1 << (element.tow->sv_id - 1);
+		}
+
+		LOG_DBG("TOW %d copied", element.tow->sv_id - 1);
+
+		return 0;
+	} else if (element.type == NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) {
+		memcpy(&stream.sys_time, element.time_and_tow,
+			sizeof(stream.sys_time) - sizeof(stream.sys_time.sv_tow));
+		stream.sys_time.sv_mask = stream.sv_mask |
+					  element.time_and_tow->sv_mask;
+		LOG_DBG("TOWs copied, bitmask: 0x%08x",
+			stream.sys_time.sv_mask);
+		element.time_and_tow = &stream.sys_time;
 	}
 
-	LOG_DBG("Received AGPS data. Schema version: %d, length: %d",
-		version, buf_len);
+	return agps_send_to_modem(&element);
+}
 
+/* Process A-GPS elements, which may be split between consecutive calls. The
+ * part of an element at the end of the buffer is kept until the rest of it is
+ * given.
+ */
+static int agps_data_process(const char *buf, size_t buf_len)
+{
+	int err;
+	size_t len;
+	size_t copy_len;
+	const char *element_buf;
+
+	while ((buf_len > 0) && !stream.finished) {
+		if (stream.partial_len > 0) {
+			len = next_agps_element_len(stream.partial);
+		} else {
+			len = next_agps_element_len(buf);
+		}
+
+		if (len == 0) {
+			LOG_DBG("Parsing finished");
+			stream.finished = true;
+			break;
+		}
+
+		if (stream.partial_len > 0) {
+			copy_len = MIN(len - stream.partial_len, buf_len);
+			memcpy(&stream.partial[stream.partial_len], buf, copy_len);
+			stream.partial_len += copy_len;
+			buf += copy_len;
+			buf_len -= copy_len;
+
+			if (stream.partial_len < len) {
+				break;
+			}
+
+			element_buf = stream.partial;
+			stream.partial_len = 0;
+		} else if (len > buf_len) {
+			memcpy(stream.partial, buf, buf_len);
+			stream.partial_len = buf_len;
+			break;
+		} else {
+			element_buf = buf;
+			buf += len;
+			buf_len -= len;
+		}
+
+		err = agps_element_process(element_buf);
+		if (err) {
+			LOG_ERR("Failed to send data to modem, error: %d", err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int agps_process_start(const int *socket)
+{
 	if (socket) {
-		LOG_DBG("Using user-provided socket, fd %d", fd);
+		LOG_DBG("Using user-provided socket, fd %d", *socket);
 
 		gps_dev = NULL;
 		fd = *socket;
@@ -708,58 +995,212 @@ int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
 		gps_dev = device_get_binding("NRF9160_GPS");
 		if (gps_dev == NULL) {
 			LOG_ERR("GPS is not enabled, A-GPS response unhandled");
-			LOG_DBG("A-GPS_inject_active UNLOCKED");
-			k_sem_give(&agps_injection_active);
 			return -ENODEV;
 		}
 	}
 
-	while (parsed_len < buf_len) {
-		size_t element_size =
-			get_next_agps_element(&element, &buf[parsed_len]);
+	memset(&stream, 0, sizeof(stream));
+	memset(&agps_stats, 0, sizeof(agps_stats));
+	stream.active = true;
 
-		if (element_size == 0) {
-			LOG_DBG("Parsing finished\n");
-			break;
-		}
+	return 0;
+}
 
-		parsed_len += element_size;
+static void agps_process_stop(void)
+{
+	if (stream.partial_len > 0) {
+		LOG_WRN("A-GPS data ends in an incomplete element");
+	}
 
-		LOG_DBG("Parsed_len: %d\n", parsed_len);
+	stream.active = false;
 
-		if (element.type == NRF_CLOUD_AGPS_GPS_TOWS) {
-			memcpy(&sys_time.sv_tow[element.tow->sv_id - 1],
-				element.tow,
-				sizeof(sys_time.sv_tow[0]));
-			if (element.tow->flags || element.tow->tlm) {
-				sv_mask |= 1 << (element.tow->sv_id - 1);
-			}
+	LOG_DBG("A-GPS_inject_active UNLOCKED");
+	k_sem_give(&agps_injection_active);
+}
+
+static int agps_schema_version_check(const char *buf)
+{
+	uint8_t version = buf[NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_INDEX];
+
+	if (version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) {
+		LOG_ERR("Cannot parse schema version: %d", version);
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
+{
+	int err;
+	uint32_t start;
+
+	if (buf_len < NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE) {
+		return -EINVAL;
+	}
+
+	err = agps_schema_version_check(buf);
+	if (err) {
+		return err;
+	}
+
+	LOG_DBG("Received AGPS data. Schema version: %d, length: %d",
+		buf[NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_INDEX], buf_len);
+
+	err = k_sem_take(&agps_injection_active, K_FOREVER);
+	if (err) {
+		LOG_ERR("A-GPS injection already active.");
+		return err;
+	}
+	LOG_DBG("A-GPS_injection_active LOCKED");
+
+	k_mutex_lock(&stream_mutex, K_FOREVER);
+
+	err = agps_process_start(socket);
+	if (err) {
+		k_mutex_unlock(&stream_mutex);
+		k_sem_give(&agps_injection_active);
+		return err;
+	}
+
+	start = k_cycle_get_32();
+
+	buf += NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE;
+	buf_len -= NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE;
+
+	err = agps_data_validate(buf, buf_len);
+	if (!err) {
+		err = agps_data_process(buf, buf_len);
+	}
+
+	agps_stats.total_cycles += k_cycle_get_32() - start;
+
+	agps_process_stop();
+
+	k_mutex_unlock(&stream_mutex);
+
+	return err;
+}
+
+int nrf_cloud_agps_process_fragment(const char *buf, size_t buf_len,
+				    size_t offset, size_t total_len,
+				    const int *socket)
+{
+	int err;
+	uint32_t start;
+	size_t skip = 0;
 
-			LOG_DBG("TOW %d copied", element.tow->sv_id - 1);
+	if ((buf_len == 0) || (offset + buf_len > total_len)) {
+		return -EINVAL;
+	}
 
-			continue;
-		} else if (element.type == NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) {
-			memcpy(&sys_time, element.time_and_tow,
-				sizeof(sys_time) - sizeof(sys_time.sv_tow));
-			sys_time.sv_mask = sv_mask | element.time_and_tow->sv_mask;
-			LOG_DBG("TOWs copied, bitmask: 0x%08x",
-				sys_time.sv_mask);
-			element.time_and_tow = &sys_time;
+	if (offset == 0) {
+		err = agps_schema_version_check(buf);
+		if (err) {
+			return err;
 		}
 
-		err = agps_send_to_modem(&element);
+		LOG_DBG("Receiving AGPS data in fragments, length: %d",
+			total_len);
+
+		/* Data that was not received to the end is replaced. */
+		nrf_cloud_agps_process_abort();
+
+		err = k_sem_take(&agps_injection_active, K_FOREVER);
 		if (err) {
-			LOG_ERR("Failed to send data to modem, error: %d", err);
-			break;
+			LOG_ERR("A-GPS injection already active.");
+			return err;
 		}
+		LOG_DBG("A-GPS_injection_active LOCKED");
 	}
 
-	LOG_DBG("A-GPS_inject_active UNLOCKED");
-	k_sem_give(&agps_injection_active);
+	k_mutex_lock(&stream_mutex, K_FOREVER);
+
+	if (offset == 0) {
+		err = agps_process_start(socket);
+		if (err) {
+			k_mutex_unlock(&stream_mutex);
+			k_sem_give(&agps_injection_active);
+			return err;
+		}
+
+		stream.fragmented = true;
+		skip = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE;
+	} else if (!stream.active || !stream.fragmented ||
+		   (offset != stream.received)) {
+		k_mutex_unlock(&stream_mutex);
+		LOG_ERR("A-GPS fragment at offset %d is out of order", offset);
+		return -EINVAL;
+	}
+
+	start = k_cycle_get_32();
+
+	err = agps_data_process(&buf[skip], buf_len - skip);
+
+	agps_stats.total_cycles += k_cycle_get_32() - start;
+	stream.received = offset + buf_len;
+	stream.fragment_time = k_uptime_get();
+
+	if (err || (stream.received == total_len)) {
+		agps_process_stop();
+		(void)k_work_cancel_delayable(&stream_timeout_work);
+	} else {
+		/* Give up on the data if the rest of it does not arrive. */
+		k_work_reschedule(&stream_timeout_work,
+				  K_SECONDS(CONFIG_NRF_CLOUD_AGPS_FRAGMENT_TIMEOUT));
+	}
+
+	k_mutex_unlock(&stream_mutex);
 
 	return err;
 }
 
+void nrf_cloud_agps_process_abort(void)
+{
+	k_mutex_lock(&stream_mutex, K_FOREVER);
+
+	if (stream.active && stream.fragmented) {
+		LOG_WRN("A-GPS data aborted after %d bytes", stream.received);
+		agps_process_stop();
+	}
+
+	k_mutex_unlock(&stream_mutex);
+
+	(void)k_work_cancel_delayable(&stream_timeout_work);
+}
+
+static void stream_timeout_work_fn(struct k_work *work)
+{
+	const int64_t timeout_ms = CONFIG_NRF_CLOUD_AGPS_FRAGMENT_TIMEOUT *
+				   MSEC_PER_SEC;
+
+	k_mutex_lock(&stream_mutex, K_FOREVER);
+
+	/* A fragment may have been received while waiting for the mutex. */
+	if (stream.active && stream.fragmented &&
+	    ((k_uptime_get() - stream.fragment_time) >= timeout_ms)) {
+		LOG_WRN("Timeout waiting for A-GPS data, %d bytes received",
+			stream.received);
+		agps_process_stop();
+	}
+
+	k_mutex_unlock(&stream_mutex);
+}
+
+void nrf_cloud_agps_stats_get(struct nrf_cloud_agps_stats *stats)
+{
+	if (stats == NULL) {
+		return;
+	}
+
+	stats->elements = agps_stats.elements;
+	stats->writes = agps_stats.writes;
+	stats->skipped = agps_stats.skipped;
+	stats->decode_time_us = k_cyc_to_us_floor32(agps_stats.total_cycles -
+						    agps_stats.inject_cycles);
+	stats->inject_time_us = k_cyc_to_us_floor32(agps_stats.inject_cycles);
+}
+
 void nrf_cloud_agps_processed(struct gps_agps_request *received_elements)
 {
 	if (received_elements) {
@@ -484,6 +484,11 @@ static int dc_rx_data_handler(const struct nct_evt *nct_evt)
 		.topic = nct_evt->param.dc->topic,
 	};
 
+	if (nct_evt->param.dc->fragment.total_len != 0) {
+		cloud_evt.type = NRF_CLOUD_EVT_RX_DATA_FRAGMENT;
+		cloud_evt.fragment = nct_evt->param.dc->fragment;
+	}
+
 	/* All data is forwared to the app */
 	nfsm_set_current_state_and_notify(nfsm_get_current_state(), &cloud_evt);
 
@@ -11,6 +11,7 @@
 #include <storage/stream_flash.h>
 #include <net/socket.h>
 #include <nrf_socket.h>
+#include <sys/crc.h>
 
 #include <cJSON.h>
 #include <cJSON_os.h>
@@ -100,6 +101,10 @@ struct pgps_index {
 
 	/* array of pointers to predictions, in sorted time order */
 	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+	/* blocks whose prediction has been verified since it was stored or
+	 * since boot
+	 */
+	bool verified[NUM_BLOCKS];
 };
 
 static struct pgps_index index;
@@ -250,6 +255,21 @@ static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
 	return err;
 }
 
+static int validate_checksum(const struct nrf_cloud_pgps_prediction *p)
+{
+	uint32_t expected_crc;
+	uint32_t stored_crc;
+
+	expected_crc = crc32_ieee((const uint8_t *)p, sizeof(*p));
+	stored_crc = *(const uint32_t *)((const uint8_t *)p + PGPS_CHECKSUM_OFFSET);
+	if (expected_crc != stored_crc) {
+		LOG_ERR("prediction at:%p has stored_crc:0x%08X, expected:0x%08X",
+			p, stored_crc, expected_crc);
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static int validate_stored_predictions(uint16_t *first_bad_day,
 				       uint32_t *first_bad_time)
 {
@@ -308,6 +328,9 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 
 		err = validate_prediction(pred, gps_day, gps_time_of_day,
 					  period_min, true, false);
+		if (!err) {
+			err = validate_checksum(pred);
+		}
 		if (err) {
 			LOG_ERR("Prediction num:%u, gps_day:%u, "
 				"gps_time_of_day:%u is bad:%d; loc:%p",
@@ -322,6 +345,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		LOG_INF("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != -1, "unexpected pointer value %p", pred);
 		npgps_mark_block_used(i, true);
+		index.verified[i] = true;
 	}
 
 	/* find first free block in flash, if any, after chronologicaly
@@ -355,6 +379,121 @@ static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_da
 	}
 }
 
+static void save_prediction_map(void)
+{
+	static struct prediction_map map;
+	int pnum;
+	int block;
+	int err;
+
+	map.start_sec = index.start_sec;
+	map.count = index.header.prediction_count;
+	for (pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		block = NO_BLOCK;
+		if ((pnum < map.count) && index.predictions[pnum]) {
+			block = npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
+		}
+		map.block[pnum] = (block == NO_BLOCK) ? NO_MAP_BLOCK : block;
+	}
+
+	err = npgps_save_prediction_map(&map);
+	if (err) {
+		LOG_ERR("Error saving prediction map:%d", err);
+	}
+}
+
+/* build catalog of predictions from the saved map, without reading them;
+ * each prediction is verified the first time it is used
+ */
+static int map_stored_predictions(const struct prediction_map *map,
+				  uint16_t *first_bad_day,
+				  uint32_t *first_bad_time)
+{
+	int i = -1;
+	int pnum;
+	uint16_t count = index.header.prediction_count;
+
+	for (pnum = 0; pnum < count; pnum++) {
+		index.predictions[pnum] = NULL;
+	}
+
+	npgps_reset_block_pool();
+
+	for (pnum = 0; pnum < count; pnum++) {
+		if (map->block[pnum] >= NUM_BLOCKS) {
+			LOG_WRN("Prediction num:%u missing", pnum);
+			get_prediction_day_time(pnum, NULL, first_bad_day, first_bad_time);
+			break;
+		}
+
+		i = map->block[pnum];
+		index.predictions[pnum] = npgps_block_to_pointer(i);
+		npgps_mark_block_used(i, true);
+	}
+
+	if (i != -1) {
+		i = npgps_find_first_free(i);
+		LOG_DBG("first free:%d", i);
+	}
+
+	npgps_print_blocks();
+	return pnum;
+}
+
+static int load_stored_predictions(uint16_t *first_bad_day,
+				   uint32_t *first_bad_time)
+{
+	const struct prediction_map *map = npgps_get_saved_prediction_map();
+	int num_valid;
+
+	if ((map->start_sec == index.start_sec) &&
+	    (map->count == index.header.prediction_count)) {
+		return map_stored_predictions(map, first_bad_day, first_bad_time);
+	}
+
+	LOG_INF("No prediction map; checking all stored predictions");
+	num_valid = validate_stored_predictions(first_bad_day, first_bad_time);
+	save_prediction_map();
+
+	return num_valid;
+}
+
+/* check a stored prediction the first time it is used; a bad prediction
+ * is freed, so that it is requested again
+ */
+static int verify_prediction(int pnum)
+{
+	struct nrf_cloud_pgps_prediction *p = index.predictions[pnum];
+	int block = npgps_pointer_to_block((uint8_t *)p);
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+	int err;
+
+	__ASSERT(block != NO_BLOCK, "unexpected pointer value %p", p);
+	if (index.verified[block]) {
+		return 0;
+	}
+
+	get_prediction_day_time(pnum, NULL, &gps_day, &gps_time_of_day);
+	err = validate_prediction(p, gps_day, gps_time_of_day,
+				  index.header.prediction_period_min, true, false);
+	if (!err) {
+		err = validate_checksum(p);
+	}
+	if (err) {
+		LOG_ERR("Prediction num:%u, loc:%p is bad:%d", pnum, p, err);
+		/* a prediction being loaded may not be written to flash yet */
+		if (!nrf_cloud_pgps_loading()) {
+			index.predictions[pnum] = NULL;
+			npgps_free_block(block);
+		}
+		return err;
+	}
+
+	index.verified[block] = true;
+	return 0;
+}
+
 static void discard_oldest_predictions(int num)
 {
 	int i;
@@ -397,6 +536,9 @@ static void discard_oldest_predictions(int num)
 	LOG_DBG("updated index to gps_sec:%lld, day:%u, time:%u",
 		index.start_sec, index.header.gps_day,
 		index.header.gps_time_of_day);
+
+	npgps_save_header(&index.header);
+	save_prediction_map();
 }
 
 int nrf_cloud_pgps_notify_prediction(void)
@@ -586,6 +728,9 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	LOG_INF("Selected prediction num:%d", pnum);
 	index.cur_pnum = pnum;
 	*prediction = index.predictions[pnum];
+	if (*prediction && verify_prediction(pnum)) {
+		*prediction = NULL;
+	}
 	if (*prediction) {
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
@@ -1040,16 +1185,23 @@ static int open_storage(uint32_t offset, bool preserve)
 static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
 {
 	static bool first = true;
-	static uint8_t pad[PGPS_PREDICTION_PAD];
+	static uint8_t pad[PGPS_PREDICTION_PAD - PGPS_CHECKSUM_SIZE];
 	int err;
 	uint8_t schema = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
 	size_t schema_offset = ((size_t) &((struct nrf_cloud_pgps_prediction *)0)->schema_version);
+	uint32_t crc;
 
 	if (first) {
-		memset(pad, 0xff, PGPS_PREDICTION_PAD);
+		memset(pad, 0xff, sizeof(pad));
 		first = false;
 	}
 
+	/* checksum of the prediction as it is laid out in flash */
+	crc = crc32_ieee_update(0, p, schema_offset);
+	crc = crc32_ieee_update(crc, &schema, sizeof(schema));
+	crc = crc32_ieee_update(crc, p + schema_offset, len - schema_offset);
+	crc = crc32_ieee_update(crc, (uint8_t *)&sentinel, sizeof(sentinel));
+
 	err = stream_flash_buffered_write(&stream, p, schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
@@ -1072,9 +1224,13 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 	if (err) {
 		LOG_ERR("Error writing sentinel:%d", err);
 	}
-	err = stream_flash_buffered_write(&stream, pad, PGPS_PREDICTION_PAD, last);
+	err = stream_flash_buffered_write(&stream, pad, sizeof(pad), false);
 	if (err) {
-		LOG_ERR("Error writing sentinel:%d", err);
+		LOG_ERR("Error writing pad:%d", err);
+	}
+	err = stream_flash_buffered_write(&stream, (uint8_t *)&crc, sizeof(crc), last);
+	if (err) {
+		LOG_ERR("Error writing checksum:%d", err);
 	}
 	return err;
 }
@@ -1133,6 +1289,7 @@ static int process_buffer(uint8_t *buf, size_t len)
 		}
 		log_pgps_header("pgps_header: ", header);
 		npgps_save_header(header);
+		save_prediction_map();
 
 		len -= sizeof(*header);
 		buf += sizeof(*header);
@@ -1316,6 +1473,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
 					 finished || (index.storage_extent == 1));
 			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
+			index.verified[index.store_block] = false;
 
 			if (pgps_need_assistance &&
 			    (finished || (index.loading_count > 1))) {
@@ -1328,6 +1486,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 				}
 			} else {
 				LOG_INF("All P-GPS data received. Done.");
+				save_prediction_map();
 				state = PGPS_READY;
 				if (handler) {
 					handler(PGPS_EVT_READY, NULL);
@@ -1597,7 +1756,7 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		 */
 		LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
 			count, period_min);
-		num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		num_valid = load_stored_predictions(&gps_day, &gps_time_of_day);
 	}
 
 	struct nrf_cloud_pgps_prediction *test_prediction;
@@ -5,7 +5,6 @@
  */
 
 #include <zephyr.h>
-#include <pm_config.h>
 #include <stdlib.h>
 
 #include <net/nrf_cloud_pgps.h>
@@ -24,6 +23,8 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_NAME				"nrf_cloud_pgps"
 #define SETTINGS_KEY_PGPS_HEADER		"pgps_header"
 #define SETTINGS_FULL_PGPS_HEADER		SETTINGS_NAME "/" SETTINGS_KEY_PGPS_HEADER
+#define SETTINGS_KEY_PREDICTION_MAP		"pred_map"
+#define SETTINGS_FULL_PREDICTION_MAP		SETTINGS_NAME "/" SETTINGS_KEY_PREDICTION_MAP
 #define SETTINGS_KEY_LOCATION			"location"
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
@@ -43,6 +44,7 @@ static int num_blocks;
 static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
+static struct prediction_map saved_map;
 
 static K_SEM_DEFINE(pgps_active, 1, 1);
 static struct download_client dlc;
@@ -76,6 +78,15 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+	if (!strncmp(key, SETTINGS_KEY_PREDICTION_MAP,
+		     strlen(SETTINGS_KEY_PREDICTION_MAP)) &&
+	    (len_rd == sizeof(saved_map))) {
+		if (read_cb(cb_arg, (void *)&saved_map, len_rd) == len_rd) {
+			LOG_DBG("Read prediction map: count:%u, gps sec:%lld",
+				saved_map.count, saved_map.start_sec);
+			return 0;
+		}
+	}
 	if (!strncmp(key, SETTINGS_KEY_LOCATION,
 		     strlen(SETTINGS_KEY_LOCATION)) &&
 	    (len_rd == sizeof(saved_location))) {
@@ -112,6 +123,21 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+int npgps_save_prediction_map(const struct prediction_map *map)
+{
+	int ret = 0;
+
+	LOG_DBG("Saving prediction map");
+	memcpy(&saved_map, map, sizeof(saved_map));
+	ret = settings_save_one(SETTINGS_FULL_PREDICTION_MAP, map, sizeof(*map));
+	return ret;
+}
+
+const struct prediction_map *npgps_get_saved_prediction_map(void)
+{
+	return &saved_map;
+}
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
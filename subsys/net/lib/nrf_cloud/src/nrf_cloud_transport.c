@@ -742,20 +742,71 @@ int nct_mqtt_connect(void)
 	return err;
 }
 
-static int publish_get_payload(struct mqtt_client *client, size_t length)
+/* Read the payload of a received message. The payload is read into the payload
+ * buffer if it fits, otherwise into a buffer that is allocated for it and must be
+ * freed by the caller.
+ */
+static int publish_get_payload(struct mqtt_client *client, size_t length,
+			       uint8_t **payload)
 {
+	*payload = nct.payload_buf;
+
 	if (length > (sizeof(nct.payload_buf) - 1)) {
-		return -EMSGSIZE;
+		if (!IS_ENABLED(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS)) {
+			return -EMSGSIZE;
+		}
+
+		*payload = nrf_cloud_malloc(length + 1);
+		if (*payload == NULL) {
+			return -ENOMEM;
+		}
 	}
 
-	int ret = mqtt_readall_publish_payload(client, nct.payload_buf, length);
+	int ret = mqtt_readall_publish_payload(client, *payload, length);
 
 	/* Ensure buffer is always NULL-terminated */
-	nct.payload_buf[length] = 0;
+	(*payload)[length] = 0;
 
 	return ret;
 }
 
+/* Read a data channel payload that is larger than the payload buffer in
+ * fragments the size of the buffer, and notify each fragment as it is read.
+ */
+static int publish_get_payload_fragments(struct mqtt_client *client,
+					 struct nct_dc_data *dc)
+{
+	int err;
+	size_t len;
+	const size_t total_len = dc->fragment.total_len;
+	struct nct_evt evt = {
+		.type = NCT_EVT_DC_RX_DATA,
+		.param.dc = dc,
+	};
+
+	for (size_t offset = 0; offset < total_len; offset += len) {
+		len = MIN(total_len - offset, sizeof(nct.payload_buf) - 1);
+
+		err = mqtt_readall_publish_payload(client, nct.payload_buf, len);
+		if (err) {
+			return err;
+		}
+
+		nct.payload_buf[len] = 0;
+
+		dc->data.ptr = nct.payload_buf;
+		dc->data.len = len;
+		dc->fragment.offset = offset;
+
+		err = nct_input(&evt);
+		if (err) {
+			LOG_ERR("nct_input: failed %d", err);
+		}
+	}
+
+	return 0;
+}
+
 /* Handle MQTT events. */
 static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 				 const struct mqtt_evt *_mqtt_evt)
@@ -764,6 +815,7 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 	struct nct_evt evt = { .status = _mqtt_evt->result };
 	struct nct_cc_data cc;
 	struct nct_dc_data dc;
+	uint8_t *payload = NULL;
 	bool event_notify = false;
 
 #if defined(CONFIG_NRF_CLOUD_FOTA)
@@ -801,8 +853,26 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			p->message_id,
 			p->message.payload.len);
 
-		int err = publish_get_payload(mqtt_client,
-					      p->message.payload.len);
+		const bool cc_topic =
+			control_channel_topic_match(NCT_RX_LIST,
+						    &p->message.topic,
+						    &cc.opcode);
+
+		if (!cc_topic &&
+		    IS_ENABLED(CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS) &&
+		    (p->message.payload.len > (sizeof(nct.payload_buf) - 1))) {
+			dc.id = p->message_id;
+			dc.topic.len = p->message.topic.topic.size;
+			dc.topic.ptr = p->message.topic.topic.utf8;
+			dc.fragment.total_len = p->message.payload.len;
+
+			/* The fragments are notified as they are read. */
+			err = publish_get_payload_fragments(mqtt_client, &dc);
+		} else {
+			err = publish_get_payload(mqtt_client,
+						  p->message.payload.len,
+						  &payload);
+		}
 
 		if (err < 0) {
 			LOG_ERR("publish_get_payload: failed %d", err);
@@ -814,10 +884,9 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 		/* If the data arrives on one of the subscribed control channel
 		 * topic. Then we notify the same.
 		 */
-		if (control_channel_topic_match(NCT_RX_LIST, &p->message.topic,
-						&cc.opcode)) {
+		if (cc_topic) {
 			cc.id = p->message_id;
-			cc.data.ptr = nct.payload_buf;
+			cc.data.ptr = payload;
 			cc.data.len = p->message.payload.len;
 			cc.topic.len = p->message.topic.topic.size;
 			cc.topic.ptr = p->message.topic.topic.utf8;
@@ -825,13 +894,15 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			evt.type = NCT_EVT_CC_RX_DATA;
 			evt.param.cc = &cc;
 			event_notify = true;
-		} else {
+		} else if (payload != NULL) {
 			/* Try to match it with one of the data topics. */
 			dc.id = p->message_id;
-			dc.data.ptr = nct.payload_buf;
+			dc.data.ptr = payload;
 			dc.data.len = p->message.payload.len;
 			dc.topic.len = p->message.topic.topic.size;
 			dc.topic.ptr = p->message.topic.topic.utf8;
+			dc.fragment.offset = 0;
+			dc.fragment.total_len = 0;
 
 			evt.type = NCT_EVT_DC_RX_DATA;
 			evt.param.dc = &dc;
@@ -911,6 +982,11 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			LOG_ERR("nct_input: failed %d", err);
 		}
 	}
+
+	if ((payload != NULL) && (payload != nct.payload_buf)) {
+		/* Allocated for a payload larger than the payload buffer. */
+		nrf_cloud_free(payload);
+	}
 }
 
 int nct_init(const char * const client_id)
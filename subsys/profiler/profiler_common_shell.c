@@ -10,6 +10,10 @@
 #include <shell/shell_rtt.h>
 #include <profiler.h>
 
+#ifdef CONFIG_PROFILER_NORDIC_RING
+#include "profiler_nordic_ring.h"
+#endif
+
 uint32_t profiler_enabled_events;
 
 static int display_registered_events(const struct shell *shell, size_t argc,
@@ -106,6 +110,23 @@ static int disable_event_profiling(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#ifdef CONFIG_PROFILER_NORDIC_RING
+static int display_ring_stats(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	struct profiler_nordic_ring_stats stats;
+
+	profiler_nordic_ring_stats_get(&stats);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Stored: %u\nDropped: %u\nMax used: %u/%u\n",
+		      stats.stored, stats.dropped, stats.max_used,
+		      CONFIG_PROFILER_NORDIC_RING_RECORD_CNT);
+
+	return 0;
+}
+#endif /* CONFIG_PROFILER_NORDIC_RING */
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
 	SHELL_CMD_ARG(list, NULL, "Display list of events",
 			display_registered_events, 0, 0),
@@ -115,6 +136,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
 	SHELL_CMD_ARG(disable, NULL, "Disable profiling of event with given ID",
 			disable_event_profiling, 1,
 			sizeof(profiler_enabled_events) * 8),
+	SHELL_COND_CMD_ARG(CONFIG_PROFILER_NORDIC_RING, stats, NULL,
+			"Display ring buffer statistics",
+			display_ring_stats, 0, 0),
 	SHELL_SUBCMD_SET_END
 );
 SHELL_CMD_REGISTER(profiler, &sub_profiler, "Profiler commands", NULL);
@@ -10,10 +10,20 @@
 #include <sys/util.h>
 #include <sys/byteorder.h>
 #include <zephyr.h>
-#include <SEGGER_RTT.h>
 #include <profiler.h>
 #include <string.h>
+
+#ifdef CONFIG_PROFILER_NORDIC_RTT
+#include <SEGGER_RTT.h>
+#endif
+
+#ifdef CONFIG_HAS_NRFX
 #include <nrfx.h>
+#else
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#include "profiler_nordic_ring.h"
 
 
 /* By default, when there is no shell, all events are profiled. */
@@ -22,7 +32,6 @@ uint32_t profiler_enabled_events = 0xffffffff;
 #endif
 
 
-static K_SEM_DEFINE(profiler_sem, 0, 1);
 static bool protocol_running;
 static bool sending_events;
 
@@ -47,6 +56,9 @@ static char *arg_types_encodings[] = {
 
 uint8_t profiler_num_events;
 
+#ifdef CONFIG_PROFILER_NORDIC_RTT
+static K_SEM_DEFINE(profiler_sem, 0, 1);
+
 static uint8_t buffer_data[CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE];
 static uint8_t buffer_info[CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE];
 static uint8_t buffer_commands[CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
@@ -141,12 +153,8 @@ static void profiler_nordic_thread_fn(void)
 	k_sem_give(&profiler_sem);
 }
 
-int profiler_init(void)
+static void rtt_init(void)
 {
-	protocol_running = true;
-	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START)) {
-		sending_events = true;
-	}
 	int ret;
 
 	ret = SEGGER_RTT_ConfigUpBuffer(
@@ -179,6 +187,30 @@ int profiler_init(void)
 			(k_thread_entry_t) profiler_nordic_thread_fn,
 			NULL, NULL, NULL,
 			CONFIG_PROFILER_NORDIC_THREAD_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void rtt_term(void)
+{
+	k_wakeup(protocol_thread_id);
+	k_sem_take(&profiler_sem, K_FOREVER);
+}
+#endif /* CONFIG_PROFILER_NORDIC_RTT */
+
+int profiler_init(void)
+{
+	protocol_running = true;
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START)) {
+		sending_events = true;
+	}
+
+#ifdef CONFIG_PROFILER_NORDIC_RTT
+	rtt_init();
+#endif
+
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING)) {
+		return profiler_nordic_ring_init();
+	}
+
 	return 0;
 }
 
@@ -186,8 +218,14 @@ void profiler_term(void)
 {
 	sending_events = false;
 	protocol_running = false;
-	k_wakeup(protocol_thread_id);
-	k_sem_take(&profiler_sem, K_FOREVER);
+
+#ifdef CONFIG_PROFILER_NORDIC_RTT
+	rtt_term();
+#endif
+
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING)) {
+		profiler_nordic_ring_term();
+	}
 }
 
 const char *profiler_get_event_descr(size_t profiler_event_id)
@@ -270,6 +308,14 @@ void profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
 		uint8_t type_id = event_type_id & UCHAR_MAX;
 
 		buf->payload_start[0] = type_id;
+
+		if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING)) {
+			profiler_nordic_ring_put(buf->payload_start,
+						 buf->payload - buf->payload_start);
+			return;
+		}
+
+#ifdef CONFIG_PROFILER_NORDIC_RTT
 		int key = irq_lock();
 
 		uint8_t num_bytes_send = SEGGER_RTT_WriteNoLock(
@@ -279,5 +325,6 @@ void profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
 		ARG_UNUSED(num_bytes_send);
 		irq_unlock(key);
 		__ASSERT_NO_MSG(num_bytes_send > 0);
+#endif /* CONFIG_PROFILER_NORDIC_RTT */
 	}
 }
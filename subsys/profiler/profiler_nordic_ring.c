@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <kernel_structs.h>
+#include <string.h>
+#include <profiler.h>
+
+#if defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_RTT)
+#include <SEGGER_RTT.h>
+#elif defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_UART)
+#include <drivers/uart.h>
+#elif defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_FILE)
+#include <stdio.h>
+#endif
+
+#include "profiler_nordic_ring.h"
+
+#define RECORD_CNT	CONFIG_PROFILER_NORDIC_RING_RECORD_CNT
+#define RECORD_MASK	(RECORD_CNT - 1)
+
+BUILD_ASSERT((RECORD_CNT & RECORD_MASK) == 0,
+	     "Number of records must be a power of two");
+BUILD_ASSERT(CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN <= UINT8_MAX,
+	     "Event buffer too long for a ring buffer record");
+
+/* Fixed-size record holding one encoded event. */
+struct record {
+	uint8_t len;
+	uint8_t data[CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN];
+};
+
+/* Single producer, single consumer ring buffer. Producers on a given CPU
+ * are serialized by locking interrupts on that CPU only. The drain thread
+ * is the only consumer. Indexes are free running and wrap on overflow.
+ */
+struct ring {
+	/* Index of the next record to write. Written only by producers. */
+	uint32_t head;
+
+	/* Index of the next record to read. Written only by the consumer. */
+	uint32_t tail;
+
+	uint32_t stored;
+	uint32_t dropped;
+	uint32_t max_used;
+
+	struct record records[RECORD_CNT];
+};
+
+static struct ring rings[CONFIG_MP_NUM_CPUS];
+
+static bool draining;
+static K_SEM_DEFINE(drain_done_sem, 0, 1);
+static K_THREAD_STACK_DEFINE(drain_stack,
+			     CONFIG_PROFILER_NORDIC_RING_STACK_SIZE);
+static struct k_thread drain_thread;
+
+#if defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_RTT)
+static int transport_init(void)
+{
+	/* RTT data up channel is configured by the Nordic profiler. */
+	return 0;
+}
+
+static int transport_write(const uint8_t *data, size_t len)
+{
+	unsigned int written = SEGGER_RTT_Write(
+				CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+				data, len);
+
+	/* Host did not read the data yet. */
+	return (written == len) ? 0 : -EAGAIN;
+}
+
+static void transport_flush(void)
+{
+}
+
+static void transport_term(void)
+{
+}
+
+#elif defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_UART)
+static const struct device *uart_dev;
+
+static int transport_init(void)
+{
+	uart_dev = device_get_binding(CONFIG_PROFILER_NORDIC_RING_UART_DEV_NAME);
+
+	return uart_dev ? 0 : -ENODEV;
+}
+
+static int transport_write(const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+	}
+
+	return 0;
+}
+
+static void transport_flush(void)
+{
+}
+
+static void transport_term(void)
+{
+}
+
+#elif defined(CONFIG_PROFILER_NORDIC_RING_TRANSPORT_FILE)
+static FILE *data_file;
+static FILE *info_file;
+static size_t described_events;
+
+static int transport_init(void)
+{
+	data_file = fopen(CONFIG_PROFILER_NORDIC_RING_DATA_FILE, "wb");
+	info_file = fopen(CONFIG_PROFILER_NORDIC_RING_INFO_FILE, "w");
+
+	if (!data_file || !info_file) {
+		printk("Cannot open profiler files\n");
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int transport_write(const uint8_t *data, size_t len)
+{
+	return (fwrite(data, 1, len, data_file) == len) ? 0 : -EIO;
+}
+
+static void transport_flush(void)
+{
+	/* Event types can be registered at any time. */
+	while (described_events < profiler_num_events) {
+		fprintf(info_file, "%s\n",
+			profiler_get_event_descr(described_events));
+		described_events++;
+	}
+
+	fflush(info_file);
+	fflush(data_file);
+}
+
+static void transport_term(void)
+{
+	/* Empty line ends the description as in the RTT info channel. */
+	fprintf(info_file, "\n");
+	fclose(info_file);
+	fclose(data_file);
+}
+#endif
+
+static void drain_ring(struct ring *ring)
+{
+	uint32_t tail = ring->tail;
+	uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	while (tail != head) {
+		const struct record *rec = &ring->records[tail & RECORD_MASK];
+
+		if (transport_write(rec->data, rec->len)) {
+			/* Retry in the next drain period. */
+			break;
+		}
+
+		tail++;
+		__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+	}
+}
+
+static void drain_all(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(rings); i++) {
+		drain_ring(&rings[i]);
+	}
+
+	transport_flush();
+}
+
+static void drain_thread_fn(void)
+{
+	int err = transport_init();
+
+	if (err) {
+		k_sem_give(&drain_done_sem);
+		return;
+	}
+
+	while (draining) {
+		drain_all();
+		k_sleep(K_MSEC(CONFIG_PROFILER_NORDIC_RING_DRAIN_PERIOD_MS));
+	}
+
+	drain_all();
+	transport_term();
+
+	k_sem_give(&drain_done_sem);
+}
+
+void profiler_nordic_ring_put(const uint8_t *data, size_t len)
+{
+	__ASSERT_NO_MSG(len <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
+
+	unsigned int key = arch_irq_lock();
+	struct ring *ring = &rings[_current_cpu->id];
+	uint32_t head = ring->head;
+	uint32_t used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	if (used < RECORD_CNT) {
+		struct record *rec = &ring->records[head & RECORD_MASK];
+
+		rec->len = len;
+		memcpy(rec->data, data, len);
+		__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+		ring->stored++;
+		ring->max_used = MAX(ring->max_used, used + 1);
+	} else {
+		ring->dropped++;
+	}
+
+	arch_irq_unlock(key);
+}
+
+void profiler_nordic_ring_stats_get(struct profiler_nordic_ring_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	for (size_t i = 0; i < ARRAY_SIZE(rings); i++) {
+		stats->stored += rings[i].stored;
+		stats->dropped += rings[i].dropped;
+		stats->max_used = MAX(stats->max_used, rings[i].max_used);
+	}
+}
+
+int profiler_nordic_ring_init(void)
+{
+	draining = true;
+
+	k_thread_create(&drain_thread, drain_stack,
+			K_THREAD_STACK_SIZEOF(drain_stack),
+			(k_thread_entry_t)drain_thread_fn,
+			NULL, NULL, NULL,
+			CONFIG_PROFILER_NORDIC_RING_THREAD_PRIORITY, 0,
+			K_NO_WAIT);
+	k_thread_name_set(&drain_thread, "profiler_drain");
+
+	return 0;
+}
+
+void profiler_nordic_ring_term(void)
+{
+	draining = false;
+	k_wakeup(&drain_thread);
+	k_sem_take(&drain_done_sem, K_FOREVER);
+}
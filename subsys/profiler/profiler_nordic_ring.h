@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Nordic profiler ring buffer backend private header. */
+
+#ifndef _PROFILER_NORDIC_RING_H_
+#define _PROFILER_NORDIC_RING_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Ring buffer statistics. */
+struct profiler_nordic_ring_stats {
+	/* Number of records stored in the ring buffers. */
+	uint32_t stored;
+
+	/* Number of records dropped because the ring buffers were full. */
+	uint32_t dropped;
+
+	/* Maximum number of records waiting in a ring buffer. */
+	uint32_t max_used;
+};
+
+
+/* Initialize the ring buffers and start the drain thread. */
+int profiler_nordic_ring_init(void);
+
+/* Flush the ring buffers and stop the drain thread. */
+void profiler_nordic_ring_term(void);
+
+/* Store an encoded event in the ring buffer of the current CPU.
+ * Can be called from any context.
+ */
+void profiler_nordic_ring_put(const uint8_t *data, size_t len);
+
+/* Get the ring buffer statistics summed up for all CPUs. */
+void profiler_nordic_ring_stats_get(struct profiler_nordic_ring_stats *stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_NORDIC_RING_H_ */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <modem/nrf_modem_lib.h>
+#include <nrf_modem_limits.h>
+
+#include "at_socket_mock.h"
+
+#define RESPONSE_MAX_LEN 64
+
+struct response {
+	bool shutdown;
+	int64_t ready_ms;
+	size_t len;
+	char data[RESPONSE_MAX_LEN];
+};
+
+K_MSGQ_DEFINE(responses, sizeof(struct response), 32, 4);
+K_SEM_DEFINE(modem_init_sem, 0, 1);
+
+static int64_t last_ready_ms;
+static atomic_t sent_cnt;
+
+int at_mock_socket(int family, int type, int proto)
+{
+	return 1;
+}
+
+int at_mock_close(int sock)
+{
+	return 0;
+}
+
+ssize_t at_mock_send(int sock, const void *buf, size_t len, int flags)
+{
+	struct response resp;
+	char cmd[RESPONSE_MAX_LEN / 2];
+	int64_t now = k_uptime_get();
+
+	len = MIN(len, sizeof(cmd) - 1);
+	memcpy(cmd, buf, len);
+	cmd[len] = '\0';
+
+	/* Commands are transported to the modem in parallel, but processed
+	 * one by one.
+	 */
+	resp.shutdown = false;
+	resp.ready_ms = MAX(now + AT_MOCK_TRANSPORT_MS,
+			    last_ready_ms + AT_MOCK_PROCESSING_MS);
+	last_ready_ms = resp.ready_ms;
+
+	if (!strcmp(cmd, AT_MOCK_FAIL_CMD)) {
+		resp.len = snprintf(resp.data, sizeof(resp.data), "ERROR\r\n");
+	} else if (!strncmp(cmd, AT_MOCK_ECHO_CMD, strlen(AT_MOCK_ECHO_CMD))) {
+		resp.len = snprintf(resp.data, sizeof(resp.data),
+				    "%s\r\nOK\r\n",
+				    cmd + strlen(AT_MOCK_ECHO_CMD));
+	} else {
+		resp.len = snprintf(resp.data, sizeof(resp.data), "OK\r\n");
+	}
+	/* Responses include the termination character. */
+	resp.len++;
+
+	atomic_inc(&sent_cnt);
+	k_msgq_put(&responses, &resp, K_FOREVER);
+
+	return len;
+}
+
+ssize_t at_mock_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	struct response resp;
+	int64_t now;
+
+	k_msgq_get(&responses, &resp, K_FOREVER);
+
+	if (resp.shutdown) {
+		errno = EHOSTDOWN;
+		return -1;
+	}
+
+	now = k_uptime_get();
+	if (resp.ready_ms > now) {
+		k_sleep(K_MSEC(resp.ready_ms - now));
+	}
+
+	if (resp.len > max_len) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+	memcpy(buf, resp.data, resp.len);
+
+	return resp.len;
+}
+
+void nrf_modem_lib_shutdown_wait(void)
+{
+	k_sem_take(&modem_init_sem, K_FOREVER);
+}
+
+void at_mock_shutdown(void)
+{
+	struct response resp = {
+		.shutdown = true,
+	};
+
+	/* Responses not received yet are lost with the modem. */
+	k_msgq_purge(&responses);
+	k_msgq_put(&responses, &resp, K_FOREVER);
+}
+
+void at_mock_init(void)
+{
+	/* Drop responses to commands written before the shutdown was
+	 * noticed.
+	 */
+	k_msgq_purge(&responses);
+	last_ready_ms = 0;
+	k_sem_give(&modem_init_sem);
+}
+
+size_t at_mock_sent_cnt(void)
+{
+	return atomic_get(&sent_cnt);
+}
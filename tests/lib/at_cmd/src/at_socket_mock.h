@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef AT_SOCKET_MOCK_H_
+#define AT_SOCKET_MOCK_H_
+
+#include <stddef.h>
+
+/* Time between writing a command and the modem starting to process it. */
+#define AT_MOCK_TRANSPORT_MS	2
+
+/* Time the modem spends processing a single command. */
+#define AT_MOCK_PROCESSING_MS	1
+
+/* Command answered with ERROR. */
+#define AT_MOCK_FAIL_CMD	"AT+FAIL"
+
+/* Command prefix answered with the rest of the command followed by OK. */
+#define AT_MOCK_ECHO_CMD	"AT+ECHO="
+
+/* Return the number of commands written to the mocked AT socket. */
+size_t at_mock_sent_cnt(void);
+
+/* Shut the modem down; the pending responses are never received. */
+void at_mock_shutdown(void);
+
+/* Initialize the modem again after at_mock_shutdown(). */
+void at_mock_init(void);
+
+#endif /* AT_SOCKET_MOCK_H_ */
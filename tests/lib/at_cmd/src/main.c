@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Test measuring the time needed to execute an initialization sequence of
+ * AT commands against a mocked AT socket, issued one by one with
+ * at_cmd_write() and at once with at_cmd_write_batch(). The test is built
+ * with different values of CONFIG_AT_CMD_PIPELINE_DEPTH (see testcase.yaml).
+ * It also checks that a modem shutdown completes all pending commands.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <modem/at_cmd.h>
+
+#include "at_socket_mock.h"
+
+#define INIT_SEQ_LEN	20
+#define TXN_LEN		8
+#define TXN_FAIL_IDX	1
+
+static atomic_t completed_cnt;
+
+static void async_handler(struct at_cmd_async *req, const char *response)
+{
+	atomic_inc(&completed_cnt);
+}
+
+static void test_init(void)
+{
+	zassert_equal(at_cmd_init(), 0, "Error when initializing");
+}
+
+static void test_init_sequence(void)
+{
+	static struct at_cmd_async reqs[INIT_SEQ_LEN];
+	int64_t start;
+	int64_t sync_ms;
+	int64_t batch_ms;
+	int err;
+
+	start = k_uptime_get();
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		err = at_cmd_write("AT+CFUN?", NULL, 0, NULL);
+		zassert_equal(err, 0, "Command failed");
+	}
+	sync_ms = k_uptime_get() - start;
+
+	atomic_set(&completed_cnt, 0);
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		reqs[i] = (struct at_cmd_async) {
+			.cmd = "AT+CFUN?",
+			.handler = async_handler,
+		};
+	}
+
+	start = k_uptime_get();
+	err = at_cmd_write_batch(reqs, ARRAY_SIZE(reqs), false);
+	zassert_equal(err, 0, "Cannot queue commands");
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		err = at_cmd_async_wait(&reqs[i], K_SECONDS(5), NULL);
+		zassert_equal(err, 0, "Command failed");
+	}
+	batch_ms = k_uptime_get() - start;
+
+	zassert_equal(atomic_get(&completed_cnt), INIT_SEQ_LEN,
+		      "Handler not called for every command");
+
+	TC_PRINT("%d commands (pipeline depth %d): sync %lld ms, batch %lld ms\n",
+		 INIT_SEQ_LEN, CONFIG_AT_CMD_PIPELINE_DEPTH, sync_ms, batch_ms);
+
+	zassert_true(batch_ms <= sync_ms, "Batch slower than sync calls");
+	if (CONFIG_AT_CMD_PIPELINE_DEPTH > 1) {
+		/* Transport delay is paid once, not for every command. */
+		zassert_true(batch_ms <= AT_MOCK_TRANSPORT_MS +
+			     INIT_SEQ_LEN * AT_MOCK_PROCESSING_MS + 1,
+			     "Commands not pipelined");
+	}
+}
+
+static void test_response_correlation(void)
+{
+	static struct at_cmd_async reqs[INIT_SEQ_LEN];
+	static char resp[INIT_SEQ_LEN][16];
+	static char cmd[INIT_SEQ_LEN][16];
+	int err;
+
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		snprintf(cmd[i], sizeof(cmd[i]), AT_MOCK_ECHO_CMD "%d", (int)i);
+		reqs[i] = (struct at_cmd_async) {
+			.cmd = cmd[i],
+			.resp = resp[i],
+			.resp_size = sizeof(resp[i]),
+		};
+	}
+
+	err = at_cmd_write_batch(reqs, ARRAY_SIZE(reqs), false);
+	zassert_equal(err, 0, "Cannot queue commands");
+
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		char expected[16];
+		enum at_cmd_state state;
+
+		err = at_cmd_async_wait(&reqs[i], K_SECONDS(5), &state);
+		zassert_equal(err, 0, "Command failed");
+		zassert_equal(state, AT_CMD_OK, "Invalid state");
+
+		snprintf(expected, sizeof(expected), "%d\r\n", (int)i);
+		zassert_equal(strcmp(resp[i], expected), 0,
+			      "Response does not match the command");
+	}
+}
+
+static void test_transaction_abort(void)
+{
+	static struct at_cmd_async reqs[TXN_LEN];
+	size_t sent_before = at_mock_sent_cnt();
+	enum at_cmd_state state;
+	int err;
+
+	BUILD_ASSERT(TXN_FAIL_IDX + CONFIG_AT_CMD_PIPELINE_DEPTH < TXN_LEN - 1,
+		     "Transaction too short for the pipeline depth");
+
+	for (size_t i = 0; i < TXN_LEN; i++) {
+		reqs[i] = (struct at_cmd_async) {
+			.cmd = (i == TXN_FAIL_IDX) ? AT_MOCK_FAIL_CMD :
+						     "AT+CFUN?",
+		};
+	}
+
+	err = at_cmd_write_batch(reqs, ARRAY_SIZE(reqs), true);
+	zassert_equal(err, 0, "Cannot queue commands");
+
+	for (size_t i = 0; i < TXN_LEN; i++) {
+		err = at_cmd_async_wait(&reqs[i], K_SECONDS(5), &state);
+
+		if (i < TXN_FAIL_IDX) {
+			zassert_equal(err, 0, "Command failed");
+		} else if (i == TXN_FAIL_IDX) {
+			zassert_equal(err, -ENOEXEC, "Command did not fail");
+			zassert_equal(state, AT_CMD_ERROR, "Invalid state");
+		} else if (i >= TXN_FAIL_IDX + CONFIG_AT_CMD_PIPELINE_DEPTH) {
+			/* Commands already written before the failure are
+			 * still executed.
+			 */
+			zassert_equal(err, -ECANCELED,
+				      "Command not cancelled");
+			zassert_equal(state, AT_CMD_ERROR_QUEUE,
+				      "Invalid state");
+		}
+	}
+
+	zassert_equal(at_mock_sent_cnt() - sent_before,
+		      TXN_FAIL_IDX + CONFIG_AT_CMD_PIPELINE_DEPTH,
+		      "Invalid number of commands sent");
+
+	/* Commands queued after the transaction are executed. */
+	err = at_cmd_write("AT+CFUN?", NULL, 0, NULL);
+	zassert_equal(err, 0, "Command after transaction failed");
+}
+
+static void test_shutdown(void)
+{
+	static struct at_cmd_async reqs[INIT_SEQ_LEN];
+	int err;
+
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		reqs[i] = (struct at_cmd_async) {
+			.cmd = "AT+CFUN?",
+		};
+	}
+
+	err = at_cmd_write_batch(reqs, ARRAY_SIZE(reqs), false);
+	zassert_equal(err, 0, "Cannot queue commands");
+
+	at_mock_shutdown();
+
+	/* Every request completes, the ones not executed with -EHOSTDOWN. */
+	for (size_t i = 0; i < INIT_SEQ_LEN; i++) {
+		err = at_cmd_async_wait(&reqs[i], K_SECONDS(5), NULL);
+		zassert_not_equal(err, -EAGAIN, "Command not completed");
+		zassert_true((err == 0) || (err == -EHOSTDOWN),
+			     "Invalid result %d", err);
+	}
+	zassert_equal(reqs[INIT_SEQ_LEN - 1].code, -EHOSTDOWN,
+		      "Batch not aborted");
+
+	err = at_cmd_write("AT+CFUN?", NULL, 0, NULL);
+	zassert_equal(err, -EHOSTDOWN, "Command accepted during shutdown");
+
+	at_mock_init();
+
+	/* Let the socket thread open the socket again. */
+	k_sleep(K_MSEC(10));
+
+	err = at_cmd_write("AT+CFUN?", NULL, 0, NULL);
+	zassert_equal(err, 0, "Command after shutdown failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cmd_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_init_sequence),
+			 ztest_unit_test(test_response_correlation),
+			 ztest_unit_test(test_transaction_abort),
+			 ztest_unit_test(test_shutdown)
+			 );
+
+	ztest_run_test_suite(at_cmd_tests);
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Replacement of the Modem library header, declaring the mocked AT socket
+ * used in place of the socket functions (see CMakeLists.txt).
+ */
+
+#ifndef NRF_MODEM_LIMITS_H_
+#define NRF_MODEM_LIMITS_H_
+
+#include <sys/types.h>
+#include <stddef.h>
+
+#ifndef AF_LTE
+#define AF_LTE 102
+#endif
+
+#ifndef NPROTO_AT
+#define NPROTO_AT 513
+#endif
+
+int at_mock_socket(int family, int type, int proto);
+ssize_t at_mock_send(int sock, const void *buf, size_t len, int flags);
+ssize_t at_mock_recv(int sock, void *buf, size_t max_len, int flags);
+int at_mock_close(int sock);
+
+#endif /* NRF_MODEM_LIMITS_H_ */
@@ -38,6 +38,36 @@ const char *certificate = "%CMNG: 12345678, 0, \"978C...02C4\","
 static struct at_param_list test_list;
 static struct at_param_list test_list2;
 
+#define VIEW_PARAMS       20
+#define BENCHMARK_ROUNDS  200
+
+static const char xmonitor_resp[] =
+	"%XMONITOR: 1,\"Operator\",\"OP\",\"20065\",\"0140\",7,20,"
+	"\"0102DAB5\",166,6400,53,23,\"\",\"11100000\",\"11100000\","
+	"\"00000000\"\r\n";
+static const char cmgl_resp[] =
+	"+CMGL: 1,0,,24\r\n"
+	"06912143658709040B911326880736F40000111011315214000BE474D8"
+	"9C0FB7E1FE9C9D\r\n";
+
+/* Number of heap allocations, see CMakeLists.txt. */
+static uint32_t alloc_cnt;
+
+void *__real_k_malloc(size_t size);
+void *__real_k_calloc(size_t nmemb, size_t size);
+
+void *__wrap_k_malloc(size_t size)
+{
+	alloc_cnt++;
+	return __real_k_malloc(size);
+}
+
+void *__wrap_k_calloc(size_t nmemb, size_t size)
+{
+	alloc_cnt++;
+	return __real_k_calloc(nmemb, size);
+}
+
 static void test_params_fail_on_invalid_input_setup(void)
 {
 	at_params_list_init(&test_list, TEST_PARAMS);
@@ -778,6 +808,228 @@ static void test_at_cmd_test_teardown(void)
 	at_params_list_free(&test_list2);
 }
 
+static void test_views_xmonitor(void)
+{
+	struct at_param_view views[VIEW_PARAMS];
+	char *remainder = NULL;
+	const char *str_ptr;
+	char tmpbuf[16];
+	size_t tmpbuf_len;
+	int32_t tmpint;
+	int ret;
+
+	ret = at_parser_views_from_str(xmonitor_resp, &remainder, views,
+				       ARRAY_SIZE(views));
+	zassert_equal(0, ret, "Parsing from string should return 0");
+	zassert_equal('\0', *remainder,
+		      "Remainder should only contain 0 termination character");
+
+	zassert_equal(AT_PARAM_TYPE_STRING, views[0].type,
+		      "Param type at index 0 should be a string");
+	str_ptr = at_params_view_string_ptr_get(xmonitor_resp, &views[0]);
+	zassert_equal(0, strncmp("%XMONITOR", str_ptr, views[0].len),
+		      "The string should equal to %XMONITOR");
+	zassert_equal(strlen("%XMONITOR"), views[0].len,
+		      "Invalid string length");
+
+	zassert_equal(0, at_params_view_int_get(xmonitor_resp, &views[1],
+						&tmpint),
+		      "Get int should not fail");
+	zassert_equal(1, tmpint, "Integer should be 1");
+
+	tmpbuf_len = sizeof(tmpbuf);
+	zassert_equal(0, at_params_view_string_get(xmonitor_resp, &views[2],
+						   tmpbuf, &tmpbuf_len),
+		      "Get string should not fail");
+	zassert_equal(strlen("Operator"), tmpbuf_len, "Invalid string length");
+	zassert_equal(0, memcmp("Operator", tmpbuf, tmpbuf_len),
+		      "The string in tmpbuf should equal to Operator");
+
+	tmpbuf_len = 4;
+	zassert_equal(-ENOMEM, at_params_view_string_get(xmonitor_resp,
+							 &views[2], tmpbuf,
+							 &tmpbuf_len),
+		      "Get string should fail when the buffer is too small");
+
+	zassert_equal(0, at_params_view_int_get(xmonitor_resp, &views[9],
+						&tmpint),
+		      "Get int should not fail");
+	zassert_equal(166, tmpint, "Integer should be 166");
+
+	zassert_equal(-EINVAL, at_params_view_int_get(xmonitor_resp,
+						      &views[8], &tmpint),
+		      "Get int should fail on a string parameter");
+
+	zassert_equal(AT_PARAM_TYPE_STRING, views[13].type,
+		      "Param type at index 13 should be a string");
+	zassert_equal(0, views[13].len, "String should be empty");
+
+	zassert_equal(AT_PARAM_TYPE_STRING, views[16].type,
+		      "Param type at index 16 should be a string");
+	zassert_equal(AT_PARAM_TYPE_INVALID, views[17].type,
+		      "Unused views should be invalid");
+
+	/* Too few views to hold all parameters. */
+	ret = at_parser_views_from_str(xmonitor_resp, NULL, views, 5);
+	zassert_equal(-E2BIG, ret, "Parsing should return -E2BIG");
+	zassert_equal(0, at_params_view_int_get(xmonitor_resp, &views[1],
+						&tmpint),
+		      "Get int should not fail");
+	zassert_equal(1, tmpint, "Integer should be 1");
+
+	zassert_equal(-EINVAL, at_parser_views_from_str(NULL, NULL, views,
+							ARRAY_SIZE(views)),
+		      "Parsing NULL string should fail");
+	zassert_equal(-EINVAL, at_parser_views_from_str(xmonitor_resp, NULL,
+							NULL, 0),
+		      "Parsing without views should fail");
+}
+
+static void test_views_types(void)
+{
+	static const char str[] = "+TEST: -2147483648,4294967296,,(1,22,333),"
+				  "\"abc\"\r\n";
+	struct at_param_view views[8];
+	uint32_t array[3];
+	size_t array_len;
+	int64_t tmpint64;
+	int32_t tmpint;
+
+	zassert_equal(0, at_parser_views_from_str(str, NULL, views,
+						  ARRAY_SIZE(views)),
+		      "Parsing from string should return 0");
+
+	zassert_equal(0, at_params_view_int_get(str, &views[1], &tmpint),
+		      "Get int should not fail");
+	zassert_equal(INT32_MIN, tmpint, "Invalid integer value");
+
+	zassert_equal(-EINVAL, at_params_view_int_get(str, &views[2], &tmpint),
+		      "Get int should fail on out of range value");
+	zassert_equal(0, at_params_view_int64_get(str, &views[2], &tmpint64),
+		      "Get int64 should not fail");
+	zassert_equal(4294967296LL, tmpint64, "Invalid integer value");
+
+	zassert_equal(AT_PARAM_TYPE_EMPTY, views[3].type,
+		      "Param type at index 3 should be empty");
+
+	array_len = sizeof(array);
+	zassert_equal(0, at_params_view_array_get(str, &views[4], array,
+						  &array_len),
+		      "Get array should not fail");
+	zassert_equal(sizeof(array), array_len, "Invalid array length");
+	zassert_equal(1, array[0], "Invalid array value");
+	zassert_equal(22, array[1], "Invalid array value");
+	zassert_equal(333, array[2], "Invalid array value");
+
+	array_len = sizeof(uint32_t);
+	zassert_equal(-ENOMEM, at_params_view_array_get(str, &views[4], array,
+							&array_len),
+		      "Get array should fail when the buffer is too small");
+
+	zassert_equal(AT_PARAM_TYPE_STRING, views[5].type,
+		      "Param type at index 5 should be a string");
+	zassert_equal(0, strncmp("abc", at_params_view_string_ptr_get(
+						str, &views[5]), views[5].len),
+		      "The string should equal to abc");
+}
+
+static void test_views_pdu(void)
+{
+	struct at_param_view views[VIEW_PARAMS];
+	const char *pdu;
+	int32_t tmpint;
+
+	zassert_equal(0, at_parser_views_from_str(cmgl_resp, NULL, views,
+						  ARRAY_SIZE(views)),
+		      "Parsing from string should return 0");
+
+	zassert_equal(0, at_params_view_int_get(cmgl_resp, &views[4], &tmpint),
+		      "Get int should not fail");
+	zassert_equal(24, tmpint, "Integer should be 24");
+
+	zassert_equal(AT_PARAM_TYPE_EMPTY, views[3].type,
+		      "Param type at index 3 should be empty");
+
+	pdu = at_params_view_string_ptr_get(cmgl_resp, &views[5]);
+	zassert_not_null(pdu, "PDU should be a string");
+	zassert_equal(0, strncmp("06912143658709", pdu, 14),
+		      "Invalid PDU");
+	zassert_equal(strlen(cmgl_resp) - (pdu - cmgl_resp) - 2, views[5].len,
+		      "Invalid PDU length");
+}
+
+/* Parse a response with a parameter list allocated for each response, as
+ * most users of the parser do, and access some of its parameters.
+ */
+static void parse_list(const char *resp)
+{
+	struct at_param_list list;
+	char tmpbuf[16];
+	size_t tmpbuf_len = sizeof(tmpbuf);
+	int32_t tmpint;
+
+	at_params_list_init(&list, VIEW_PARAMS);
+	(void)at_parser_params_from_str(resp, NULL, &list);
+	(void)at_params_int_get(&list, 1, &tmpint);
+	(void)at_params_string_get(&list, 2, tmpbuf, &tmpbuf_len);
+	at_params_list_free(&list);
+}
+
+static void parse_views(const char *resp)
+{
+	struct at_param_view views[VIEW_PARAMS];
+	char tmpbuf[16];
+	size_t tmpbuf_len = sizeof(tmpbuf);
+	int32_t tmpint;
+
+	(void)at_parser_views_from_str(resp, NULL, views, ARRAY_SIZE(views));
+	(void)at_params_view_int_get(resp, &views[1], &tmpint);
+	(void)at_params_view_string_get(resp, &views[2], tmpbuf, &tmpbuf_len);
+}
+
+static void benchmark(const char *name, const char *resp)
+{
+	uint32_t list_cycles, view_cycles;
+	uint32_t list_allocs, view_allocs;
+	uint32_t start;
+
+	alloc_cnt = 0;
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		parse_list(resp);
+	}
+	list_cycles = k_cycle_get_32() - start;
+	list_allocs = alloc_cnt;
+
+	alloc_cnt = 0;
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		parse_views(resp);
+	}
+	view_cycles = k_cycle_get_32() - start;
+	view_allocs = alloc_cnt;
+
+	TC_PRINT("%s x %d: list %u cycles, %u allocations; "
+		 "views %u cycles, %u allocations\n",
+		 name, BENCHMARK_ROUNDS, list_cycles, list_allocs,
+		 view_cycles, view_allocs);
+
+	zassert_true(list_allocs > 0, "Allocations not counted");
+	zassert_equal(0, view_allocs, "Parsing views allocated memory");
+
+	/* The cycle counter is driven by simulated time on native_posix. */
+	if (list_cycles > 0) {
+		zassert_true(view_cycles < list_cycles,
+			     "Parsing views is not faster");
+	}
+}
+
+static void test_views_benchmark(void)
+{
+	benchmark("%XMONITOR", xmonitor_resp);
+	benchmark("+CMGL", cmgl_resp);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -808,7 +1060,11 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				test_at_cmd_test,
 				test_at_cmd_test_setup,
-				test_at_cmd_test_teardown)
+				test_at_cmd_test_teardown),
+			 ztest_unit_test(test_views_xmonitor),
+			 ztest_unit_test(test_views_types),
+			 ztest_unit_test(test_views_pdu),
+			 ztest_unit_test(test_views_benchmark)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
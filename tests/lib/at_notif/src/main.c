@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Benchmark comparing the cost of dispatching a stream of notifications to
+ * subscribers that filter notifications themselves and to subscribers
+ * registered for a notification prefix.
+ *
+ * Note that on native_posix the cycle counter is driven by simulated time,
+ * so the dispatch cost is only meaningful when run on QEMU or hardware.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <modem/at_cmd.h>
+#include <modem/at_notif.h>
+
+#define STREAM_LEN	1000
+
+static at_cmd_handler_t dispatch;
+
+static const char *const prefixes[] = {
+	"+CEREG", "+CSCON", "+CEDRXP", "%XT3412", "%NCELLMEAS",
+	"%XMODEMSLEEP", "%CESQ", "+CMT", "+CDS", "%XTIME", "#XSLEEP", "+CGEV",
+};
+
+/* Synthetic stream dominated by frequent notifications. */
+static const char *const urcs[] = {
+	"%CESQ: 54,2,16,2",
+	"+CEREG: 5,\"0A0B\",\"01020304\",9,0,0,\"11100000\",\"00011111\"",
+	"%XMODEMSLEEP: 1,3600000",
+	"%CESQ: 55,2,17,2",
+	"+CSCON: 0",
+	"%CESQ: 53,2,15,2",
+	"%XTIME: \"80\",\"12105111005480\",\"01\"",
+	"+CUSD: 0",
+};
+
+static uint32_t handled_cnt[ARRAY_SIZE(prefixes)];
+
+/* Legacy subscriber filtering the notifications it handles. */
+static void filtering_handler(void *context, const char *response)
+{
+	size_t idx = POINTER_TO_UINT(context);
+
+	if (!strncmp(response, prefixes[idx], strlen(prefixes[idx]))) {
+		handled_cnt[idx]++;
+	}
+}
+
+static void prefix_handler(void *context, const char *response)
+{
+	handled_cnt[POINTER_TO_UINT(context)]++;
+}
+
+static atomic_t all_cnt;
+
+static void all_handler(void *context, const char *response)
+{
+	atomic_inc(&all_cnt);
+}
+
+static void self_removing_handler(void *context, const char *response)
+{
+	zassert_ok(at_notif_deregister_prefix_handler("+CEREG", NULL,
+						      self_removing_handler),
+		   "Cannot deregister handler");
+	atomic_inc(&all_cnt);
+}
+
+static K_SEM_DEFINE(handler_entered, 0, 1);
+static K_SEM_DEFINE(handler_release, 0, 1);
+
+static void blocking_handler(void *context, const char *response)
+{
+	k_sem_give(&handler_entered);
+	k_sem_take(&handler_release, K_FOREVER);
+}
+
+/* Replaces the AT command driver. */
+void at_cmd_set_notification_handler(at_cmd_handler_t handler)
+{
+	dispatch = handler;
+}
+
+static uint32_t run_stream(void)
+{
+	uint32_t start;
+
+	memset(handled_cnt, 0, sizeof(handled_cnt));
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < STREAM_LEN; i++) {
+		dispatch(urcs[i % ARRAY_SIZE(urcs)]);
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void expected_cnt(uint32_t *cnt)
+{
+	memset(cnt, 0, sizeof(handled_cnt));
+
+	for (size_t i = 0; i < STREAM_LEN; i++) {
+		const char *urc = urcs[i % ARRAY_SIZE(urcs)];
+
+		for (size_t j = 0; j < ARRAY_SIZE(prefixes); j++) {
+			size_t len = strlen(prefixes[j]);
+
+			if (!strncmp(urc, prefixes[j], len) &&
+			    urc[len] == ':') {
+				cnt[j]++;
+			}
+		}
+	}
+}
+
+static void test_init(void)
+{
+	zassert_ok(at_notif_init(), "Error when initializing");
+	zassert_not_null(dispatch, "Dispatch function not set");
+}
+
+static void test_dispatch_cost(void)
+{
+	uint32_t expected[ARRAY_SIZE(prefixes)];
+	uint32_t filtering_cycles;
+	uint32_t prefix_cycles;
+
+	expected_cnt(expected);
+
+	for (size_t i = 0; i < ARRAY_SIZE(prefixes); i++) {
+		zassert_ok(at_notif_register_handler(UINT_TO_POINTER(i),
+						     filtering_handler),
+			   "Cannot register handler");
+	}
+
+	filtering_cycles = run_stream();
+	zassert_mem_equal(handled_cnt, expected, sizeof(expected),
+			  "Invalid notifications handled");
+
+	for (size_t i = 0; i < ARRAY_SIZE(prefixes); i++) {
+		zassert_ok(at_notif_deregister_handler(UINT_TO_POINTER(i),
+						       filtering_handler),
+			   "Cannot deregister handler");
+		zassert_ok(at_notif_register_prefix_handler(prefixes[i],
+							    UINT_TO_POINTER(i),
+							    prefix_handler),
+			   "Cannot register handler");
+	}
+
+	prefix_cycles = run_stream();
+	zassert_mem_equal(handled_cnt, expected, sizeof(expected),
+			  "Invalid notifications routed");
+
+	TC_PRINT("Dispatching %d notifications to %d subscribers: "
+		 "filtering %u cycles, prefix %u cycles\n",
+		 STREAM_LEN, (int)ARRAY_SIZE(prefixes), filtering_cycles,
+		 prefix_cycles);
+
+	if (filtering_cycles > 0) {
+		zassert_true(prefix_cycles < filtering_cycles,
+			     "Prefix routing does not reduce dispatch cost");
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(prefixes); i++) {
+		zassert_ok(at_notif_deregister_prefix_handler(
+				prefixes[i], UINT_TO_POINTER(i),
+				prefix_handler),
+			   "Cannot deregister handler");
+	}
+}
+
+static void test_legacy_handler(void)
+{
+	atomic_set(&all_cnt, 0);
+	zassert_ok(at_notif_register_handler(NULL, all_handler),
+		   "Cannot register handler");
+
+	run_stream();
+	zassert_equal(atomic_get(&all_cnt), STREAM_LEN,
+		      "Legacy handler did not receive all notifications");
+
+	zassert_ok(at_notif_deregister_handler(NULL, all_handler),
+		   "Cannot deregister handler");
+}
+
+static void test_invalid_prefix(void)
+{
+	zassert_equal(at_notif_register_prefix_handler(NULL, NULL,
+						       prefix_handler),
+		      -EINVAL, "NULL prefix accepted");
+	zassert_equal(at_notif_register_prefix_handler("", NULL,
+						       prefix_handler),
+		      -EINVAL, "Empty prefix accepted");
+	zassert_equal(at_notif_register_prefix_handler("+CEREG:", NULL,
+						       prefix_handler),
+		      -EINVAL, "Prefix with colon accepted");
+	zassert_equal(at_notif_register_prefix_handler("+CEREG", NULL, NULL),
+		      -EINVAL, "NULL handler accepted");
+}
+
+static void test_deregister_from_handler(void)
+{
+	atomic_set(&all_cnt, 0);
+	zassert_ok(at_notif_register_prefix_handler("+CEREG", NULL,
+						    self_removing_handler),
+		   "Cannot register handler");
+
+	dispatch("+CEREG: 1");
+	dispatch("+CEREG: 2");
+
+	zassert_equal(atomic_get(&all_cnt), 1,
+		      "Handler called after deregistration");
+}
+
+#define THREAD_STACK_SIZE	1024
+
+static K_THREAD_STACK_DEFINE(dispatch_stack, THREAD_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(remove_stack, THREAD_STACK_SIZE);
+static struct k_thread dispatch_thread_data;
+static struct k_thread remove_thread_data;
+static atomic_t removed;
+
+static void dispatch_fn(void *p1, void *p2, void *p3)
+{
+	dispatch("+CEREG: 1");
+}
+
+static void remove_fn(void *p1, void *p2, void *p3)
+{
+	zassert_ok(at_notif_deregister_prefix_handler("+CEREG", NULL,
+						      blocking_handler),
+		   "Cannot deregister handler");
+	atomic_set(&removed, true);
+}
+
+static void test_deregister_during_dispatch(void)
+{
+	atomic_set(&removed, false);
+	zassert_ok(at_notif_register_prefix_handler("+CEREG", NULL,
+						    blocking_handler),
+		   "Cannot register handler");
+
+	k_thread_create(&dispatch_thread_data, dispatch_stack,
+			K_THREAD_STACK_SIZEOF(dispatch_stack), dispatch_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	zassert_ok(k_sem_take(&handler_entered, K_SECONDS(1)),
+		   "Handler not called");
+
+	/* Removal waits until the dispatch in progress is complete. */
+	k_thread_create(&remove_thread_data, remove_stack,
+			K_THREAD_STACK_SIZEOF(remove_stack), remove_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+	zassert_false(atomic_get(&removed),
+		      "Handler removed during the dispatch");
+
+	k_sem_give(&handler_release);
+	zassert_ok(k_thread_join(&remove_thread_data, K_SECONDS(1)),
+		   "Removal not completed after the dispatch");
+	zassert_true(atomic_get(&removed), "Handler not removed");
+	zassert_ok(k_thread_join(&dispatch_thread_data, K_SECONDS(1)),
+		   "Dispatch not completed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_notif_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_dispatch_cost),
+			 ztest_unit_test(test_legacy_handler),
+			 ztest_unit_test(test_invalid_prefix),
+			 ztest_unit_test(test_deregister_from_handler),
+			 ztest_unit_test(test_deregister_during_dispatch)
+			 );
+
+	ztest_run_test_suite(at_notif_tests);
+}
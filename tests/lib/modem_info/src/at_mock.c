@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <modem/at_cmd.h>
+#include <modem/at_notif.h>
+
+#include "at_mock.h"
+
+#define RESPONSE_MAX_LEN	128
+#define HANDLERS_MAX		8
+
+struct mock_response {
+	const char *cmd;
+	char resp[RESPONSE_MAX_LEN];
+	size_t cnt;
+};
+
+struct mock_handler {
+	const char *prefix;
+	void *context;
+	at_notif_handler_t handler;
+};
+
+static struct mock_response responses[] = {
+	{ "AT%XCBAND", "%XCBAND: 20\r\n" },
+	{ "AT%XCBAND=?", "%XCBAND: (1,2,3,4,12,13,20)\r\n" },
+	{ "AT+CEMODE?", "+CEMODE: 2\r\n" },
+	{ "AT+COPS?", "+COPS: 0,2,\"24201\",7\r\n" },
+	{ "AT+CEREG?", "+CEREG: 5,1,\"0A0B\",\"01020304\",7\r\n" },
+	{ "AT+CGDCONT?",
+	  "+CGDCONT: 0,\"IP\",\"telenor.smart\",\"10.0.0.1\",0,0\r\n" },
+	{ "AT%XSIM?", "%XSIM: 1\r\n" },
+	{ "AT%XVBAT", "%XVBAT: 3600\r\n" },
+	{ "AT%XTEMP?", "%XTEMP: 24\r\n" },
+	{ "AT+CGMR", "mfw_nrf9160_1.3.0\r\n" },
+	{ "AT+CRSM=176,12258,0,0,10",
+	  "+CRSM: 144,0,\"89441000301234567810\"\r\n" },
+	{ "AT%XSYSTEMMODE?", "%XSYSTEMMODE: 1,0,1,0\r\n" },
+	{ "AT+CIMI", "242016000001234\r\n" },
+	{ "AT+CGSN", "352656100000000\r\n" },
+	{ "AT+CESQ", "+CESQ: 99,99,255,255,31,62\r\n" },
+	{ "AT+CCLK?", "+CCLK: \"21/06/01,12:00:00+08\"\r\n" },
+	{ "AT%CESQ=1", "" },
+};
+
+static struct mock_handler handlers[HANDLERS_MAX];
+static size_t cmd_cnt;
+static size_t batch_cnt;
+
+static struct mock_response *response_get(const char *cmd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(responses); i++) {
+		if (!strcmp(responses[i].cmd, cmd)) {
+			return &responses[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int response_copy(const char *cmd, char *buf, size_t buf_len)
+{
+	struct mock_response *response = response_get(cmd);
+
+	cmd_cnt++;
+
+	if (response == NULL) {
+		return -EIO;
+	}
+
+	response->cnt++;
+
+	if (buf != NULL) {
+		if (strlen(response->resp) >= buf_len) {
+			return -EMSGSIZE;
+		}
+		strcpy(buf, response->resp);
+	}
+
+	return 0;
+}
+
+int at_cmd_write(const char *const cmd, char *buf, size_t buf_len,
+		 enum at_cmd_state *state)
+{
+	int err;
+
+	k_sleep(K_MSEC(AT_MOCK_CMD_MS));
+
+	err = response_copy(cmd, buf, buf_len);
+	if (state) {
+		*state = err ? AT_CMD_ERROR : AT_CMD_OK;
+	}
+
+	return err;
+}
+
+int at_cmd_write_batch(struct at_cmd_async *reqs, size_t count,
+		       bool transaction)
+{
+	if (count == 0 || count > CONFIG_AT_CMD_QUEUE_LEN) {
+		return -EINVAL;
+	}
+
+	batch_cnt++;
+	k_sleep(K_MSEC(AT_MOCK_CMD_MS + count * AT_MOCK_PROCESSING_MS));
+
+	for (size_t i = 0; i < count; i++) {
+		reqs[i].code = response_copy(reqs[i].cmd, reqs[i].resp,
+					     reqs[i].resp_size);
+		reqs[i].state = reqs[i].code ? AT_CMD_ERROR : AT_CMD_OK;
+
+		if (reqs[i].handler) {
+			reqs[i].handler(&reqs[i], reqs[i].resp);
+		}
+	}
+
+	return 0;
+}
+
+int at_cmd_async_wait(struct at_cmd_async *req, k_timeout_t timeout,
+		      enum at_cmd_state *state)
+{
+	if (state) {
+		*state = req->state;
+	}
+
+	return req->code;
+}
+
+int at_notif_register_prefix_handler(const char *prefix, void *context,
+				     at_notif_handler_t handler)
+{
+	struct mock_handler *free_slot = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(handlers); i++) {
+		if (handlers[i].handler == NULL) {
+			free_slot = free_slot ? free_slot : &handlers[i];
+		} else if (!strcmp(handlers[i].prefix, prefix) &&
+			   handlers[i].context == context &&
+			   handlers[i].handler == handler) {
+			return 0;
+		}
+	}
+
+	if (free_slot == NULL) {
+		return -ENOBUFS;
+	}
+
+	*free_slot = (struct mock_handler) {
+		.prefix = prefix,
+		.context = context,
+		.handler = handler,
+	};
+
+	return 0;
+}
+
+void at_mock_notify(const char *notif)
+{
+	size_t len;
+
+	for (size_t i = 0; i < ARRAY_SIZE(handlers); i++) {
+		if (handlers[i].handler == NULL) {
+			continue;
+		}
+
+		len = strlen(handlers[i].prefix);
+		if (!strncmp(notif, handlers[i].prefix, len) &&
+		    notif[len] == ':') {
+			handlers[i].handler(handlers[i].context, notif);
+		}
+	}
+}
+
+size_t at_mock_cmd_cnt(void)
+{
+	return cmd_cnt;
+}
+
+size_t at_mock_batch_cnt(void)
+{
+	return batch_cnt;
+}
+
+size_t at_mock_cmd_cnt_get(const char *cmd)
+{
+	struct mock_response *response = response_get(cmd);
+
+	return response ? response->cnt : 0;
+}
+
+void at_mock_response_set(const char *cmd, const char *resp)
+{
+	struct mock_response *response = response_get(cmd);
+
+	if (response) {
+		strncpy(response->resp, resp, sizeof(response->resp) - 1);
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef AT_MOCK_H_
+#define AT_MOCK_H_
+
+#include <stddef.h>
+
+/* Time the modem spends answering a single AT command. */
+#define AT_MOCK_CMD_MS		20
+
+/* Time the modem spends processing a command of a batch. The time needed
+ * to write the commands and read the responses is paid once per batch.
+ */
+#define AT_MOCK_PROCESSING_MS	2
+
+/* Return the number of AT commands issued, one by one or in batches. */
+size_t at_mock_cmd_cnt(void);
+
+/* Return the number of batches of AT commands issued. */
+size_t at_mock_batch_cnt(void);
+
+/* Return the number of times a given AT command was issued. */
+size_t at_mock_cmd_cnt_get(const char *cmd);
+
+/* Change the response to a given AT command. */
+void at_mock_response_set(const char *cmd, const char *response);
+
+/* Dispatch a notification to the registered handlers. */
+void at_mock_notify(const char *notif);
+
+#endif /* AT_MOCK_H_ */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Test counting the AT commands issued by the modem information library
+ * against a mocked AT layer, with and without CONFIG_MODEM_INFO_CACHE
+ * (see testcase.yaml).
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <modem/modem_info.h>
+
+#include "at_mock.h"
+
+/* AT commands issued by modem_info_params_get(), one per parameter. */
+#define PARAMS_READ_CNT		17
+/* Distinct AT commands among those. */
+#define PARAMS_CMD_CNT		13
+/* AT commands reading network information invalidated by +CEREG. */
+#define CEREG_CMD_CNT		6
+/* AT commands reading network information invalidated by %XMODEMSLEEP. */
+#define XMODEMSLEEP_CMD_CNT	4
+/* AT commands reading SIM information. */
+#define SIM_CMD_CNT		3
+
+static struct modem_param_info modem;
+
+/* Return the number of AT commands issued by modem_info_params_get(). */
+static size_t params_get_cmd_cnt(void)
+{
+	size_t cnt = at_mock_cmd_cnt();
+
+	zassert_ok(modem_info_params_get(&modem), "Cannot get parameters");
+
+	return at_mock_cmd_cnt() - cnt;
+}
+
+static void skip_if_not_cached(void)
+{
+	if (!IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		ztest_test_skip();
+	}
+}
+
+static void test_init(void)
+{
+	zassert_ok(modem_info_init(), "Error when initializing");
+	zassert_ok(modem_info_params_init(&modem),
+		   "Error when initializing parameters");
+}
+
+static void test_params_get(void)
+{
+	size_t batch_cnt = at_mock_batch_cnt();
+	size_t cmd_cnt;
+	int64_t start;
+	int64_t cold_ms;
+	int64_t hit_ms;
+
+	start = k_uptime_get();
+	cmd_cnt = params_get_cmd_cnt();
+	cold_ms = k_uptime_get() - start;
+
+	zassert_equal(modem.network.current_band.value, 20, "Invalid band");
+	zassert_equal(modem.network.area_code.value, 0x0A0B,
+		      "Invalid area code");
+	zassert_equal(strcmp(modem.network.cellid_hex.value_string,
+			     "01020304"), 0, "Invalid cell ID");
+	zassert_equal((int)modem.network.mcc.value, 242, "Invalid MCC");
+	zassert_equal((int)modem.network.mnc.value, 1, "Invalid MNC");
+	zassert_equal(strcmp(modem.network.ip_address.value_string,
+			     "10.0.0.1"), 0, "Invalid IP address");
+	zassert_equal(strcmp(modem.network.apn.value_string, "telenor.smart"),
+		      0, "Invalid APN");
+	zassert_equal(modem.network.lte_mode.value, 1, "Invalid LTE-M mode");
+	zassert_equal(modem.network.gps_mode.value, 1, "Invalid GPS mode");
+	zassert_equal(strcmp(modem.sim.iccid.value_string,
+			     "98440100032143658701"), 0, "Invalid ICCID");
+	zassert_equal(strcmp(modem.sim.imsi.value_string, "242016000001234"),
+		      0, "Invalid IMSI");
+	zassert_equal(strcmp(modem.device.modem_fw.value_string,
+			     "mfw_nrf9160_1.3.0"), 0, "Invalid firmware");
+	zassert_equal(modem.device.battery.value, 3600, "Invalid battery");
+	zassert_equal(strcmp(modem.device.imei.value_string,
+			     "352656100000000"), 0, "Invalid IMEI");
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		zassert_equal(cmd_cnt, PARAMS_CMD_CNT,
+			      "Commands issued more than once");
+		zassert_equal(at_mock_batch_cnt() - batch_cnt, 1,
+			      "Commands not issued in a single batch");
+	} else {
+		zassert_equal(cmd_cnt, PARAMS_READ_CNT,
+			      "Invalid number of commands");
+	}
+
+	start = k_uptime_get();
+	cmd_cnt = params_get_cmd_cnt();
+	hit_ms = k_uptime_get() - start;
+
+	TC_PRINT("modem_info_params_get(): first call %lld ms, "
+		 "second call %lld ms, %d commands\n",
+		 cold_ms, hit_ms, (int)cmd_cnt);
+
+	if (IS_ENABLED(CONFIG_MODEM_INFO_CACHE)) {
+		zassert_equal(cmd_cnt, 0, "Cached data requested again");
+		zassert_true(hit_ms < AT_MOCK_CMD_MS, "Cache hit too slow");
+	} else {
+		zassert_equal(cmd_cnt, PARAMS_READ_CNT,
+			      "Invalid number of commands");
+	}
+}
+
+static void test_cereg_invalidation(void)
+{
+	skip_if_not_cached();
+
+	at_mock_response_set("AT+CEREG?",
+			     "+CEREG: 5,1,\"0A0C\",\"01020305\",7\r\n");
+
+	zassert_equal(params_get_cmd_cnt(), 0, "Cached data requested again");
+	zassert_equal(strcmp(modem.network.cellid_hex.value_string,
+			     "01020304"), 0, "Cell ID not cached");
+
+	at_mock_notify("+CEREG: 5,\"0A0C\",\"01020305\",7");
+
+	zassert_equal(params_get_cmd_cnt(), CEREG_CMD_CNT,
+		      "Invalid number of commands");
+	zassert_equal(strcmp(modem.network.cellid_hex.value_string,
+			     "01020305"), 0, "Cell ID not updated");
+	zassert_equal(modem.network.area_code.value, 0x0A0C,
+		      "Area code not updated");
+}
+
+static void test_xmodemsleep_invalidation(void)
+{
+	skip_if_not_cached();
+
+	at_mock_notify("%XMODEMSLEEP: 1,3600000");
+
+	zassert_equal(params_get_cmd_cnt(), XMODEMSLEEP_CMD_CNT,
+		      "Invalid number of commands");
+}
+
+static void test_xsim_invalidation(void)
+{
+	skip_if_not_cached();
+
+	at_mock_notify("%XSIM: 1");
+
+	zassert_equal(params_get_cmd_cnt(), SIM_CMD_CNT,
+		      "Invalid number of commands");
+}
+
+static void test_cesq_invalidation(void)
+{
+	size_t cnt = at_mock_cmd_cnt_get("AT+CESQ");
+	uint16_t rsrp;
+
+	skip_if_not_cached();
+
+	zassert_equal(modem_info_short_get(MODEM_INFO_RSRP, &rsrp),
+		      sizeof(uint16_t), "Cannot get RSRP");
+	zassert_equal(rsrp, 62, "Invalid RSRP");
+	zassert_equal(modem_info_short_get(MODEM_INFO_RSRP, &rsrp),
+		      sizeof(uint16_t), "Cannot get RSRP");
+	zassert_equal(at_mock_cmd_cnt_get("AT+CESQ") - cnt, 1,
+		      "RSRP not cached");
+
+	/* Signal strength notifications do not affect the parameters */
+	at_mock_notify("%CESQ: 54,2,16,2");
+	zassert_equal(params_get_cmd_cnt(), 0, "Cached data requested again");
+
+	zassert_equal(modem_info_short_get(MODEM_INFO_RSRP, &rsrp),
+		      sizeof(uint16_t), "Cannot get RSRP");
+	zassert_equal(at_mock_cmd_cnt_get("AT+CESQ") - cnt, 2,
+		      "RSRP not invalidated");
+}
+
+static void test_measurement_expiry(void)
+{
+	size_t cnt = at_mock_cmd_cnt_get("AT%XVBAT");
+
+	skip_if_not_cached();
+
+	at_mock_response_set("AT%XVBAT", "%XVBAT: 3550\r\n");
+	k_sleep(K_MSEC(CONFIG_MODEM_INFO_CACHE_MEASUREMENT_TTL *
+		       MSEC_PER_SEC + 100));
+
+	zassert_equal(params_get_cmd_cnt(), 1, "Invalid number of commands");
+	zassert_equal(at_mock_cmd_cnt_get("AT%XVBAT") - cnt, 1,
+		      "Battery voltage not requested");
+	zassert_equal(modem.device.battery.value, 3550,
+		      "Battery voltage not updated");
+}
+
+static void test_date_time_not_cached(void)
+{
+	char buf[32];
+	size_t cnt = at_mock_cmd_cnt_get("AT+CCLK?");
+
+	for (size_t i = 0; i < 2; i++) {
+		zassert_true(modem_info_string_get(MODEM_INFO_DATE_TIME, buf,
+						   sizeof(buf)) > 0,
+			     "Cannot get date and time");
+		zassert_equal(strcmp(buf, "21/06/01,12:00:00+08"), 0,
+			      "Invalid date and time");
+	}
+
+	zassert_equal(at_mock_cmd_cnt_get("AT+CCLK?") - cnt, 2,
+		      "Date and time cached");
+}
+
+static void test_cache_invalidate(void)
+{
+	skip_if_not_cached();
+
+	modem_info_cache_invalidate();
+
+	zassert_equal(params_get_cmd_cnt(), PARAMS_CMD_CNT,
+		      "Invalid number of commands");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(modem_info_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_params_get),
+			 ztest_unit_test(test_cereg_invalidation),
+			 ztest_unit_test(test_xmodemsleep_invalidation),
+			 ztest_unit_test(test_xsim_invalidation),
+			 ztest_unit_test(test_cesq_invalidation),
+			 ztest_unit_test(test_measurement_expiry),
+			 ztest_unit_test(test_date_time_not_cached),
+			 ztest_unit_test(test_cache_invalidate)
+			 );
+
+	ztest_run_test_suite(modem_info_tests);
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Tests for reassembly of concatenated SMS messages, built with
+ * CONFIG_SMS_CONCAT_REASSEMBLY (see testcase.yaml). The test configuration allows
+ * reassembling two messages of at most five parts at the same time, with memory
+ * for storing four parts.
+ */
+
+#include <unity.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <kernel.h>
+#include <modem/sms.h>
+#include <mock_at_cmd.h>
+
+/* Concatenated message 126 of 291 characters in 2 parts */
+#define MSG126_TEXT "1234567890"
+#define MSG126_LEN 291
+
+/* Concatenated message 128 of 755 characters in 5 parts */
+#define MSG128_TEXT "abcdefghijklmnopqrstuvwxyz "
+#define MSG128_LEN 755
+
+#define MSG126_PART1 \
+	"0791534874894310440A912143658709000012201232054480A00500037E020162B219AD66BBE172" \
+	"B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46AB" \
+	"D96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C" \
+	"269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB6" \
+	"1B2E078BC966"
+
+#define MSG126_PART2 \
+	"0791534874894320440A912143658709000012201232054480910500037E02026835DB0D9783C564" \
+	"335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3" \
+	"E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C" \
+	"56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031"
+
+#define MSG128_PART1 \
+	"0791534874894310440A912143658709000012202280655080A0050003800501C2E231B96C3EA3D3" \
+	"EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A" \
+	"8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C" \
+	"5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B" \
+	"76DBFD86C7E5"
+
+#define MSG128_PART2 \
+	"0791534874894370440A912143658709000012202280656080A0050003800502E6F4BAFD8ECFEB41" \
+	"61F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9F" \
+	"D3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47A" \
+	"CD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E2" \
+	"31B96C3EA3D3"
+
+#define MSG128_PART3 \
+	"0791534874894310440A912143658709000012202280656080A0050003800503D46B76DBFD86C7E5" \
+	"737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56" \
+	"AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A5058" \
+	"3C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4" \
+	"BAFD8ECFEB41"
+
+#define MSG128_PART4 \
+	"0791534874894370440A912143658709000012202280656080A0050003800504C2E231B96C3EA3D3" \
+	"EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A" \
+	"8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C" \
+	"5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B" \
+	"76DBFD86C7E5"
+
+#define MSG128_PART5 \
+	"0791534874894310440A91214365870900001220228065608096050003800505E6F4BAFD8ECFEB41" \
+	"61F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9F" \
+	"D3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47A" \
+	"CD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD703"
+
+#define MSG127_PART1 \
+	"0791534874894310440A912143658709000012201232054480A00500037F020162B219AD66BBE172" \
+	"B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46AB" \
+	"D96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C" \
+	"269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB6" \
+	"1B2E078BC966"
+
+#define MSG127_PART2 \
+	"0791534874894320440A912143658709000012201232054480910500037F02026835DB0D9783C564" \
+	"335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3" \
+	"E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C" \
+	"56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031"
+
+#define MSG128_OF6_PART1 \
+	"0791534874894310440A912143658709000012202280655080A0050003800601C2E231B96C3EA3D3" \
+	"EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A" \
+	"8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C" \
+	"5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B" \
+	"76DBFD86C7E5"
+
+static struct sms_data received;
+static int received_cnt;
+static int test_handle;
+
+/* sms_at_handler() is implemented in the library and we'll call it directly
+ * to fake received SMS message
+ */
+extern void sms_at_handler(void *context, const char *at_notif);
+
+static void sms_callback(struct sms_data *const data, void *context)
+{
+	memcpy(&received, data, sizeof(received));
+	received_cnt++;
+}
+
+static void sms_reg_helper(void)
+{
+	char resp[] = "+CNMI: 0,0,0,0,1\r\n";
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI?", NULL, 0, NULL, 0);
+	__wrap_at_cmd_write_IgnoreArg_buf();
+	__wrap_at_cmd_write_IgnoreArg_buf_len();
+	__wrap_at_cmd_write_ReturnArrayThruPtr_buf(resp, sizeof(resp));
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI=3,2,0,1", NULL, 0, NULL, 0);
+
+	test_handle = sms_register_listener(sms_callback, NULL);
+	TEST_ASSERT_EQUAL(0, test_handle);
+}
+
+static void sms_unreg_helper(void)
+{
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI=0,0,0,0", NULL, 0, NULL, 0);
+	__wrap_at_cmd_write_IgnoreArg_buf();
+	__wrap_at_cmd_write_IgnoreArg_buf_len();
+
+	sms_unregister_listener(test_handle);
+	test_handle = -1;
+}
+
+/** Receive a part, which is always acknowledged whether or not it is delivered. */
+static void recv_part(const char *pdu)
+{
+	static char notif[512];
+
+	snprintf(notif, sizeof(notif), "+CMT: \"+1234567890\",159\r\n%s\r\n", pdu);
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMA=1", NULL, 0, NULL, 0);
+	sms_at_handler(NULL, notif);
+}
+
+static void assert_text(const char *pattern, int len)
+{
+	static char expected[SMS_MAX_DATA_LEN_CHARS + 1];
+	size_t pattern_len = strlen(pattern);
+
+	for (int i = 0; i < len; i++) {
+		expected[i] = pattern[i % pattern_len];
+	}
+	expected[len] = '\0';
+
+	TEST_ASSERT_EQUAL(len, received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(expected, received.payload);
+}
+
+void setUp(void)
+{
+	memset(&received, 0, sizeof(received));
+	received_cnt = 0;
+	sms_reg_helper();
+}
+
+void tearDown(void)
+{
+	sms_unreg_helper();
+}
+
+/** Parts received in order are delivered as one message. */
+void test_concat_in_order(void)
+{
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+
+	TEST_ASSERT_EQUAL(SMS_TYPE_DELIVER, received.type);
+	assert_text(MSG126_TEXT, MSG126_LEN);
+	TEST_ASSERT_EQUAL_STRING("1234567890",
+		received.header.deliver.originating_address.address_str);
+	TEST_ASSERT_FALSE(received.header.deliver.concatenated.present);
+	TEST_ASSERT_EQUAL(0, received.header.deliver.concatenated.ref_number);
+}
+
+/** Parts received in any order are reassembled in order, with the header of the first part. */
+void test_concat_out_of_order(void)
+{
+	recv_part(MSG128_PART4);
+	recv_part(MSG128_PART2);
+	recv_part(MSG128_PART5);
+	recv_part(MSG128_PART1);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG128_PART3);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+
+	assert_text(MSG128_TEXT, MSG128_LEN);
+	/* Only the first part was sent at 08:56:05, other parts at 08:56:06 */
+	TEST_ASSERT_EQUAL(8, received.header.deliver.time.hour);
+	TEST_ASSERT_EQUAL(56, received.header.deliver.time.minute);
+	TEST_ASSERT_EQUAL(5, received.header.deliver.time.second);
+	TEST_ASSERT_FALSE(received.header.deliver.concatenated.present);
+}
+
+/** Duplicate parts are ignored. */
+void test_concat_duplicate_part(void)
+{
+	recv_part(MSG126_PART2);
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+	assert_text(MSG126_TEXT, MSG126_LEN);
+
+	/* A part received after the message is complete starts a new message */
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+}
+
+/** Parts of different messages can be interleaved. */
+void test_concat_interleaved(void)
+{
+	recv_part(MSG128_PART1);
+	recv_part(MSG126_PART2);
+	recv_part(MSG128_PART2);
+	recv_part(MSG128_PART3);
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+	assert_text(MSG126_TEXT, MSG126_LEN);
+
+	recv_part(MSG128_PART4);
+	recv_part(MSG128_PART5);
+	TEST_ASSERT_EQUAL(2, received_cnt);
+	assert_text(MSG128_TEXT, MSG128_LEN);
+}
+
+/** The oldest message is dropped when too many messages are being reassembled. */
+void test_concat_too_many_messages(void)
+{
+	recv_part(MSG126_PART1);
+	recv_part(MSG128_PART1);
+
+	/* Drops message 126 */
+	recv_part(MSG127_PART1);
+
+	/* Starts message 126 again, dropping message 128 */
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG127_PART2);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+	assert_text(MSG126_TEXT, MSG126_LEN);
+
+	recv_part(MSG128_PART2);
+	recv_part(MSG128_PART3);
+	recv_part(MSG128_PART4);
+	recv_part(MSG128_PART5);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+}
+
+/** The oldest message is dropped when there is no memory left for storing a part. */
+void test_concat_pool_exhausted(void)
+{
+	recv_part(MSG126_PART1);
+	recv_part(MSG128_PART1);
+	recv_part(MSG128_PART2);
+	recv_part(MSG128_PART3);
+
+	/* Drops message 126 */
+	recv_part(MSG128_PART4);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG128_PART5);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+	assert_text(MSG128_TEXT, MSG128_LEN);
+
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+}
+
+/** Parts of a message are dropped if the message is not complete within the timeout. */
+void test_concat_timeout(void)
+{
+	recv_part(MSG126_PART1);
+
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC + 100));
+
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+	assert_text(MSG126_TEXT, MSG126_LEN);
+}
+
+/** Parts of messages with too many parts are delivered one by one. */
+void test_concat_too_many_parts(void)
+{
+	recv_part(MSG128_OF6_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+
+	TEST_ASSERT_EQUAL(153, received.payload_len);
+	TEST_ASSERT_TRUE(received.header.deliver.concatenated.present);
+	TEST_ASSERT_EQUAL(128, received.header.deliver.concatenated.ref_number);
+	TEST_ASSERT_EQUAL(6, received.header.deliver.concatenated.total_msgs);
+	TEST_ASSERT_EQUAL(1, received.header.deliver.concatenated.seq_number);
+}
+
+/** Messages being reassembled are dropped when the last listener unregisters. */
+void test_concat_unregister(void)
+{
+	recv_part(MSG126_PART1);
+
+	sms_unreg_helper();
+	sms_reg_helper();
+
+	recv_part(MSG126_PART2);
+	TEST_ASSERT_EQUAL(0, received_cnt);
+
+	recv_part(MSG126_PART1);
+	TEST_ASSERT_EQUAL(1, received_cnt);
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
@@ -11,6 +11,8 @@
 #include <modem/sms.h>
 #include <mock_at_cmd.h>
 
+#include "string_conversion.h"
+
 
 static struct sms_data test_sms_data = {0};
 static struct sms_deliver_header test_sms_header = {0};
@@ -1717,6 +1719,158 @@ void test_recv_loop(void)
 	sms_unreg_helper();
 }
 
+/********* STRING CONVERSION TESTS ***********************/
+
+#define PACK_BENCH_ROUNDS 1000
+
+/** Reference packing placing one septet at a time at its bit position. */
+static uint8_t ref_7bit_packing(const uint8_t *data, uint8_t len, uint8_t *out)
+{
+	uint16_t bit;
+
+	memset(out, 0, (len * 7 + 7) / 8);
+	for (uint16_t i = 0; i < len; i++) {
+		bit = i * 7;
+		out[bit / 8] |= data[i] << (bit % 8);
+		if (bit % 8 > 1) {
+			out[bit / 8 + 1] |= data[i] >> (8 - bit % 8);
+		}
+	}
+
+	return (len * 7 + 7) / 8;
+}
+
+/** Reference unpacking extracting one septet at a time from its bit position. */
+static void ref_7bit_unpacking(const uint8_t *packed, uint8_t len, uint8_t *out)
+{
+	uint16_t bit;
+
+	for (uint16_t i = 0; i < len; i++) {
+		bit = i * 7;
+		out[i] = packed[bit / 8] >> (bit % 8);
+		if (bit % 8 > 1) {
+			out[i] |= packed[bit / 8 + 1] << (8 - bit % 8);
+		}
+		out[i] &= 0x7F;
+	}
+}
+
+/** Pack and unpack strings of all lengths, with and without a trailing partial group. */
+void test_string_conversion_7bit_packing(void)
+{
+	uint8_t septets[255];
+	uint8_t packed[255];
+	uint8_t expected[255];
+	uint8_t unpacked[255];
+	uint8_t packed_len;
+	uint8_t len;
+
+	srand(1);
+	for (int i = 0; i < sizeof(septets); i++) {
+		septets[i] = rand() & 0x7F;
+	}
+
+	for (int n = 0; n < sizeof(septets); n++) {
+		memcpy(packed, septets, n);
+		packed_len = string_conversion_7bit_sms_packing(packed, n);
+
+		TEST_ASSERT_EQUAL(ref_7bit_packing(septets, n, expected), packed_len);
+
+		memset(unpacked, 0xFF, sizeof(unpacked));
+		len = string_conversion_7bit_sms_unpacking(packed, unpacked, n);
+
+		TEST_ASSERT_EQUAL(n, len);
+		if (n > 0) {
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, packed, packed_len);
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(septets, unpacked, n);
+		}
+		if (n < sizeof(unpacked)) {
+			/* Nothing written beyond the requested number of characters */
+			TEST_ASSERT_EQUAL_HEX8(0xFF, unpacked[n]);
+		}
+	}
+}
+
+/** Conversion with packing gives the same result as conversion followed by packing. */
+void test_string_conversion_ascii_to_gsm7bit_packed(void)
+{
+	/* Extension table characters force escape codes at varying positions */
+	const uint8_t *text = "Hello [world] {12345} ~^|\\ \xa4 1234567890123456789012345678901234567890"
+		"12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+		"123456789012345678901234567890123456789012345678901234567890";
+	uint8_t unpacked[SMS_MAX_PAYLOAD_LEN_CHARS];
+	uint8_t packed[SMS_MAX_PAYLOAD_LEN_CHARS];
+	uint8_t ascii[SMS_MAX_PAYLOAD_LEN_CHARS];
+	uint8_t unpacked_chars, unpacked_bytes;
+	uint8_t packed_chars, packed_bytes;
+	uint8_t converted;
+
+	for (int n = 0; n <= strlen((const char *)text); n++) {
+		converted = string_conversion_ascii_to_gsm7bit(
+			text, n, unpacked, &unpacked_bytes, &unpacked_chars, false);
+		TEST_ASSERT_EQUAL(converted, string_conversion_ascii_to_gsm7bit(
+			text, n, packed, &packed_bytes, &packed_chars, true));
+
+		TEST_ASSERT_EQUAL(unpacked_chars, unpacked_bytes);
+		TEST_ASSERT_EQUAL(unpacked_chars, packed_chars);
+		TEST_ASSERT_EQUAL(string_conversion_7bit_sms_packing(unpacked, unpacked_chars),
+				  packed_bytes);
+		if (packed_bytes > 0) {
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(unpacked, packed, packed_bytes);
+		}
+
+		TEST_ASSERT_EQUAL(converted,
+			string_conversion_gsm7bit_to_ascii(packed, ascii, packed_chars, true));
+		TEST_ASSERT_EQUAL_MEMORY(text, ascii, converted);
+	}
+}
+
+/**
+ * Compare the throughput of packing and unpacking a full message with the reference
+ * implementation placing one septet at a time.
+ *
+ * Note that on native_posix the cycle counter is driven by simulated time, so the
+ * cycle counts are only meaningful when run on QEMU or hardware.
+ */
+void test_string_conversion_7bit_packing_throughput(void)
+{
+	static uint8_t septets[SMS_MAX_PAYLOAD_LEN_CHARS];
+	static uint8_t packed[SMS_MAX_PAYLOAD_LEN_CHARS];
+	static uint8_t unpacked[SMS_MAX_PAYLOAD_LEN_CHARS];
+	uint32_t ref_cycles;
+	uint32_t cycles;
+	uint32_t start;
+
+	for (int i = 0; i < sizeof(septets); i++) {
+		septets[i] = 'A' + i % 26;
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < PACK_BENCH_ROUNDS; i++) {
+		ref_7bit_packing(septets, sizeof(septets), packed);
+		ref_7bit_unpacking(packed, sizeof(septets), unpacked);
+	}
+	ref_cycles = k_cycle_get_32() - start;
+	TEST_ASSERT_EQUAL_MEMORY(septets, unpacked, sizeof(septets));
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < PACK_BENCH_ROUNDS; i++) {
+		memcpy(packed, septets, sizeof(septets));
+		string_conversion_7bit_sms_packing(packed, sizeof(septets));
+		string_conversion_7bit_sms_unpacking(packed, unpacked, sizeof(septets));
+	}
+	cycles = k_cycle_get_32() - start;
+	TEST_ASSERT_EQUAL_MEMORY(septets, unpacked, sizeof(septets));
+
+	printk("Packing and unpacking %d characters %d times: "
+	       "reference %u cycles, library %u cycles\n",
+	       SMS_MAX_PAYLOAD_LEN_CHARS, PACK_BENCH_ROUNDS, ref_cycles, cycles);
+
+	if (ref_cycles > 0) {
+		TEST_ASSERT_TRUE(cycles < ref_cycles);
+	}
+}
+
 /* It is required to be added to each test. That is because unity is using
  * different main signature (returns int) and zephyr expects main which does
  * not return value.
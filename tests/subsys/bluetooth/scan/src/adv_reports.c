@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <bluetooth/gap.h>
+
+#include "adv_reports.h"
+
+/* Advertising data layouts of the common asset tag formats. The variable
+ * fields are filled in for every tag.
+ */
+static const uint8_t name_report[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR,
+	0x03, BT_DATA_GAP_APPEARANCE, 0x00, 0x02,
+	0x08, BT_DATA_NAME_COMPLETE, 'T', 'a', 'g', '0', '0', '0', '0',
+};
+
+static const uint8_t uuid16_report[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR,
+	0x05, BT_DATA_UUID16_ALL, 0x0f, 0x18, 0x00, 0x00,
+	0x02, BT_DATA_TX_POWER, 0x00,
+};
+
+static const uint8_t ibeacon_report[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+	0x1a, BT_DATA_MANUFACTURER_DATA, 0x4c, 0x00, 0x02, 0x15,
+	0xe2, 0xc5, 0x6d, 0xb5, 0xdf, 0xfb, 0x48, 0xd2,
+	0xb0, 0x60, 0xd0, 0xf5, 0xa7, 0x10, 0x96, 0xe0,
+	0x00, 0x01, 0x00, 0x00, 0xc5,
+};
+
+static const uint8_t eddystone_report[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR,
+	0x03, BT_DATA_UUID16_ALL, 0xaa, 0xfe,
+	0x11, BT_DATA_SVC_DATA16, 0xaa, 0xfe, 0x20, 0x00,
+	0x0b, 0xb8, 0x18, 0x00, 0x00, 0x00, 0x00, 0x10,
+	0x00, 0x00, 0x00, 0x00,
+};
+
+void adv_report_addr_get(uint16_t tag_id, bt_addr_le_t *addr)
+{
+	addr->type = BT_ADDR_LE_RANDOM;
+	addr->a.val[0] = tag_id & 0xff;
+	addr->a.val[1] = tag_id >> 8;
+	addr->a.val[2] = 0x5a;
+	addr->a.val[3] = 0x3c;
+	addr->a.val[4] = 0x11;
+	/* Static random address. */
+	addr->a.val[5] = 0xc7;
+}
+
+void adv_report_name_get(uint16_t tag_id, char *name, size_t size)
+{
+	snprintk(name, size, ADV_REPORT_NAME_PREFIX "%04u", tag_id);
+}
+
+size_t adv_report_build(enum adv_report_kind kind, uint16_t tag_id,
+			uint8_t *buf, size_t size)
+{
+	size_t len;
+
+	switch (kind) {
+	case ADV_REPORT_NAME:
+	{
+		char name[sizeof(ADV_REPORT_NAME_PREFIX) + 4];
+
+		len = sizeof(name_report);
+		__ASSERT_NO_MSG(len <= size);
+		memcpy(buf, name_report, len);
+
+		adv_report_name_get(tag_id, name, sizeof(name));
+		memcpy(&buf[len - strlen(name)], name, strlen(name));
+		break;
+	}
+
+	case ADV_REPORT_UUID16:
+		len = sizeof(uuid16_report);
+		__ASSERT_NO_MSG(len <= size);
+		memcpy(buf, uuid16_report, len);
+
+		sys_put_le16(ADV_REPORT_UUID16_BASE +
+			     (tag_id % ADV_REPORT_UUID16_CNT), &buf[7]);
+		break;
+
+	case ADV_REPORT_IBEACON:
+		len = sizeof(ibeacon_report);
+		__ASSERT_NO_MSG(len <= size);
+		memcpy(buf, ibeacon_report, len);
+
+		/* Minor */
+		sys_put_be16(tag_id, &buf[27]);
+		break;
+
+	case ADV_REPORT_EDDYSTONE:
+		len = sizeof(eddystone_report);
+		__ASSERT_NO_MSG(len <= size);
+		memcpy(buf, eddystone_report, len);
+
+		/* Advertising PDU count */
+		sys_put_be32(tag_id, &buf[17]);
+		break;
+
+	default:
+		__ASSERT_NO_MSG(false);
+		len = 0;
+		break;
+	}
+
+	return len;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ADV_REPORTS_H_
+#define _ADV_REPORTS_H_
+
+#include <zephyr/types.h>
+#include <bluetooth/addr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Name prefix advertised by the tags. */
+#define ADV_REPORT_NAME_PREFIX	"Tag"
+
+/* 16-bit UUIDs advertised by the tags start from this value. */
+#define ADV_REPORT_UUID16_BASE	0xFD00
+
+/* Number of distinct 16-bit UUIDs advertised by the tags. */
+#define ADV_REPORT_UUID16_CNT	128
+
+enum adv_report_kind {
+	ADV_REPORT_NAME,
+	ADV_REPORT_UUID16,
+	ADV_REPORT_IBEACON,
+	ADV_REPORT_EDDYSTONE,
+
+	ADV_REPORT_KIND_COUNT
+};
+
+/** Get the address of a tag. */
+void adv_report_addr_get(uint16_t tag_id, bt_addr_le_t *addr);
+
+/** Get the name advertised by a tag. */
+void adv_report_name_get(uint16_t tag_id, char *name, size_t size);
+
+/** Build the advertising data of a tag.
+ *
+ * @return Length of the advertising data.
+ */
+size_t adv_report_build(enum adv_report_kind kind, uint16_t tag_id,
+			uint8_t *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ADV_REPORTS_H_ */
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Benchmark of the scan library filters with filter lists in the hundreds.
+ * Advertising reports of a large tag population are replayed directly to the
+ * scan library callback. The same test is built with and without
+ * CONFIG_BT_SCAN_FILTER_INDEX (see testcase.yaml).
+ *
+ * The advertising report deduplication is tested in a separate build with
+ * CONFIG_BT_SCAN_DEDUP enabled, as the cache would drop the replayed reports.
+ */
+
+#include <ztest.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#include "adv_reports.h"
+
+#define TAG_CNT		1000
+#define REPORT_CNT	2000
+#define ROUND_CNT	10
+
+/* Every fifth tag is on the address filter list. */
+#define TAG_ADDR_FILTERED(id)	(((id) % 5) == 0)
+/* Every tenth tag, starting from the third one, is on the name list. */
+#define TAG_NAME_FILTERED(id)	(((id) % 10) == 3)
+/* Every twentieth tag is on the blocklist. */
+#define TAG_BLOCKED(id)		(((id) % 20) == 0)
+/* Every second advertised UUID is on the UUID filter list. */
+#define TAG_UUID_FILTERED(id)	((((id) % ADV_REPORT_UUID16_CNT) % 2) == 0)
+
+BUILD_ASSERT(TAG_CNT / 5 <= CONFIG_BT_SCAN_ADDRESS_CNT);
+BUILD_ASSERT(TAG_CNT / 10 <= CONFIG_BT_SCAN_NAME_CNT);
+BUILD_ASSERT(TAG_CNT / 20 <= CONFIG_BT_SCAN_BLOCKLIST_LEN);
+BUILD_ASSERT(ADV_REPORT_UUID16_CNT / 2 <= CONFIG_BT_SCAN_UUID_CNT);
+
+static struct bt_le_scan_cb *scan_cb;
+static size_t match_cnt;
+static size_t no_match_cnt;
+static struct bt_scan_filter_match last_filter_match;
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	match_cnt++;
+	last_filter_match = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, scan_filter_match, scan_filter_no_match,
+		NULL, NULL);
+
+static void filters_setup(void)
+{
+	int err;
+
+	for (uint16_t id = 0; id < TAG_CNT; id++) {
+		bt_addr_le_t addr;
+		char name[CONFIG_BT_SCAN_NAME_MAX_LEN];
+
+		adv_report_addr_get(id, &addr);
+
+		if (TAG_ADDR_FILTERED(id)) {
+			err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+			zassert_ok(err, "Cannot add address filter (err %d)", err);
+		}
+
+		if (TAG_BLOCKED(id)) {
+			err = bt_scan_blocklist_device_add(&addr);
+			zassert_ok(err, "Cannot add blocklist device (err %d)", err);
+		}
+
+		if (TAG_NAME_FILTERED(id)) {
+			adv_report_name_get(id, name, sizeof(name));
+			err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, name);
+			zassert_ok(err, "Cannot add name filter (err %d)", err);
+		}
+	}
+
+	for (uint16_t i = 0; i < ADV_REPORT_UUID16_CNT; i++) {
+		struct bt_uuid_16 uuid = BT_UUID_INIT_16(ADV_REPORT_UUID16_BASE + i);
+
+		if (TAG_UUID_FILTERED(i)) {
+			err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid);
+			zassert_ok(err, "Cannot add UUID filter (err %d)", err);
+		}
+	}
+
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER | BT_SCAN_NAME_FILTER |
+				    BT_SCAN_UUID_FILTER, false);
+	zassert_ok(err, "Cannot enable filters (err %d)", err);
+}
+
+static bool report_expected_match(uint16_t id, enum adv_report_kind kind)
+{
+	return TAG_ADDR_FILTERED(id) ||
+	       ((kind == ADV_REPORT_NAME) && TAG_NAME_FILTERED(id)) ||
+	       ((kind == ADV_REPORT_UUID16) && TAG_UUID_FILTERED(id));
+}
+
+static void report_recv(const bt_addr_le_t *addr, uint8_t *data, size_t len,
+			bool scan_rsp)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.rssi = -60,
+		.adv_type = scan_rsp ? BT_GAP_ADV_TYPE_SCAN_RSP :
+				       BT_GAP_ADV_TYPE_ADV_IND,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE |
+			     BT_GAP_ADV_PROP_SCANNABLE |
+			     (scan_rsp ? BT_GAP_ADV_PROP_SCAN_RESPONSE : 0),
+	};
+	struct net_buf_simple ad;
+
+	zassert_not_null(scan_cb, "Scan callback not registered");
+
+	net_buf_simple_init_with_data(&ad, data, len);
+	scan_cb->recv(&info, &ad);
+}
+
+static void test_filter_replay(void)
+{
+	static uint8_t data[REPORT_CNT][BT_GAP_ADV_MAX_ADV_DATA_LEN];
+	static uint8_t data_len[REPORT_CNT];
+	static bt_addr_le_t addr[REPORT_CNT];
+	size_t expected_match = 0;
+	size_t expected_no_match = 0;
+
+	if (IS_ENABLED(CONFIG_BT_SCAN_DEDUP)) {
+		ztest_test_skip();
+		return;
+	}
+
+	filters_setup();
+
+	for (size_t i = 0; i < REPORT_CNT; i++) {
+		uint16_t id = (i * 7) % TAG_CNT;
+		enum adv_report_kind kind = i % ADV_REPORT_KIND_COUNT;
+
+		adv_report_addr_get(id, &addr[i]);
+		data_len[i] = adv_report_build(kind, id, data[i],
+					       sizeof(data[i]));
+
+		if (TAG_BLOCKED(id)) {
+			continue;
+		}
+
+		if (report_expected_match(id, kind)) {
+			expected_match++;
+		} else {
+			expected_no_match++;
+		}
+	}
+
+	uint64_t cycles = 0;
+
+	for (size_t round = 0; round < ROUND_CNT; round++) {
+		match_cnt = 0;
+		no_match_cnt = 0;
+
+		uint32_t start = k_cycle_get_32();
+
+		for (size_t i = 0; i < REPORT_CNT; i++) {
+			report_recv(&addr[i], data[i], data_len[i], false);
+		}
+
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(match_cnt, expected_match,
+			      "Invalid match count %zu", match_cnt);
+		zassert_equal(no_match_cnt, expected_no_match,
+			      "Invalid no match count %zu", no_match_cnt);
+	}
+
+	TC_PRINT("Filter index %s: %u reports, %u ns per report\n",
+		 IS_ENABLED(CONFIG_BT_SCAN_FILTER_INDEX) ? "on" : "off",
+		 REPORT_CNT * ROUND_CNT,
+		 (uint32_t)(k_cyc_to_ns_floor64(cycles) /
+			    (REPORT_CNT * ROUND_CNT)));
+}
+
+static void test_uuid_filter_status(void)
+{
+	/* Both UUIDs are on the filter list, but advertised in the reverse
+	 * order of adding the filters.
+	 */
+	uint8_t data[] = {
+		5, BT_DATA_UUID16_ALL,
+		BT_UUID_16_ENCODE(ADV_REPORT_UUID16_BASE + 4),
+		BT_UUID_16_ENCODE(ADV_REPORT_UUID16_BASE + 2),
+	};
+	bt_addr_le_t addr;
+
+	BUILD_ASSERT(TAG_UUID_FILTERED(2) && TAG_UUID_FILTERED(4));
+	BUILD_ASSERT(!TAG_ADDR_FILTERED(1) && !TAG_BLOCKED(1));
+
+	if (IS_ENABLED(CONFIG_BT_SCAN_DEDUP)) {
+		ztest_test_skip();
+		return;
+	}
+
+	/* Filters are set up by test_filter_replay. */
+	match_cnt = 0;
+	adv_report_addr_get(1, &addr);
+	report_recv(&addr, data, sizeof(data), false);
+
+	zassert_equal(match_cnt, 1, "UUID filter not matched");
+	zassert_true(last_filter_match.uuid.match, "UUID match not reported");
+	zassert_equal(last_filter_match.uuid.count, 1,
+		      "Invalid UUID match count %u",
+		      last_filter_match.uuid.count);
+	zassert_equal(bt_uuid_cmp(last_filter_match.uuid.uuid[0],
+				  BT_UUID_DECLARE_16(ADV_REPORT_UUID16_BASE + 2)),
+		      0, "First added matching filter not reported");
+}
+
+#if CONFIG_BT_SCAN_DEDUP
+static void test_dedup(void)
+{
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+	struct bt_scan_dedup_stats stats;
+	bt_addr_le_t addr;
+	size_t len;
+	int err;
+
+	/* No filter is enabled, so every report passed on is not matched. */
+	bt_scan_dedup_clear();
+	no_match_cnt = 0;
+
+	adv_report_addr_get(0, &addr);
+	len = adv_report_build(ADV_REPORT_EDDYSTONE, 0, data, sizeof(data));
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 1, "New device not reported");
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 1, "Duplicate report not dropped");
+
+	report_recv(&addr, data, len, true);
+	zassert_equal(no_match_cnt, 2, "Scan response not reported");
+
+	len = adv_report_build(ADV_REPORT_EDDYSTONE, 1, data, sizeof(data));
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 3, "Changed data not reported");
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 3, "Duplicate report not dropped");
+
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_INTERVAL));
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 4, "Report not repeated after interval");
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Cannot get statistics (err %d)", err);
+	zassert_equal(stats.hit, 2, "Invalid hit count %u", stats.hit);
+	zassert_equal(stats.miss, 4, "Invalid miss count %u", stats.miss);
+	zassert_equal(stats.evicted, 0, "Invalid eviction count %u",
+		      stats.evicted);
+}
+
+static void test_dedup_lru(void)
+{
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+	struct bt_scan_dedup_stats stats;
+	bt_addr_le_t addr;
+	size_t len;
+	int err;
+
+	bt_scan_dedup_clear();
+	no_match_cnt = 0;
+
+	len = adv_report_build(ADV_REPORT_IBEACON, 0, data, sizeof(data));
+
+	/* Fill the cache. */
+	for (uint16_t id = 0; id < CONFIG_BT_SCAN_DEDUP_CACHE_SIZE; id++) {
+		adv_report_addr_get(id, &addr);
+		report_recv(&addr, data, len, false);
+	}
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE,
+		      "New devices not reported");
+
+	/* Make the first device the most recently seen one. */
+	adv_report_addr_get(0, &addr);
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE,
+		      "Duplicate report not dropped");
+
+	/* The second device is the least recently seen one and is evicted. */
+	adv_report_addr_get(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE, &addr);
+	report_recv(&addr, data, len, false);
+
+	adv_report_addr_get(0, &addr);
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 1,
+		      "Recently seen device evicted");
+
+	adv_report_addr_get(1, &addr);
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 2,
+		      "Evicted device not reported");
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Cannot get statistics (err %d)", err);
+	zassert_equal(stats.hit, 2, "Invalid hit count %u", stats.hit);
+	zassert_equal(stats.miss, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 2,
+		      "Invalid miss count %u", stats.miss);
+	zassert_equal(stats.evicted, 2, "Invalid eviction count %u",
+		      stats.evicted);
+}
+
+static void test_dedup_filter_change(void)
+{
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+	struct bt_scan_dedup_stats stats;
+	bt_addr_le_t addr;
+	size_t len;
+	int err;
+
+	BUILD_ASSERT(TAG_ADDR_FILTERED(5) && !TAG_BLOCKED(5));
+
+	bt_scan_dedup_clear();
+	match_cnt = 0;
+	no_match_cnt = 0;
+
+	adv_report_addr_get(5, &addr);
+	len = adv_report_build(ADV_REPORT_IBEACON, 5, data, sizeof(data));
+
+	report_recv(&addr, data, len, false);
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 1, "Duplicate report not dropped");
+
+	/* The cache is cleared when a filter is added. */
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_ok(err, "Cannot add address filter (err %d)", err);
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(no_match_cnt, 2, "Report dropped after filter add");
+
+	/* The cache is cleared when the filters are enabled. */
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_ok(err, "Cannot enable filters (err %d)", err);
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(match_cnt, 1, "Report dropped after filter enable");
+
+	report_recv(&addr, data, len, false);
+	zassert_equal(match_cnt, 1, "Duplicate report not dropped");
+
+	/* The statistics are kept. */
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Cannot get statistics (err %d)", err);
+	zassert_equal(stats.hit, 2, "Invalid hit count %u", stats.hit);
+	zassert_equal(stats.miss, 3, "Invalid miss count %u", stats.miss);
+
+	bt_scan_filter_disable();
+	bt_scan_filter_remove_all();
+}
+#else
+static void test_dedup(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dedup_lru(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dedup_filter_change(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+void test_main(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	ztest_test_suite(scan_filter_tests,
+			 ztest_unit_test(test_filter_replay),
+			 ztest_unit_test(test_uuid_filter_status),
+			 ztest_unit_test(test_dedup),
+			 ztest_unit_test(test_dedup_lru),
+			 ztest_unit_test(test_dedup_filter_change)
+			 );
+
+	ztest_run_test_suite(scan_filter_tests);
+}
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <ztest.h>
+#include <device.h>
+#include <drivers/flash.h>
+#include <settings/settings.h>
+#include <dfu/dfu_target_stream.h>
+
+#define SLOW_FLASH_NAME "SLOW_FLASH"
+#define SLOW_FLASH_PAGE_SIZE 4096
+#define SLOW_FLASH_PAGES 32
+#define SLOW_FLASH_SIZE (SLOW_FLASH_PAGE_SIZE * SLOW_FLASH_PAGES)
+#define SLOW_FLASH_WRITE_BLOCK_SIZE 4
+
+/* Erase and write times of the nRF9160 internal flash */
+#define ERASE_TIME_MS 87
+#define WRITE_TIME_US_PER_BLOCK 41
+
+#define TEST_ID "bench"
+#define TEST_KEY "dfu/" TEST_ID
+
+#define IMAGE_SIZE (16 * SLOW_FLASH_PAGE_SIZE)
+#define FRAGMENT_SIZE 1024
+
+/* Time to receive one fragment, around 400 kbit/s */
+#define FRAGMENT_TIME_MS 20
+
+static const struct device *fdev;
+static uint8_t stream_buf[1024];
+static uint8_t fragment[FRAGMENT_SIZE];
+static uint8_t read_buf[SLOW_FLASH_PAGE_SIZE];
+
+/* Flash device that takes as long to erase and write as real flash, and only
+ * accepts writes to erased memory.
+ */
+static uint8_t slow_flash[SLOW_FLASH_SIZE];
+
+static int slow_flash_read(const struct device *dev, off_t offset,
+			   void *data, size_t len)
+{
+	if (offset < 0 || offset + len > SLOW_FLASH_SIZE) {
+		return -EINVAL;
+	}
+
+	memcpy(data, &slow_flash[offset], len);
+
+	return 0;
+}
+
+static int slow_flash_write(const struct device *dev, off_t offset,
+			    const void *data, size_t len)
+{
+	if (offset < 0 || offset + len > SLOW_FLASH_SIZE ||
+	    offset % SLOW_FLASH_WRITE_BLOCK_SIZE ||
+	    len % SLOW_FLASH_WRITE_BLOCK_SIZE) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		if (slow_flash[offset + i] != 0xff) {
+			return -EIO;
+		}
+	}
+
+	memcpy(&slow_flash[offset], data, len);
+	k_sleep(K_USEC(WRITE_TIME_US_PER_BLOCK *
+		       (len / SLOW_FLASH_WRITE_BLOCK_SIZE)));
+
+	return 0;
+}
+
+static int slow_flash_erase(const struct device *dev, off_t offset,
+			    size_t size)
+{
+	if (offset < 0 || offset + size > SLOW_FLASH_SIZE ||
+	    offset % SLOW_FLASH_PAGE_SIZE || size % SLOW_FLASH_PAGE_SIZE) {
+		return -EINVAL;
+	}
+
+	memset(&slow_flash[offset], 0xff, size);
+	k_sleep(K_MSEC(ERASE_TIME_MS * (size / SLOW_FLASH_PAGE_SIZE)));
+
+	return 0;
+}
+
+static int slow_flash_write_protection(const struct device *dev,
+				       bool enable)
+{
+	return 0;
+}
+
+static const struct flash_parameters slow_flash_parameters = {
+	.write_block_size = SLOW_FLASH_WRITE_BLOCK_SIZE,
+	.erase_value = 0xff,
+};
+
+static const struct flash_parameters *
+slow_flash_get_parameters(const struct device *dev)
+{
+	return &slow_flash_parameters;
+}
+
+static const struct flash_pages_layout slow_flash_layout = {
+	.pages_count = SLOW_FLASH_PAGES,
+	.pages_size = SLOW_FLASH_PAGE_SIZE,
+};
+
+static void slow_flash_page_layout(const struct device *dev,
+				   const struct flash_pages_layout **layout,
+				   size_t *layout_size)
+{
+	*layout = &slow_flash_layout;
+	*layout_size = 1;
+}
+
+static int slow_flash_init(const struct device *dev)
+{
+	memset(slow_flash, 0xff, sizeof(slow_flash));
+
+	return 0;
+}
+
+static const struct flash_driver_api slow_flash_api = {
+	.read = slow_flash_read,
+	.write = slow_flash_write,
+	.erase = slow_flash_erase,
+	.write_protection = slow_flash_write_protection,
+	.get_parameters = slow_flash_get_parameters,
+	.page_layout = slow_flash_page_layout,
+};
+
+DEVICE_DEFINE(slow_flash, SLOW_FLASH_NAME,
+	      slow_flash_init, NULL,
+	      NULL, NULL,
+	      POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+	      &slow_flash_api);
+
+/* Settings backend in RAM that counts the number of writes. */
+struct ram_setting {
+	bool used;
+	char name[32];
+	uint8_t value[16];
+	size_t len;
+};
+
+static struct ram_setting ram_settings[4];
+static int settings_writes;
+
+static struct ram_setting *ram_setting_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].used &&
+		    !strcmp(ram_settings[i].name, name)) {
+			return &ram_settings[i];
+		}
+	}
+
+	return NULL;
+}
+
+static ssize_t ram_setting_read(void *cb_arg, void *data, size_t len)
+{
+	struct ram_setting *setting = cb_arg;
+
+	len = MIN(len, setting->len);
+	memcpy(data, setting->value, len);
+
+	return len;
+}
+
+static int ram_settings_load(struct settings_store *cs,
+			     const struct settings_load_arg *arg)
+{
+	for (int i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].used) {
+			settings_call_set_handler(ram_settings[i].name,
+						  ram_settings[i].len,
+						  ram_setting_read,
+						  &ram_settings[i], arg);
+		}
+	}
+
+	return 0;
+}
+
+static int ram_settings_save(struct settings_store *cs, const char *name,
+			     const char *value, size_t val_len)
+{
+	struct ram_setting *setting = ram_setting_find(name);
+
+	if (val_len == 0) {
+		/* Delete */
+		if (setting) {
+			setting->used = false;
+		}
+		return 0;
+	}
+
+	if (val_len > sizeof(setting->value) ||
+	    strlen(name) >= sizeof(setting->name)) {
+		return -ENOMEM;
+	}
+
+	for (int i = 0; setting == NULL && i < ARRAY_SIZE(ram_settings); i++) {
+		if (!ram_settings[i].used) {
+			setting = &ram_settings[i];
+		}
+	}
+
+	if (setting == NULL) {
+		return -ENOMEM;
+	}
+
+	setting->used = true;
+	strcpy(setting->name, name);
+	memcpy(setting->value, value, val_len);
+	setting->len = val_len;
+	settings_writes++;
+
+	return 0;
+}
+
+static const struct settings_store_itf ram_settings_itf = {
+	.csi_load = ram_settings_load,
+	.csi_save = ram_settings_save,
+};
+
+static struct settings_store ram_settings_store = {
+	.cs_itf = &ram_settings_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_dst_register(&ram_settings_store);
+	settings_src_register(&ram_settings_store);
+
+	return 0;
+}
+
+static size_t *stored_progress(void)
+{
+	struct ram_setting *setting = ram_setting_find(TEST_KEY);
+
+	if (setting == NULL) {
+		return NULL;
+	}
+
+	return (size_t *)setting->value;
+}
+
+static uint8_t image_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7 + (offset >> 8));
+}
+
+static int stream_init(void)
+{
+	return dfu_target_stream_init(&(struct dfu_target_stream_init) {
+		.id = TEST_ID, .fdev = fdev, .buf = stream_buf,
+		.len = sizeof(stream_buf), .offset = 0, .size = 0,
+		.cb = NULL});
+}
+
+/* Simulate the download of the image from 'from' to 'to'. */
+static void receive(size_t from, size_t to)
+{
+	int err;
+
+	for (size_t offset = from; offset < to; offset += FRAGMENT_SIZE) {
+		size_t len = MIN(FRAGMENT_SIZE, to - offset);
+
+		for (size_t i = 0; i < len; i++) {
+			fragment[i] = image_byte(offset + i);
+		}
+
+		k_sleep(K_MSEC(FRAGMENT_TIME_MS));
+
+		err = dfu_target_stream_write(fragment, len);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+}
+
+static void verify_image(void)
+{
+	int err;
+
+	for (size_t offset = 0; offset < IMAGE_SIZE;
+	     offset += sizeof(read_buf)) {
+		err = flash_read(fdev, offset, read_buf, sizeof(read_buf));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		for (size_t i = 0; i < sizeof(read_buf); i++) {
+			zassert_equal(read_buf[i], image_byte(offset + i),
+				      "Incorrect value at %zu", offset + i);
+		}
+	}
+}
+
+static void test_fota_benchmark(void)
+{
+	int err;
+	int64_t start;
+	uint32_t duration;
+
+	settings_writes = 0;
+	start = k_uptime_get();
+
+	err = stream_init();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	receive(0, IMAGE_SIZE);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	duration = (uint32_t)(k_uptime_get() - start);
+
+	TC_PRINT("FOTA of %d bytes in %d byte fragments: %u ms, "
+		 "%d settings writes\n", IMAGE_SIZE, FRAGMENT_SIZE,
+		 duration, settings_writes);
+
+	/* At most one settings write for each page written */
+	zassert_true(settings_writes <= IMAGE_SIZE / SLOW_FLASH_PAGE_SIZE,
+		     "Too many settings writes: %d", settings_writes);
+	zassert_is_null(stored_progress(), "Progress not deleted");
+
+	verify_image();
+}
+
+static void test_resume(void)
+{
+	int err;
+	size_t offset;
+	size_t checkpoint;
+	size_t *progress;
+
+	err = stream_init();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	receive(0, IMAGE_SIZE / 2 + FRAGMENT_SIZE);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* The progress is stored at the start of the page being written */
+	progress = stored_progress();
+	zassert_not_null(progress, "Progress not stored");
+	checkpoint = *progress;
+	zassert_equal(checkpoint % SLOW_FLASH_PAGE_SIZE, 0,
+		      "Progress not stored at page start: %zu", checkpoint);
+	zassert_true(checkpoint <= offset &&
+		     offset - checkpoint < SLOW_FLASH_PAGE_SIZE,
+		     "Unexpected progress %zu at offset %zu", checkpoint, offset);
+
+	/* Abort and resume, the exact progress is stored on abort */
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	progress = stored_progress();
+	zassert_not_null(progress, "Progress not stored");
+	zassert_not_equal(*progress, checkpoint, "Exact progress not stored");
+
+	err = stream_init();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, *progress, "Progress not restored");
+
+	/* Continue within the same page, which must not be erased */
+	receive(offset, offset + FRAGMENT_SIZE);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Abort, and roll back to the page start, as if the device was reset
+	 * before the progress was stored on abort. The page has been written
+	 * past the stored progress, and must be erased when resuming.
+	 */
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	progress = stored_progress();
+	zassert_not_null(progress, "Progress not stored");
+	*progress = checkpoint;
+
+	err = stream_init();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, checkpoint, "Progress not restored");
+
+	receive(offset, IMAGE_SIZE);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_is_null(stored_progress(), "Progress not deleted");
+
+	verify_image();
+}
+
+void test_main(void)
+{
+	fdev = device_get_binding(SLOW_FLASH_NAME);
+
+	ztest_test_suite(lib_dfu_target_stream_benchmark,
+	     ztest_unit_test(test_fota_benchmark),
+	     ztest_unit_test(test_resume)
+	 );
+
+	ztest_run_test_suite(lib_dfu_target_stream_benchmark);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "coalesce_events.h"
+
+
+static bool merge_motion_event(struct event_header *queued,
+			       const struct event_header *eh)
+{
+	struct motion_event *queued_event = cast_motion_event(queued);
+	const struct motion_event *event = cast_motion_event(eh);
+
+	if (queued_event->button != event->button) {
+		return false;
+	}
+
+	queued_event->dx += event->dx;
+	queued_event->dy += event->dy;
+
+	return true;
+}
+
+EVENT_TYPE_DEFINE_COALESCABLE(motion_event,
+			      false,
+			      NULL,
+			      NULL,
+			      merge_motion_event);
+
+EVENT_TYPE_DEFINE(marker_event,
+		  false,
+		  NULL,
+		  NULL);
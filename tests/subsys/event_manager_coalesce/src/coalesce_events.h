@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _COALESCE_EVENTS_H_
+#define _COALESCE_EVENTS_H_
+
+/**
+ * @brief Coalescing test events
+ * @defgroup coalesce_events Coalescing test events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Coalescable event. Events are merged only if the button state is the
+ * same.
+ */
+struct motion_event {
+	struct event_header header;
+
+	int32_t dx;
+	int32_t dy;
+	bool button;
+};
+
+EVENT_TYPE_DECLARE(motion_event);
+
+/* Event marking the end of a test sequence. */
+struct marker_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(marker_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _COALESCE_EVENTS_H_ */
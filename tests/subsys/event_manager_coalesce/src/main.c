@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <event_manager.h>
+
+#include "coalesce_events.h"
+
+#define MOTION_EVENT_CNT 64
+
+static size_t motion_dispatch_cnt;
+static int32_t motion_dx_sum;
+static int32_t motion_dy_sum;
+static K_SEM_DEFINE(marker_sem, 0, 1);
+
+static struct motion_event *motion_event_create(bool button)
+{
+	struct motion_event *event = new_motion_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->dx = 1;
+	event->dy = -2;
+	event->button = button;
+
+	return event;
+}
+
+static void submit_marker(void)
+{
+	struct marker_event *event = new_marker_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	EVENT_SUBMIT(event);
+}
+
+static void wait_for_marker(void)
+{
+	int err = k_sem_take(&marker_sem, K_SECONDS(5));
+
+	zassert_equal(err, 0, "Events were not processed");
+	zassert_equal(motion_dx_sum, MOTION_EVENT_CNT, "Motion lost");
+	zassert_equal(motion_dy_sum, -2 * MOTION_EVENT_CNT, "Motion lost");
+}
+
+static void test_init(void)
+{
+	zassert_false(event_manager_init(), "Error when initializing");
+}
+
+static void test_setup(void)
+{
+	motion_dispatch_cnt = 0;
+	motion_dx_sum = 0;
+	motion_dy_sum = 0;
+}
+
+static void test_submit(void)
+{
+	/* Prevent processing events before all are submitted. */
+	k_sched_lock();
+
+	for (size_t i = 0; i < MOTION_EVENT_CNT; i++) {
+		EVENT_SUBMIT(motion_event_create(false));
+	}
+	submit_marker();
+
+	k_sched_unlock();
+
+	wait_for_marker();
+	zassert_equal(motion_dispatch_cnt, 1, "Events were not merged");
+}
+
+static void test_submit_batch(void)
+{
+	struct event_header *ehs[MOTION_EVENT_CNT + 1];
+
+	for (size_t i = 0; i < MOTION_EVENT_CNT; i++) {
+		ehs[i] = &motion_event_create(false)->header;
+	}
+	ehs[MOTION_EVENT_CNT] = &new_marker_event()->header;
+
+	EVENT_SUBMIT_BATCH(ehs, ARRAY_SIZE(ehs));
+
+	wait_for_marker();
+	zassert_equal(motion_dispatch_cnt, 1, "Events were not merged");
+}
+
+static void test_merge_rejected(void)
+{
+	struct event_header *ehs[MOTION_EVENT_CNT + 1];
+
+	for (size_t i = 0; i < MOTION_EVENT_CNT; i++) {
+		ehs[i] = &motion_event_create(i & 1)->header;
+	}
+	ehs[MOTION_EVENT_CNT] = &new_marker_event()->header;
+
+	EVENT_SUBMIT_BATCH(ehs, ARRAY_SIZE(ehs));
+
+	wait_for_marker();
+	zassert_equal(motion_dispatch_cnt, MOTION_EVENT_CNT,
+		      "Events with different state were merged");
+}
+
+static void test_interleaved(void)
+{
+	struct event_header *ehs[MOTION_EVENT_CNT + 1];
+	size_t half = MOTION_EVENT_CNT / 2;
+
+	for (size_t i = 0; i < half; i++) {
+		ehs[i] = &motion_event_create(false)->header;
+	}
+
+	/* Other event breaks the sequence of coalescable events. */
+	ehs[half] = &new_marker_event()->header;
+
+	for (size_t i = half + 1; i < ARRAY_SIZE(ehs); i++) {
+		ehs[i] = &motion_event_create(false)->header;
+	}
+
+	EVENT_SUBMIT_BATCH(ehs, ARRAY_SIZE(ehs));
+	k_sem_take(&marker_sem, K_SECONDS(5));
+
+	submit_marker();
+	wait_for_marker();
+	zassert_equal(motion_dispatch_cnt, 2, "Invalid number of events");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(event_manager_coalesce_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test_setup_teardown(test_submit,
+						test_setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_submit_batch,
+						test_setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_merge_rejected,
+						test_setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_interleaved,
+						test_setup, unit_test_noop)
+			 );
+
+	ztest_run_test_suite(event_manager_coalesce_tests);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_motion_event(eh)) {
+		const struct motion_event *event = cast_motion_event(eh);
+
+		motion_dispatch_cnt++;
+		motion_dx_sum += event->dx;
+		motion_dy_sum += event->dy;
+
+		return false;
+	}
+
+	if (is_marker_event(eh)) {
+		k_sem_give(&marker_sem);
+
+		return false;
+	}
+
+	zassert_true(false, "Wrong event type received");
+	return false;
+}
+
+EVENT_LISTENER(test_main, event_handler);
+EVENT_SUBSCRIBE(test_main, motion_event);
+EVENT_SUBSCRIBE(test_main, marker_event);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Listener statistics are checked after dispatching a known number of events
+ * to a fast listener and to a listener that busy waits for some events.
+ *
+ * On native_posix the system timer cycle counter is used and busy waiting
+ * advances the simulated time, so the statistics are deterministic.
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <event_manager.h>
+
+#ifdef CONFIG_CPU_CORTEX_M_HAS_DWT
+#include <arch/arm/aarch32/cortex_m/cmsis.h>
+#endif
+
+#include "stats_events.h"
+
+#define FAST_EVENT_CNT		20
+#define SLOW_EVENT_CNT		10
+#define EVENT_CNT		(FAST_EVENT_CNT + SLOW_EVENT_CNT)
+#define SLOW_HANDLER_US		1000
+
+static atomic_t received_cnt;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+
+static bool fast_handler(const struct event_header *eh)
+{
+	return false;
+}
+
+static bool slow_handler(const struct event_header *eh)
+{
+	const struct stats_event *event = cast_stats_event(eh);
+
+	if (event->slow) {
+		k_busy_wait(SLOW_HANDLER_US);
+	}
+
+	return false;
+}
+
+static bool done_handler(const struct event_header *eh)
+{
+	if (atomic_inc(&received_cnt) + 1 == EVENT_CNT) {
+		k_sem_give(&done_sem);
+	}
+
+	return false;
+}
+
+/* Statistics of early listeners are updated before the normal listener
+ * signals that all events were processed.
+ */
+EVENT_LISTENER(fast, fast_handler);
+EVENT_SUBSCRIBE_EARLY(fast, stats_event);
+
+EVENT_LISTENER(slow, slow_handler);
+EVENT_SUBSCRIBE_EARLY(slow, stats_event);
+
+EVENT_LISTENER(done, done_handler);
+EVENT_SUBSCRIBE(done, stats_event);
+
+
+static struct event_listener_stats *listener_stats_get(const char *name)
+{
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		if (!strcmp(el->name, name)) {
+			return el->stats;
+		}
+	}
+
+	zassert_unreachable("Listener %s not found", name);
+	return NULL;
+}
+
+/* Convert time to the unit used by the listener statistics. */
+static uint32_t us_to_stats_cycles(uint32_t us)
+{
+#ifdef CONFIG_CPU_CORTEX_M_HAS_DWT
+	return (uint64_t)us * SystemCoreClock / USEC_PER_SEC;
+#else
+	return k_us_to_cyc_floor32(us);
+#endif
+}
+
+/* Histogram bucket of the given execution time. */
+static size_t stats_bucket(uint32_t cycles)
+{
+	int bucket = (cycles ? (31 - __builtin_clz(cycles)) : 0) -
+		     CONFIG_EVENT_MANAGER_LISTENER_STATS_BUCKET_SHIFT;
+
+	return MIN(MAX(bucket, 0), EVENT_LISTENER_STATS_BUCKET_CNT - 1);
+}
+
+static uint32_t hist_sum(const struct event_listener_stats *stats,
+			 size_t first_bucket)
+{
+	uint32_t sum = 0;
+
+	for (size_t i = first_bucket; i < ARRAY_SIZE(stats->hist); i++) {
+		sum += stats->hist[i];
+	}
+
+	return sum;
+}
+
+static void test_init(void)
+{
+	zassert_false(event_manager_init(), "Error when initializing");
+}
+
+static void test_listener_stats(void)
+{
+	struct event_listener_stats *fast_stats = listener_stats_get("fast");
+	struct event_listener_stats *slow_stats = listener_stats_get("slow");
+	uint32_t slow_cycles = us_to_stats_cycles(SLOW_HANDLER_US);
+
+	memset(fast_stats, 0, sizeof(*fast_stats));
+	memset(slow_stats, 0, sizeof(*slow_stats));
+	atomic_set(&received_cnt, 0);
+
+	for (size_t i = 0; i < EVENT_CNT; i++) {
+		struct stats_event *event = new_stats_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->slow = (i % (EVENT_CNT / SLOW_EVENT_CNT)) == 0;
+		EVENT_SUBMIT(event);
+	}
+
+	int err = k_sem_take(&done_sem, K_SECONDS(5));
+
+	zassert_equal(err, 0, "Events were not processed");
+
+	TC_PRINT("Listener stats: fast max %u cycles, slow max %u cycles, "
+		 "slow handler %u cycles\n",
+		 fast_stats->max, slow_stats->max, slow_cycles);
+
+	zassert_equal(fast_stats->cnt, EVENT_CNT, "Wrong fast listener count");
+	zassert_equal(hist_sum(fast_stats, 0), EVENT_CNT,
+		      "Fast listener histogram does not match count");
+	zassert_true(fast_stats->max < slow_cycles,
+		     "Fast listener max execution time too long");
+	zassert_true(fast_stats->total <= (uint64_t)fast_stats->max * EVENT_CNT,
+		     "Fast listener total inconsistent with max");
+
+	zassert_equal(slow_stats->cnt, EVENT_CNT, "Wrong slow listener count");
+	zassert_equal(hist_sum(slow_stats, 0), EVENT_CNT,
+		      "Slow listener histogram does not match count");
+	zassert_true(hist_sum(slow_stats, stats_bucket(slow_cycles)) >=
+		     SLOW_EVENT_CNT,
+		     "Slow notifications not in the expected buckets");
+	zassert_true(slow_stats->max >= slow_cycles,
+		     "Slow listener max execution time too short");
+	zassert_true(slow_stats->total >= (uint64_t)slow_cycles * SLOW_EVENT_CNT,
+		     "Slow listener total execution time too short");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(event_manager_listener_stats_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_listener_stats)
+			 );
+
+	ztest_run_test_suite(event_manager_listener_stats_tests);
+}
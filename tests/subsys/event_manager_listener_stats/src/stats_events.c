@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "stats_events.h"
+
+
+EVENT_TYPE_DEFINE(stats_event,
+		  false,
+		  NULL,
+		  NULL);
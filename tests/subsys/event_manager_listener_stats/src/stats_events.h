@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _STATS_EVENTS_H_
+#define _STATS_EVENTS_H_
+
+/**
+ * @brief Listener statistics test events
+ * @defgroup stats_events Listener statistics test events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct stats_event {
+	struct event_header header;
+
+	bool slow;
+};
+
+EVENT_TYPE_DECLARE(stats_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _STATS_EVENTS_H_ */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "bench_events.h"
+
+
+EVENT_TYPE_DEFINE(small_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_DEFINE(large_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_DEFINE(dyn_event,
+		  false,
+		  NULL,
+		  NULL);
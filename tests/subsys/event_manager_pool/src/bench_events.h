@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _BENCH_EVENTS_H_
+#define _BENCH_EVENTS_H_
+
+/**
+ * @brief Memory pool benchmark events
+ * @defgroup bench_events Memory pool benchmark events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct small_event {
+	struct event_header header;
+
+	int16_t dx;
+	int16_t dy;
+};
+
+EVENT_TYPE_DECLARE(small_event);
+
+struct large_event {
+	struct event_header header;
+
+	uint32_t val[16];
+};
+
+EVENT_TYPE_DECLARE(large_event);
+
+struct dyn_event {
+	struct event_header header;
+
+	struct event_dyndata dyndata;
+};
+
+EVENT_TYPE_DYNDATA_DECLARE(dyn_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _BENCH_EVENTS_H_ */
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Benchmark comparing event allocation from the heap and from per event type
+ * memory pools. The same test is built with and without
+ * CONFIG_EVENT_MANAGER_EVENT_POOL (see testcase.yaml).
+ *
+ * Note that on native_posix the cycle counter is driven by simulated time,
+ * so allocation latency is only meaningful when run on hardware.
+ */
+
+#include <ztest.h>
+#include <event_manager.h>
+
+#include "bench_events.h"
+
+#define BURST_SIZE	12
+#define ROUND_CNT	200
+#define APP_BUF_SIZE	48
+#define APP_BUF_CNT	24
+#define DYNDATA_SIZE	20
+
+static atomic_t received_cnt;
+static atomic_t expected_cnt;
+static K_SEM_DEFINE(burst_done_sem, 0, 1);
+
+struct alloc_stats {
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t cnt;
+};
+
+static void stats_update(struct alloc_stats *stats, uint32_t cycles)
+{
+	stats->min = MIN(stats->min, cycles);
+	stats->max = MAX(stats->max, cycles);
+	stats->sum += cycles;
+	stats->cnt++;
+}
+
+static struct event_header *alloc_event(size_t idx)
+{
+	switch (idx % 3) {
+	case 0:
+		return &new_small_event()->header;
+	case 1:
+		return &new_large_event()->header;
+	default:
+		return &new_dyn_event(DYNDATA_SIZE)->header;
+	}
+}
+
+static void submit_burst(struct alloc_stats *stats)
+{
+	struct event_header *burst[BURST_SIZE];
+
+	atomic_set(&received_cnt, 0);
+	atomic_set(&expected_cnt, ARRAY_SIZE(burst));
+
+	for (size_t i = 0; i < ARRAY_SIZE(burst); i++) {
+		uint32_t start = k_cycle_get_32();
+
+		burst[i] = alloc_event(i);
+
+		uint32_t cycles = k_cycle_get_32() - start;
+
+		zassert_not_null(burst[i], "Failed to allocate event");
+		if (stats) {
+			stats_update(stats, cycles);
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(burst); i++) {
+		_event_submit(burst[i]);
+	}
+
+	int err = k_sem_take(&burst_done_sem, K_SECONDS(5));
+
+	zassert_equal(err, 0, "Events were not processed");
+}
+
+/* Find the largest block that can be allocated from the heap. */
+static size_t largest_free_block(void)
+{
+	size_t low = 0;
+	size_t high = CONFIG_HEAP_MEM_POOL_SIZE;
+
+	while (low < high) {
+		size_t mid = (low + high + 1) / 2;
+		void *mem = k_malloc(mid);
+
+		if (mem) {
+			k_free(mem);
+			low = mid;
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return low;
+}
+
+static void test_init(void)
+{
+	zassert_false(event_manager_init(), "Error when initializing");
+}
+
+static void test_alloc_latency(void)
+{
+	struct alloc_stats stats = {
+		.min = UINT32_MAX,
+	};
+
+	for (size_t i = 0; i < ROUND_CNT; i++) {
+		submit_burst(&stats);
+	}
+
+	TC_PRINT("Event allocation (%s): min %u avg %u max %u cycles\n",
+		 IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_POOL) ? "pool" : "heap",
+		 stats.min, (uint32_t)(stats.sum / stats.cnt), stats.max);
+}
+
+static void test_fragmentation(void)
+{
+	void *app_buf[APP_BUF_CNT];
+	size_t initial = largest_free_block();
+
+	/* Long living application allocations are interleaved with
+	 * short living events.
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(app_buf); i++) {
+		submit_burst(NULL);
+		app_buf[i] = k_malloc(APP_BUF_SIZE);
+		zassert_not_null(app_buf[i], "Failed to allocate buffer");
+	}
+
+	size_t fragmented = largest_free_block();
+
+	for (size_t i = 0; i < ARRAY_SIZE(app_buf); i++) {
+		k_free(app_buf[i]);
+	}
+
+	size_t released = largest_free_block();
+
+	TC_PRINT("Largest free heap block (%s): initial %zu, "
+		 "with application buffers %zu, released %zu\n",
+		 IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_POOL) ? "pool" : "heap",
+		 initial, fragmented, released);
+
+	zassert_equal(initial, released, "Memory leak detected");
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+	for (const struct event_type *et = __start_event_types;
+	     et != __stop_event_types;
+	     et++) {
+		TC_PRINT("Pool %s: max used %u, heap allocations %u\n",
+			 et->name, et->pool->max_used,
+			 et->pool->heap_alloc_cnt);
+		zassert_equal(et->pool->heap_alloc_cnt, 0,
+			      "Event allocated from heap");
+	}
+
+	/* Application buffers are allocated back to back. */
+	zassert_true(fragmented + APP_BUF_CNT * (APP_BUF_SIZE + 16) >= initial,
+		     "Heap fragmented");
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(event_manager_pool_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_alloc_latency),
+			 ztest_unit_test(test_fragmentation)
+			 );
+
+	ztest_run_test_suite(event_manager_pool_tests);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (atomic_inc(&received_cnt) + 1 == atomic_get(&expected_cnt)) {
+		k_sem_give(&burst_done_sem);
+	}
+
+	return false;
+}
+
+EVENT_LISTENER(bench, event_handler);
+EVENT_SUBSCRIBE(bench, small_event);
+EVENT_SUBSCRIBE(bench, large_event);
+EVENT_SUBSCRIBE(bench, dyn_event);
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "latency_events.h"
+
+EVENT_QUEUE_DEFINE(urgent_queue, K_PRIO_PREEMPT(1), 1024);
+
+
+EVENT_TYPE_DEFINE(flood_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_DEFINE(urgent_default_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_DEFINE_ON_QUEUE(urgent_queued_event,
+			   false,
+			   NULL,
+			   NULL,
+			   urgent_queue);
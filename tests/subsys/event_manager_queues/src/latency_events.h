@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LATENCY_EVENTS_H_
+#define _LATENCY_EVENTS_H_
+
+/**
+ * @brief Event queue latency test events
+ * @defgroup latency_events Event queue latency test events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Low priority event flooding the system workqueue. */
+struct flood_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(flood_event);
+
+/* Time critical event processed by the system workqueue. */
+struct urgent_default_event {
+	struct event_header header;
+
+	uint32_t submit_cycles;
+};
+
+EVENT_TYPE_DECLARE(urgent_default_event);
+
+/* Time critical event processed by a dedicated queue. */
+struct urgent_queued_event {
+	struct event_header header;
+
+	uint32_t submit_cycles;
+};
+
+EVENT_TYPE_DECLARE(urgent_queued_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _LATENCY_EVENTS_H_ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Test measuring the delay between submitting a time critical event and
+ * notifying its first listener while the system workqueue is flooded
+ * with low priority events.
+ */
+
+#include <ztest.h>
+#include <event_manager.h>
+
+#include "latency_events.h"
+
+#define ROUND_CNT		20
+#define FLOOD_CNT		50
+#define FLOOD_HANDLER_US	200
+
+static atomic_t flood_cnt;
+static uint32_t latency_cycles;
+static K_SEM_DEFINE(flood_done_sem, 0, 1);
+static K_SEM_DEFINE(urgent_done_sem, 0, 1);
+
+struct latency_stats {
+	uint32_t min_us;
+	uint32_t max_us;
+	uint32_t sum_us;
+};
+
+static void flood(void)
+{
+	atomic_set(&flood_cnt, 0);
+
+	for (size_t i = 0; i < FLOOD_CNT; i++) {
+		struct flood_event *event = new_flood_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		EVENT_SUBMIT(event);
+	}
+}
+
+static void measure(struct latency_stats *stats, bool dedicated_queue)
+{
+	*stats = (struct latency_stats) {
+		.min_us = UINT32_MAX,
+	};
+
+	for (size_t i = 0; i < ROUND_CNT; i++) {
+		flood();
+
+		if (dedicated_queue) {
+			struct urgent_queued_event *event =
+				new_urgent_queued_event();
+
+			event->submit_cycles = k_cycle_get_32();
+			EVENT_SUBMIT(event);
+		} else {
+			struct urgent_default_event *event =
+				new_urgent_default_event();
+
+			event->submit_cycles = k_cycle_get_32();
+			EVENT_SUBMIT(event);
+		}
+
+		int err = k_sem_take(&urgent_done_sem, K_SECONDS(5));
+
+		zassert_equal(err, 0, "Urgent event was not processed");
+
+		err = k_sem_take(&flood_done_sem, K_SECONDS(5));
+		zassert_equal(err, 0, "Flood events were not processed");
+
+		uint32_t latency_us = k_cyc_to_us_floor32(latency_cycles);
+
+		stats->min_us = MIN(stats->min_us, latency_us);
+		stats->max_us = MAX(stats->max_us, latency_us);
+		stats->sum_us += latency_us;
+	}
+
+	TC_PRINT("Latency (%s queue): min %u avg %u max %u us\n",
+		 dedicated_queue ? "dedicated" : "default",
+		 stats->min_us, stats->sum_us / ROUND_CNT, stats->max_us);
+}
+
+static void test_init(void)
+{
+	zassert_false(event_manager_init(), "Error when initializing");
+}
+
+static void test_latency(void)
+{
+	struct latency_stats default_stats;
+	struct latency_stats queued_stats;
+
+	measure(&default_stats, false);
+	measure(&queued_stats, true);
+
+	zassert_true(default_stats.min_us >= FLOOD_CNT * FLOOD_HANDLER_US,
+		     "Urgent event not delayed by the flood");
+	zassert_true(queued_stats.max_us < default_stats.min_us,
+		     "Dedicated queue does not reduce latency");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(event_manager_queues_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_latency)
+			 );
+
+	ztest_run_test_suite(event_manager_queues_tests);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_flood_event(eh)) {
+		k_busy_wait(FLOOD_HANDLER_US);
+
+		if (atomic_inc(&flood_cnt) + 1 == FLOOD_CNT) {
+			k_sem_give(&flood_done_sem);
+		}
+
+		return false;
+	}
+
+	if (is_urgent_default_event(eh)) {
+		struct urgent_default_event *event =
+			cast_urgent_default_event(eh);
+
+		latency_cycles = k_cycle_get_32() - event->submit_cycles;
+		k_sem_give(&urgent_done_sem);
+
+		return false;
+	}
+
+	if (is_urgent_queued_event(eh)) {
+		struct urgent_queued_event *event =
+			cast_urgent_queued_event(eh);
+
+		latency_cycles = k_cycle_get_32() - event->submit_cycles;
+		k_sem_give(&urgent_done_sem);
+
+		return false;
+	}
+
+	zassert_true(false, "Wrong event type received");
+	return false;
+}
+
+EVENT_LISTENER(test_main, event_handler);
+EVENT_SUBSCRIBE_EARLY(test_main, urgent_default_event);
+EVENT_SUBSCRIBE_EARLY(test_main, urgent_queued_event);
+EVENT_SUBSCRIBE(test_main, flood_event);
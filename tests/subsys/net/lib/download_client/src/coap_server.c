@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/coap.h>
+
+#include "coap_server.h"
+
+#define STACK_SIZE	2048
+#define PRIORITY	5
+#define DATAGRAM_MAX	(COAP_SERVER_BLOCK_MAX + 64)
+
+struct block_request {
+	int64_t ready_ms;
+	struct sockaddr addr;
+	socklen_t addrlen;
+	size_t offset;
+	enum coap_block_size szx;
+	uint16_t id;
+	uint8_t tkl;
+	uint8_t token[8];
+};
+
+K_MSGQ_DEFINE(block_requests, sizeof(struct block_request), 16, 4);
+
+static int fd = -1;
+static atomic_t request_cnt;
+static atomic_t dropped_cnt;
+static atomic_t loss_period;
+static atomic_t loss_limit;
+static atomic_t block_size_min;
+
+static int request_parse(uint8_t *buf, size_t len, struct block_request *req)
+{
+	struct coap_packet request;
+	int block2;
+
+	if (coap_packet_parse(&request, buf, len, NULL, 0)) {
+		return -EINVAL;
+	}
+
+	block2 = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		block2 = COAP_BLOCK_1024;
+	}
+
+	/* Block2 option value: NUM (block number), M (more), SZX */
+	req->szx = MIN(block2 & 0x7, COAP_BLOCK_512);
+	req->offset = (block2 >> 4) * coap_block_size_to_bytes(block2 & 0x7);
+	req->id = coap_header_get_id(&request);
+	req->tkl = coap_header_get_token(&request, req->token);
+
+	return 0;
+}
+
+/* Receive the requests and timestamp them as they arrive. */
+static void receiver_thread(void *p1, void *p2, void *p3)
+{
+	static uint8_t buf[DATAGRAM_MAX];
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(COAP_SERVER_PORT),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+	struct block_request req;
+	ssize_t len;
+	size_t period;
+	size_t limit;
+	size_t idx;
+
+	fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		printk("Cannot start CoAP server, errno %d\n", errno);
+		return;
+	}
+
+	while (true) {
+		req.addrlen = sizeof(req.addr);
+		len = recvfrom(fd, buf, sizeof(buf), 0, &req.addr,
+			       &req.addrlen);
+		if (len <= 0 || request_parse(buf, len, &req)) {
+			continue;
+		}
+
+		if (coap_block_size_to_bytes(req.szx) <
+		    atomic_get(&block_size_min)) {
+			atomic_set(&block_size_min,
+				   coap_block_size_to_bytes(req.szx));
+		}
+
+		/* atomic_inc() returns the previous value. */
+		idx = atomic_inc(&request_cnt);
+		period = atomic_get(&loss_period);
+		limit = atomic_get(&loss_limit);
+		if (period && (idx % period) == period - 1 &&
+		    (!limit || idx < limit)) {
+			atomic_inc(&dropped_cnt);
+			continue;
+		}
+
+		req.ready_ms = k_uptime_get() + COAP_SERVER_LATENCY_MS;
+		k_msgq_put(&block_requests, &req, K_FOREVER);
+	}
+}
+
+/* Answer the requests once the link latency has elapsed. */
+static void sender_thread(void *p1, void *p2, void *p3)
+{
+	static uint8_t buf[DATAGRAM_MAX];
+	static uint8_t payload[COAP_SERVER_BLOCK_MAX];
+	struct coap_block_context block_ctx;
+	struct block_request req;
+	struct coap_packet response;
+	size_t len;
+	int64_t now;
+
+	while (true) {
+		k_msgq_get(&block_requests, &req, K_FOREVER);
+
+		now = k_uptime_get();
+		if (req.ready_ms > now) {
+			k_sleep(K_MSEC(req.ready_ms - now));
+		}
+
+		block_ctx = (struct coap_block_context) {
+			.block_size = req.szx,
+			.current = req.offset,
+			.total_size = COAP_SERVER_FILE_SIZE,
+		};
+
+		len = MIN(coap_block_size_to_bytes(req.szx),
+			  COAP_SERVER_FILE_SIZE - req.offset);
+		for (size_t i = 0; i < len; i++) {
+			payload[i] = coap_server_file_byte(req.offset + i);
+		}
+
+		if (coap_packet_init(&response, buf, sizeof(buf), 1,
+				     COAP_TYPE_ACK, req.tkl, req.token,
+				     COAP_RESPONSE_CODE_CONTENT, req.id) ||
+		    coap_append_block2_option(&response, &block_ctx) ||
+		    coap_append_size2_option(&response, &block_ctx) ||
+		    coap_packet_append_payload_marker(&response) ||
+		    coap_packet_append_payload(&response, payload, len)) {
+			printk("Cannot create CoAP response\n");
+			continue;
+		}
+
+		(void)sendto(fd, response.data, response.offset, 0,
+			     &req.addr, req.addrlen);
+	}
+}
+
+K_THREAD_STACK_DEFINE(receiver_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(sender_stack, STACK_SIZE);
+static struct k_thread receiver;
+static struct k_thread sender;
+
+void coap_server_start(void)
+{
+	k_thread_create(&receiver, receiver_stack,
+			K_THREAD_STACK_SIZEOF(receiver_stack), receiver_thread,
+			NULL, NULL, NULL, PRIORITY, 0, K_NO_WAIT);
+	k_thread_create(&sender, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender_thread,
+			NULL, NULL, NULL, PRIORITY, 0, K_NO_WAIT);
+}
+
+void coap_server_loss_set(size_t period, size_t limit)
+{
+	atomic_set(&loss_period, period);
+	atomic_set(&loss_limit, limit);
+	atomic_set(&request_cnt, 0);
+	atomic_set(&dropped_cnt, 0);
+	atomic_set(&block_size_min, COAP_SERVER_BLOCK_MAX);
+}
+
+size_t coap_server_request_cnt(void)
+{
+	return atomic_get(&request_cnt);
+}
+
+size_t coap_server_dropped_cnt(void)
+{
+	return atomic_get(&dropped_cnt);
+}
+
+size_t coap_server_block_size_min(void)
+{
+	return atomic_get(&block_size_min);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef COAP_SERVER_H_
+#define COAP_SERVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COAP_SERVER_PORT	5683
+
+/* Time between a request reaching the server and its response being sent,
+ * standing in for the round-trip time of the link.
+ */
+#define COAP_SERVER_LATENCY_MS	50
+
+/* Size of the file served for any request. */
+#define COAP_SERVER_FILE_SIZE	(32 * 512 + 100)
+
+/* Largest block size used by the server. */
+#define COAP_SERVER_BLOCK_MAX	512
+
+/* Start a minimal CoAP server answering Block2 requests on the loopback
+ * interface.
+ */
+void coap_server_start(void);
+
+/* Drop one request out of every `period` requests among the first `limit`
+ * requests received, or among all requests if `limit` is zero. No request is
+ * dropped if `period` is zero. Reset the server counters.
+ */
+void coap_server_loss_set(size_t period, size_t limit);
+
+/* Return the content of the served file at a given offset. */
+static inline uint8_t coap_server_file_byte(size_t off)
+{
+	return (uint8_t)(off % 241);
+}
+
+/* Return the number of requests received, including dropped ones. */
+size_t coap_server_request_cnt(void);
+
+/* Return the number of requests dropped. */
+size_t coap_server_dropped_cnt(void);
+
+/* Return the smallest block size requested, in bytes. */
+size_t coap_server_block_size_min(void);
+
+#endif /* COAP_SERVER_H_ */
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "http_server.h"
+
+#define STACK_SIZE	2048
+#define PRIORITY	5
+#define REQUEST_MAX_LEN	512
+
+struct range_request {
+	int64_t ready_ms;
+	size_t from;
+	size_t to;
+};
+
+K_MSGQ_DEFINE(requests, sizeof(struct range_request), 16, 4);
+
+static int client_fd = -1;
+static atomic_t request_cnt;
+static atomic_t outstanding;
+static atomic_t max_outstanding;
+
+static int range_parse(const char *request, struct range_request *range)
+{
+	const char *p = strstr(request, "Range: bytes=");
+
+	if (!p) {
+		return -EINVAL;
+	}
+
+	p += strlen("Range: bytes=");
+	range->from = strtoul(p, (char **)&p, 10);
+	if (*p != '-') {
+		return -EINVAL;
+	}
+
+	range->to = strtoul(p + 1, NULL, 10);
+	range->to = MIN(range->to, HTTP_SERVER_FILE_SIZE - 1);
+
+	return 0;
+}
+
+static void request_received(const char *request)
+{
+	struct range_request range;
+	atomic_val_t cnt;
+
+	if (range_parse(request, &range)) {
+		printk("Invalid request: %s\n", request);
+		return;
+	}
+
+	range.ready_ms = k_uptime_get() + HTTP_SERVER_LATENCY_MS;
+
+	atomic_inc(&request_cnt);
+	cnt = atomic_inc(&outstanding) + 1;
+	if (cnt > atomic_get(&max_outstanding)) {
+		atomic_set(&max_outstanding, cnt);
+	}
+
+	k_msgq_put(&requests, &range, K_FOREVER);
+}
+
+/* Accept connections and timestamp the requests as they arrive. */
+static void receiver_thread(void *p1, void *p2, void *p3)
+{
+	static char buf[REQUEST_MAX_LEN + 1];
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(HTTP_SERVER_PORT),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0 ||
+	    bind(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(fd, 1)) {
+		printk("Cannot start HTTP server, errno %d\n", errno);
+		return;
+	}
+
+	while (true) {
+		size_t len = 0;
+
+		client_fd = accept(fd, NULL, NULL);
+		if (client_fd < 0) {
+			continue;
+		}
+
+		while (true) {
+			ssize_t rc;
+			char *end;
+
+			rc = recv(client_fd, buf + len, REQUEST_MAX_LEN - len, 0);
+			if (rc <= 0) {
+				break;
+			}
+			len += rc;
+			buf[len] = '\0';
+
+			/* Handle every complete request in the buffer. */
+			while ((end = strstr(buf, "\r\n\r\n")) != NULL) {
+				end += strlen("\r\n\r\n");
+				end[-1] = '\0';
+				request_received(buf);
+
+				len -= end - buf;
+				memmove(buf, end, len);
+				buf[len] = '\0';
+			}
+		}
+
+		close(client_fd);
+		client_fd = -1;
+	}
+}
+
+static int response_send(const char *buf, size_t len)
+{
+	while (len) {
+		ssize_t sent = send(client_fd, buf, len, 0);
+
+		if (sent <= 0) {
+			return -errno;
+		}
+		buf += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+/* Answer the requests in order, once the link latency has elapsed. */
+static void sender_thread(void *p1, void *p2, void *p3)
+{
+	static char buf[256];
+	struct range_request range;
+	int64_t now;
+	size_t off;
+	int len;
+
+	while (true) {
+		k_msgq_get(&requests, &range, K_FOREVER);
+
+		now = k_uptime_get();
+		if (range.ready_ms > now) {
+			k_sleep(K_MSEC(range.ready_ms - now));
+		}
+
+		len = snprintf(buf, sizeof(buf),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "Content-Range: bytes %u-%u/%u\r\n"
+			       "Content-Length: %u\r\n"
+			       "Connection: keep-alive\r\n\r\n",
+			       (unsigned int)range.from, (unsigned int)range.to,
+			       HTTP_SERVER_FILE_SIZE,
+			       (unsigned int)(range.to - range.from + 1));
+		(void)response_send(buf, len);
+
+		off = range.from;
+		while (off <= range.to) {
+			len = MIN(sizeof(buf), range.to - off + 1);
+			for (size_t i = 0; i < len; i++) {
+				buf[i] = http_server_file_byte(off + i);
+			}
+
+			if (off + len > range.to) {
+				/* The client may send the next request as soon
+				 * as the response has been received.
+				 */
+				atomic_dec(&outstanding);
+			}
+
+			(void)response_send(buf, len);
+			off += len;
+		}
+	}
+}
+
+K_THREAD_STACK_DEFINE(receiver_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(sender_stack, STACK_SIZE);
+static struct k_thread receiver;
+static struct k_thread sender;
+
+void http_server_start(void)
+{
+	k_thread_create(&receiver, receiver_stack,
+			K_THREAD_STACK_SIZEOF(receiver_stack), receiver_thread,
+			NULL, NULL, NULL, PRIORITY, 0, K_NO_WAIT);
+	k_thread_create(&sender, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender_thread,
+			NULL, NULL, NULL, PRIORITY, 0, K_NO_WAIT);
+}
+
+size_t http_server_request_cnt(void)
+{
+	return atomic_get(&request_cnt);
+}
+
+size_t http_server_max_outstanding(void)
+{
+	return atomic_get(&max_outstanding);
+}
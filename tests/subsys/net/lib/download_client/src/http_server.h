@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_SERVER_H_
+#define HTTP_SERVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTTP_SERVER_PORT	8080
+
+/* Time between a request reaching the server and its response being sent,
+ * standing in for the round-trip time of the link.
+ */
+#define HTTP_SERVER_LATENCY_MS	50
+
+/* Size of the file served for any request. */
+#define HTTP_SERVER_FILE_SIZE	(16 * 512 + 100)
+
+/* Start a minimal HTTP server answering range requests on the loopback
+ * interface.
+ */
+void http_server_start(void);
+
+/* Return the content of the served file at a given offset. */
+static inline uint8_t http_server_file_byte(size_t off)
+{
+	return (uint8_t)(off % 251);
+}
+
+/* Return the number of requests received. */
+size_t http_server_request_cnt(void);
+
+/* Return the maximum number of requests received and not yet answered. */
+size_t http_server_max_outstanding(void);
+
+#endif /* HTTP_SERVER_H_ */
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Test downloading a file in fragments from HTTP and CoAP server stand-ins
+ * running on the loopback interface, which answer each request after a fixed
+ * latency. The test is built with different values of
+ * CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH and
+ * CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW (see testcase.yaml).
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/download_client.h>
+
+#include "http_server.h"
+#include "coap_server.h"
+
+#define FRAG_SIZE	CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE
+#define FRAG_CNT	DIV_ROUND_UP(HTTP_SERVER_FILE_SIZE, FRAG_SIZE)
+#define PIPELINE_DEPTH	CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH
+#define BLOCK_CNT	DIV_ROUND_UP(COAP_SERVER_FILE_SIZE, COAP_SERVER_BLOCK_MAX)
+#define COAP_WINDOW	CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW
+#define LOSS_PERIOD	8
+/* Requests are dropped only at the beginning of the lossy download, so the
+ * adaptive block size can recover afterwards.
+ */
+#define LOSS_LIMIT	BLOCK_CNT
+#define BLOCK_SIZE	coap_block_size_to_bytes(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE)
+
+static struct download_client client;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static uint8_t (*file_byte)(size_t off);
+static struct download_client_stats stats;
+static size_t received;
+static size_t max_frag_len;
+static bool content_valid;
+static int error;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	const uint8_t *buf;
+
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		buf = event->fragment.buf;
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (buf[i] != file_byte(received + i)) {
+				content_valid = false;
+			}
+		}
+
+		received += event->fragment.len;
+		max_frag_len = MAX(max_frag_len, event->fragment.len);
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		stats = event->stats;
+		k_sem_give(&done_sem);
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		error = event->error;
+		k_sem_give(&done_sem);
+		/* Stop the download */
+		return 1;
+	}
+
+	return 0;
+}
+
+static void test_init(void)
+{
+	http_server_start();
+	coap_server_start();
+
+	zassert_equal(download_client_init(&client, download_client_callback),
+		      0, "Error when initializing");
+}
+
+static void test_download(void)
+{
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	int64_t start;
+	int64_t duration_ms;
+	int err;
+
+	file_byte = http_server_file_byte;
+	received = 0;
+	max_frag_len = 0;
+	content_valid = true;
+	error = 0;
+
+	err = download_client_connect(&client,
+				      "http://127.0.0.1:" STRINGIFY(HTTP_SERVER_PORT),
+				      &config);
+	zassert_equal(err, 0, "Cannot connect");
+
+	start = k_uptime_get();
+	err = download_client_start(&client, "file.bin", 0);
+	zassert_equal(err, 0, "Cannot start download");
+
+	err = k_sem_take(&done_sem, K_SECONDS(30));
+	duration_ms = k_uptime_get() - start;
+
+	zassert_equal(err, 0, "Download timed out");
+	zassert_equal(error, 0, "Download failed");
+	zassert_equal(received, HTTP_SERVER_FILE_SIZE, "Invalid file size");
+	zassert_true(content_valid, "Invalid file content");
+	zassert_true(max_frag_len <= FRAG_SIZE, "Fragment too large");
+	zassert_equal(http_server_request_cnt(), FRAG_CNT,
+		      "Invalid number of requests");
+	zassert_equal(stats.bytes, HTTP_SERVER_FILE_SIZE, "Invalid statistics");
+	zassert_equal(stats.requests, FRAG_CNT, "Invalid statistics");
+
+	TC_PRINT("%d fragments (pipeline depth %d): %lld ms, "
+		 "max %d requests outstanding\n",
+		 FRAG_CNT, PIPELINE_DEPTH, duration_ms,
+		 (int)http_server_max_outstanding());
+
+	/* The amount of data in flight is bounded by the window. */
+	zassert_true(http_server_max_outstanding() <= PIPELINE_DEPTH,
+		     "Too many outstanding requests");
+
+	if (PIPELINE_DEPTH > 1) {
+		zassert_true(http_server_max_outstanding() > 1,
+			     "Requests not pipelined");
+		zassert_true(duration_ms < FRAG_CNT * HTTP_SERVER_LATENCY_MS / 2,
+			     "Latency not hidden by pipelining");
+	} else {
+		zassert_true(duration_ms >= FRAG_CNT * HTTP_SERVER_LATENCY_MS,
+			     "Latency not injected");
+	}
+
+	zassert_equal(download_client_disconnect(&client), 0,
+		      "Cannot disconnect");
+}
+
+static void coap_download(size_t loss_period, size_t loss_limit)
+{
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	int err;
+
+	coap_server_loss_set(loss_period, loss_limit);
+
+	file_byte = coap_server_file_byte;
+	received = 0;
+	content_valid = true;
+	error = 0;
+
+	err = download_client_connect(&client,
+				      "coap://127.0.0.1:" STRINGIFY(COAP_SERVER_PORT),
+				      &config);
+	zassert_equal(err, 0, "Cannot connect");
+
+	err = download_client_start(&client, "file.bin", 0);
+	zassert_equal(err, 0, "Cannot start download");
+
+	err = k_sem_take(&done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+	zassert_equal(error, 0, "Download failed");
+	zassert_equal(received, COAP_SERVER_FILE_SIZE, "Invalid file size");
+	zassert_true(content_valid, "Invalid file content");
+
+	TC_PRINT("%d blocks (window %d, loss 1/%d): %u ms, %u B/s, "
+		 "%u requests, %u retransmissions, rtt %u ms, block %u\n",
+		 BLOCK_CNT, COAP_WINDOW, (int)loss_period, stats.duration_ms,
+		 stats.goodput, stats.requests, stats.retransmissions,
+		 stats.rtt_ms, stats.block_size);
+
+	zassert_equal(stats.bytes, COAP_SERVER_FILE_SIZE, "Invalid statistics");
+	zassert_equal(stats.requests, coap_server_request_cnt(),
+		      "Invalid number of requests");
+	zassert_true(stats.requests >= BLOCK_CNT, "Invalid number of requests");
+	zassert_true(stats.retransmissions >= coap_server_dropped_cnt(),
+		     "Lost requests not retransmitted");
+	zassert_true(stats.rtt_min_ms >= COAP_SERVER_LATENCY_MS,
+		     "Invalid round-trip time");
+
+	zassert_equal(download_client_disconnect(&client), 0,
+		      "Cannot disconnect");
+}
+
+static void test_coap_download(void)
+{
+	coap_download(0, 0);
+
+	zassert_equal(stats.retransmissions, 0, "Unexpected retransmissions");
+
+	if (COAP_WINDOW > 1) {
+		zassert_true(stats.duration_ms <
+			     BLOCK_CNT * COAP_SERVER_LATENCY_MS / 2,
+			     "Latency not hidden by the window");
+	} else {
+		zassert_equal(stats.requests, BLOCK_CNT,
+			      "Invalid number of requests");
+		zassert_true(stats.duration_ms >=
+			     BLOCK_CNT * COAP_SERVER_LATENCY_MS,
+			     "Latency not injected");
+	}
+}
+
+static void test_coap_download_lossy(void)
+{
+	coap_download(LOSS_PERIOD, LOSS_LIMIT);
+
+	zassert_true(coap_server_dropped_cnt() > 0, "No request dropped");
+
+	TC_PRINT("Smallest block requested: %u\n",
+		 (unsigned int)coap_server_block_size_min());
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE_ADAPTIVE)) {
+		zassert_true(coap_server_block_size_min() < BLOCK_SIZE,
+			     "Block size not reduced on loss");
+	} else {
+		zassert_equal(coap_server_block_size_min(), BLOCK_SIZE,
+			      "Block size changed");
+	}
+
+	/* The block size is back to the configured one after the loss. */
+	zassert_equal(stats.block_size, BLOCK_SIZE, "Block size not recovered");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(download_client_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_download),
+			 ztest_unit_test(test_coap_download),
+			 ztest_unit_test(test_coap_download_lossy)
+			 );
+
+	ztest_run_test_suite(download_client_tests);
+}
@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <net/nrf_cloud_agps.h>
+
+#include "nrf_cloud_agps_schema_v1.h"
+#include "mock.h"
+
+/* Size of the MQTT payload buffer when fragments are enabled. */
+#define FRAGMENT_SIZE		512
+/* Number of elements injected from the test data. TOWs are injected with the
+ * system clock.
+ */
+#define INJECTED_COUNT		(1 + 32 + 32 + 1 + 1 + 1 + 1)
+/* Number of elements decoded from the test data. */
+#define ELEMENT_COUNT		(1 + 32 + 32 + 1 + 32 + 1 + 1 + 1)
+/* Offsets of the first ephemeris and TOW in the test data. */
+#define EPHEMERIS_OFFSET	(1 + 3 + sizeof(struct nrf_cloud_agps_utc) + 3)
+#define TOW_OFFSET		(EPHEMERIS_OFFSET + \
+				 32 * sizeof(struct nrf_cloud_agps_ephemeris) + 3 + \
+				 32 * sizeof(struct nrf_cloud_agps_almanac) + 3 + \
+				 sizeof(struct nrf_cloud_agps_klobuchar) + 3)
+
+static const int socket = 1;
+static char agps_data[4096];
+static size_t agps_data_len;
+static struct mock_sent reference;
+
+static void array_add(enum nrf_cloud_agps_type type, uint16_t count,
+		      const void *elements, size_t element_len)
+{
+	agps_data[agps_data_len++] = type;
+	sys_put_le16(count, (uint8_t *)&agps_data[agps_data_len]);
+	agps_data_len += sizeof(count);
+
+	memcpy(&agps_data[agps_data_len], elements, count * element_len);
+	agps_data_len += count * element_len;
+}
+
+/* Synthetic response with all assistance data. */
+static void agps_data_create(void)
+{
+	struct nrf_cloud_agps_utc utc = { .a1 = 1, .a0 = -2, .delta_tls = 18 };
+	struct nrf_cloud_agps_ephemeris ephemeris[32];
+	struct nrf_cloud_agps_almanac almanac[32];
+	struct nrf_cloud_agps_klobuchar klobuchar = { .alpha0 = 1, .beta3 = -1 };
+	struct nrf_cloud_agps_tow_element tow[32];
+	uint8_t system_clock[16] = { 0x10, 0x2c, 0x00, 0xa8, 0x0b, 0x00 };
+	struct nrf_cloud_agps_location location = {
+		.latitude = 5000000,
+		.longitude = -300000,
+		.confidence = 68
+	};
+	struct nrf_cloud_agps_integrity integrity = { .integrity_mask = 0x20 };
+
+	for (size_t i = 0; i < 32; i++) {
+		memset(&ephemeris[i], i, sizeof(ephemeris[i]));
+		ephemeris[i].sv_id = i + 1;
+		ephemeris[i].health = 0;
+
+		memset(&almanac[i], 0x80 + i, sizeof(almanac[i]));
+		almanac[i].sv_id = i + 1;
+
+		tow[i].sv_id = i + 1;
+		tow[i].tlm = i;
+		tow[i].flags = i & 1;
+	}
+
+	agps_data_len = 0;
+	agps_data[agps_data_len++] = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+
+	array_add(NRF_CLOUD_AGPS_UTC_PARAMETERS, 1, &utc, sizeof(utc));
+	array_add(NRF_CLOUD_AGPS_EPHEMERIDES, 32, ephemeris, sizeof(ephemeris[0]));
+	array_add(NRF_CLOUD_AGPS_ALMANAC, 32, almanac, sizeof(almanac[0]));
+	array_add(NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION, 1, &klobuchar,
+		  sizeof(klobuchar));
+	array_add(NRF_CLOUD_AGPS_GPS_TOWS, 32, tow, sizeof(tow[0]));
+	array_add(NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK, 1, system_clock,
+		  sizeof(system_clock));
+	array_add(NRF_CLOUD_AGPS_LOCATION, 1, &location, sizeof(location));
+	array_add(NRF_CLOUD_AGPS_INTEGRITY, 1, &integrity, sizeof(integrity));
+}
+
+/* Compare the fields of two injected elements. The padding of the modem structures is
+ * not initialized, and is not compared.
+ */
+static bool injected_equal(nrf_gnss_agps_data_type_t type, const uint8_t *a,
+			   const uint8_t *b)
+{
+	switch (type) {
+	case NRF_GNSS_AGPS_UTC_PARAMETERS: {
+		const nrf_gnss_agps_data_utc_t *x = (const void *)a;
+		const nrf_gnss_agps_data_utc_t *y = (const void *)b;
+
+		return (x->a1 == y->a1) && (x->a0 == y->a0) &&
+		       (x->delta_tls == y->delta_tls) && (x->dn == y->dn);
+	}
+	case NRF_GNSS_AGPS_EPHEMERIDES: {
+		const nrf_gnss_agps_data_ephemeris_t *x = (const void *)a;
+		const nrf_gnss_agps_data_ephemeris_t *y = (const void *)b;
+
+		return (x->sv_id == y->sv_id) && (x->iodc == y->iodc) &&
+		       (x->af0 == y->af0) && (x->toe == y->toe) && (x->m0 == y->m0) &&
+		       (x->e == y->e) && (x->sqrt_a == y->sqrt_a) && (x->cuc == y->cuc);
+	}
+	case NRF_GNSS_AGPS_ALMANAC: {
+		const nrf_gnss_agps_data_almanac_t *x = (const void *)a;
+		const nrf_gnss_agps_data_almanac_t *y = (const void *)b;
+
+		return (x->sv_id == y->sv_id) && (x->e == y->e) &&
+		       (x->sqrt_a == y->sqrt_a) && (x->m0 == y->m0) && (x->af1 == y->af1);
+	}
+	case NRF_GNSS_AGPS_GPS_SYSTEM_CLOCK_AND_TOWS: {
+		const nrf_gnss_agps_data_system_time_and_sv_tow_t *x = (const void *)a;
+		const nrf_gnss_agps_data_system_time_and_sv_tow_t *y = (const void *)b;
+
+		for (size_t i = 0; i < ARRAY_SIZE(x->sv_tow); i++) {
+			if ((x->sv_tow[i].tlm != y->sv_tow[i].tlm) ||
+			    (x->sv_tow[i].flags != y->sv_tow[i].flags)) {
+				return false;
+			}
+		}
+
+		return (x->date_day == y->date_day) && (x->time_full_s == y->time_full_s) &&
+		       (x->sv_mask == y->sv_mask);
+	}
+	case NRF_GNSS_AGPS_LOCATION: {
+		const nrf_gnss_agps_data_location_t *x = (const void *)a;
+		const nrf_gnss_agps_data_location_t *y = (const void *)b;
+
+		return (x->latitude == y->latitude) && (x->longitude == y->longitude) &&
+		       (x->confidence == y->confidence);
+	}
+	default:
+		/* Structures without padding. */
+		return memcmp(a, b, sizeof(uint32_t)) == 0;
+	}
+}
+
+static int fragments_process(size_t fragment_size)
+{
+	int err = 0;
+
+	for (size_t offset = 0; offset < agps_data_len; offset += fragment_size) {
+		err = nrf_cloud_agps_process_fragment(&agps_data[offset],
+						      MIN(fragment_size,
+							  agps_data_len - offset),
+						      offset, agps_data_len, &socket);
+		if (err) {
+			break;
+		}
+	}
+
+	return err;
+}
+
+static void test_setup(void)
+{
+	struct gps_agps_request request = {0};
+
+	/* Data for all satellites is injected until satellites are requested. */
+	(void)nrf_cloud_agps_request(request);
+
+	agps_data_create();
+	mock_sent_reset();
+}
+
+static void test_process(void)
+{
+	int err;
+	struct nrf_cloud_agps_stats stats;
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(INJECTED_COUNT, mock_sent.count, "Wrong number of injections");
+
+	zassert_equal(NRF_GNSS_AGPS_UTC_PARAMETERS, mock_sent.type[0], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_EPHEMERIDES, mock_sent.type[1], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_ALMANAC, mock_sent.type[33], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_KLOBUCHAR_IONOSPHERIC_CORRECTION,
+		      mock_sent.type[65], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_GPS_SYSTEM_CLOCK_AND_TOWS,
+		      mock_sent.type[66], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_LOCATION, mock_sent.type[67], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_INTEGRITY, mock_sent.type[68], "Wrong type");
+
+	nrf_cloud_agps_stats_get(&stats);
+	zassert_equal(ELEMENT_COUNT, stats.elements, "Wrong number of elements");
+	zassert_equal(INJECTED_COUNT, stats.writes, "Wrong number of writes");
+	zassert_equal(0, stats.skipped, "Wrong number of skipped elements");
+}
+
+/* Fragments of any size inject the same data as the complete response. */
+static void test_process_fragments(void)
+{
+	int err;
+	const size_t fragment_sizes[] = { 1, 3, 17, 61, 62, FRAGMENT_SIZE };
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	memcpy(&reference, &mock_sent, sizeof(reference));
+
+	for (size_t i = 0; i < ARRAY_SIZE(fragment_sizes); i++) {
+		mock_sent_reset();
+
+		err = fragments_process(fragment_sizes[i]);
+		zassert_equal(0, err, "Return value %d is wrong", err);
+
+		zassert_equal(reference.count, mock_sent.count,
+			      "Wrong number of injections, fragment size %d",
+			      (int)fragment_sizes[i]);
+		zassert_mem_equal(reference.type, mock_sent.type, sizeof(reference.type),
+				  "Wrong types, fragment size %d", (int)fragment_sizes[i]);
+		zassert_mem_equal(reference.len, mock_sent.len, sizeof(reference.len),
+				  "Wrong lengths, fragment size %d", (int)fragment_sizes[i]);
+		zassert_equal(reference.data_len, mock_sent.data_len,
+			      "Wrong data length, fragment size %d",
+			      (int)fragment_sizes[i]);
+
+		for (size_t j = 0, offset = 0; j < reference.count; j++) {
+			zassert_true(injected_equal(reference.type[j],
+						    &reference.data[offset],
+						    &mock_sent.data[offset]),
+				     "Wrong data, fragment size %d, element %d",
+				     (int)fragment_sizes[i], (int)j);
+
+			offset += reference.len[j];
+		}
+	}
+}
+
+static void test_process_fragment_order(void)
+{
+	int err;
+
+	err = nrf_cloud_agps_process_fragment(agps_data, 100, 0, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	/* A fragment is missing. */
+	err = nrf_cloud_agps_process_fragment(&agps_data[200], 100, 200, agps_data_len,
+					      &socket);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	/* New data replaces the incomplete data. */
+	mock_sent_reset();
+
+	err = fragments_process(FRAGMENT_SIZE);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(INJECTED_COUNT, mock_sent.count, "Wrong number of injections");
+
+	/* Processing is complete, and the next fragment must start new data. */
+	err = nrf_cloud_agps_process_fragment(&agps_data[100], 100, 100, agps_data_len,
+					      &socket);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	mock_sent_reset();
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+}
+
+/* Incomplete data does not block other users of the A-GPS injection. */
+static void test_process_fragment_abort(void)
+{
+	int err;
+
+	err = nrf_cloud_agps_process_fragment(agps_data, 100, 0, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	/* The connection is lost. */
+	nrf_cloud_agps_process_abort();
+
+	err = nrf_cloud_agps_process_fragment(&agps_data[100], 100, 100, agps_data_len,
+					      &socket);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	mock_sent_reset();
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(INJECTED_COUNT, mock_sent.count, "Wrong number of injections");
+
+	/* Aborting without fragmented data does nothing. */
+	nrf_cloud_agps_process_abort();
+}
+
+static void test_process_fragment_timeout(void)
+{
+	int err;
+
+	err = nrf_cloud_agps_process_fragment(agps_data, 100, 0, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	/* The rest of the data never arrives. */
+	k_sleep(K_MSEC(CONFIG_NRF_CLOUD_AGPS_FRAGMENT_TIMEOUT * MSEC_PER_SEC + 100));
+
+	err = nrf_cloud_agps_process_fragment(&agps_data[100], 100, 100, agps_data_len,
+					      &socket);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	mock_sent_reset();
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(INJECTED_COUNT, mock_sent.count, "Wrong number of injections");
+}
+
+static void test_process_schema_version(void)
+{
+	int err;
+
+	agps_data[0] = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION + 1;
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+
+	err = nrf_cloud_agps_process_fragment(agps_data, FRAGMENT_SIZE, 0,
+					      agps_data_len, &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+	zassert_equal(0, mock_sent.count, "Data is injected");
+
+	/* Processing is not blocked by the rejected data. */
+	agps_data[0] = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+}
+
+/* Invalid data is rejected before any of it is injected. */
+static void test_process_invalid(void)
+{
+	int err;
+
+	/* Truncated in an element. */
+	err = nrf_cloud_agps_process(agps_data, agps_data_len - 1, &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+
+	/* Truncated between two elements of an array. */
+	err = nrf_cloud_agps_process(agps_data, TOW_OFFSET +
+				     sizeof(struct nrf_cloud_agps_tow_element), &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+
+	/* Invalid satellite ID of the last TOW. */
+	agps_data[TOW_OFFSET + 31 * sizeof(struct nrf_cloud_agps_tow_element)] = 33;
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+	zassert_equal(0, mock_sent.count, "Data is injected");
+
+	/* Fragments are checked as they are injected. */
+	err = fragments_process(FRAGMENT_SIZE);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+
+	/* Empty array. */
+	agps_data_create();
+	mock_sent_reset();
+	agps_data[EPHEMERIS_OFFSET - 2] = 0;
+	agps_data[EPHEMERIS_OFFSET - 1] = 0;
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(-EBADMSG, err, "Return value %d is wrong", err);
+	zassert_equal(0, mock_sent.count, "Data is injected");
+}
+
+/* Ephemerides and almanacs are only injected for the requested satellites. */
+static void test_process_requested(void)
+{
+	int err;
+	struct nrf_cloud_agps_stats stats;
+	struct gps_agps_request processed;
+	struct gps_agps_request request = {
+		.sv_mask_ephe = 0x3,
+		.sv_mask_alm = 0x80000000,
+	};
+
+	/* The request is not sent by the mocked transport, but the satellites
+	 * are recorded.
+	 */
+	(void)nrf_cloud_agps_request(request);
+
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(INJECTED_COUNT - 30 - 31, mock_sent.count,
+		      "Wrong number of injections");
+
+	zassert_equal(NRF_GNSS_AGPS_EPHEMERIDES, mock_sent.type[1], "Wrong type");
+	zassert_equal(1, mock_sent.data[mock_sent.len[0]], "Wrong satellite");
+	zassert_equal(NRF_GNSS_AGPS_EPHEMERIDES, mock_sent.type[2], "Wrong type");
+	zassert_equal(NRF_GNSS_AGPS_ALMANAC, mock_sent.type[3], "Wrong type");
+	zassert_equal(32, mock_sent.data[mock_sent.len[0] + mock_sent.len[1] +
+					 mock_sent.len[2]], "Wrong satellite");
+
+	nrf_cloud_agps_stats_get(&stats);
+	zassert_equal(ELEMENT_COUNT, stats.elements, "Wrong number of elements");
+	zassert_equal(mock_sent.count, stats.writes, "Wrong number of writes");
+	zassert_equal(30 + 31, stats.skipped, "Wrong number of skipped elements");
+
+	/* Only the satellites sent to the modem are reported as processed. */
+	nrf_cloud_agps_processed(&processed);
+	zassert_equal(request.sv_mask_ephe, processed.sv_mask_ephe,
+		      "Wrong processed ephemerides 0x%08x",
+		      processed.sv_mask_ephe);
+	zassert_equal(request.sv_mask_alm, processed.sv_mask_alm,
+		      "Wrong processed almanacs 0x%08x", processed.sv_mask_alm);
+}
+
+/* Compare processing of the complete response to processing in fragments. The
+ * cycle counts are only meaningful on hardware.
+ */
+static void test_process_measurement(void)
+{
+	int err;
+	uint32_t cycles;
+	uint32_t fragment_cycles;
+	struct nrf_cloud_agps_stats stats;
+
+	cycles = k_cycle_get_32();
+	err = nrf_cloud_agps_process(agps_data, agps_data_len, &socket);
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	mock_sent_reset();
+
+	fragment_cycles = k_cycle_get_32();
+	err = fragments_process(FRAGMENT_SIZE);
+	fragment_cycles = k_cycle_get_32() - fragment_cycles;
+
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	TC_PRINT("Processing %d bytes of A-GPS data:\n", (int)agps_data_len);
+	TC_PRINT("Complete: %d bytes payload buffer, %u cycles\n",
+		 (int)agps_data_len, cycles);
+	TC_PRINT("Fragments: %d bytes payload buffer, %u cycles\n",
+		 FRAGMENT_SIZE, fragment_cycles);
+
+	nrf_cloud_agps_stats_get(&stats);
+	TC_PRINT("Fragments: %u us decoding, %u us injecting\n",
+		 stats.decode_time_us, stats.inject_time_us);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_agps,
+		ztest_unit_test_setup_teardown(test_process, test_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_fragments, test_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_fragment_order,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_fragment_abort,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_fragment_timeout,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_schema_version,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_invalid,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_requested,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_process_measurement,
+					       test_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(nrf_cloud_agps);
+}
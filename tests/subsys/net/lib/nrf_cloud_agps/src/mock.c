@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <modem/modem_info.h>
+#include <nrf_socket.h>
+
+#include "nrf_cloud_transport.h"
+#include "nrf_cloud_agps_schema_v1.h"
+#include "mock.h"
+
+struct mock_sent mock_sent;
+
+void mock_sent_reset(void)
+{
+	memset(&mock_sent, 0, sizeof(mock_sent));
+}
+
+ssize_t nrf_sendto(int socket, const void *message, size_t length, int flags,
+		   const void *dest_addr, nrf_socklen_t dest_len)
+{
+	if ((mock_sent.count == MOCK_SEND_COUNT_MAX) ||
+	    (mock_sent.data_len + length > sizeof(mock_sent.data))) {
+		return -1;
+	}
+
+	memcpy(&mock_sent.type[mock_sent.count], dest_addr,
+	       sizeof(mock_sent.type[0]));
+	mock_sent.len[mock_sent.count++] = length;
+
+	memcpy(&mock_sent.data[mock_sent.data_len], message, length);
+	mock_sent.data_len += length;
+
+	return length;
+}
+
+void agps_print(enum nrf_cloud_agps_type type, void *data)
+{
+}
+
+int nct_dc_send(const struct nct_dc_data *dc)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_init(void)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_init(struct modem_param_info *modem)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_get(struct modem_param_info *modem)
+{
+	return -ENOTSUP;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_H__
+#define MOCK_H__
+
+#include <zephyr.h>
+#include <nrf_socket.h>
+
+#define MOCK_SEND_COUNT_MAX	128
+#define MOCK_SEND_DATA_LEN	8192
+
+/* Data injected to the modem through the mocked GNSS socket. */
+struct mock_sent {
+	size_t count;
+	nrf_gnss_agps_data_type_t type[MOCK_SEND_COUNT_MAX];
+	size_t len[MOCK_SEND_COUNT_MAX];
+	size_t data_len;
+	uint8_t data[MOCK_SEND_DATA_LEN];
+};
+
+extern struct mock_sent mock_sent;
+
+void mock_sent_reset(void);
+
+#endif /* MOCK_H__ */
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Functional test of the P-GPS library. The storage is a RAM array and the
+ * flash stream writes to it directly, see mock.c.
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <settings/settings.h>
+#include <net/nrf_cloud_pgps.h>
+
+#include "nrf_cloud_pgps_schema_v1.h"
+#include "nrf_cloud_pgps_utils.h"
+#include "mock.h"
+
+#define FRAGMENT_SIZE		CONFIG_NRF_CLOUD_PGPS_DOWNLOAD_FRAGMENT_SIZE
+#define PERIOD_SEC		(CONFIG_NRF_CLOUD_PGPS_PREDICTION_PERIOD * SEC_PER_MIN)
+#define START_GPS_DAY		15000
+#define START_GPS_SEC		((int64_t)START_GPS_DAY * SEC_PER_DAY)
+/* The library looks for the prediction two hours ahead of the current time. */
+#define MIDPOINT_SHIFT_SEC	(2 * SEC_PER_HOUR)
+#define DL_INFO			"[\"pgps.nrfcloud.com\",\"/predictions.bin\"]"
+
+static uint8_t storage[NUM_PREDICTIONS * PGPS_PREDICTION_STORAGE_SIZE] __aligned(4);
+static uint8_t pgps_data[sizeof(struct nrf_cloud_pgps_header) +
+			 NUM_PREDICTIONS * PGPS_PREDICTION_DL_SIZE];
+static enum nrf_cloud_pgps_event last_event;
+
+static void event_handler(enum nrf_cloud_pgps_event event,
+			  struct nrf_cloud_pgps_prediction *p)
+{
+	last_event = event;
+}
+
+/* Set the current time to the given offset into a prediction. */
+static void time_set(int pnum, uint32_t offset_sec)
+{
+	int64_t gps_sec = START_GPS_SEC + pnum * PERIOD_SEC + offset_sec -
+			  MIDPOINT_SHIFT_SEC;
+
+	mock_date_time_ms = (gps_sec + GPS_TO_UNIX_UTC_OFFSET_SECONDS -
+			     GPS_TO_UTC_LEAP_SECONDS) * MSEC_PER_SEC;
+}
+
+/* Synthetic download with a full set of predictions. The schema version and
+ * sentinel of each prediction are only added when it is stored.
+ */
+static void pgps_data_create(void)
+{
+	struct nrf_cloud_pgps_header header = {
+		.schema_version = NRF_CLOUD_PGPS_BIN_SCHEMA_VERSION,
+		.array_type = NRF_CLOUD_PGPS_PREDICTION_HEADER,
+		.num_items = 1,
+		.prediction_count = NUM_PREDICTIONS,
+		.prediction_size = PGPS_PREDICTION_DL_SIZE,
+		.prediction_period_min = CONFIG_NRF_CLOUD_PGPS_PREDICTION_PERIOD,
+		.gps_day = START_GPS_DAY,
+		.gps_time_of_day = 0
+	};
+	struct nrf_cloud_pgps_prediction p;
+	size_t schema_offset = offsetof(struct nrf_cloud_pgps_prediction, schema_version);
+	uint8_t *data = pgps_data;
+
+	memcpy(data, &header, sizeof(header));
+	data += sizeof(header);
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		int64_t gps_sec = START_GPS_SEC + pnum * PERIOD_SEC;
+
+		memset(&p, pnum + 1, sizeof(p));
+		p.time_type = NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK;
+		p.time_count = 1;
+		p.time.date_day = gps_sec / SEC_PER_DAY;
+		p.time.time_full_s = gps_sec % SEC_PER_DAY;
+		p.time.time_frac_ms = 0;
+		p.time.sv_mask = 0;
+		p.ephemeris_type = NRF_CLOUD_AGPS_EPHEMERIDES;
+		p.ephemeris_count = NRF_CLOUD_PGPS_NUM_SV;
+
+		for (int i = 0; i < NRF_CLOUD_PGPS_NUM_SV; i++) {
+			p.ephemerii[i].sv_id = i + 1;
+			p.ephemerii[i].health = 0;
+		}
+
+		memcpy(data, &p, schema_offset);
+		data += schema_offset;
+		memcpy(data, &p.ephemeris_type, PGPS_PREDICTION_DL_SIZE - schema_offset);
+		data += PGPS_PREDICTION_DL_SIZE - schema_offset;
+	}
+}
+
+/* Remove the prediction map, as if the predictions were stored by an earlier
+ * version of the library.
+ */
+static void prediction_map_remove(void)
+{
+	struct prediction_map map = {0};
+	int err;
+
+	err = settings_save_one("nrf_cloud_pgps/pred_map", &map, sizeof(map));
+	zassert_equal(0, err, "settings_save_one, error: %d", err);
+}
+
+static int pgps_init(void)
+{
+	struct nrf_cloud_pgps_init_param param = {
+		.event_handler = event_handler,
+		.storage_base = (uint32_t)storage,
+		.storage_size = sizeof(storage)
+	};
+
+	last_event = PGPS_EVT_INIT;
+	mock_requests = 0;
+
+	return nrf_cloud_pgps_init(&param);
+}
+
+/* Initialize without stored predictions, and load a full set. */
+static void pgps_load(void)
+{
+	int err;
+
+	err = pgps_init();
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(PGPS_EVT_UNAVAILABLE, last_event, "Wrong event");
+	zassert_equal(1, mock_requests, "Predictions are not requested");
+
+	err = nrf_cloud_pgps_process(DL_INFO, strlen(DL_INFO));
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	err = mock_download(pgps_data, sizeof(pgps_data), FRAGMENT_SIZE);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+}
+
+static void test_setup(void)
+{
+	struct nrf_cloud_pgps_header header = {0};
+	int err;
+
+	memset(storage, 0xff, sizeof(storage));
+
+	err = settings_save_one("nrf_cloud_pgps/pgps_header", &header, sizeof(header));
+	zassert_equal(0, err, "settings_save_one, error: %d", err);
+	prediction_map_remove();
+
+	pgps_data_create();
+	time_set(0, SEC_PER_HOUR);
+}
+
+static void test_load(void)
+{
+	int ret;
+	struct nrf_cloud_pgps_prediction *p;
+
+	pgps_load();
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(START_GPS_DAY, p->time.date_day, "Wrong prediction");
+
+	time_set(NUM_PREDICTIONS - 1, SEC_PER_HOUR);
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(NUM_PREDICTIONS - 1, ret, "Return value %d is wrong", ret);
+	zassert_equal(NRF_CLOUD_PGPS_NUM_SV, p->ephemeris_count, "Wrong prediction");
+}
+
+/* The stored predictions are found through the map, without a request. */
+static void test_boot(void)
+{
+	int ret;
+	struct nrf_cloud_pgps_prediction *p;
+
+	pgps_load();
+
+	ret = pgps_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+	zassert_equal(0, mock_requests, "Predictions are requested");
+
+	time_set(5, 0);
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(5, ret, "Return value %d is wrong", ret);
+
+	/* Without the map, all predictions are checked. */
+	prediction_map_remove();
+
+	ret = pgps_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+	zassert_equal(0, mock_requests, "Predictions are requested");
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(5, ret, "Return value %d is wrong", ret);
+}
+
+/* A corrupted prediction is found when it is used, or by the check of all
+ * predictions when there is no map.
+ */
+static void test_corrupted(void)
+{
+	int ret;
+	struct nrf_cloud_pgps_prediction *p;
+	struct nrf_cloud_pgps_header *header;
+
+	pgps_load();
+
+	storage[3 * PGPS_PREDICTION_STORAGE_SIZE + 100] ^= 0x01;
+
+	ret = pgps_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+
+	time_set(3, 0);
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_true(ret < 0, "Corrupted prediction is used");
+	zassert_is_null(p, "Corrupted prediction is returned");
+
+	time_set(4, 0);
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(4, ret, "Return value %d is wrong", ret);
+
+	/* The corrupted prediction and the ones after it are requested again. */
+	prediction_map_remove();
+	time_set(0, 0);
+
+	ret = pgps_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(PGPS_EVT_LOADING, last_event, "Wrong event");
+	zassert_equal(1, mock_requests, "Predictions are not requested");
+
+	header = (struct nrf_cloud_pgps_header *)pgps_data;
+	header->prediction_count = NUM_PREDICTIONS - 3;
+	memmove(&pgps_data[sizeof(*header)],
+		&pgps_data[sizeof(*header) + 3 * PGPS_PREDICTION_DL_SIZE],
+		(NUM_PREDICTIONS - 3) * PGPS_PREDICTION_DL_SIZE);
+
+	ret = nrf_cloud_pgps_process(DL_INFO, strlen(DL_INFO));
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = mock_download(pgps_data, sizeof(*header) +
+			    (NUM_PREDICTIONS - 3) * PGPS_PREDICTION_DL_SIZE, FRAGMENT_SIZE);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+
+	time_set(3, 0);
+
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	zassert_equal(3, ret, "Return value %d is wrong", ret);
+}
+
+/* Compare boot with and without the map, and the first and later lookups of a
+ * prediction, for a full set of predictions. The cycle counts are only
+ * meaningful on hardware.
+ */
+static void test_measurement(void)
+{
+	int ret;
+	uint32_t map_cycles;
+	uint32_t scan_cycles;
+	uint32_t first_cycles;
+	uint32_t next_cycles;
+	struct nrf_cloud_pgps_prediction *p;
+
+	pgps_load();
+
+	map_cycles = k_cycle_get_32();
+	ret = pgps_init();
+	map_cycles = k_cycle_get_32() - map_cycles;
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+
+	prediction_map_remove();
+
+	scan_cycles = k_cycle_get_32();
+	ret = pgps_init();
+	scan_cycles = k_cycle_get_32() - scan_cycles;
+	zassert_equal(PGPS_EVT_READY, last_event, "Wrong event");
+
+	/* Boot again with the map saved by the check of all predictions. */
+	ret = pgps_init();
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	time_set(NUM_PREDICTIONS / 2, 0);
+
+	first_cycles = k_cycle_get_32();
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	first_cycles = k_cycle_get_32() - first_cycles;
+	zassert_equal(NUM_PREDICTIONS / 2, ret, "Return value %d is wrong", ret);
+
+	next_cycles = k_cycle_get_32();
+	ret = nrf_cloud_pgps_find_prediction(&p);
+	next_cycles = k_cycle_get_32() - next_cycles;
+	zassert_equal(NUM_PREDICTIONS / 2, ret, "Return value %d is wrong", ret);
+
+	TC_PRINT("Boot with %d stored predictions:\n", NUM_PREDICTIONS);
+	TC_PRINT("With map: %u cycles\n", map_cycles);
+	TC_PRINT("Checking all predictions: %u cycles\n", scan_cycles);
+	TC_PRINT("Prediction lookup:\n");
+	TC_PRINT("First, with verification: %u cycles\n", first_cycles);
+	TC_PRINT("Next: %u cycles\n", next_cycles);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_pgps,
+		ztest_unit_test_setup_teardown(test_load, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_boot, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_corrupted, test_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_measurement, test_setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(nrf_cloud_pgps);
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <storage/stream_flash.h>
+#include <net/download_client.h>
+#include <date_time.h>
+#include <drivers/gps.h>
+#include <nrfx_nvmc.h>
+
+#include "nrf_cloud_transport.h"
+#include "mock.h"
+
+int64_t mock_date_time_ms;
+int mock_requests;
+size_t mock_flash_written;
+
+static download_client_callback_t download_callback;
+
+/* The P-GPS storage is read directly. Writes through the flash stream are
+ * copied to the address given as the flash offset.
+ *
+ * The flash simulator cannot be used instead, because the library reads the
+ * predictions through the storage address, as the flash of the nRF9160 is
+ * memory mapped. This makes the test a functional test of the library only:
+ * flash page erase, write alignment and the write timing are not covered.
+ */
+static uint8_t *write_ptr;
+
+uint32_t nrfx_nvmc_flash_page_size_get(void)
+{
+	return 4096;
+}
+
+int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
+		      uint8_t *buf, size_t buf_len, size_t offset, size_t size,
+		      stream_flash_callback_t cb)
+{
+	write_ptr = (uint8_t *)offset;
+
+	return 0;
+}
+
+int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
+				size_t len, bool flush)
+{
+	if (data && len) {
+		memmove(write_ptr, data, len);
+		write_ptr += len;
+		mock_flash_written += len;
+	}
+
+	return 0;
+}
+
+int date_time_now(int64_t *unix_time_ms)
+{
+	*unix_time_ms = mock_date_time_ms;
+
+	return 0;
+}
+
+int nct_dc_send(const struct nct_dc_data *dc)
+{
+	mock_requests++;
+
+	return 0;
+}
+
+int download_client_init(struct download_client *client,
+			 download_client_callback_t callback)
+{
+	download_callback = callback;
+
+	return 0;
+}
+
+int download_client_connect(struct download_client *client, const char *host,
+			    const struct download_client_cfg *config)
+{
+	return 0;
+}
+
+int download_client_start(struct download_client *client, const char *file,
+			  size_t from)
+{
+	return 0;
+}
+
+int download_client_disconnect(struct download_client *client)
+{
+	return 0;
+}
+
+int mock_download(const uint8_t *buf, size_t len, size_t fragment_size)
+{
+	int err = 0;
+	struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT
+	};
+
+	for (size_t offset = 0; offset < len; offset += fragment_size) {
+		evt.fragment.buf = &buf[offset];
+		evt.fragment.len = MIN(fragment_size, len - offset);
+
+		err = download_callback(&evt);
+		if (err) {
+			return err;
+		}
+	}
+
+	memset(&evt, 0, sizeof(evt));
+	evt.id = DOWNLOAD_CLIENT_EVT_DONE;
+
+	return download_callback(&evt);
+}
+
+int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
+{
+	return 0;
+}
+
+void nrf_cloud_agps_processed(struct gps_agps_request *received_elements)
+{
+	memset(received_elements, 0, sizeof(*received_elements));
+}
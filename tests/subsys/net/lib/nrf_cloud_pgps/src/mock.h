@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_H__
+#define MOCK_H__
+
+#include <zephyr.h>
+
+/* Current time returned by date_time_now(). */
+extern int64_t mock_date_time_ms;
+
+/* Number of P-GPS requests sent to the cloud. */
+extern int mock_requests;
+
+/* Flash writes through the mocked flash stream. */
+extern size_t mock_flash_written;
+
+/* Pass data to the P-GPS library as if it was downloaded in fragments of the
+ * given size, and end the download.
+ */
+int mock_download(const uint8_t *buf, size_t len, size_t fragment_size);
+
+#endif /* MOCK_H__ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRFX_NVMC_H__
+#define NRFX_NVMC_H__
+
+#include <zephyr.h>
+
+/* Replaces the nrfx driver, which is not available on native_posix. */
+uint32_t nrfx_nvmc_flash_page_size_get(void);
+
+#endif /* NRFX_NVMC_H__ */
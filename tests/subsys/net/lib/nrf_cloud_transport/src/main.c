@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Test of the reception of MQTT payloads by the nRF Cloud transport, with
+ * payloads larger than the payload buffer received in fragments
+ * (CONFIG_NRF_CLOUD_MQTT_PAYLOAD_FRAGMENTS).
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <net/mqtt.h>
+
+#include "nrf_cloud_transport.h"
+#include "mock.h"
+
+#define CLIENT_ID	"test-device"
+#define DC_TOPIC	"prod/test-tenant/m/d/" CLIENT_ID "/agps"
+#define CC_TOPIC	CLIENT_ID "/shadow/get/accepted"
+
+/* Data read from the socket at once; the payload buffer holds a terminator. */
+#define FRAGMENT_SIZE	CONFIG_NRF_CLOUD_MQTT_PAYLOAD_BUFFER_LEN
+#define NO_READ_FAIL	SIZE_MAX
+
+/* Not declared in the transport header, as the library connects through
+ * nct_connect().
+ */
+int nct_mqtt_connect(void);
+
+static uint8_t payload[MOCK_RX_DATA_LEN];
+
+static void publish_receive(const char *topic, size_t len,
+			    size_t read_fail_offset)
+{
+	struct mqtt_evt evt = {
+		.type = MQTT_EVT_PUBLISH,
+		.param.publish = {
+			.message = {
+				.topic = {
+					.topic = {
+						.utf8 = (const uint8_t *)topic,
+						.size = strlen(topic),
+					},
+					.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+				},
+				.payload.len = len,
+			},
+			.message_id = 1,
+		},
+	};
+
+	mock_payload_set(payload, len, read_fail_offset);
+	mock_client->evt_cb(mock_client, &evt);
+}
+
+static void test_setup(void)
+{
+	for (size_t i = 0; i < sizeof(payload); i++) {
+		payload[i] = i * 7;
+	}
+
+	mock_reset();
+}
+
+static void test_connect(void)
+{
+	int err;
+
+	err = nct_init(CLIENT_ID);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	err = nct_mqtt_connect();
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_not_null(mock_client, "MQTT client not connected");
+	zassert_not_null(mock_client->evt_cb, "No MQTT event handler");
+}
+
+static void test_rx_data(void)
+{
+	const size_t len = FRAGMENT_SIZE;
+
+	publish_receive(DC_TOPIC, len, NO_READ_FAIL);
+
+	zassert_equal(1, mock_rx.dc_count, "Wrong number of events");
+	zassert_equal(0, mock_rx.fragment_count, "Data is fragmented");
+	zassert_equal(len, mock_rx.data_len, "Wrong data length");
+	zassert_mem_equal(payload, mock_rx.data, len, "Wrong data");
+	zassert_equal(1, mock_ack_count, "Message not acknowledged");
+}
+
+static void test_rx_data_fragments(void)
+{
+	const size_t lens[] = {
+		FRAGMENT_SIZE + 1,
+		2 * FRAGMENT_SIZE,
+		MOCK_RX_DATA_LEN - 3,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(lens); i++) {
+		mock_reset();
+
+		publish_receive(DC_TOPIC, lens[i], NO_READ_FAIL);
+
+		zassert_equal(ceiling_fraction(lens[i], FRAGMENT_SIZE),
+			      mock_rx.fragment_count,
+			      "Wrong number of fragments, length %d", (int)lens[i]);
+		zassert_equal(mock_rx.fragment_count, mock_rx.dc_count,
+			      "Data not notified in fragments");
+		zassert_false(mock_rx.out_of_order, "Fragments out of order");
+		zassert_true(mock_rx.max_len <= FRAGMENT_SIZE,
+			     "Fragment larger than the payload buffer");
+		zassert_equal(lens[i], mock_rx.total_len, "Wrong total length");
+		zassert_equal(lens[i], mock_rx.data_len, "Wrong data length");
+		zassert_mem_equal(payload, mock_rx.data, lens[i], "Wrong data");
+		zassert_equal(lens[i], mock_payload_read(), "Payload not read");
+		zassert_equal(1, mock_ack_count, "Message not acknowledged");
+		zassert_equal(0, mock_disconnect_count, "Disconnected");
+	}
+}
+
+static void test_rx_data_fragments_read_error(void)
+{
+	const size_t len = 4 * FRAGMENT_SIZE;
+
+	publish_receive(DC_TOPIC, len, 2 * FRAGMENT_SIZE + 10);
+
+	zassert_equal(2, mock_rx.fragment_count, "Wrong number of fragments");
+	zassert_equal(1, mock_disconnect_count, "Not disconnected");
+	zassert_equal(0, mock_ack_count, "Message acknowledged");
+}
+
+/* The shadow is not fragmented, but read into an allocated buffer. */
+static void test_rx_control_channel(void)
+{
+	const size_t len = 5 * FRAGMENT_SIZE;
+
+	publish_receive(CC_TOPIC, len, NO_READ_FAIL);
+
+	zassert_equal(1, mock_rx.cc_count, "Wrong number of events");
+	zassert_equal(0, mock_rx.dc_count, "Data channel event");
+	zassert_equal(len, mock_rx.data_len, "Wrong data length");
+	zassert_mem_equal(payload, mock_rx.data, len, "Wrong data");
+	zassert_equal(1, mock_ack_count, "Message not acknowledged");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_transport,
+		ztest_unit_test_setup_teardown(test_connect, test_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_rx_data, test_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_rx_data_fragments,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_rx_data_fragments_read_error,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_rx_control_channel,
+					       test_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(nrf_cloud_transport);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <net/mqtt.h>
+#include <net/nrf_cloud.h>
+
+#include "nrf_cloud_transport.h"
+#include "mock.h"
+
+struct mock_rx mock_rx;
+struct mqtt_client *mock_client;
+size_t mock_ack_count;
+size_t mock_disconnect_count;
+
+static struct {
+	const uint8_t *data;
+	size_t len;
+	size_t read;
+	size_t fail_offset;
+} payload;
+
+void mock_reset(void)
+{
+	memset(&mock_rx, 0, sizeof(mock_rx));
+	memset(&payload, 0, sizeof(payload));
+	mock_ack_count = 0;
+	mock_disconnect_count = 0;
+}
+
+void mock_payload_set(const uint8_t *data, size_t len, size_t read_fail_offset)
+{
+	payload.data = data;
+	payload.len = len;
+	payload.read = 0;
+	payload.fail_offset = read_fail_offset;
+}
+
+size_t mock_payload_read(void)
+{
+	return payload.read;
+}
+
+static void rx_data_add(const struct nrf_cloud_data *data, size_t offset)
+{
+	if ((offset != mock_rx.data_len) ||
+	    (offset + data->len > sizeof(mock_rx.data))) {
+		mock_rx.out_of_order = true;
+		return;
+	}
+
+	memcpy(&mock_rx.data[offset], data->ptr, data->len);
+	mock_rx.data_len += data->len;
+	mock_rx.max_len = MAX(mock_rx.max_len, data->len);
+}
+
+int nct_input(const struct nct_evt *evt)
+{
+	switch (evt->type) {
+	case NCT_EVT_DC_RX_DATA:
+		mock_rx.dc_count++;
+
+		if (evt->param.dc->fragment.total_len != 0) {
+			mock_rx.fragment_count++;
+			mock_rx.total_len = evt->param.dc->fragment.total_len;
+			rx_data_add(&evt->param.dc->data,
+				    evt->param.dc->fragment.offset);
+		} else {
+			rx_data_add(&evt->param.dc->data, 0);
+		}
+		break;
+	case NCT_EVT_CC_RX_DATA:
+		mock_rx.cc_count++;
+		rx_data_add(&evt->param.cc->data, 0);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+int nrf_cloud_disconnect(void)
+{
+	mock_disconnect_count++;
+	return 0;
+}
+
+void mqtt_client_init(struct mqtt_client *client)
+{
+	memset(client, 0, sizeof(*client));
+}
+
+int mqtt_connect(struct mqtt_client *client)
+{
+	mock_client = client;
+	return 0;
+}
+
+int mqtt_disconnect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_input(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_live(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_keepalive_time_left(const struct mqtt_client *client)
+{
+	return -1;
+}
+
+int mqtt_publish(struct mqtt_client *client,
+		 const struct mqtt_publish_param *param)
+{
+	return 0;
+}
+
+int mqtt_publish_qos1_ack(struct mqtt_client *client,
+			  const struct mqtt_puback_param *param)
+{
+	mock_ack_count++;
+	return 0;
+}
+
+int mqtt_subscribe(struct mqtt_client *client,
+		   const struct mqtt_subscription_list *param)
+{
+	return 0;
+}
+
+int mqtt_unsubscribe(struct mqtt_client *client,
+		     const struct mqtt_subscription_list *param)
+{
+	return 0;
+}
+
+int mqtt_readall_publish_payload(struct mqtt_client *client, uint8_t *buffer,
+				 size_t length)
+{
+	if ((payload.read + length > payload.len) ||
+	    (payload.read + length > payload.fail_offset)) {
+		return -EIO;
+	}
+
+	memcpy(buffer, &payload.data[payload.read], length);
+	payload.read += length;
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_H__
+#define MOCK_H__
+
+#include <zephyr.h>
+#include <net/mqtt.h>
+
+#define MOCK_RX_DATA_LEN	2048
+
+/* Data notified by the transport through the mocked nct_input(). */
+struct mock_rx {
+	/* Number of data channel events, and of those the fragments. */
+	size_t dc_count;
+	size_t fragment_count;
+	/* Number of control channel events. */
+	size_t cc_count;
+	/* Largest data length notified in one event. */
+	size_t max_len;
+	/* Fragments are not notified in order. */
+	bool out_of_order;
+	/* Total length given with the fragments. */
+	size_t total_len;
+	/* Received data, fragments are reassembled. */
+	size_t data_len;
+	uint8_t data[MOCK_RX_DATA_LEN];
+};
+
+extern struct mock_rx mock_rx;
+
+/* MQTT client registered by the transport. */
+extern struct mqtt_client *mock_client;
+
+/* Number of acknowledgments sent, and of disconnects requested. */
+extern size_t mock_ack_count;
+extern size_t mock_disconnect_count;
+
+void mock_reset(void);
+
+/* Set the payload read by the transport. Reading fails at read_fail_offset,
+ * unless it is beyond the end of the payload.
+ */
+void mock_payload_set(const uint8_t *payload, size_t len,
+		      size_t read_fail_offset);
+
+/* Number of payload bytes read by the transport. */
+size_t mock_payload_read(void);
+
+#endif /* MOCK_H__ */
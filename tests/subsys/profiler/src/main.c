@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Benchmark measuring the cost of profiler_log_send for the direct RTT
+ * backend and for the ring buffer backend (see testcase.yaml).
+ */
+
+#include <ztest.h>
+#include <profiler.h>
+
+#ifdef CONFIG_PROFILER_NORDIC_RING
+#include <profiler_nordic_ring.h>
+#endif
+
+#define LOG_CNT 1000
+
+static uint16_t event_id;
+
+static void test_init(void)
+{
+	const char *labels[] = {"val", "inv_val"};
+	enum profiler_arg types[] = {PROFILER_ARG_U32, PROFILER_ARG_U32};
+
+	zassert_ok(profiler_init(), "Error when initializing");
+
+	event_id = profiler_register_event_type("bench_event", labels, types,
+						ARRAY_SIZE(types));
+	zassert_true(is_profiling_enabled(event_id), "Event not profiled");
+}
+
+static void test_log_send_cycles(void)
+{
+	uint32_t min = UINT32_MAX;
+	uint32_t max = 0;
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i < LOG_CNT; i++) {
+		struct log_event_buf buf;
+
+		profiler_log_start(&buf);
+		profiler_log_encode_u32(&buf, i);
+		profiler_log_encode_u32(&buf, ~i);
+
+		uint32_t start = k_cycle_get_32();
+
+		profiler_log_send(&buf, event_id);
+
+		uint32_t cycles = k_cycle_get_32() - start;
+
+		min = MIN(min, cycles);
+		max = MAX(max, cycles);
+		sum += cycles;
+
+		/* Let the host or the drain thread keep up. */
+		if ((i % 16) == 0) {
+			k_sleep(K_MSEC(1));
+		}
+	}
+
+	TC_PRINT("profiler_log_send (%s): min %u avg %u max %u cycles\n",
+		 IS_ENABLED(CONFIG_PROFILER_NORDIC_RING) ? "ring" : "rtt",
+		 min, (uint32_t)(sum / LOG_CNT), max);
+}
+
+#ifdef CONFIG_PROFILER_NORDIC_RING
+static void log_event(uint32_t val)
+{
+	struct log_event_buf buf;
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, val);
+	profiler_log_encode_u32(&buf, ~val);
+	profiler_log_send(&buf, event_id);
+}
+
+static void test_ring_drop(void)
+{
+	struct profiler_nordic_ring_stats before;
+	struct profiler_nordic_ring_stats after;
+	size_t cnt = 2 * CONFIG_PROFILER_NORDIC_RING_RECORD_CNT;
+
+	/* Wait until the ring buffer is drained. */
+	k_sleep(K_MSEC(10 * CONFIG_PROFILER_NORDIC_RING_DRAIN_PERIOD_MS));
+	profiler_nordic_ring_stats_get(&before);
+
+	/* Drain thread cannot run while the scheduler is locked. */
+	k_sched_lock();
+	for (size_t i = 0; i < cnt; i++) {
+		log_event(i);
+	}
+	k_sched_unlock();
+
+	profiler_nordic_ring_stats_get(&after);
+
+	zassert_equal(after.stored - before.stored,
+		      CONFIG_PROFILER_NORDIC_RING_RECORD_CNT,
+		      "Invalid number of stored records");
+	zassert_equal(after.dropped - before.dropped,
+		      cnt - CONFIG_PROFILER_NORDIC_RING_RECORD_CNT,
+		      "Invalid number of dropped records");
+	zassert_equal(after.max_used, CONFIG_PROFILER_NORDIC_RING_RECORD_CNT,
+		      "Ring buffer not full");
+}
+#else
+static void test_ring_drop(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_PROFILER_NORDIC_RING */
+
+static void test_term(void)
+{
+	profiler_term();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(profiler_tests,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_log_send_cycles),
+			 ztest_unit_test(test_ring_drop),
+			 ztest_unit_test(test_term)
+			 );
+
+	ztest_run_test_suite(profiler_tests);
+}